@@ -11,111 +11,145 @@
 
 #pragma once
 
-#include <algorithm>
-#include <condition_variable>
-#include <deque>
-#include <limits>
-#include <mutex>
-
-#include "util/Assert.h"
-#include "util/safe_casts.h"  // for as_signed
-
+#include <algorithm>  // for min
+#include <atomic>     // for atomic
+#include <cstddef>    // for size_t
+#include <cstdint>    // for uint32_t
+#include <iterator>   // for distance
+#include <limits>     // for numeric_limits
+#include <utility>    // for pair
+#include <vector>     // for vector
+
+/**
+ * @brief Single producer, single consumer ring buffer of audio samples
+ *
+ * The buffer is allocated once: emplace() and pop() never allocate, lock nor wait, so that they can be called from the
+ * real-time callbacks of PortAudio. Samples which do not fit in the buffer are dropped and counted, see
+ * getDroppedSamples().
+ *
+ * emplace() may only be called by one thread (the producer) and pop() by one other thread (the consumer). The threads
+ * which are not real-time may block in waitForProducer() / waitForConsumer() until the other side makes progress.
+ */
 template <typename T>
 class AudioQueue {
 public:
+    /**
+     * About 5 seconds of stereo audio at 48 kHz
+     */
+    static constexpr size_t DEFAULT_CAPACITY = size_t{1} << 19U;
+
+    /**
+     * @param capacity The maximal number of samples in the queue, rounded up to a power of 2
+     */
+    explicit AudioQueue(size_t capacity = DEFAULT_CAPACITY) {
+        size_t size = 1;
+        while (size < capacity) {
+            size <<= 1U;
+        }
+        this->buffer.resize(size);
+        this->mask = size - 1;
+    }
+
+    /**
+     * Empties the queue for a new stream. Neither the producer nor the consumer may be running.
+     */
     void reset() {
-        std::lock_guard<std::mutex> lock(internalLock);
-        this->popNotified = false;
-        this->pushNotified = false;
-        this->streamEnd = false;
-        internalQueue.clear();
+        this->head.store(0, std::memory_order_relaxed);
+        this->tail.store(0, std::memory_order_relaxed);
+        this->droppedSamples.store(0, std::memory_order_relaxed);
+        this->streamEnd.store(false, std::memory_order_relaxed);
+        this->lastPushSeen = this->pushCount.load(std::memory_order_relaxed);
+        this->lastPopSeen = this->popCount.load(std::memory_order_relaxed);
 
         this->sampleRate = -1;
         this->channels = 0;
     }
 
-    bool empty() {
-        std::lock_guard<std::mutex> lock(internalLock);
-        return internalQueue.empty();
-    }
+    bool empty() const { return size() == 0; }
 
-    size_t size() {
-        std::lock_guard<std::mutex> lock(internalLock);
-        return internalQueue.size();
+    size_t size() const {
+        // Load the tail first: the head only grows, so that the difference never underflows
+        size_t t = this->tail.load(std::memory_order_acquire);
+        return this->head.load(std::memory_order_acquire) - t;
     }
 
+    size_t capacity() const { return this->buffer.size(); }
+
+    /**
+     * Appends the samples (producer only). The samples which do not fit are dropped.
+     */
     template <typename Iter>
     void emplace(Iter begI, Iter endI) {
-        std::lock_guard<std::mutex> lock(internalLock);
-        std::move(begI, endI, std::front_inserter(internalQueue));
+        size_t h = this->head.load(std::memory_order_relaxed);
+        size_t free = capacity() - (h - this->tail.load(std::memory_order_acquire));
+        auto count = static_cast<size_t>(std::distance(begI, endI));
+        size_t n = std::min(count, free);
+
+        for (size_t i = 0; i < n; ++i, ++begI) {
+            this->buffer[(h + i) & this->mask] = std::move(*begI);
+        }
+        this->head.store(h + n, std::memory_order_release);
 
-        this->pushNotified = true;
-        this->pushLockCondition.notify_one();
+        if (n < count) {
+            this->droppedSamples.fetch_add(count - n, std::memory_order_relaxed);
+        }
+        notify(this->pushCount);
     }
 
+    /**
+     * Takes up to nSamples samples from the front of the queue (consumer only). Only whole frames are taken.
+     */
     template <typename InsertIter>
     InsertIter pop(InsertIter insertIter, size_t nSamples) {
-        std::lock_guard<std::mutex> lock(internalLock);
-
-        if (this->channels == 0) {
-            this->popNotified = true;
-            this->popLockCondition.notify_one();
+        uint32_t ch = this->channels.load(std::memory_order_acquire);
+        if (ch == 0) {
+            notify(this->popCount);
             return insertIter;
         }
 
+        size_t t = this->tail.load(std::memory_order_relaxed);
+        size_t available = this->head.load(std::memory_order_acquire) - t;
+        size_t n = std::min(nSamples, available - available % ch);
 
-        auto queueSize = internalQueue.size();
-        auto returnBufferLength = std::min<size_t>(nSamples, queueSize - queueSize % this->channels);
-        auto begI = rbegin(internalQueue);
-        auto endI = std::next(begI, as_signed(returnBufferLength));
-
-        auto ret = std::move(begI, endI, insertIter);
-        internalQueue.erase(endI.base(), begI.base());
+        for (size_t i = 0; i < n; ++i) {
+            *insertIter = std::move(this->buffer[(t + i) & this->mask]);
+            ++insertIter;
+        }
+        this->tail.store(t + n, std::memory_order_release);
 
-        this->popNotified = true;
-        this->popLockCondition.notify_one();
-        return ret;
+        notify(this->popCount);
+        return insertIter;
     }
 
     void signalEndOfStream() {
-        std::lock_guard<std::mutex> lock(internalLock);
-        this->streamEnd = true;
-        this->pushNotified = true;
-        this->popNotified = true;
-        this->pushLockCondition.notify_one();
-        this->popLockCondition.notify_one();
+        this->streamEnd.store(true, std::memory_order_release);
+        notify(this->pushCount);
+        notify(this->popCount);
     }
 
-    void waitForProducer(std::unique_lock<std::mutex>& lock) {
-        // static_assert(lock.mutex() == &this->queueLock);
-        xoj_assert(lock.mutex() == &this->queueLock);
-        while (!this->pushNotified && !hasStreamEnded()) { this->pushLockCondition.wait(lock); }
-        this->pushNotified = false;
-    }
+    /**
+     * Blocks until the producer has pushed samples since the last call, or the stream has ended (consumer only)
+     */
+    void waitForProducer() { wait(this->pushCount, this->lastPushSeen); }
 
-    void waitForConsumer(std::unique_lock<std::mutex>& lock) {
-        // static_assert(lock.mutex() == &this->queueLock);
-        xoj_assert(lock.mutex() == &this->queueLock);
-        while (!this->popNotified && !hasStreamEnded()) { this->popLockCondition.wait(lock); }
-        this->popNotified = false;
-    }
+    /**
+     * Blocks until the consumer has popped samples since the last call, or the stream has ended (producer only)
+     */
+    void waitForConsumer() { wait(this->popCount, this->lastPopSeen); }
 
-    bool hasStreamEnded() {
-        std::lock_guard<std::mutex> lock(internalLock);
-        return this->streamEnd;
-    }
+    bool hasStreamEnded() const { return this->streamEnd.load(std::memory_order_acquire); }
 
-    [[nodiscard]] std::unique_lock<std::mutex> acquire_lock() {
-        std::unique_lock retLock{this->queueLock, std::defer_lock};
-        std::lock(retLock, this->internalLock);
-        std::lock_guard lock{this->internalLock, std::adopt_lock};
-        return retLock;
-    }
+    /**
+     * @return The number of samples dropped since the last reset() because the queue was full
+     */
+    size_t getDroppedSamples() const { return this->droppedSamples.load(std::memory_order_relaxed); }
 
+    /**
+     * Set by the producer before the stream is started
+     */
     void setAudioAttributes(double lSampleRate, unsigned int lChannels) {
-        std::lock_guard<std::mutex> lock(internalLock);
-        this->sampleRate = lSampleRate;
-        this->channels = lChannels;
+        this->sampleRate.store(lSampleRate, std::memory_order_relaxed);
+        this->channels.store(lChannels, std::memory_order_release);
     }
 
     /**
@@ -124,24 +158,45 @@ public:
      * Todo (readability, type-safety): create a struct AudioAttributes; remove this comment
      */
 
-    [[nodiscard]] std::pair<double, int> getAudioAttributes() {
-        std::lock_guard<std::mutex> lock(internalLock);
-        return {this->sampleRate, this->channels};
+    [[nodiscard]] std::pair<double, int> getAudioAttributes() const {
+        uint32_t ch = this->channels.load(std::memory_order_acquire);
+        return {this->sampleRate.load(std::memory_order_relaxed), static_cast<int>(ch)};
     }
 
 private:
-    std::mutex queueLock;
-    std::mutex internalLock;
+    static void notify(std::atomic<uint32_t>& counter) {
+        counter.fetch_add(1, std::memory_order_release);
+        counter.notify_all();
+    }
+
+    void wait(std::atomic<uint32_t>& counter, uint32_t& lastSeen) {
+        uint32_t current = counter.load(std::memory_order_acquire);
+        while (current == lastSeen && !hasStreamEnded()) {
+            counter.wait(current, std::memory_order_acquire);
+            current = counter.load(std::memory_order_acquire);
+        }
+        lastSeen = current;
+    }
+
+private:
+    std::vector<T> buffer;
+    size_t mask = 0;
+
+    /// The number of samples ever pushed, written by the producer only
+    std::atomic<size_t> head{0};
+    /// The number of samples ever popped, written by the consumer only
+    std::atomic<size_t> tail{0};
 
-    std::deque<T> internalQueue;
+    std::atomic<size_t> droppedSamples{0};
 
-    std::condition_variable pushLockCondition;
-    std::condition_variable popLockCondition;
+    /// Incremented on each emplace() / pop(), to wake up the other side
+    std::atomic<uint32_t> pushCount{0};
+    std::atomic<uint32_t> popCount{0};
+    uint32_t lastPushSeen = 0;  ///< Only used by the consumer
+    uint32_t lastPopSeen = 0;   ///< Only used by the producer
 
-    double sampleRate{std::numeric_limits<double>::quiet_NaN()};
-    uint32_t channels{0};
+    std::atomic<double> sampleRate{std::numeric_limits<double>::quiet_NaN()};
+    std::atomic<uint32_t> channels{0};
 
-    bool streamEnd{false};
-    bool pushNotified{false};
-    bool popNotified{false};
+    std::atomic<bool> streamEnd{false};
 };
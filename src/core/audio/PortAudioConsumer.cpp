@@ -1,7 +1,6 @@
 #include "PortAudioConsumer.h"
 
 #include <algorithm>  // for for_each, transform, max
-#include <deque>      // for _Deque_iterator
 #include <iterator>   // for next, prev
 #include <string>     // for to_string, string
 
@@ -5,7 +5,7 @@
 #include <iterator>   // for next
 #include <string>     // for to_string, string
 
-#include <glib.h>  // for g_message
+#include <glib.h>  // for g_message, g_warning
 
 #include "audio/AudioQueue.h"           // for AudioQueue
 #include "audio/DeviceInfo.h"           // for DeviceInfo
@@ -115,6 +115,11 @@ void PortAudioProducer::stopRecording() {
         }
     }
 
+    if (size_t dropped = this->audioQueue.getDroppedSamples(); dropped > 0) {
+        g_warning("PortAudioProducer: %zu audio samples were dropped, the recording could not be written fast enough",
+                  dropped);
+    }
+
     // Notify the consumer at the other side that there will be no more data
     this->audioQueue.signalEndOfStream();
 
@@ -2,7 +2,6 @@
 
 #include <algorithm>  // for for_each, min, max
 #include <cstddef>    // for size_t
-#include <deque>      // for _Deque_iterator
 #include <iterator>   // for back_insert_iterator, back_in...
 #include <memory>     // for unique_ptr
 #include <string>     // for string
@@ -41,14 +40,13 @@ auto VorbisConsumer::start(fs::path const& file) -> bool {
     }
 
     this->consumerThread = std::thread([this, sfFile = std::move(sfFile), channels = channels] {
-        auto lock{audioQueue.acquire_lock()};
         auto buffer_size{size_t(64 * channels)};
         std::vector<float> buffer;
         buffer.reserve(buffer_size);  // efficiency
         float audioGain = static_cast<float>(this->settings.getAudioGain());
 
         while (!(this->stopConsumer || (audioQueue.hasStreamEnded() && audioQueue.empty()))) {
-            audioQueue.waitForProducer(lock);
+            audioQueue.waitForProducer();
             while (audioQueue.size() > buffer_size || (audioQueue.hasStreamEnded() && !audioQueue.empty())) {
                 buffer.resize(0);
                 this->audioQueue.pop(std::back_inserter(buffer), buffer_size);
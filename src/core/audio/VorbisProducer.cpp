@@ -42,7 +42,6 @@ auto VorbisProducer::start(fs::path const& file, unsigned int timestamp) -> bool
         sf_count_t numFrames{1};
         size_t const bufferSize{size_t(1024U) * size_t(sfInfo.channels)};
         std::vector<float> sampleBuffer(bufferSize);
-        auto lock = audioQueue.acquire_lock();
 
         while (!this->stopProducer && numFrames > 0 && !this->audioQueue.hasStreamEnded()) {
             sampleBuffer.resize(bufferSize);
@@ -51,7 +50,7 @@ auto VorbisProducer::start(fs::path const& file, unsigned int timestamp) -> bool
 
             while (this->audioQueue.size() >= sample_buffer_size && !this->audioQueue.hasStreamEnded() &&
                    !this->stopProducer) {
-                audioQueue.waitForConsumer(lock);
+                audioQueue.waitForConsumer();
             }
 
             if (auto tmpSeekSeconds = this->seekSeconds.load(); tmpSeekSeconds != 0) {
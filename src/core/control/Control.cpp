@@ -15,13 +15,17 @@
 #include "control/ClipboardHandler.h"                            // for Clip...
 #include "motion/MotionExportController.h"                       // for Moti...
 #include "control/CompassController.h"                           // for Comp...
+#include "control/PdfCache.h"                                    // for PdfC...
 #include "control/RecentManager.h"                               // for Rece...
+#include "control/RenderCache.h"                                 // for Rend...
 #include "control/ScrollHandler.h"                               // for Scro...
 #include "control/SetsquareController.h"                         // for Sets...
+#include "control/ThumbnailCache.h"                              // for Thum...
 #include "control/Tool.h"                                        // for Tool
 #include "control/ToolHandler.h"                                 // for Tool...
 #include "control/actions/ActionDatabase.h"                      // for Acti...
 #include "control/jobs/AutosaveJob.h"                            // for Auto...
+#include "control/jobs/AutosaveWriter.h"                         // for Auto...
 #include "control/jobs/BaseExportJob.h"                          // for Base...
 #include "control/jobs/CustomExportJob.h"                        // for Cust...
 #include "control/jobs/PdfExportJob.h"                           // for PdfE...
@@ -37,6 +41,7 @@
 #include "control/settings/SettingsEnums.h"                      // for Button
 #include "control/settings/ViewModes.h"                          // for ViewM..
 #include "control/tools/TextEditor.h"                            // for Text...
+#include "control/xojfile/AutosaveJournal.h"                     // for Auto...
 #include "control/xojfile/LoadHandler.h"                         // for Load...
 #include "control/zoom/ZoomControl.h"                            // for Zoom...
 #include "gui/FloatingToolbox.h"                                 // for Floa...
@@ -134,6 +139,7 @@ Control::Control(GApplication* gtkApp, GladeSearchpath* gladeSearchPath, bool di
     auto name = Util::getConfigFile(SETTINGS_XML_FILE);
     this->settings = new Settings(std::move(name));
     this->settings->load();
+    this->undoRedo->setMemoryLimit(size_t{this->settings->getUndoMemoryLimit()} << 20U);
     this->loadPaletteFromSettings();
 
     this->pageTypes = new PageTypeHandler(gladeSearchPath);
@@ -146,7 +152,14 @@ Control::Control(GApplication* gtkApp, GladeSearchpath* gladeSearchPath, bool di
 
     this->scrollHandler = new ScrollHandler(this);
 
-    this->scheduler = new XournalScheduler();
+    this->scheduler = new XournalScheduler(this->settings->getSchedulerThreadCount());
+    Text::setRenderThreadCount(this->scheduler->getThreadCount());
+    this->renderCache = std::make_unique<RenderCache>(size_t{this->settings->getRenderCacheBudget()} * 1024 * 1024);
+    if (this->settings->getThumbnailCacheSize() > 0) {
+        this->thumbnailCache = std::make_unique<ThumbnailCache>(
+                Util::getCacheSubfolder("thumbnails"), size_t{this->settings->getThumbnailCacheSize()} * 1024 * 1024);
+    }
+    this->autosaveWriter = std::make_unique<AutosaveWriter>(this);
 
     this->doc = new Document(this);
 
@@ -186,8 +199,10 @@ Control::~Control() {
     g_source_remove(this->changeTimout);
     this->enableAutosave(false);
 
-    deleteLastAutosaveFile();
     this->scheduler->stop();
+    // Waits for the autosave being written, after which the autosave file may be deleted
+    this->autosaveWriter.reset();
+    deleteLastAutosaveFile();
     this->changedPages.clear();  // can be removed, will be done by implicit destructor
 
     delete this->pluginController;
@@ -246,8 +261,9 @@ void Control::setLastAutosaveFile(fs::path newAutosaveFile) {
 
 void Control::deleteLastAutosaveFile() {
     try {
-        if (fs::exists(this->lastAutosaveFilename)) {
+        if (!this->lastAutosaveFilename.empty()) {
             fs::remove(this->lastAutosaveFilename);
+            fs::remove(AutosaveJournal::getPath(this->lastAutosaveFilename));
         }
     } catch (const fs::filesystem_error& e) {
         auto fmtstr = FS(_F("Could not remove old autosave file \"{1}\": {2}") % this->lastAutosaveFilename.u8string() %
@@ -334,8 +350,13 @@ auto Control::autosaveCallback(Control* control) -> bool {
         // do nothing, nothing changed
         return true;
     }
+    if (control->autosaveWriter->isRunning()) {
+        // The previous autosave is not written yet, try again next time
+        return true;
+    }
 
-    auto* job = new AutosaveJob(control);
+    auto* job = new AutosaveJob(control, control->undoRedo->getPagesChangedSinceAutosave());
+    control->undoRedo->documentAutosaved();
     control->scheduler->addJob(job, JOB_PRIORITY_NONE);
     job->unref();
 
@@ -566,7 +587,18 @@ auto Control::firePageSelected(const PageRef& page) -> size_t {
     return pageId;
 }
 
-void Control::firePageSelected(size_t page) { DocumentHandler::firePageSelected(page); }
+void Control::firePageSelected(size_t page) {
+    DocumentHandler::firePageSelected(page);
+
+    if (this->settings->isLazyPageLoading()) {
+        // The pages far from the current one are likely not needed anymore. Don't wait if the document is in use:
+        // the pages will be unloaded on the next page change.
+        if (this->doc->tryLock()) {
+            this->doc->unloadLazyPages(size_t(this->settings->getLazyPageMemoryBudget()) * 1024 * 1024, page);
+            this->doc->unlock();
+        }
+    }
+}
 
 void Control::manageToolbars() {
     xoj::popup::PopupWindowWrapper<ToolbarManageDialog> dlg(
@@ -1550,6 +1582,7 @@ void Control::replaceDocument(std::unique_ptr<Document> doc, int scrollToPage) {
 
 void Control::openXoppFile(fs::path filepath, int scrollToPage, std::function<void(bool)> callback) {
     LoadHandler loadHandler;
+    loadHandler.setLoadPagesLazily(this->settings->isLazyPageLoading());
     std::unique_ptr<Document> doc(loadHandler.loadDocument(filepath));
 
     if (!doc) {
@@ -2528,6 +2561,33 @@ auto Control::getToolHandler() const -> ToolHandler* { return this->toolHandler;
 
 auto Control::getScheduler() const -> XournalScheduler* { return this->scheduler; }
 
+auto Control::getRenderCache() const -> RenderCache* { return this->renderCache.get(); }
+
+auto Control::getPdfCache() const -> std::shared_ptr<PdfCache> {
+    std::lock_guard lock(this->pdfCacheMutex);
+    return this->pdfCache;
+}
+
+void Control::updatePdfCache() {
+    std::shared_ptr<PdfCache> cache = getPdfCache();
+
+    this->doc->lock();
+    const XojPdfDocument& pdf = this->doc->getPdfDocument();
+    if (this->doc->getPdfPageCount() == 0) {
+        cache.reset();
+    } else if (!cache || !(cache->getPdfDocument() == pdf)) {
+        cache = std::make_shared<PdfCache>(pdf, this->settings, this->renderCache.get());
+    }
+    this->doc->unlock();
+
+    std::lock_guard lock(this->pdfCacheMutex);
+    this->pdfCache = std::move(cache);
+}
+
+auto Control::getThumbnailCache() const -> ThumbnailCache* { return this->thumbnailCache.get(); }
+
+auto Control::getAutosaveWriter() const -> AutosaveWriter* { return this->autosaveWriter.get(); }
+
 auto Control::getWindow() const -> MainWindow* { return this->win; }
 
 auto Control::getGtkWindow() const -> GtkWindow* { return GTK_WINDOW(this->win->getWindow()); }
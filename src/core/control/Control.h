@@ -12,7 +12,8 @@
 #pragma once
 
 #include <cstddef>   // for size_t
-#include <memory>    // for unique_ptr
+#include <memory>    // for unique_ptr, shared_ptr
+#include <mutex>     // for mutex
 #include <optional>  // for optional
 #include <string>    // for string, allocator
 #include <vector>    // for vector
@@ -39,6 +40,7 @@
 #include "filesystem.h"        // for path
 
 class LoadHandler;
+class AutosaveWriter;
 class GeometryToolController;
 class AudioController;
 class MotionExportController;
@@ -55,6 +57,9 @@ class PageTypeHandler;
 class BaseExportJob;
 class LayerController;
 class PluginController;
+class PdfCache;
+class RenderCache;
+class ThumbnailCache;
 class Document;
 class EditSelection;
 class Element;
@@ -288,6 +293,28 @@ public:
     void disableSidebarTmp(bool disabled);
 
     XournalScheduler* getScheduler() const;
+    AutosaveWriter* getAutosaveWriter() const;
+    RenderCache* getRenderCache() const;
+
+    /**
+     * The rasterized PDF backgrounds, shared by the main view and the sidebar previews. Thread safe: the jobs keep the
+     * returned cache alive while they use it, even if it is replaced in the meantime.
+     *
+     * @return nullptr if the document has no PDF background
+     */
+    std::shared_ptr<PdfCache> getPdfCache() const;
+
+    /**
+     * Replaces the PDF cache if the PDF background of the document changed. Must be called from the UI thread.
+     */
+    void updatePdfCache();
+
+    /**
+     * The page previews cached on disk, thread safe
+     *
+     * @return nullptr if the cache is disabled
+     */
+    ThumbnailCache* getThumbnailCache() const;
 
     void block(const std::string& name);
     void unblock();
@@ -533,9 +560,23 @@ private:
      */
     guint autosaveTimeout = 0;
     fs::path lastAutosaveFilename;
+    std::unique_ptr<AutosaveWriter> autosaveWriter;
 
     XournalScheduler* scheduler;
 
+    /**
+     * The memory budget of the page buffers, PDF backgrounds and previews, shared by all the views
+     */
+    std::unique_ptr<RenderCache> renderCache;
+
+    /**
+     * See getPdfCache(). Declared after renderCache, with which its entries are registered.
+     */
+    std::shared_ptr<PdfCache> pdfCache;
+    mutable std::mutex pdfCacheMutex;
+
+    std::unique_ptr<ThumbnailCache> thumbnailCache;
+
     /**
      * State / Blocking attributes
      */
@@ -3,7 +3,7 @@
 #include <algorithm>  // for max
 #include <cmath>      // for ceil, abs
 #include <cstdio>     // for size_t
-#include <memory>     // for shared_ptr, __shared_ptr_access
+#include <memory>     // for shared_ptr, make_shared
 #include <string>     // for string
 #include <utility>    // for move
 
@@ -37,17 +37,33 @@ public:
     xoj::view::Mask buffer;
 };
 
-PdfCache::PdfCache(const XojPdfDocument& doc, Settings* settings): pdfDocument(doc) { updateSettings(settings); }
+PdfCache::PdfCache(const XojPdfDocument& doc, Settings* settings, RenderCache* renderCache):
+        pdfDocument(doc), renderCache(renderCache) {
+    updateSettings(settings);
+}
 
-PdfCache::~PdfCache() = default;
+PdfCache::~PdfCache() {
+    if (this->renderCache) {
+        this->renderCache->remove(this);
+    }
+}
 
-void PdfCache::setRefreshThreshold(double threshold) { this->zoomRefreshThreshold = threshold; }
+void PdfCache::setRefreshThreshold(double threshold) {
+    std::lock_guard lock(this->dataMutex);
+    this->zoomRefreshThreshold = threshold;
+}
 
 void PdfCache::setMaxSize(size_t newSize) {
+    std::lock_guard lock(this->dataMutex);
     this->maxSize = newSize;
-    if (this->data.size() > this->maxSize) {
-        this->data.resize(this->maxSize);
-    }
+    truncate(this->maxSize);
+}
+
+auto PdfCache::getPdfDocument() const -> const XojPdfDocument& { return this->pdfDocument; }
+
+auto PdfCache::contains(size_t pdfPageNo) const -> bool {
+    std::lock_guard lock(this->dataMutex);
+    return this->index.count(pdfPageNo) != 0;
 }
 
 void PdfCache::updateSettings(Settings* settings) {
@@ -57,61 +73,162 @@ void PdfCache::updateSettings(Settings* settings) {
     }
 }
 
-auto PdfCache::lookup(size_t pdfPageNo) const -> const PdfCacheEntry* {
-    for (auto& e: this->data) {
-        if (static_cast<size_t>(e->popplerPage->getPageId()) == pdfPageNo) {
-            return e.get();
-        }
+auto PdfCache::evictRenderCache(size_t id) -> bool {
+    // Called with the render cache locked: never wait for our own mutex
+    std::unique_lock lock(this->dataMutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        return false;
     }
-
-    return nullptr;
+    if (auto it = this->index.find(id); it != this->index.end()) {
+        // The threads painting the entry keep it alive
+        this->data.erase(it->second);
+        this->index.erase(it);
+    }
+    return true;
 }
 
-auto PdfCache::cache(XojPdfPageSPtr popplerPage, xoj::view::Mask&& buffer) -> const PdfCacheEntry* {
-    if (this->data.size() > this->maxSize) {
-        this->data.resize(this->maxSize);
+void PdfCache::truncate(size_t size) {
+    while (this->data.size() > size) {
+        size_t pdfPageNo = this->data.back().first;
+        if (this->renderCache) {
+            this->renderCache->remove(this, pdfPageNo);
+        }
+        this->index.erase(pdfPageNo);
+        this->data.pop_back();
     }
+}
 
-    this->data.emplace_front(
-            std::make_unique<PdfCacheEntry>(std::move(popplerPage), std::forward<xoj::view::Mask>(buffer)));
+auto PdfCache::lookup(size_t pdfPageNo) -> std::shared_ptr<const PdfCacheEntry> {
+    auto it = this->index.find(pdfPageNo);
+    if (it == this->index.end()) {
+        return nullptr;
+    }
 
-    return this->data.front().get();
+    this->data.splice(this->data.begin(), this->data, it->second);
+    if (this->renderCache) {
+        this->renderCache->touch(this, pdfPageNo);
+    }
+    return this->data.front().second;
 }
 
-void PdfCache::render(cairo_t* cr, size_t pdfPageNo, double zoom, double pageWidth, double pageHeight) {
-    std::lock_guard<std::mutex> lock(this->renderMutex);
+void PdfCache::cache(size_t pdfPageNo, std::shared_ptr<const PdfCacheEntry> entry) {
+    if (auto it = this->index.find(pdfPageNo); it != this->index.end()) {
+        // The page was rerendered at another zoom
+        this->data.erase(it->second);
+        this->index.erase(it);
+    } else {
+        truncate(std::max<size_t>(this->maxSize, 1) - 1);
+    }
 
-    const PdfCacheEntry* cacheResult = lookup(pdfPageNo);
+    size_t bytes = entry->buffer.getByteSize();
+    this->data.emplace_front(pdfPageNo, std::move(entry));
+    this->index.emplace(pdfPageNo, this->data.begin());
 
-    bool needsRefresh = cacheResult == nullptr;
+    if (this->renderCache) {
+        // Only the images of the other clients may be evicted: we hold our own mutex
+        this->renderCache->update(this, pdfPageNo, RenderCache::PDF_PAGE, bytes);
+    }
+}
 
-    if (!needsRefresh) {
-        double averagedZoom = (zoom + cacheResult->buffer.getZoom()) / 2.0;
-        double percentZoomChange = std::abs(cacheResult->buffer.getZoom() - zoom) * 100.0 / averagedZoom;
+auto PdfCache::isUpToDate(const PdfCacheEntry& entry, double zoom) const -> bool {
+    double averagedZoom = (zoom + entry.buffer.getZoom()) / 2.0;
+    double percentZoomChange = std::abs(entry.buffer.getZoom() - zoom) * 100.0 / averagedZoom;
 
-        // If we do have a cached result, is its rendering quality
-        // acceptable for our current zoom?
-        needsRefresh = (zoom > 1.0 && percentZoomChange > this->zoomRefreshThreshold);
+    // If we do have a cached result, is its rendering quality
+    // acceptable for our current zoom?
+    return zoom <= 1.0 || percentZoomChange <= this->zoomRefreshThreshold;
+}
+
+auto PdfCache::fetch(size_t pdfPageNo, double zoom, const BufferFactory& createBuffer)
+        -> std::shared_ptr<const PdfCacheEntry> {
+    XojPdfPageSPtr popplerPage;
+    {
+        std::unique_lock lock(this->dataMutex);
+        // Wait for the rendering of the page by another thread rather than rasterizing it twice
+        this->renderingDone.wait(lock, [&]() { return this->rendering.count(pdfPageNo) == 0; });
+
+        auto cached = lookup(pdfPageNo);
+        if (cached && isUpToDate(*cached, zoom)) {
+            return cached;
+        }
+        if (cached) {
+            popplerPage = cached->popplerPage;
+        }
+        this->rendering.insert(pdfPageNo);
     }
 
-    if (needsRefresh) {
+    // Rasterize without the lock, so that the cached pages are painted in the meantime
+    std::shared_ptr<const PdfCacheEntry> entry;
+    if (!popplerPage) {
+        popplerPage = pdfDocument.getPage(pdfPageNo);
+    }
+    if (popplerPage) {
         double renderZoom = std::max(zoom, 1.0);
+        auto buffer = createBuffer(Range(0, 0, popplerPage->getWidth(), popplerPage->getHeight()), renderZoom);
+        popplerPage->render(buffer.get());
+        entry = std::make_shared<PdfCacheEntry>(std::move(popplerPage), std::move(buffer));
+    }
+
+    std::lock_guard lock(this->dataMutex);
+    this->rendering.erase(pdfPageNo);
+    this->renderingDone.notify_all();
+    if (entry) {
+        cache(pdfPageNo, entry);
+    }
+    return entry;
+}
 
-        auto popplerPage = cacheResult ? cacheResult->popplerPage : pdfDocument.getPage(pdfPageNo);
+void PdfCache::render(cairo_t* cr, size_t pdfPageNo, double zoom, double pageWidth, double pageHeight,
+                      xoj::view::PdfCacheTreatment treatment) {
+    if (treatment == xoj::view::REUSE_CACHED_PDF_ONLY) {
+        std::shared_ptr<const PdfCacheEntry> cached;
+        {
+            std::lock_guard lock(this->dataMutex);
+            // No lookup(): the entry must not become the most recently used one
+            if (auto it = this->index.find(pdfPageNo); it != this->index.end()) {
+                const auto& entry = it->second->second;
+                if (isUpToDate(*entry, zoom)) {
+                    cached = entry;
+                }
+            }
+        }
+        if (cached) {
+            cached->buffer.paintTo(cr);
+            return;
+        }
 
+        XojPdfPageSPtr popplerPage = pdfDocument.getPage(pdfPageNo);
         if (!popplerPage) {
             g_warning("PdfCache::render Could not get the pdf page %zu from the document", pdfPageNo);
             renderMissingPdfPage(cr, pageWidth, pageHeight);
             return;
         }
+        cairo_save(cr);
+        cairo_rectangle(cr, 0, 0, popplerPage->getWidth(), popplerPage->getHeight());
+        cairo_clip(cr);
+        popplerPage->render(cr);
+        cairo_restore(cr);
+        return;
+    }
 
-        xoj::view::Mask buffer(cairo_get_target(cr), Range(0, 0, popplerPage->getWidth(), popplerPage->getHeight()),
-                               renderZoom, CAIRO_CONTENT_COLOR_ALPHA);
-        popplerPage->render(buffer.get());
-        cacheResult = cache(popplerPage, std::move(buffer));
+    cairo_surface_t* target = cairo_get_target(cr);
+    auto entry = fetch(pdfPageNo, zoom, [target](const Range& extent, double renderZoom) {
+        return xoj::view::Mask(target, extent, renderZoom, CAIRO_CONTENT_COLOR_ALPHA);
+    });
+
+    if (!entry) {
+        g_warning("PdfCache::render Could not get the pdf page %zu from the document", pdfPageNo);
+        renderMissingPdfPage(cr, pageWidth, pageHeight);
+        return;
     }
 
-    cacheResult->buffer.paintTo(cr);
+    entry->buffer.paintTo(cr);
+}
+
+void PdfCache::prefetch(size_t pdfPageNo, double zoom, int DPIScaling) {
+    fetch(pdfPageNo, zoom, [DPIScaling](const Range& extent, double renderZoom) {
+        return xoj::view::Mask(DPIScaling, extent, renderZoom, CAIRO_CONTENT_COLOR_ALPHA);
+    });
 }
 
 void PdfCache::renderMissingPdfPage(cairo_t* cr, double pageWidth, double pageHeight) {
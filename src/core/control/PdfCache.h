@@ -11,26 +11,47 @@
 
 #pragma once
 
-#include <cstddef>  // for size_t
-#include <deque>    // for deque
-#include <mutex>    // for mutex
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <functional>          // for function
+#include <list>                // for list
+#include <memory>              // for shared_ptr
+#include <mutex>               // for mutex
+#include <unordered_map>       // for unordered_map
+#include <unordered_set>       // for unordered_set
 
 #include <cairo.h>  // for cairo_t, cairo_surface_t
 
-#include "pdf/base/XojPdfDocument.h"  // for XojPdfDocument
-#include "pdf/base/XojPdfPage.h"      // for XojPdfPageSPtr
+#include "control/RenderCache.h"              // for RenderCache
+#include "pdf/base/XojPdfDocument.h"          // for XojPdfDocument
+#include "pdf/base/XojPdfPage.h"              // for XojPdfPageSPtr
+#include "view/background/BackgroundFlags.h"  // for PdfCacheTreatment
 
 namespace xoj::view {
 class Mask;
 };
 
 class PdfCacheEntry;
+class Range;
 class Settings;
 
-class PdfCache {
+/**
+ * @brief Thread safe cache of the rasterized PDF pages
+ *
+ * The cache is only locked to look up and insert entries, so the cached pages are painted while other pages are
+ * rasterized. Poppler itself renders one page at a time (see PopplerGlibDocument::getPopplerMutex()). A page requested
+ * while another thread rasterizes it waits for that rendering instead of doing it again.
+ *
+ * The main view and the sidebar share the cache. The sidebar previews only reuse the cached renderings (see
+ * xoj::view::REUSE_CACHED_PDF_ONLY), so that the thumbnails never evict the pages of the main view.
+ */
+class PdfCache: public RenderCache::Client {
 public:
-    PdfCache(const XojPdfDocument& doc, Settings* settings);
-    virtual ~PdfCache();
+    /**
+     * @param renderCache The memory budget shared with the other rendered images, may be nullptr
+     */
+    PdfCache(const XojPdfDocument& doc, Settings* settings, RenderCache* renderCache);
+    ~PdfCache() override;
 
 private:
     PdfCache(const PdfCache& cache);
@@ -43,8 +64,19 @@ public:
      * @param pdfPageNo The page number (in the pdf document)
      * @param zoom The current zoom level
      * @param pageWidth/pageHeight Xournal++ page dimensions
+     * @param treatment With REUSE_CACHED_PDF_ONLY, a page which is not cached is rendered directly to cr: the cache is
+     * neither filled nor reordered
      */
-    void render(cairo_t* cr, size_t pdfPageNo, double zoom, double pageWidth, double pageHeight);
+    void render(cairo_t* cr, size_t pdfPageNo, double zoom, double pageWidth, double pageHeight,
+                xoj::view::PdfCacheTreatment treatment = xoj::view::CACHE_PDF_RENDERING);
+
+    /**
+     * @brief Rasterize the page in advance, unless it is already cached at a close enough zoom
+     * @param pdfPageNo The page number (in the pdf document)
+     * @param zoom The zoom the page will be rendered at, in pixels per page unit (as for render())
+     * @param DPIScaling The DPI scaling of the surfaces the page will be painted on
+     */
+    void prefetch(size_t pdfPageNo, double zoom, int DPIScaling);
 
 public:
     /**
@@ -60,28 +92,76 @@ public:
 
     void updateSettings(Settings* settings);
 
+    const XojPdfDocument& getPdfDocument() const;
+
+    /**
+     * @return If a rendering of the page is cached
+     * @param pdfPageNo The page number (in the pdf document)
+     */
+    bool contains(size_t pdfPageNo) const;
+
+    /**
+     * @brief Drop the rendering of a page, see RenderCache
+     * @param id The page number (in the pdf document)
+     */
+    bool evictRenderCache(size_t id) override;
+
     /**
      * @brief Renders an error background, for when the pdf page cannot be rendered
      */
     static void renderMissingPdfPage(cairo_t* cr, double pageWidth, double pageHeight);
 
 private:
+    using BufferFactory = std::function<xoj::view::Mask(const Range& extent, double zoom)>;
+
+    /**
+     * @brief Get the rendering of the page, rasterizing it if it is missing or if its zoom is too far from the given
+     * one
+     * @param createBuffer Creates the surface the page is rasterized on
+     * @return nullptr if the page cannot be found in the pdf document
+     */
+    std::shared_ptr<const PdfCacheEntry> fetch(size_t pdfPageNo, double zoom, const BufferFactory& createBuffer);
+
     /**
-     * @brief Look up for a cache entry for the page with number pdfPgeNo in the PDF.
+     * @brief Look up for a cache entry for the page with number pdfPgeNo in the PDF. The entry found becomes the most
+     * recently used one. The data mutex has to be locked.
      */
-    const PdfCacheEntry* lookup(size_t pdfPageNo) const;
+    std::shared_ptr<const PdfCacheEntry> lookup(size_t pdfPageNo);
+
     /**
-     * @brief Push a cache entry
+     * @brief Push a cache entry, replacing the previous rendering of the page. The data mutex has to be locked.
      */
-    const PdfCacheEntry* cache(XojPdfPageSPtr popplerPage, xoj::view::Mask&& buffer);
+    void cache(size_t pdfPageNo, std::shared_ptr<const PdfCacheEntry> entry);
+
+    /**
+     * @brief Drop the least recently used entries, until there are at most `size` entries. The data mutex has to be
+     * locked.
+     */
+    void truncate(size_t size);
+
+    /**
+     * @return If the entry was rendered at a zoom close enough to the given one. The data mutex has to be locked.
+     */
+    bool isUpToDate(const PdfCacheEntry& entry, double zoom) const;
 
 private:
     XojPdfDocument pdfDocument;
+    RenderCache* renderCache;
+
+    /// Protects all the members below. Never held while rasterizing.
+    mutable std::mutex dataMutex;
+
+    /// The pages being rasterized
+    std::unordered_set<size_t> rendering;
+    std::condition_variable renderingDone;
 
-    std::mutex renderMutex;
+    /// The entries are shared with the threads painting them, so they can be dropped at any time
+    using EntryList = std::list<std::pair<size_t, std::shared_ptr<const PdfCacheEntry>>>;
 
-    std::deque<std::unique_ptr<PdfCacheEntry>> data;
-    decltype(data)::size_type maxSize = 0;
+    /// From the most to the least recently used
+    EntryList data;
+    std::unordered_map<size_t, EntryList::iterator> index;
+    size_t maxSize = 0;
 
-    double zoomRefreshThreshold;
+    double zoomRefreshThreshold{};
 };
@@ -0,0 +1,103 @@
+#include "RenderCache.h"
+
+#include <iterator>  // for prev
+
+#include <glib.h>  // for g_debug
+
+RenderCache::RenderCache(size_t budget): budget(budget) {}
+
+void RenderCache::setBudget(size_t budget) {
+    std::lock_guard lock(this->mutex);
+    this->budget = budget;
+    evictUnlocked(nullptr);
+}
+
+auto RenderCache::getBudget() const -> size_t {
+    std::lock_guard lock(this->mutex);
+    return this->budget;
+}
+
+void RenderCache::update(Client* client, size_t id, Kind kind, size_t bytes) {
+    std::lock_guard lock(this->mutex);
+    Key key{client, id};
+    if (auto it = this->entries.find(key); it != this->entries.end()) {
+        Entry& e = *it->second;
+        this->used -= e.bytes;
+        this->usedByKind[e.kind] -= e.bytes;
+        this->lru.erase(it->second);
+        this->entries.erase(it);
+    }
+    if (bytes == 0) {
+        return;
+    }
+
+    this->lru.push_back({key, kind, bytes});
+    this->entries.emplace(key, std::prev(this->lru.end()));
+    this->used += bytes;
+    this->usedByKind[kind] += bytes;
+
+    evictUnlocked(client);
+}
+
+void RenderCache::touch(Client* client, size_t id) {
+    std::lock_guard lock(this->mutex);
+    if (auto it = this->entries.find({client, id}); it != this->entries.end()) {
+        this->lru.splice(this->lru.end(), this->lru, it->second);
+    }
+}
+
+void RenderCache::remove(Client* client, size_t id) { update(client, id, PAGE_BUFFER, 0); }
+
+void RenderCache::remove(Client* client) {
+    std::lock_guard lock(this->mutex);
+    auto it = this->entries.lower_bound({client, 0});
+    while (it != this->entries.end() && it->first.first == client) {
+        Entry& e = *it->second;
+        this->used -= e.bytes;
+        this->usedByKind[e.kind] -= e.bytes;
+        this->lru.erase(it->second);
+        it = this->entries.erase(it);
+    }
+}
+
+auto RenderCache::getStats() const -> Stats {
+    std::lock_guard lock(this->mutex);
+    return {this->budget, this->used, this->usedByKind, this->lru.size(), this->evictions};
+}
+
+auto RenderCache::getSurfaceSize(cairo_surface_t* surface) -> size_t {
+    if (!surface || cairo_surface_get_type(surface) != CAIRO_SURFACE_TYPE_IMAGE) {
+        return 0;
+    }
+    return static_cast<size_t>(cairo_image_surface_get_stride(surface)) *
+           static_cast<size_t>(cairo_image_surface_get_height(surface));
+}
+
+void RenderCache::evictUnlocked(Client* keep) {
+    size_t evicted = 0;
+    // Each image is visited at most once: those which cannot be evicted are moved to the end
+    size_t remaining = this->lru.size();
+    for (auto it = this->lru.begin(); this->used > this->budget && remaining > 0 && it != this->lru.end(); remaining--) {
+        auto current = it++;
+        if (current->key.first == keep) {
+            // The client which is updating may hold its own lock
+            continue;
+        }
+        if (current->key.first->evictRenderCache(current->key.second)) {
+            this->used -= current->bytes;
+            this->usedByKind[current->kind] -= current->bytes;
+            this->entries.erase(current->key);
+            this->lru.erase(current);
+            evicted++;
+        } else {
+            this->lru.splice(this->lru.end(), this->lru, current);
+        }
+    }
+
+    if (evicted > 0) {
+        this->evictions += evicted;
+        g_debug("RenderCache: evicted %zu images, %zu / %zu KiB used (pages %zu, PDF %zu, previews %zu KiB)", evicted,
+                this->used / 1024, this->budget / 1024, this->usedByKind[PAGE_BUFFER] / 1024,
+                this->usedByKind[PDF_PAGE] / 1024, this->usedByKind[PREVIEW] / 1024);
+    }
+}
@@ -0,0 +1,121 @@
+/*
+ * Xournal++
+ *
+ * Memory budget of the rendered images kept for repainting
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <array>    // for array
+#include <cstddef>  // for size_t
+#include <list>     // for list
+#include <map>      // for map
+#include <mutex>    // for mutex
+#include <utility>  // for pair
+
+#include <cairo.h>  // for cairo_surface_t
+
+/**
+ * @brief Least recently used cache of the rendered images: the buffers of the page views, the PDF pages rasterized by
+ * the PdfCaches and the sidebar previews share a single memory budget.
+ *
+ * The images stay owned by their clients, which report the memory they use for each image with update(). When the
+ * total exceeds the budget, the least recently used images are evicted: their client is asked to free them.
+ *
+ * Locking: the clients are called back while the cache is locked, so they must only try_lock their own mutex in
+ * evictRenderCache(). This way, the clients may call the cache with their own mutex held.
+ */
+class RenderCache {
+public:
+    enum Kind { PAGE_BUFFER, PDF_PAGE, PREVIEW, KIND_COUNT };
+
+    class Client {
+    public:
+        virtual ~Client() = default;
+
+        /**
+         * Free an image. Called from any thread, with the cache locked: it must not call the cache.
+         *
+         * @param id The id of the image given to update()
+         * @return false if the image cannot be freed now, e.g. it is displayed or the client is busy
+         */
+        virtual bool evictRenderCache(size_t id) = 0;
+    };
+
+    struct Stats {
+        size_t budget;
+        size_t used;
+        std::array<size_t, KIND_COUNT> usedByKind;
+        size_t images;
+        size_t evictions;
+    };
+
+    /**
+     * @param budget The memory budget in bytes
+     */
+    explicit RenderCache(size_t budget);
+    RenderCache(const RenderCache&) = delete;
+    RenderCache& operator=(const RenderCache&) = delete;
+
+public:
+    void setBudget(size_t budget);
+    size_t getBudget() const;
+
+    /**
+     * Sets the memory used by an image and marks it as the most recently used one. Images of other clients are evicted
+     * if the budget is exceeded.
+     */
+    void update(Client* client, size_t id, Kind kind, size_t bytes);
+
+    /**
+     * Marks an image as the most recently used one, if it is in the cache
+     */
+    void touch(Client* client, size_t id);
+
+    /**
+     * Forgets an image freed by its client
+     */
+    void remove(Client* client, size_t id);
+
+    /**
+     * Forgets all the images of a client, to be called by the client before it is deleted
+     */
+    void remove(Client* client);
+
+    Stats getStats() const;
+
+    /**
+     * @return The memory used by the pixels of an image surface, 0 for other surfaces
+     */
+    static size_t getSurfaceSize(cairo_surface_t* surface);
+
+private:
+    /**
+     * Evicts the least recently used images until the budget is met, the mutex has to be locked
+     */
+    void evictUnlocked(Client* keep);
+
+    using Key = std::pair<Client*, size_t>;
+
+    struct Entry {
+        Key key;
+        Kind kind;
+        size_t bytes;
+    };
+
+    /// From the least to the most recently used
+    std::list<Entry> lru;
+    std::map<Key, std::list<Entry>::iterator> entries;
+
+    size_t budget;
+    size_t used = 0;
+    std::array<size_t, KIND_COUNT> usedByKind{};
+    size_t evictions = 0;
+
+    mutable std::mutex mutex;
+};
@@ -0,0 +1,214 @@
+#include "SearchIndex.h"
+
+#include <algorithm>  // for lower_bound, min_element, set_intersection, sort, stable_sort, unique, upper_bound
+#include <iterator>   // for back_inserter, prev
+#include <utility>    // for move
+
+#include "control/Control.h"                // for Control
+#include "control/jobs/SearchIndexJob.h"    // for SearchIndexJob
+#include "control/jobs/XournalScheduler.h"  // for XournalScheduler
+#include "model/Document.h"                 // for Document
+#include "model/Element.h"                  // for ELEMENT_TEXT
+#include "model/Layer.h"                    // for Layer
+#include "model/Text.h"                     // for Text
+#include "model/XojPage.h"                  // for XojPage
+#include "util/StringUtils.h"               // for StringUtils
+#include "util/Util.h"                      // for npos
+
+auto SearchIndexData::trigram(std::string_view s, size_t pos) -> uint32_t {
+    return (static_cast<uint32_t>(static_cast<unsigned char>(s[pos])) << 16U) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(s[pos + 1])) << 8U) |
+           static_cast<uint32_t>(static_cast<unsigned char>(s[pos + 2]));
+}
+
+auto SearchIndexData::getTrigrams(std::string_view text) -> std::vector<uint32_t> {
+    std::vector<uint32_t> trigrams;
+    if (text.size() >= 3) {
+        trigrams.reserve(text.size() - 2);
+        for (size_t pos = 0; pos + 3 <= text.size(); pos++) {
+            trigrams.push_back(trigram(text, pos));
+        }
+        std::sort(trigrams.begin(), trigrams.end());
+        trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    }
+    return trigrams;
+}
+
+void SearchIndexData::addPdfPage(size_t pdfPageNo, std::string text, const std::vector<uint32_t>& trigrams) {
+    if (pdfPageNo >= this->pdfText.size()) {
+        this->pdfText.resize(pdfPageNo + 1);
+    }
+    this->pdfText[pdfPageNo] = std::move(text);
+    for (uint32_t t: trigrams) {
+        // The pages are indexed in increasing order: the lists stay sorted
+        this->pdfTrigrams[t].push_back(static_cast<uint32_t>(pdfPageNo));
+    }
+}
+
+auto SearchIndexData::findPdfCandidates(std::string_view pattern) const -> std::vector<bool> {
+    const size_t pageCount = this->pdfText.size();
+    if (pattern.size() < 3) {
+        return std::vector<bool>(pageCount, true);
+    }
+
+    std::vector<const std::vector<uint32_t>*> lists;
+    for (size_t pos = 0; pos + 3 <= pattern.size(); pos++) {
+        auto it = this->pdfTrigrams.find(SearchIndexData::trigram(pattern, pos));
+        if (it == this->pdfTrigrams.end()) {
+            return std::vector<bool>(pageCount, false);
+        }
+        lists.push_back(&it->second);
+    }
+
+    // Intersect the page lists, starting from the shortest one
+    auto shortest =
+            std::min_element(lists.begin(), lists.end(), [](auto* a, auto* b) { return a->size() < b->size(); });
+    std::vector<uint32_t> pages = **shortest;
+    for (const auto* list: lists) {
+        if (list == *shortest) {
+            continue;
+        }
+        std::vector<uint32_t> kept;
+        std::set_intersection(pages.begin(), pages.end(), list->begin(), list->end(), std::back_inserter(kept));
+        pages = std::move(kept);
+    }
+
+    std::vector<bool> candidates(pageCount, false);
+    for (uint32_t p: pages) {
+        candidates[p] = true;
+    }
+    return candidates;
+}
+
+SearchIndex::SearchIndex(Control* control): control(control) { registerListener(control); }
+
+SearchIndex::~SearchIndex() { invalidate(); }
+
+void SearchIndex::build() {
+    if (this->data) {
+        return;
+    }
+    this->data = std::make_shared<SearchIndexData>();
+
+    Document* doc = this->control->getDocument();
+    std::vector<SearchIndexJob::LazyPage> lazyPages;
+    doc->lock();
+    for (size_t i = 0; i < doc->getPageCount(); i++) {
+        PageRef page = doc->getPage(i);
+        if (!page->isContentLoaded()) {
+            lazyPages.emplace_back(page, page->getLazyContent());
+        }
+    }
+    XojPdfDocument pdf = doc->getPdfDocument();
+    doc->unlock();
+
+    this->control->getScheduler()->addBuildSearchIndex(this->data, pdf, std::move(lazyPages));
+}
+
+void SearchIndex::invalidate() {
+    if (!this->data) {
+        return;
+    }
+    this->data->cancelled = true;
+    this->control->getScheduler()->removeSearchIndex(this->data.get());
+    this->data.reset();
+}
+
+void SearchIndex::stopBuilding() {
+    if (!isReady()) {
+        invalidate();
+    }
+}
+
+auto SearchIndex::isReady() const -> bool {
+    if (!this->data) {
+        return false;
+    }
+    std::lock_guard lock(this->data->mutex);
+    return this->data->complete;
+}
+
+void SearchIndex::documentChanged(DocumentChangeType type) {
+    if (type == DOCUMENT_CHANGE_CLEARED || type == DOCUMENT_CHANGE_COMPLETE) {
+        // The PDF may have changed: index it again on the next search
+        invalidate();
+    }
+}
+
+auto SearchIndex::countOccurrences(std::string_view text, std::string_view pattern) -> size_t {
+    size_t count = 0;
+    for (size_t pos = text.find(pattern); pos != std::string_view::npos; pos = text.find(pattern, pos + 1)) {
+        count++;
+    }
+    return count;
+}
+
+auto SearchIndex::countInTextElements(const PageRef& page, std::string_view pattern) const -> size_t {
+    if (!page->isContentLoaded()) {
+        auto it = this->data->typedText.find(page);
+        if (it != this->data->typedText.end()) {
+            size_t count = 0;
+            for (const std::string& text: it->second) {
+                count += countOccurrences(text, pattern);
+            }
+            return count;
+        }
+    }
+
+    // The page may have been edited: read its Text elements, as SearchControl does
+    size_t count = 0;
+    for (const Layer* l: page->getLayersView()) {
+        if (!l->isVisible()) {
+            continue;
+        }
+        for (const Element* e: l->getElementsView()) {
+            if (e->getType() == ELEMENT_TEXT) {
+                count += countOccurrences(StringUtils::toLowerCase(static_cast<const Text*>(e)->getText()), pattern);
+            }
+        }
+    }
+    return count;
+}
+
+auto SearchIndex::search(const std::string& text) const -> std::vector<PageHit> {
+    std::vector<PageHit> hits;
+    if (text.empty() || !this->data) {
+        return hits;
+    }
+    const std::string pattern = StringUtils::toLowerCase(text);
+
+    std::lock_guard lock(this->data->mutex);
+    std::vector<bool> candidates = this->data->findPdfCandidates(pattern);
+
+    Document* doc = this->control->getDocument();
+    for (size_t i = 0; i < doc->getPageCount(); i++) {
+        PageRef page = doc->getPage(i);
+        size_t occurrences = 0;
+
+        size_t pdfPageNo = page->getPdfPageNr();
+        if (pdfPageNo != npos && pdfPageNo < candidates.size() && candidates[pdfPageNo]) {
+            occurrences += countOccurrences(this->data->pdfText[pdfPageNo], pattern);
+        }
+        occurrences += countInTextElements(page, pattern);
+
+        if (occurrences > 0) {
+            hits.push_back({i, occurrences});
+        }
+    }
+    return hits;
+}
+
+void SearchIndex::rank(std::vector<PageHit>& hits) {
+    std::stable_sort(hits.begin(), hits.end(),
+                     [](const PageHit& a, const PageHit& b) { return a.occurrences > b.occurrences; });
+}
+
+auto SearchIndex::nextPage(const std::vector<size_t>& pages, size_t page) -> size_t {
+    auto it = std::upper_bound(pages.begin(), pages.end(), page);
+    return it == pages.end() ? pages.front() : *it;
+}
+
+auto SearchIndex::previousPage(const std::vector<size_t>& pages, size_t page) -> size_t {
+    auto it = std::lower_bound(pages.begin(), pages.end(), page);
+    return it == pages.begin() ? pages.back() : *std::prev(it);
+}
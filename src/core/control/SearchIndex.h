@@ -0,0 +1,148 @@
+/*
+ * Xournal++
+ *
+ * Document wide index of the PDF text and the text elements
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <atomic>         // for atomic_bool
+#include <cstddef>        // for size_t
+#include <cstdint>        // for uint32_t
+#include <map>            // for map
+#include <memory>         // for shared_ptr, weak_ptr, owner_less
+#include <mutex>          // for mutex
+#include <string>         // for string
+#include <string_view>    // for string_view
+#include <unordered_map>  // for unordered_map
+#include <vector>         // for vector
+
+#include "model/DocumentListener.h"  // for DocumentListener
+#include "model/PageRef.h"           // for PageRef
+
+class Control;
+class XojPage;
+
+/**
+ * @brief The text extracted by a SearchIndexJob, shared with the job
+ */
+class SearchIndexData {
+public:
+    /// Set when the index is dropped, to stop the job
+    std::atomic_bool cancelled = false;
+
+    /// Guards the members below
+    std::mutex mutex;
+
+    /// The lowercase text of each page of the PDF
+    std::vector<std::string> pdfText;
+
+    /// For each trigram (3 consecutive bytes) of the PDF text, the PDF pages containing it, in increasing order
+    std::unordered_map<uint32_t, std::vector<uint32_t>> pdfTrigrams;
+
+    /// The lowercase content of the Text elements on the visible layers of the pages which were not loaded
+    std::map<std::weak_ptr<XojPage>, std::vector<std::string>, std::owner_less<>> typedText;
+
+    /// Set by the job once all the pages are indexed
+    bool complete = false;
+
+    static uint32_t trigram(std::string_view s, size_t pos);
+
+    /**
+     * @return The trigrams of text, sorted and without duplicates
+     */
+    static std::vector<uint32_t> getTrigrams(std::string_view text);
+
+    /**
+     * Adds the lowercase text of a PDF page and its trigrams (see getTrigrams()) to the index. The pages must be added
+     * in increasing order. mutex must be locked.
+     */
+    void addPdfPage(size_t pdfPageNo, std::string text, const std::vector<uint32_t>& trigrams);
+
+    /**
+     * @return For each PDF page, if it may contain the lowercase pattern. mutex must be locked.
+     */
+    std::vector<bool> findPdfCandidates(std::string_view pattern) const;
+};
+
+/**
+ * @brief Finds the pages of the document containing a text, without searching the pages one by one
+ *
+ * The text of the PDF never changes: it is extracted once in the background and indexed by trigrams. The Text
+ * elements may be edited: they are read from the pages when they are loaded, so that the index is always up to date.
+ * The pages not loaded yet have not been modified: their Text elements are extracted in the background too.
+ */
+class SearchIndex: public DocumentListener {
+public:
+    struct PageHit {
+        size_t page;
+        /// Number of matches on the page, which may slightly differ from the matches highlighted by SearchControl
+        size_t occurrences;
+    };
+
+    explicit SearchIndex(Control* control);
+    ~SearchIndex() override;
+
+    /**
+     * Starts indexing the document in the background, unless it is already indexed or being indexed
+     */
+    void build();
+
+    /**
+     * Stops indexing the document if it is not indexed yet. The next build() starts over.
+     */
+    void stopBuilding();
+
+    /**
+     * @return If the document has been indexed, see search()
+     */
+    bool isReady() const;
+
+    /**
+     * Searches the index, the PDF pages are not searched again. Only call this once isReady().
+     * @return The pages containing the text (ignoring the case), in document order
+     */
+    std::vector<PageHit> search(const std::string& text) const;
+
+    /**
+     * Sorts the hits by decreasing number of occurrences, the first pages first in case of a tie
+     */
+    static void rank(std::vector<PageHit>& hits);
+
+    /**
+     * Counts the (possibly overlapping) occurrences of pattern in text
+     */
+    static size_t countOccurrences(std::string_view text, std::string_view pattern);
+
+    /**
+     * @return The first page of pages after page, wrapping around. pages must be sorted and not empty.
+     */
+    static size_t nextPage(const std::vector<size_t>& pages, size_t page);
+
+    /**
+     * @return The last page of pages before page, wrapping around. pages must be sorted and not empty.
+     */
+    static size_t previousPage(const std::vector<size_t>& pages, size_t page);
+
+public:
+    // DocumentListener interface
+    void documentChanged(DocumentChangeType type) override;
+
+private:
+    /**
+     * Drops the index and stops the job filling it
+     */
+    void invalidate();
+
+    size_t countInTextElements(const PageRef& page, std::string_view pattern) const;
+
+private:
+    Control* control;
+
+    std::shared_ptr<SearchIndexData> data;
+};
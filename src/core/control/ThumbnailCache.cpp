@@ -0,0 +1,190 @@
+#include "ThumbnailCache.h"
+
+#include <algorithm>     // for sort
+#include <cstdint>       // for uint32_t, uintmax_t
+#include <functional>    // for hash
+#include <mutex>         // for lock_guard
+#include <string>        // for string, to_string
+#include <system_error>  // for error_code
+#include <thread>        // for this_thread
+#include <tuple>         // for tuple
+#include <utility>       // for move
+#include <vector>        // for vector
+
+#include <gdk-pixbuf/gdk-pixbuf.h>  // for gdk_pixbuf_read_pixels
+#include <glib.h>                   // for GChecksum, g_warning
+
+#include "model/BackgroundImage.h"                // for BackgroundImage
+#include "model/Element.h"                        // for Element
+#include "model/Layer.h"                          // for Layer
+#include "model/PageType.h"                       // for PageType
+#include "model/XojPage.h"                        // for XojPage
+#include "util/StringUtils.h"                     // for char_cast
+#include "util/serializing/BinObjectEncoding.h"   // for BinObjectEncoding
+#include "util/serializing/ObjectOutputStream.h"  // for ObjectOutputStream
+
+/// Changed when the way the previews are drawn changes, to ignore the previews cached by previous versions
+static constexpr int PREVIEW_FORMAT_VERSION = 1;
+
+/// The number of page hashes above which the hashes of the pages which are not rendered anymore are forgotten
+static constexpr size_t MAX_PAGE_HASHES = 4096;
+
+ThumbnailCache::ThumbnailCache(fs::path folder, size_t maxSize): folder(std::move(folder)), maxSize(maxSize) {}
+
+auto ThumbnailCache::getKey(const XojPage& page, const fs::path& pdfFile, int width, int height, int DPIScaling) const
+        -> std::string {
+    uint64_t revision = page.getRevision();
+    std::string hash;
+    {
+        std::lock_guard lock(this->pageHashesMutex);
+        if (auto it = this->pageHashes.find(&page); it != this->pageHashes.end() && it->second.revision == revision) {
+            hash = it->second.hash;
+        }
+    }
+    if (hash.empty()) {
+        hash = hashPage(page, pdfFile);
+        std::lock_guard lock(this->pageHashesMutex);
+        if (this->pageHashes.size() >= MAX_PAGE_HASHES) {
+            this->pageHashes.clear();
+        }
+        this->pageHashes[&page] = {revision, hash};
+    }
+    return hash + "-" + std::to_string(PREVIEW_FORMAT_VERSION) + "-" + std::to_string(width) + "x" +
+           std::to_string(height) + "@" + std::to_string(DPIScaling);
+}
+
+auto ThumbnailCache::hashPage(const XojPage& page, const fs::path& pdfFile) -> std::string {
+    ObjectOutputStream out(new BinObjectEncoding());
+    out.writeObject("Preview");
+    out.writeDouble(page.getWidth());
+    out.writeDouble(page.getHeight());
+    PageType bg = page.getBackgroundType();
+    out.writeInt(static_cast<int>(bg.format));
+    out.writeString(bg.config);
+    out.writeUInt(uint32_t(page.getBackgroundColor()));
+
+    if (bg.isPdfPage()) {
+        out.writeSizeT(page.getPdfPageNr());
+        out.writeString(char_cast(pdfFile.u8string()));
+        std::error_code ec;
+        auto modified = fs::last_write_time(pdfFile, ec);
+        out.writeSizeT(ec ? 0 : static_cast<size_t>(modified.time_since_epoch().count()));
+    } else if (bg.isImagePage()) {
+        const BackgroundImage& img = page.getBackgroundImage();
+        out.writeString(char_cast(img.getFilepath().u8string()));
+        if (const GdkPixbuf* pixbuf = img.getPixbuf()) {
+            out.writeInt(gdk_pixbuf_get_width(pixbuf));
+            out.writeInt(gdk_pixbuf_get_height(pixbuf));
+            // Only an image without file has to be identified by its pixels
+            if (img.getFilepath().empty()) {
+                out.writeData(gdk_pixbuf_read_pixels(pixbuf), gdk_pixbuf_get_byte_length(pixbuf), 1);
+            }
+        }
+    }
+
+    for (const Layer* layer: page.getLayersView()) {
+        out.writeBool(layer->isVisible());
+        if (layer->isVisible()) {
+            for (const Element* e: layer->getElementsView()) {
+                e->serialize(out);
+            }
+        }
+    }
+    out.endObject();
+
+    GString* data = out.stealData();
+    gchar* hash = g_compute_checksum_for_data(G_CHECKSUM_SHA256, reinterpret_cast<const guchar*>(data->str), data->len);
+    std::string key(hash);
+    g_free(hash);
+    g_string_free(data, true);
+    return key;
+}
+
+auto ThumbnailCache::getFile(const std::string& key) const -> fs::path { return this->folder / (key + ".png"); }
+
+auto ThumbnailCache::load(const std::string& key, int width, int height, int DPIScaling) const
+        -> xoj::util::CairoSurfaceSPtr {
+    fs::path file = getFile(key);
+    std::error_code ec;
+    if (!fs::exists(file, ec)) {
+        return nullptr;
+    }
+
+    xoj::util::CairoSurfaceSPtr surface(cairo_image_surface_create_from_png(char_cast(file.u8string().c_str())),
+                                        xoj::util::adopt);
+    if (cairo_surface_status(surface.get()) != CAIRO_STATUS_SUCCESS ||
+        cairo_image_surface_get_width(surface.get()) != width * DPIScaling ||
+        cairo_image_surface_get_height(surface.get()) != height * DPIScaling) {
+        return nullptr;
+    }
+    cairo_surface_set_device_scale(surface.get(), DPIScaling, DPIScaling);
+
+    // The modification time orders the previews for prune()
+    fs::last_write_time(file, fs::file_time_type::clock::now(), ec);
+    return surface;
+}
+
+void ThumbnailCache::store(const std::string& key, cairo_surface_t* surface) const {
+    fs::path file = getFile(key);
+    std::error_code ec;
+    if (fs::exists(file, ec)) {
+        // Already written by another job or instance
+        return;
+    }
+
+    // Written under a temporary name, so that another thread or instance never reads a partial file
+    fs::path tmpFile = file;
+    tmpFile += "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+
+    if (cairo_surface_write_to_png(surface, char_cast(tmpFile.u8string().c_str())) != CAIRO_STATUS_SUCCESS) {
+        g_warning("ThumbnailCache: could not write %s", char_cast(tmpFile.u8string().c_str()));
+        return;
+    }
+    fs::rename(tmpFile, file, ec);
+    if (ec) {
+        g_warning("ThumbnailCache: could not write %s: %s", char_cast(file.u8string().c_str()), ec.message().c_str());
+        fs::remove(tmpFile, ec);
+        return;
+    }
+
+    uintmax_t size = fs::file_size(file, ec);
+    std::lock_guard lock(this->sizeMutex);
+    if (!this->folderSize || ec || (*this->folderSize += size) > this->maxSize) {
+        pruneLocked();
+    }
+}
+
+void ThumbnailCache::prune() const {
+    std::lock_guard lock(this->sizeMutex);
+    pruneLocked();
+}
+
+void ThumbnailCache::pruneLocked() const {
+    std::error_code ec;
+    std::vector<std::tuple<fs::file_time_type, uintmax_t, fs::path>> files;
+    uintmax_t total = 0;
+    for (const auto& entry: fs::directory_iterator(this->folder, ec)) {
+        if (!entry.is_regular_file(ec)) {
+            continue;
+        }
+        uintmax_t size = entry.file_size(ec);
+        if (ec) {
+            continue;
+        }
+        files.emplace_back(entry.last_write_time(ec), size, entry.path());
+        total += size;
+    }
+
+    if (total > this->maxSize) {
+        std::sort(files.begin(), files.end());
+        for (const auto& [time, size, path]: files) {
+            if (total <= this->maxSize) {
+                break;
+            }
+            if (fs::remove(path, ec)) {
+                total -= size;
+            }
+        }
+    }
+    this->folderSize = total;
+}
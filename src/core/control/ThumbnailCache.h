@@ -0,0 +1,108 @@
+/*
+ * Xournal++
+ *
+ * On-disk cache of the sidebar page previews
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>        // for size_t
+#include <cstdint>        // for uint64_t, uintmax_t
+#include <mutex>          // for mutex
+#include <optional>       // for optional
+#include <string>         // for string
+#include <unordered_map>  // for unordered_map
+
+#include <cairo.h>  // for cairo_surface_t
+
+#include "util/raii/CairoWrappers.h"  // for CairoSurfaceSPtr
+
+#include "filesystem.h"  // for path
+
+class XojPage;
+
+/**
+ * @brief Content addressed cache of the rendered page previews, stored as PNG files in the user cache folder
+ *
+ * A preview is stored under a hash of everything it is rendered from: the content of the page, its background and
+ * the size of the preview. A modified page gets a new key, so the cache never has to be invalidated: the previews which
+ * are not used anymore are deleted by prune(), least recently used first, as soon as a write exceeds the size limit.
+ *
+ * The hash of a page is only computed again when the revision of the page changed (see PageHandler::getRevision()).
+ *
+ * The methods may be called from any thread.
+ */
+class ThumbnailCache {
+public:
+    /**
+     * @param folder The folder of the PNG files
+     * @param maxSize The size in bytes above which prune() deletes files
+     */
+    ThumbnailCache(fs::path folder, size_t maxSize);
+
+    ThumbnailCache(const ThumbnailCache&) = delete;
+    ThumbnailCache& operator=(const ThumbnailCache&) = delete;
+
+public:
+    /**
+     * Hashes the page if it changed since the last call, its content lock has to be held
+     *
+     * @param pdfFile The PDF file of the document, the date it was modified is part of the key
+     * @param width The size of the preview in device pixels (before DPI scaling)
+     */
+    std::string getKey(const XojPage& page, const fs::path& pdfFile, int width, int height, int DPIScaling) const;
+
+    /**
+     * @return The cached preview with the DPI scaling set, nullptr if it is missing or has another size
+     */
+    xoj::util::CairoSurfaceSPtr load(const std::string& key, int width, int height, int DPIScaling) const;
+
+    /**
+     * Writes a preview to the cache, unless it is already there, and prunes the cache if it got too large.
+     * Errors are only logged: the cache is an optimization.
+     */
+    void store(const std::string& key, cairo_surface_t* surface) const;
+
+    /**
+     * Deletes the least recently used previews until the cache fits in maxSize
+     */
+    void prune() const;
+
+private:
+    fs::path getFile(const std::string& key) const;
+
+    /**
+     * @return The hash of the page content and background
+     */
+    static std::string hashPage(const XojPage& page, const fs::path& pdfFile);
+
+    /**
+     * Same as prune(), with sizeMutex locked
+     */
+    void pruneLocked() const;
+
+    fs::path folder;
+    size_t maxSize;
+
+    struct PageHash {
+        uint64_t revision;
+        std::string hash;
+    };
+
+    /**
+     * The last hash of each page. The revisions are unique, so the entry of a deleted page is never used by another.
+     */
+    mutable std::unordered_map<const XojPage*, PageHash> pageHashes;
+    mutable std::mutex pageHashesMutex;
+
+    /**
+     * The size of the folder as of the last prune() plus the files written since, unknown before the first prune()
+     */
+    mutable std::optional<uintmax_t> folderSize;
+    mutable std::mutex sizeMutex;
+};
@@ -11,26 +11,35 @@
 
 #pragma once
 
-#include <string>  // for string
+#include <optional>  // for optional
+#include <vector>    // for vector
+
+#include "model/PageRef.h"  // for PageRef
 
 #include "Job.h"  // for Job, JobType
 
 class Control;
 
+/**
+ * Hands the document to the AutosaveWriter of the Control, which takes a snapshot of it and writes it in the
+ * background. The document is only locked while the snapshot is taken.
+ */
 class AutosaveJob: public Job {
 public:
-    AutosaveJob(Control* control);
+    /**
+     * @param changedPages The pages changed since the last autosave, std::nullopt if not known
+     */
+    AutosaveJob(Control* control, std::optional<std::vector<PageRef>> changedPages);
 
 protected:
     ~AutosaveJob() override;
 
 public:
     void run() override;
-    void afterRun() override;
 
     JobType getType() override;
 
 private:
     Control* control = nullptr;
-    std::string error;
+    std::optional<std::vector<PageRef>> changedPages;
 };
@@ -0,0 +1,262 @@
+#include "AutosaveWriter.h"
+
+#include <algorithm>     // for find
+#include <system_error>  // for error_code
+#include <utility>       // for move
+
+#include <glib.h>  // for g_message, g_warning
+
+#ifdef __linux__
+#include <pthread.h>  // for pthread_setschedparam, pthread_self
+#include <sched.h>    // for SCHED_IDLE, sched_param
+#endif
+
+#include "control/Control.h"              // for Control
+#include "control/xojfile/SaveHandler.h"  // for SaveHandler
+#include "model/Document.h"               // for Document
+#include "model/XojPage.h"                // for XojPage
+#include "util/PathUtil.h"                // for clearExtensions, getAutosaveFilepath, safeRenameFile
+#include "util/PlaceholderString.h"       // for PlaceholderString
+#include "util/Util.h"                    // for execInUiThread
+#include "util/XojMsgBox.h"               // for XojMsgBox
+#include "util/i18n.h"                    // for FS, _F
+
+/// The autosave file is rewritten once the journal has that many records...
+static constexpr size_t MAX_JOURNAL_RECORDS = 64;
+
+/// ... or once the journal is bigger than the autosave file divided by this
+static constexpr std::uintmax_t MAX_JOURNAL_SIZE_RATIO = 2;
+
+AutosaveWriter::AutosaveWriter(Control* control): control(control) {}
+
+AutosaveWriter::~AutosaveWriter() {
+    cancel();
+    if (this->thread.joinable()) {
+        this->thread.join();
+    }
+}
+
+auto AutosaveWriter::save(Document* doc, std::optional<std::vector<PageRef>> changedPages) -> bool {
+    if (this->running) {
+        // The changes would be missing from the journal
+        this->changesSkipped = true;
+        return false;
+    }
+    if (this->thread.joinable()) {
+        this->thread.join();
+    }
+    if (this->changesSkipped) {
+        this->journal.reset();
+        this->changesSkipped = false;
+    }
+
+    doc->lock_shared();
+
+    auto filepath = doc->getFilepath();
+    if (filepath.empty()) {
+        filepath = Util::getAutosaveFilepath();
+    } else {
+        filepath.replace_filename(fs::path(".") += filepath.filename());
+    }
+    Util::clearExtensions(filepath);
+    filepath += ".autosave.xopp";
+
+    std::vector<size_t> pageIndices;
+    auto record = prepareRecord(doc, filepath, changedPages, pageIndices);
+    std::unique_ptr<Document> snapshot;
+    if (record) {
+        snapshot = doc->createSnapshot(pageIndices);
+    } else {
+        resetPageIds(doc);
+        this->journal->autosaveFile = filepath;
+        snapshot = doc->createSnapshot();
+    }
+
+    doc->unlock_shared();
+
+    this->handler = std::make_unique<SaveHandler>();
+    this->pageCount = snapshot->getPageCount();
+    this->pagesWritten = 0;
+    this->running = true;
+    this->thread = std::thread([this, snapshot = std::move(snapshot), filepath = std::move(filepath),
+                                record = std::move(record)]() mutable {
+        run(std::move(snapshot), filepath, record);
+        this->running = false;
+    });
+    return true;
+}
+
+auto AutosaveWriter::prepareRecord(const Document* doc, const fs::path& filepath,
+                                   const std::optional<std::vector<PageRef>>& changedPages,
+                                   std::vector<size_t>& pageIndices) -> std::optional<AutosaveJournal::Record> {
+    if (!this->journal || !changedPages || this->journal->autosaveFile != filepath ||
+        this->journal->recordCount >= MAX_JOURNAL_RECORDS ||
+        this->journal->journalSize > this->journal->autosaveFileSize / MAX_JOURNAL_SIZE_RATIO) {
+        return std::nullopt;
+    }
+    std::error_code ec;
+    if (!fs::exists(filepath, ec)) {
+        return std::nullopt;
+    }
+
+    AutosaveJournal::Record record;
+    std::unordered_map<const XojPage*, PageIdEntry> pageIds;
+    const size_t count = doc->getPageCount();
+    record.pages.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        PageRef p = doc->getPage(i);
+        bool changed = std::find(changedPages->begin(), changedPages->end(), p) != changedPages->end();
+
+        AutosaveJournal::PageId id{};
+        if (auto it = this->journal->pageIds.find(p.get());
+            it != this->journal->pageIds.end() && it->second.page.lock() == p) {
+            id = it->second.id;
+        } else {
+            // Inserted since the last autosave
+            id = this->journal->nextPageId++;
+            changed = true;
+        }
+        pageIds.emplace(p.get(), PageIdEntry{p, id});
+        record.pages.push_back(id);
+
+        if (changed) {
+            if (p->getBackgroundType().isImagePage()) {
+                // Background images are stored next to the file they are saved in and may be shared between pages
+                return std::nullopt;
+            }
+            record.changedPages.push_back(id);
+            pageIndices.push_back(i);
+        }
+    }
+    this->journal->pageIds = std::move(pageIds);
+    return record;
+}
+
+void AutosaveWriter::resetPageIds(const Document* doc) {
+    this->journal.emplace();
+    const size_t count = doc->getPageCount();
+    for (size_t i = 0; i < count; i++) {
+        PageRef p = doc->getPage(i);
+        this->journal->pageIds.emplace(p.get(), PageIdEntry{p, i});
+    }
+    this->journal->nextPageId = count;
+}
+
+auto AutosaveWriter::isRunning() const -> bool { return this->running; }
+
+void AutosaveWriter::cancel() {
+    if (this->running && this->handler) {
+        this->handler->cancel();
+    }
+}
+
+void AutosaveWriter::setMaximumState(size_t max) { this->pageCount = max; }
+
+void AutosaveWriter::setCurrentState(size_t state) { this->pagesWritten = state; }
+
+void AutosaveWriter::run(std::unique_ptr<Document> snapshot, const fs::path& filepath,
+                         const std::optional<AutosaveJournal::Record>& record) {
+#ifdef __linux__
+    // Only use otherwise idle CPU time, so that rendering is never slowed down
+    sched_param param{};
+    if (pthread_setschedparam(pthread_self(), SCHED_IDLE, &param) != 0) {
+        g_warning("Could not lower the priority of the autosave thread");
+    }
+#endif
+
+    if (record) {
+        appendToJournal(snapshot.get(), filepath, *record);
+    } else {
+        writeAutosaveFile(snapshot.get(), filepath);
+    }
+}
+
+void AutosaveWriter::writeAutosaveFile(Document* snapshot, const fs::path& filepath) {
+    g_message("%s", FS(_F("Autosaving to {1}") % filepath.string()).c_str());
+
+    fs::path tempfile = filepath;
+    tempfile += u8"~";
+
+    this->handler->prepareSave(snapshot, filepath);
+    this->handler->saveTo(tempfile, this);
+
+    if (this->handler->isCancelled()) {
+        g_message("%s", FS(_F("Autosave cancelled after {1} of {2} pages") % this->pagesWritten.load() %
+                           this->pageCount.load())
+                                .c_str());
+        this->journal.reset();
+        std::error_code ec;
+        fs::remove(tempfile, ec);
+        return;
+    }
+
+    std::string error = this->handler->getErrorMessage();
+    if (error.empty()) {
+        // The journal refers to the previous autosave file: remove it first, in case of a crash in between
+        std::error_code ec;
+        fs::remove(AutosaveJournal::getPath(filepath), ec);
+        error = replaceAutosaveFile(tempfile, filepath);
+    }
+
+    if (!error.empty()) {
+        this->journal.reset();
+        showError(error);
+        return;
+    }
+
+    std::error_code ec;
+    this->journal->autosaveFileSize = fs::file_size(filepath, ec);
+    if (ec) {
+        this->journal.reset();
+    }
+}
+
+void AutosaveWriter::appendToJournal(Document* snapshot, const fs::path& filepath,
+                                     const AutosaveJournal::Record& record) {
+    g_message("%s", FS(_F("Autosaving {1} changed pages to {2}") % record.changedPages.size() % filepath.string())
+                            .c_str());
+
+    // The journal refers to the PDF instead of copying it every time, and does not need a preview
+    snapshot->setPdfAttributes(snapshot->getPdfFilepath(), false);
+    snapshot->setPreview(nullptr);
+
+    auto journalPath = AutosaveJournal::getPath(filepath);
+    auto error = AutosaveJournal::append(journalPath, record, snapshot);
+    if (!error.empty()) {
+        this->journal.reset();
+        showError(error);
+        return;
+    }
+
+    std::error_code ec;
+    this->journal->journalSize = fs::file_size(journalPath, ec);
+    this->journal->recordCount++;
+    if (ec) {
+        this->journal.reset();
+    }
+}
+
+auto AutosaveWriter::replaceAutosaveFile(const fs::path& tempfile, const fs::path& filepath) -> std::string {
+    try {
+        if (fs::exists(filepath)) {
+            fs::path swaptmpfile = filepath;
+            swaptmpfile += u8".swap";
+            Util::safeRenameFile(filepath, swaptmpfile);
+            Util::safeRenameFile(tempfile, filepath);
+            // All went well, we can delete the old autosave file
+            fs::remove(swaptmpfile);
+        } else {
+            Util::safeRenameFile(tempfile, filepath);
+        }
+        control->setLastAutosaveFile(filepath);
+    } catch (const fs::filesystem_error& e) {
+        auto fmtstr = _F("Could not rename autosave file from \"{1}\" to \"{2}\": {3}");
+        return FS(fmtstr % tempfile.u8string() % filepath.u8string() % e.what());
+    }
+    return {};
+}
+
+void AutosaveWriter::showError(const std::string& error) {
+    std::string msg = FS(_F("Error while autosaving: {1}") % error);
+    Util::execInUiThread([msg, win = control->getGtkWindow()]() { XojMsgBox::showErrorToUser(win, msg); });
+}
@@ -0,0 +1,137 @@
+/*
+ * Xournal++
+ *
+ * Writes autosave files in the background
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <atomic>         // for atomic
+#include <cstddef>        // for size_t
+#include <cstdint>        // for uintmax_t
+#include <memory>         // for unique_ptr, weak_ptr
+#include <optional>       // for optional
+#include <string>         // for string
+#include <thread>         // for thread
+#include <unordered_map>  // for unordered_map
+#include <vector>         // for vector
+
+#include "control/xojfile/AutosaveJournal.h"  // for AutosaveJournal
+#include "model/PageRef.h"                    // for PageRef
+
+#include "ProgressListener.h"  // for ProgressListener
+#include "filesystem.h"        // for path
+
+class Control;
+class Document;
+class SaveHandler;
+
+/**
+ * @brief Serializes snapshots of the document to the autosave file on a dedicated low priority thread
+ *
+ * The snapshot is owned by the writer: the document itself is never accessed, so drawing and rendering go on
+ * undisturbed while the file is written and compressed.
+ *
+ * When possible, only the pages changed since the previous autosave are appended to the journal of the autosave file
+ * (see AutosaveJournal). The whole autosave file is rewritten, and the journal cleared, when the journal gets too long
+ * compared to the autosave file or when the changes cannot be expressed as page changes.
+ */
+class AutosaveWriter final: public ProgressListener {
+public:
+    explicit AutosaveWriter(Control* control);
+    AutosaveWriter(const AutosaveWriter&) = delete;
+    AutosaveWriter& operator=(const AutosaveWriter&) = delete;
+
+    /**
+     * Cancels the autosave in progress, if any, and waits for the thread to finish
+     */
+    ~AutosaveWriter() override;
+
+public:
+    /**
+     * Takes a snapshot of the document (locking it shared meanwhile) and starts writing it in the background.
+     *
+     * @param changedPages The pages changed since the previous autosave, std::nullopt if not known
+     * @return false (and does nothing) if the previous autosave is still being written
+     */
+    bool save(Document* doc, std::optional<std::vector<PageRef>> changedPages);
+
+    /**
+     * @return true if an autosave is being written
+     */
+    bool isRunning() const;
+
+    /**
+     * Stops the autosave in progress after the current page. The previous autosave file is kept.
+     */
+    void cancel();
+
+    void setMaximumState(size_t max) override;
+    void setCurrentState(size_t state) override;
+
+private:
+    /**
+     * Computes the journal record for the changed pages and updates the page ids.
+     * The document must be locked.
+     *
+     * @param pageIndices Filled with the indices of the pages to write
+     * @return std::nullopt if the whole autosave file must be rewritten
+     */
+    std::optional<AutosaveJournal::Record> prepareRecord(const Document* doc, const fs::path& filepath,
+                                                         const std::optional<std::vector<PageRef>>& changedPages,
+                                                         std::vector<size_t>& pageIndices);
+
+    void resetPageIds(const Document* doc);
+
+    void run(std::unique_ptr<Document> snapshot, const fs::path& filepath,
+             const std::optional<AutosaveJournal::Record>& record);
+    void writeAutosaveFile(Document* snapshot, const fs::path& filepath);
+    void appendToJournal(Document* snapshot, const fs::path& filepath, const AutosaveJournal::Record& record);
+
+    /**
+     * Replaces the autosave file by the newly written one
+     *
+     * @return an error message, empty on success
+     */
+    std::string replaceAutosaveFile(const fs::path& tempfile, const fs::path& filepath);
+
+    void showError(const std::string& error);
+
+private:
+    Control* control = nullptr;
+
+    std::unique_ptr<SaveHandler> handler;
+    std::thread thread{};
+    std::atomic<bool> running{false};
+
+    /// Progress of the autosave being written, in pages
+    std::atomic<size_t> pageCount{0};
+    std::atomic<size_t> pagesWritten{0};
+
+    struct PageIdEntry {
+        std::weak_ptr<XojPage> page;
+        AutosaveJournal::PageId id;
+    };
+
+    /**
+     * State of the autosave file and its journal, std::nullopt if the next autosave has to rewrite the whole file.
+     * Only accessed by save() and the writer thread, which save() joins first.
+     */
+    struct JournalState {
+        fs::path autosaveFile;
+        std::unordered_map<const XojPage*, PageIdEntry> pageIds;
+        AutosaveJournal::PageId nextPageId = 0;
+        size_t recordCount = 0;
+        std::uintmax_t autosaveFileSize = 0;
+        std::uintmax_t journalSize = 0;
+    };
+    std::optional<JournalState> journal;
+
+    /// If save() was called while the previous autosave was being written
+    bool changesSkipped = false;
+};
@@ -1,10 +1,15 @@
 #include "ImageExport.h"
 
-#include <cmath>    // for round
-#include <cstddef>  // for size_t
-#include <memory>   // for __shared_ptr_access, allocat...
-#include <utility>  // for move
-#include <vector>   // for vector
+#include <algorithm>           // for clamp, max
+#include <atomic>              // for atomic_size_t
+#include <cmath>               // for round
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <memory>              // for __shared_ptr_access, allocat...
+#include <shared_mutex>        // for shared_lock
+#include <thread>              // for thread
+#include <utility>             // for move, pair
+#include <vector>              // for vector
 
 #include <cairo-svg.h>  // for cairo_svg_surface_create
 
@@ -64,7 +69,15 @@ void ImageExport::setLayerRange(const char* rangeStr) {
  * @brief Get the last error message
  * @return The last error message to show to the user
  */
-auto ImageExport::getLastErrorMsg() const -> string { return lastError; }
+auto ImageExport::getLastErrorMsg() const -> string {
+    std::lock_guard lock(lastErrorMutex);
+    return lastError;
+}
+
+void ImageExport::setLastError(std::string msg) {
+    std::lock_guard lock(lastErrorMutex);
+    lastError = std::move(msg);
+}
 
 /**
  * @brief Create Cairo surface for a given page
@@ -78,36 +91,38 @@ auto ImageExport::getLastErrorMsg() const -> string { return lastError; }
  * height (in pixels). In this case, the zoomRatio (and the DPI) is page-dependent as soon as the document has pages of
  * different sizes.
  */
-auto ImageExport::createSurface(double width, double height, size_t id, double zoomRatio) -> double {
+auto ImageExport::createSurface(double width, double height, size_t id, double zoomRatio,
+                                xoj::util::CairoSurfaceSPtr& surface) -> double {
     switch (this->format) {
         case EXPORT_GRAPHICS_PNG:
             switch (this->qualityParameter.getQualityCriterion()) {
                 case EXPORT_QUALITY_WIDTH:
                     zoomRatio = ((double)this->qualityParameter.getValue()) / width;
-                    this->surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, this->qualityParameter.getValue(),
-                                                               (int)std::round(height * zoomRatio));
+                    surface.reset(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, this->qualityParameter.getValue(),
+                                                             (int)std::round(height * zoomRatio)),
+                                  xoj::util::adopt);
                     break;
                 case EXPORT_QUALITY_HEIGHT:
                     zoomRatio = ((double)this->qualityParameter.getValue()) / height;
-                    this->surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, (int)std::round(width * zoomRatio),
-                                                               this->qualityParameter.getValue());
+                    surface.reset(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, (int)std::round(width * zoomRatio),
+                                                             this->qualityParameter.getValue()),
+                                  xoj::util::adopt);
                     break;
                 case EXPORT_QUALITY_DPI:  // Use the zoomRatio given as argument
-                    this->surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, (int)std::round(width * zoomRatio),
-                                                               (int)std::round(height * zoomRatio));
+                    surface.reset(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, (int)std::round(width * zoomRatio),
+                                                             (int)std::round(height * zoomRatio)),
+                                  xoj::util::adopt);
                     break;
             }
-            this->cr = cairo_create(this->surface);
-            cairo_scale(this->cr, zoomRatio, zoomRatio);
             return zoomRatio;
         case EXPORT_GRAPHICS_SVG:
-            this->surface =
-                    cairo_svg_surface_create(char_cast(getFilenameWithNumber(id).u8string().c_str()), width, height);
-            cairo_svg_surface_restrict_to_version(this->surface, CAIRO_SVG_VERSION_1_2);
-            this->cr = cairo_create(this->surface);
+            surface.reset(cairo_svg_surface_create(char_cast(getFilenameWithNumber(id).u8string().c_str()), width,
+                                                   height),
+                          xoj::util::adopt);
+            cairo_svg_surface_restrict_to_version(surface.get(), CAIRO_SVG_VERSION_1_2);
             break;
         default:
-            this->lastError = _("Unsupported graphics format: ") + std::to_string(this->format);
+            setLastError(_("Unsupported graphics format: ") + std::to_string(this->format));
     }
     return 0.0;
 }
@@ -115,20 +130,41 @@ auto ImageExport::createSurface(double width, double height, size_t id, double z
 /**
  * Free / store the surface
  */
-auto ImageExport::freeSurface(size_t id) -> bool {
-    cairo_destroy(this->cr);
-
+auto ImageExport::freeSurface(size_t id, xoj::util::CairoSurfaceSPtr surface) -> bool {
     cairo_status_t status = CAIRO_STATUS_SUCCESS;
     if (format == EXPORT_GRAPHICS_PNG) {
         auto filepath = getFilenameWithNumber(id);
-        status = cairo_surface_write_to_png(surface, char_cast(filepath.u8string().c_str()));
+        status = cairo_surface_write_to_png(surface.get(), char_cast(filepath.u8string().c_str()));
+    } else {
+        // Writes the end of the SVG file
+        cairo_surface_finish(surface.get());
+        status = cairo_surface_status(surface.get());
     }
-    cairo_surface_destroy(surface);
 
     // we ignore this problem
     return status == CAIRO_STATUS_SUCCESS;
 }
 
+auto ImageExport::getSurfaceByteSize(size_t pageId, double zoomRatio) -> size_t {
+    doc->lock();
+    ConstPageRef page = doc->getPage(pageId);
+    doc->unlock();
+
+    double width = page->getWidth();
+    double height = page->getHeight();
+    switch (this->qualityParameter.getQualityCriterion()) {
+        case EXPORT_QUALITY_WIDTH:
+            zoomRatio = ((double)this->qualityParameter.getValue()) / width;
+            break;
+        case EXPORT_QUALITY_HEIGHT:
+            zoomRatio = ((double)this->qualityParameter.getValue()) / height;
+            break;
+        case EXPORT_QUALITY_DPI:
+            break;
+    }
+    return static_cast<size_t>(std::round(width * zoomRatio)) * static_cast<size_t>(std::round(height * zoomRatio)) * 4;
+}
+
 /**
  * @brief Get a filename with a (page) number appended
  * @param no The appended number. If no==-1, does not append anything.
@@ -163,21 +199,31 @@ void ImageExport::exportImagePage(size_t pageId, size_t id, double zoomRatio, Ex
     ConstPageRef page = doc->getPage(pageId);
     doc->unlock();
 
-    zoomRatio = createSurface(page->getWidth(), page->getHeight(), id, zoomRatio);
+    xoj::util::CairoSurfaceSPtr surface;
+    zoomRatio = createSurface(page->getWidth(), page->getHeight(), id, zoomRatio, surface);
+    if (!surface) {
+        return;
+    }
 
-    cairo_status_t state = cairo_surface_status(this->surface);
+    cairo_status_t state = cairo_surface_status(surface.get());
     if (state != CAIRO_STATUS_SUCCESS) {
-        this->lastError = _("Error save image #1");
+        setLastError(_("Error save image #1"));
         return;
     }
 
+    xoj::util::CairoSPtr crPtr(cairo_create(surface.get()), xoj::util::adopt);
+    cairo_t* cr = crPtr.get();
+    if (format == EXPORT_GRAPHICS_PNG) {
+        cairo_scale(cr, zoomRatio, zoomRatio);
+    }
+
     if (page->getBackgroundType().isPdfPage() && (exportBackground != EXPORT_BACKGROUND_NONE)) {
         // Handle the pdf page separately, to call renderForPrinting for better quality.
         auto pgNo = page->getPdfPageNr();
         XojPdfPageSPtr popplerPage = doc->getPdfPage(pgNo);
         if (!popplerPage) {
-            this->lastError = _("Error while exporting the pdf background: I cannot find the pdf page number ");
-            this->lastError += std::to_string(pgNo);
+            setLastError(_("Error while exporting the pdf background: I cannot find the pdf page number ") +
+                         std::to_string(pgNo));
         } else if (format == EXPORT_GRAPHICS_PNG) {
             popplerPage->render(cr);
         } else {
@@ -192,15 +238,21 @@ void ImageExport::exportImagePage(size_t pageId, size_t id, double zoomRatio, Ex
     flags.showRuling = exportBackground <= EXPORT_BACKGROUND_UNRULED ? xoj::view::HIDE_RULING_BACKGROUND :
                                                                        xoj::view::SHOW_RULING_BACKGROUND;
 
-    if (layerRange) {
-        view.drawLayersOfPage(*layerRange, page, this->cr, true /* dont render eraseable */, flags);
-    } else {
-        view.drawPage(page, this->cr, true /* dont render eraseable */, flags);
+    {
+        // The pages are drawn by several threads while the document may be edited
+        std::shared_lock<Document> docLock(*doc);
+        std::shared_lock pageLock(page->getContentLock());
+        if (layerRange) {
+            view.drawLayersOfPage(*layerRange, page, cr, true /* dont render eraseable */, flags);
+        } else {
+            view.drawPage(page, cr, true /* dont render eraseable */, flags);
+        }
     }
+    crPtr.reset();
 
-    if (!freeSurface(id)) {
+    if (!freeSurface(id, std::move(surface))) {
         // could not create this file...
-        this->lastError = _("Error save image #2");
+        setLastError(_("Error save image #2"));
         return;
     }
 }
@@ -225,8 +277,6 @@ void ImageExport::exportGraphics(ProgressListener* stateListener) {
         }
     }
 
-    stateListener->setMaximumState(selectedCount);
-
     /*
      * Compute the zoomRatio only once if using DPI as a PNG quality criterion
      */
@@ -235,20 +285,66 @@ void ImageExport::exportGraphics(ProgressListener* stateListener) {
         zoomRatio = ((double)this->qualityParameter.getValue()) / Util::DPI_NORMALIZATION_FACTOR;
     }
 
-    DocumentView view;
-    size_t current = 0;
-
+    // The pages to export, with the number of their file
+    std::vector<std::pair<size_t, size_t>> pages;
+    pages.reserve(selectedCount);
+    size_t largestSurface = 0;
     for (size_t i = 0; i < count; i++) {
-        auto id = i + 1;
-        if (onePage) {
-            id = SINGLE_PAGE;
+        if (selectedPages[i]) {
+            pages.emplace_back(i, onePage ? SINGLE_PAGE : i + 1);
+            if (this->format == EXPORT_GRAPHICS_PNG) {
+                largestSurface = std::max(largestSurface, getSurfaceByteSize(i, zoomRatio));
+            }
         }
+    }
 
-        if (selectedPages[i]) {
-            exportImagePage(i, id, zoomRatio, format, view);
-            stateListener->setCurrentState(++current);
+    stateListener->setMaximumState(pages.size());
+
+    // Each thread holds one surface at a time: bound their count so that the surfaces fit in memory
+    size_t threadCount = std::max(std::thread::hardware_concurrency(), 1U);
+    if (largestSurface > 0) {
+        threadCount = std::clamp<size_t>(MAX_IN_FLIGHT_BYTES / largestSurface, 1, threadCount);
+    }
+    threadCount = std::min(threadCount, std::max<size_t>(pages.size(), 1));
+
+    std::atomic_size_t next = 0;
+    std::mutex doneMutex;
+    std::condition_variable doneChanged;
+    size_t done = 0;
+
+    auto worker = [&]() {
+        DocumentView view;
+        for (size_t n = next++; n < pages.size(); n = next++) {
+            exportImagePage(pages[n].first, pages[n].second, zoomRatio, format, view);
+
+            std::lock_guard lock(doneMutex);
+            done++;
+            doneChanged.notify_one();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; i++) {
+        threads.emplace_back(worker);
+    }
+
+    // The listener is only notified from this thread
+    {
+        std::unique_lock lock(doneMutex);
+        size_t reported = 0;
+        while (reported < pages.size()) {
+            doneChanged.wait(lock, [&]() { return done > reported; });
+            reported = done;
+            lock.unlock();
+            stateListener->setCurrentState(reported);
+            lock.lock();
         }
     }
+
+    for (std::thread& t: threads) {
+        t.join();
+    }
 }
 
 RasterImageQualityParameter::RasterImageQualityParameter() = default;
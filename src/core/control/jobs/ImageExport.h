@@ -12,11 +12,13 @@
 #pragma once
 
 #include <cstddef>  // for size_t
+#include <mutex>    // for mutex
 #include <string>   // for string
 
 #include <cairo.h>  // for cairo_surface_t, cairo_t
 
-#include "util/ElementRange.h"  // for PageRangeVector, LayerRangeVector
+#include "util/ElementRange.h"        // for PageRangeVector, LayerRangeVector
+#include "util/raii/CairoWrappers.h"  // for CairoSurfaceSPtr
 
 #include "BaseExportJob.h"  // for ExportBackgroundType, EXPORT_BACKGROUND_ALL
 #include "filesystem.h"     // for path
@@ -79,8 +81,9 @@ public:
     std::string getLastErrorMsg() const;
 
     /**
-     * @brief Create one Graphics file per page
-     * @param stateListener A listener to track the progress
+     * @brief Create one Graphics file per page. The pages are rendered and written in parallel, by as many threads as
+     * there are CPU cores, fewer if their PNG surfaces would not fit in MAX_IN_FLIGHT_BYTES.
+     * @param stateListener A listener to track the progress, only called from the calling thread
      */
     void exportGraphics(ProgressListener* stateListener);
 
@@ -110,17 +113,30 @@ private:
      * @param height the height of the page being exported
      * @param id the id of the page being exported
      * @param zoomRatio the zoom ratio for PNG exports with fixed DPI
+     * @param surface Receives the surface
      *
      * @return the zoom ratio of the current page if the export type is PNG, 0.0 otherwise
      *          The return value may differ from that of the parameter zoomRatio
      *          if the export has fixed page width or height (in pixels)
      */
-    double createSurface(double width, double height, size_t id, double zoomRatio);
+    double createSurface(double width, double height, size_t id, double zoomRatio,
+                         xoj::util::CairoSurfaceSPtr& surface);
 
     /**
      * Free / store the surface
      */
-    bool freeSurface(size_t id);
+    bool freeSurface(size_t id, xoj::util::CairoSurfaceSPtr surface);
+
+    /**
+     * @brief Get the size in bytes of the PNG surface of a page
+     * @param zoomRatio The zoom ratio for PNG exports with fixed DPI
+     */
+    size_t getSurfaceByteSize(size_t pageId, double zoomRatio);
+
+    /**
+     * @brief Remember an error message, from any thread
+     */
+    void setLastError(std::string msg);
 
     /**
      * @brief Get a filename with a (page) number appended
@@ -143,6 +159,11 @@ private:
 
     static constexpr size_t SINGLE_PAGE = size_t(-1);
 
+    /**
+     * The memory the PNG surfaces rendered at the same time may use
+     */
+    static constexpr size_t MAX_IN_FLIGHT_BYTES = 512 * 1024 * 1024;
+
 public:
     /**
      * Document to export
@@ -180,17 +201,12 @@ public:
     RasterImageQualityParameter qualityParameter = RasterImageQualityParameter();
 
     /**
-     * Export surface
-     */
-    cairo_surface_t* surface = nullptr;
-
-    /**
-     * Cairo context
+     * The last error message to show to the user
      */
-    cairo_t* cr = nullptr;
+    std::string lastError;
 
     /**
-     * The last error message to show to the user
+     * Protects lastError, the pages are exported in parallel
      */
-    std::string lastError;
+    mutable std::mutex lastErrorMutex;
 };
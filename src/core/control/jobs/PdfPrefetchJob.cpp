@@ -0,0 +1,26 @@
+#include "PdfPrefetchJob.h"
+
+#include <utility>  // for move
+
+#include "control/PdfCache.h"  // for PdfCache
+
+PdfPrefetchJob::PdfPrefetchJob(std::shared_ptr<PdfCache> cache, std::vector<size_t> pdfPages, double zoom,
+                               int DPIScaling):
+        cache(std::move(cache)), pdfPages(std::move(pdfPages)), zoom(zoom), DPIScaling(DPIScaling) {}
+
+PdfPrefetchJob::~PdfPrefetchJob() = default;
+
+void PdfPrefetchJob::onDelete() { this->deleted = true; }
+
+auto PdfPrefetchJob::getSource() -> void* { return this->cache.get(); }
+
+auto PdfPrefetchJob::getType() -> JobType { return JOB_TYPE_PDF_PREFETCH; }
+
+void PdfPrefetchJob::run() {
+    for (size_t pdfPageNo: this->pdfPages) {
+        if (this->deleted) {
+            return;
+        }
+        this->cache->prefetch(pdfPageNo, this->zoom, this->DPIScaling);
+    }
+}
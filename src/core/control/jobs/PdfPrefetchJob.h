@@ -0,0 +1,56 @@
+/*
+ * Xournal++
+ *
+ * A job which rasterizes PDF pages in advance
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <atomic>   // for atomic_bool
+#include <cstddef>  // for size_t
+#include <memory>   // for shared_ptr
+#include <vector>   // for vector
+
+#include "Job.h"  // for Job, JobType
+
+class PdfCache;
+
+/**
+ * @brief A Job which fills a PdfCache with the PDF pages around the current page, so that they are not rasterized
+ * when the user flips to them
+ */
+class PdfPrefetchJob: public Job {
+public:
+    /**
+     * @param pdfPages The pages (in the pdf document) to rasterize, the most likely to be shown first
+     * @param zoom The zoom the pages will be rendered at, in pixels per page unit
+     * @param DPIScaling The DPI scaling of the view
+     */
+    PdfPrefetchJob(std::shared_ptr<PdfCache> cache, std::vector<size_t> pdfPages, double zoom, int DPIScaling);
+
+protected:
+    void onDelete() override;
+    ~PdfPrefetchJob() override;
+
+public:
+    void* getSource() override;
+
+    void run() override;
+
+    JobType getType() override;
+
+private:
+    /// Kept alive even if the document changes in the meantime
+    std::shared_ptr<PdfCache> cache;
+    std::vector<size_t> pdfPages;
+    double zoom;
+    int DPIScaling;
+
+    /// Set when the job is removed from the scheduler, to stop before the next page
+    std::atomic_bool deleted = false;
+};
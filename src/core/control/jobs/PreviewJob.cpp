@@ -1,13 +1,16 @@
 #include "PreviewJob.h"
 
-#include <memory>  // for __s...
-#include <mutex>   // for mutex
-#include <vector>  // for vector
+#include <memory>        // for __s...
+#include <mutex>         // for mutex
+#include <shared_mutex>  // for shared_lock
+#include <vector>        // for vector
 
 #include <glib-object.h>  // for g_o...
 #include <gtk/gtk.h>      // for Gtk...
 
 #include "control/Control.h"                                      // for Con...
+#include "control/RenderCache.h"                                  // for Ren...
+#include "control/ThumbnailCache.h"                               // for Thu...
 #include "control/jobs/Job.h"                                     // for JOB...
 #include "gui/Shadow.h"                                           // for Shadow
 #include "gui/sidebar/previews/base/SidebarPreviewBase.h"         // for Sid...
@@ -48,6 +51,10 @@ void PreviewJob::initGraphics() {
 void PreviewJob::finishPaint() {
     auto lock = std::lock_guard(this->sidebarPreview->drawingMutex);
     this->sidebarPreview->buffer = std::move(this->buffer);
+    // The cache only try_locks the mutexes of the clients it evicts, so it can be called with ours locked
+    this->sidebarPreview->sidebar->getControl()->getRenderCache()->update(
+            this->sidebarPreview, 0, RenderCache::PREVIEW,
+            RenderCache::getSurfaceSize(this->sidebarPreview->buffer.get()));
     Util::execInUiThread([btn = this->sidebarPreview->button]() { gtk_widget_queue_draw(btn.get()); });
 }
 
@@ -55,11 +62,15 @@ void PreviewJob::drawPage() {
     ConstPageRef page = this->sidebarPreview->page;
     Document* doc = this->sidebarPreview->sidebar->getControl()->getDocument();
     DocumentView view;
-    view.setPdfCache(this->sidebarPreview->sidebar->getCache());
+    // Keeps the cache alive if it is replaced while rendering
+    auto pdfCache = this->sidebarPreview->sidebar->getCache();
+    // The thumbnails must not evict the pages of the main view from the shared cache
+    view.setPdfCache(pdfCache.get(), xoj::view::REUSE_CACHED_PDF_ONLY);
     PreviewRenderType type = this->sidebarPreview->getRenderType();
     Layer::Index layer = 0;
 
-    doc->lock();
+    std::shared_lock<Document> docLock(*doc);
+    std::shared_lock pageLock(page->getContentLock());
 
     // getLayer is not defined for page preview
     if (type != RENDER_TYPE_PAGE_PREVIEW) {
@@ -70,6 +81,17 @@ void PreviewJob::drawPage() {
 
     switch (type) {
         case RENDER_TYPE_PAGE_PREVIEW:
+            if (ThumbnailCache* thumbnails = this->sidebarPreview->sidebar->getControl()->getThumbnailCache()) {
+                auto w = this->sidebarPreview->imageWidth;
+                auto h = this->sidebarPreview->imageHeight;
+                auto DPIscaling = this->sidebarPreview->DPIscaling;
+                this->thumbnailKey = thumbnails->getKey(*page, doc->getPdfFilepath(), w, h, DPIscaling);
+                if (auto cached = thumbnails->load(this->thumbnailKey, w, h, DPIscaling)) {
+                    this->buffer = std::move(cached);
+                    this->loadedThumbnail = true;
+                    break;
+                }
+            }
             // render all layers
             view.drawPage(page, cr.get(), true);
             break;
@@ -109,8 +131,6 @@ void PreviewJob::drawPage() {
             // unknown type
             break;
     }
-
-    doc->unlock();
 }
 
 void PreviewJob::clipToPage() {
@@ -128,5 +148,10 @@ void PreviewJob::run() {
     initGraphics();
     clipToPage();
     drawPage();
+
+    // Written without the document lock: the key already identifies the content
+    if (!this->thumbnailKey.empty() && !this->loadedThumbnail) {
+        this->sidebarPreview->sidebar->getControl()->getThumbnailCache()->store(this->thumbnailKey, this->buffer.get());
+    }
     finishPaint();
 }
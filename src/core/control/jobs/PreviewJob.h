@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include <string>  // for string
+
 #include <cairo.h>  // for cairo_surface_t, cairo_t
 
 #include "util/raii/CairoWrappers.h"
@@ -54,6 +56,16 @@ private:
      */
     xoj::util::CairoSPtr cr;
 
+    /**
+     * The key of the page preview in the ThumbnailCache, empty if it is not cached on disk
+     */
+    std::string thumbnailKey;
+
+    /**
+     * If the buffer was loaded from the ThumbnailCache instead of drawn
+     */
+    bool loadedThumbnail = false;
+
     /**
      * Sidebar preview
      */
@@ -1,12 +1,15 @@
 #include "RenderJob.h"
 
-#include <mutex>    // for mutex
-#include <utility>  // for move
-#include <vector>   // for vector
+#include <algorithm>     // for min
+#include <mutex>         // for mutex
+#include <shared_mutex>  // for shared_lock
+#include <utility>       // for move
+#include <vector>        // for vector
 
 #include <cairo.h>  // for cairo_create, cairo_destroy, cairo_...
 
 #include "control/Control.h"            // for Control
+#include "control/RenderCache.h"        // for RenderCache
 #include "control/ToolEnums.h"          // for TOOL_PLAY_OBJECT
 #include "control/ToolHandler.h"        // for ToolHandler
 #include "control/jobs/Job.h"           // for JOB_TYPE_RENDER, JobType
@@ -16,26 +19,26 @@
 #include "model/Document.h"             // for Document
 #include "model/XojPage.h"              // for Page
 #include "util/Assert.h"                // for xoj_assert
+#include "util/Range.h"                 // for Range
 #include "util/Rectangle.h"             // for Rectangle
 #include "util/Util.h"                  // for execInUiThread
 #include "util/raii/CairoWrappers.h"    // for CairoSurfaceSPtr, CairoSPtr
 #include "util/safe_casts.h"            // for strict_cast, as_signed, as_si...
 #include "view/DocumentView.h"          // for DocumentView
 #include "view/Mask.h"                  // for Mask
-
-#if defined(__has_cpp_attribute) && __has_cpp_attribute(likely)
-#define XOJ_CPP20_UNLIKELY [[unlikely]]
-#else
-#define XOJ_CPP20_UNLIKELY
-#endif
+#include "view/TiledBuffer.h"           // for TiledBuffer
 
 using xoj::util::Rectangle;
+using xoj::view::TiledBuffer;
+
+/// Size of the part of a page rendered before it is shown, in device pixels
+static constexpr double PRELOAD_SIZE = 2048;
 
 RenderJob::RenderJob(XojPageView* view): view(view) {}
 
 auto RenderJob::getSource() -> void* { return this->view; }
 
-void RenderJob::rerenderRectangle(Rectangle<double> const& rect) {
+void RenderJob::rerenderRectangle(Rectangle<double> const& rect, double zoom) {
     /**
      * Padding seems to be necessary to prevent artefacts of most strokes.
      * These artefacts are most pronounced when using the stroke deletion
@@ -46,18 +49,30 @@ void RenderJob::rerenderRectangle(Rectangle<double> const& rect) {
 
     Range maskRange(rect);
     maskRange.addPadding(RENDER_PADDING);
-    xoj::view::Mask newMask(view->xournal->getDpiScaleFactor(), maskRange, view->xournal->getZoom(),
-                            CAIRO_CONTENT_COLOR_ALPHA);
+    xoj::view::Mask newMask(view->xournal->getDpiScaleFactor(), maskRange, zoom, CAIRO_CONTENT_COLOR_ALPHA);
 
     renderToBuffer(newMask.get());
 
     std::lock_guard lock(this->view->drawingMutex);
-    if (!view->buffer.isInitialized()) {
-        // Todo: the buffer must not be uninitializable here, either by moving it into the job or by locking it at job
-        // creation a shared prt may also be suffice.
-        XOJ_CPP20_UNLIKELY return;
+    this->view->buffer.update(zoom, newMask, maskRange);
+    updateRenderCache();
+}
+
+auto RenderJob::renderTiles(std::vector<TiledBuffer::TileIndex> const& indices, double zoom) const
+        -> std::vector<TiledBuffer::RenderedTile> {
+    Range pageRange(0, 0, view->page->getWidth(), view->page->getHeight());
+    std::vector<TiledBuffer::RenderedTile> tiles;
+    tiles.reserve(indices.size());
+    for (auto index: indices) {
+        Range extent = TiledBuffer::getTileExtent(index, zoom).intersect(pageRange);
+        if (extent.empty()) {
+            continue;
+        }
+        xoj::view::Mask tile(view->xournal->getDpiScaleFactor(), extent, zoom, CAIRO_CONTENT_COLOR_ALPHA);
+        renderToBuffer(tile.get());
+        tiles.emplace_back(index, std::move(tile));
     }
-    newMask.paintTo(view->buffer.get());
+    return tiles;
 }
 
 void RenderJob::run() {
@@ -66,18 +81,26 @@ void RenderJob::run() {
     bool rerenderComplete = std::exchange(this->view->rerenderComplete, false);
     bool sizeChanged = std::exchange(this->view->sizeChanged, false);
     auto rerenderRects = std::move(this->view->rerenderRects);
+    Range visible = this->view->visibleRange;
 
     this->view->repaintRectMutex.unlock();
 
-    if (rerenderComplete) {
-        xoj::view::Mask newMask(view->xournal->getDpiScaleFactor(),
-                                Range(0, 0, view->page->getWidth(), view->page->getHeight()), view->xournal->getZoom(),
-                                CAIRO_CONTENT_COLOR_ALPHA);
+    double zoom = view->xournal->getZoom();
+    Range region = visible.intersect(Range(0, 0, view->page->getWidth(), view->page->getHeight()));
+    if (region.empty()) {
+        // The page has not been shown yet (e.g. it is preloaded): render its top left part, about a screen large
+        region = Range(0, 0, std::min(view->page->getWidth(), PRELOAD_SIZE / zoom),
+                       std::min(view->page->getHeight(), PRELOAD_SIZE / zoom));
+    }
 
-        renderToBuffer(newMask.get());
+    if (rerenderComplete) {
+        auto tiles = renderTiles(TiledBuffer::getTilesIn(region, zoom), zoom);
         {
             std::lock_guard lock(this->view->drawingMutex);
-            std::swap(this->view->buffer, newMask);
+            // Only a change of size keeps the tiles of the other zoom levels up to date
+            this->view->buffer.replaceTiles(zoom, std::move(tiles), sizeChanged);
+            this->view->buffer.evict(region, zoom);
+            updateRenderCache();
         }
         if (sizeChanged) {
             // We do not have any control on what portion of the widget needs to be redrawn. Redraw it all.
@@ -85,11 +108,29 @@ void RenderJob::run() {
         } else {
             repaintPage();
         }
-    } else {
-        for (Rectangle<double> const& rect: rerenderRects) {
-            rerenderRectangle(rect);
-            repaintPageArea(rect.x, rect.y, rect.x + rect.width, rect.y + rect.height);
+        return;
+    }
+
+    for (Rectangle<double> const& rect: rerenderRects) {
+        rerenderRectangle(rect, zoom);
+        repaintPageArea(rect.x, rect.y, rect.x + rect.width, rect.y + rect.height);
+    }
+
+    // The tiles which became visible, e.g. after scrolling or zooming
+    std::vector<TiledBuffer::TileIndex> missing;
+    {
+        std::lock_guard lock(this->view->drawingMutex);
+        missing = this->view->buffer.getMissingTiles(region, zoom);
+    }
+    if (!missing.empty()) {
+        auto tiles = renderTiles(missing, zoom);
+        {
+            std::lock_guard lock(this->view->drawingMutex);
+            this->view->buffer.addTiles(zoom, std::move(tiles));
+            this->view->buffer.evict(region, zoom);
+            updateRenderCache();
         }
+        repaintPageArea(region.minX, region.minY, region.maxX, region.maxY);
     }
 }
 
@@ -107,13 +148,24 @@ void RenderJob::repaintPageArea(double x1, double y1, double x2, double y2) cons
                       x + ceil_cast<int>(zoom * x2), y + ceil_cast<int>(zoom * y2));
 }
 
+void RenderJob::updateRenderCache() const {
+    // The cache only try_locks the drawing mutexes of the views it evicts, so it can be called with ours locked
+    this->view->xournal->getControl()->getRenderCache()->update(this->view, 0, RenderCache::PAGE_BUFFER,
+                                                               this->view->buffer.getByteSize());
+}
+
 void RenderJob::renderToBuffer(cairo_t* cr) const {
     DocumentView localView;
     localView.setMarkAudioStroke(this->view->getXournal()->getControl()->getToolHandler()->getToolType() ==
                                  TOOL_PLAY_OBJECT);
-    localView.setPdfCache(this->view->xournal->getCache());
-
-    std::lock_guard<Document> lock(*this->view->xournal->getDocument());
+    localView.setCacheContours(true);
+    // Keeps the cache alive if it is replaced while rendering
+    auto pdfCache = this->view->xournal->getCache();
+    localView.setPdfCache(pdfCache.get());
+
+    // Only lock the rendered page: modifications of other pages must not wait for us
+    std::shared_lock<Document> docLock(*this->view->xournal->getDocument());
+    std::shared_lock pageLock(this->view->page->getContentLock());
     localView.drawPage(this->view->page, cr, false);
 }
 
@@ -11,9 +11,13 @@
 
 #pragma once
 
+#include <vector>  // for vector
+
 #include <cairo.h>    // for cairo_surface_t
 #include <gtk/gtk.h>  // for GtkWidget
 
+#include "view/TiledBuffer.h"  // for TiledBuffer
+
 #include "Job.h"  // for Job, JobType
 
 class XojPageView;
@@ -41,10 +45,21 @@ private:
 
     void repaintPageArea(double x1, double y1, double x2, double y2) const;
 
-    void rerenderRectangle(xoj::util::Rectangle<double> const& rect);
+    void rerenderRectangle(xoj::util::Rectangle<double> const& rect, double zoom);
+
+    /**
+     * Renders the tiles of the page view's buffer, the tiles outside of the page are skipped
+     */
+    std::vector<xoj::view::TiledBuffer::RenderedTile> renderTiles(
+            std::vector<xoj::view::TiledBuffer::TileIndex> const& indices, double zoom) const;
 
     void renderToBuffer(cairo_t* cr) const;
 
+    /**
+     * Reports the memory used by the buffer of the view to the RenderCache. The drawing mutex has to be locked.
+     */
+    void updateRenderCache() const;
+
 private:
     XojPageView* view;
 };
@@ -1,7 +1,9 @@
 #include "Scheduler.h"
 
+#include <algorithm>  // for any_of, none_of, find_if, max
 #include <cinttypes>  // for PRId64
 #include <cstdint>    // for uint64_t
+#include <thread>     // for thread
 
 #include "control/jobs/Job.h"  // for Job, JOB_TYPE_RENDER
 #include "util/Assert.h"       // for xoj_assert
@@ -15,9 +17,14 @@
 #define SDEBUG(msg, ...)
 #endif
 
-Scheduler::Scheduler() {
+Scheduler::Scheduler(unsigned int threadCount) {
     this->name = "Scheduler";
 
+    if (threadCount == 0) {
+        threadCount = std::max(1U, std::thread::hardware_concurrency());
+    }
+    this->threadCount = threadCount;
+
     // Queue
     this->jobQueue[JOB_PRIORITY_URGENT] = &this->queueUrgent;
     this->jobQueue[JOB_PRIORITY_HIGH] = &this->queueHigh;
@@ -34,17 +41,23 @@ Scheduler::~Scheduler() {
 
     stop();
 
-    Job* job = nullptr;
-    while ((job = getNextJobUnlocked()) != nullptr) {
-        job->unref();
+    for (auto* queue: this->jobQueue) {
+        for (Job* job: *queue) {
+            job->unref();
+        }
+        queue->clear();
     }
 }
 
 void Scheduler::start() {
-    SDEBUG("Starting scheduler");
-    g_return_if_fail(this->thread == nullptr);
+    SDEBUG("Starting scheduler with %zu threads", this->threadCount);
+    g_return_if_fail(this->threads.empty());
 
-    this->thread = g_thread_new(name.c_str(), reinterpret_cast<GThreadFunc>(jobThreadCallback), this);
+    this->threads.reserve(this->threadCount);
+    for (size_t i = 0; i < this->threadCount; i++) {
+        this->threads.emplace_back(
+                g_thread_new(name.c_str(), reinterpret_cast<GThreadFunc>(jobThreadCallback), this));
+    }
 }
 
 void Scheduler::stop() {
@@ -53,14 +66,20 @@ void Scheduler::stop() {
     if (!this->threadRunning) {
         return;
     }
-    this->threadRunning = false;
+    {
+        std::lock_guard lock{this->jobQueueMutex};
+        this->threadRunning = false;
+    }
     this->jobQueueCond.notify_all();
 
-    if (this->thread) {
-        g_thread_join(this->thread);
+    for (GThread* thread: this->threads) {
+        g_thread_join(thread);
     }
+    this->threads.clear();
 }
 
+auto Scheduler::getThreadCount() const -> size_t { return this->threadCount; }
+
 void Scheduler::addJob(Job* job, JobPriority priority) {
     SDEBUG("Adding job...");
 
@@ -75,30 +94,52 @@ void Scheduler::addJob(Job* job, JobPriority priority) {
     this->jobQueueCond.notify_all();
 }
 
+auto Scheduler::isConcurrentJob(Job* job) -> bool {
+    JobType type = job->getType();
+    return type == JOB_TYPE_RENDER || type == JOB_TYPE_PREVIEW || type == JOB_TYPE_PDF_PREFETCH ||
+           type == JOB_TYPE_SELECTION || type == JOB_TYPE_SEARCH_INDEX;
+}
+
+auto Scheduler::isSourceRunningUnlocked(Job* job) const -> bool {
+    void* source = job->getSource();
+    if (source == nullptr) {
+        return false;
+    }
+    JobType type = job->getType();
+    return std::any_of(this->runningJobs.begin(), this->runningJobs.end(),
+                       [&](const RunningJob& r) { return r.type == type && r.source == source; });
+}
+
 auto Scheduler::getNextJobUnlocked(bool onlyNotRender, bool* hasRenderJobs) -> Job* {
-    Job* job = nullptr;
+    if (this->exclusiveJobRunning) {
+        return nullptr;
+    }
 
     for (size_t i = JOB_PRIORITY_URGENT; i < JOB_N_PRIORITIES; i++) {
         std::deque<Job*>& queue = *this->jobQueue[i];
 
-        if (onlyNotRender) {
-            for (auto it = queue.begin(); it != queue.end(); ++it) {
-                job = *it;
-
-                if (job->getType() != JOB_TYPE_RENDER) {
-                    queue.erase(it);
-                    return job;
-                }
+        for (auto it = queue.begin(); it != queue.end(); ++it) {
+            Job* job = *it;
+            xoj_assert(job != nullptr);
 
+            if (onlyNotRender && job->getType() == JOB_TYPE_RENDER) {
                 if (hasRenderJobs != nullptr) {
                     *hasRenderJobs = true;
                 }
+                continue;
             }
-        } else if (!queue.empty()) {
-            job = queue.front();
-            queue.pop_front();
-            xoj_assert(job != nullptr);
 
+            if (!isConcurrentJob(job)) {
+                if (!this->runningJobs.empty()) {
+                    // Wait for the pool to drain. Do not start anything behind this job, or it may starve.
+                    return nullptr;
+                }
+            } else if (isSourceRunningUnlocked(job)) {
+                // Keep jobs of the same source in order: another worker is still processing it
+                continue;
+            }
+
+            queue.erase(it);
             return job;
         }
     }
@@ -116,6 +157,23 @@ void Scheduler::lock() { this->schedulerMutex.lock(); }
  */
 void Scheduler::unlock() { this->schedulerMutex.unlock(); }
 
+void Scheduler::awaitSource(void* source, JobType type) {
+    std::unique_lock lock{this->jobQueueMutex};
+    this->jobFinishedCond.wait(lock, [&]() {
+        return std::none_of(this->runningJobs.begin(), this->runningJobs.end(),
+                            [&](const RunningJob& r) { return r.type == type && r.source == source; });
+    });
+}
+
+void Scheduler::awaitRunningJobs() {
+    std::unique_lock lock{this->jobQueueMutex};
+    const uint64_t last = this->lastTicket;
+    this->jobFinishedCond.wait(lock, [&]() {
+        return std::none_of(this->runningJobs.begin(), this->runningJobs.end(),
+                            [&](const RunningJob& r) { return r.ticket <= last; });
+    });
+}
+
 #define ZOOM_WAIT_US_TIMEOUT 300000  // 0.3s
 
 void Scheduler::blockRerenderZoom() { this->blockRenderZoomTime = g_get_monotonic_time() + ZOOM_WAIT_US_TIMEOUT; }
@@ -145,8 +203,8 @@ auto Scheduler::jobRenderThreadTimer(Scheduler* scheduler) -> bool {
 
 auto Scheduler::jobThreadCallback(Scheduler* scheduler) -> gpointer {
     while (scheduler->threadRunning) {
-        // lock the whole scheduler
-        std::unique_lock schedulerLock{scheduler->schedulerMutex};
+        // lock the whole scheduler (shared with the other workers)
+        std::shared_lock schedulerLock{scheduler->schedulerMutex};
         SDEBUG("Job Thread: Blocked scheduler.");
 
         bool onlyNonRenderJobs = false;
@@ -165,11 +223,16 @@ auto Scheduler::jobThreadCallback(Scheduler* scheduler) -> gpointer {
         }
 
         Job* job;
+        uint64_t ticket;
 
         {
             std::unique_lock jobLock{scheduler->jobQueueMutex};
             SDEBUG("Job Thread: Locked job queue.");
 
+            if (!scheduler->threadRunning) {
+                break;
+            }
+
             bool hasOnlyRenderJobs = false;
             job = scheduler->getNextJobUnlocked(onlyNonRenderJobs, &hasOnlyRenderJobs);
             if (job != nullptr) {
@@ -193,15 +256,27 @@ auto Scheduler::jobThreadCallback(Scheduler* scheduler) -> gpointer {
                 scheduler->jobQueueCond.wait(jobLock);
                 continue;
             }
+
+            ticket = ++scheduler->lastTicket;
+            scheduler->runningJobs.push_back({job, job->getType(), job->getSource(), ticket});
+            scheduler->exclusiveJobRunning = !isConcurrentJob(job);
         }
 
         // Run the job.
+        SDEBUG("do job: %" PRId64, (uint64_t)job);
+        job->execute();
+        job->unref();
+
         {
-            std::lock_guard lock{scheduler->jobRunningMutex};
-            SDEBUG("do job: %" PRId64, (uint64_t)job);
-            job->execute();
-            job->unref();
+            std::lock_guard jobLock{scheduler->jobQueueMutex};
+            auto& running = scheduler->runningJobs;
+            running.erase(std::find_if(running.begin(), running.end(),
+                                       [ticket](const RunningJob& r) { return r.ticket == ticket; }));
+            scheduler->exclusiveJobRunning = false;
         }
+        // Wake up workers waiting for the source or for the pool to drain, as well as awaitSource()/awaitRunningJobs()
+        scheduler->jobFinishedCond.notify_all();
+        scheduler->jobQueueCond.notify_all();
 
         SDEBUG("next");
     }
@@ -16,13 +16,16 @@
 #include <array>               // for array
 #include <atomic>              // for atomic
 #include <condition_variable>  // for condition_variable
+#include <cstdint>             // for uint64_t
 #include <deque>               // for deque
 #include <mutex>               // for mutex
+#include <shared_mutex>        // for shared_mutex
 #include <string>              // for string
+#include <vector>              // for vector
 
 #include <glib.h>  // for GThread, GTimeVal, gpointer
 
-class Job;
+#include "control/jobs/Job.h"  // for JobType
 
 /**
  * @file Scheduler.h
@@ -64,9 +67,19 @@ enum JobPriority {
 };
 
 
+/**
+ * A pool of worker threads processing Job%s by priority.
+ *
+ * Render and preview jobs run concurrently on all workers, but never two jobs for the same source at once.
+ * All other jobs (saving, exporting, ...) are exclusive: they start only once all running jobs are done and no other
+ * job starts while they are running.
+ */
 class Scheduler {
 public:
-    Scheduler();
+    /**
+     * @param threadCount The number of worker threads, 0 means one per available CPU core
+     */
+    explicit Scheduler(unsigned int threadCount = 1);
     virtual ~Scheduler();
 
 public:
@@ -84,7 +97,7 @@ public:
     void stop();
 
     /**
-     * Locks the complete scheduler
+     * Locks the complete scheduler: waits for all running jobs and prevents new ones from starting
      */
     void lock();
 
@@ -103,26 +116,91 @@ public:
      */
     void unblockRerenderZoom();
 
+    /**
+     * @return The number of worker threads
+     */
+    size_t getThreadCount() const;
+
 private:
     static auto jobThreadCallback(Scheduler* scheduler) -> gpointer;
+
+    /**
+     * Pops the next job which may be started right now. Must be called with jobQueueMutex held.
+     *
+     * @param onlyNotRender   Skip render jobs (used while zooming)
+     * @param hasRenderJobs   Set to true if render jobs were skipped
+     */
     auto getNextJobUnlocked(bool onlyNotRender = false, bool* hasRenderJobs = nullptr) -> Job*;
 
+    /**
+     * @return true if the job may run on the pool while other jobs are running. The jobs of the same type and source
+     * still run one at a time (see isSourceRunningUnlocked())
+     */
+    static bool isConcurrentJob(Job* job);
+
+    /**
+     * @return true if a job with the same type and source is currently running. Must be called with jobQueueMutex held.
+     */
+    bool isSourceRunningUnlocked(Job* job) const;
+
     static auto jobRenderThreadTimer(Scheduler* scheduler) -> bool;
 
 protected:
-    bool threadRunning = true;
+    /**
+     * Blocks until no job of the given type working on source is running anymore
+     */
+    void awaitSource(void* source, JobType type);
+
+    /**
+     * Blocks until all jobs which are running at the time of the call have finished
+     */
+    void awaitRunningJobs();
+
+protected:
+    std::atomic<bool> threadRunning = true;
 
-    GThread* thread = nullptr;
+    size_t threadCount;
+    std::vector<GThread*> threads{};
 
     std::condition_variable jobQueueCond{};
     std::mutex jobQueueMutex{};
-    std::mutex schedulerMutex{};
 
     /**
-     * This is need to be sure there is no job running if we delete a page.
+     * Held shared by each worker while it picks and runs a job, held exclusively by lock()
+     */
+    std::shared_mutex schedulerMutex{};
+
+    /**
+     * A job which is currently executed by a worker
+     */
+    struct RunningJob {
+        Job* job;
+        JobType type;
+        void* source;
+        uint64_t ticket;
+    };
+
+    /**
+     * The jobs currently being executed, guarded by jobQueueMutex.
+     * This is needed to be sure there is no job running if we delete a page.
      * If a job is, we may access deleted memory.
      */
-    std::mutex jobRunningMutex{};
+    std::vector<RunningJob> runningJobs{};
+
+    /**
+     * Whether an exclusive (non render / preview) job is running, guarded by jobQueueMutex
+     */
+    bool exclusiveJobRunning = false;
+
+    /**
+     * Sequence number of the last started job, guarded by jobQueueMutex
+     */
+    uint64_t lastTicket = 0;
+
+    /**
+     * Signaled each time a job finished
+     */
+    std::condition_variable jobFinishedCond{};
 
     /**
      * Jobs of each priority. New jobs
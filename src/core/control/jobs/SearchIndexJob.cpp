@@ -0,0 +1,79 @@
+#include "SearchIndexJob.h"
+
+#include <cstdint>  // for uint32_t
+#include <mutex>    // for lock_guard
+#include <string>   // for string
+#include <utility>  // for move
+
+#include "control/SearchIndex.h"    // for SearchIndexData
+#include "model/Element.h"          // for ELEMENT_TEXT
+#include "model/LazyPageContent.h"  // for LazyPageContent
+#include "model/Layer.h"            // for Layer
+#include "model/Text.h"             // for Text
+#include "pdf/base/XojPdfPage.h"    // for XojPdfPageSPtr
+#include "util/StringUtils.h"       // for StringUtils
+
+SearchIndexJob::SearchIndexJob(std::shared_ptr<SearchIndexData> data, const XojPdfDocument& pdf, size_t firstPdfPage,
+                               size_t endPdfPage, std::vector<LazyPage> lazyPages, bool completesIndex):
+        data(std::move(data)),
+        pdf(pdf),
+        firstPdfPage(firstPdfPage),
+        endPdfPage(endPdfPage),
+        lazyPages(std::move(lazyPages)),
+        completesIndex(completesIndex) {}
+
+SearchIndexJob::~SearchIndexJob() = default;
+
+auto SearchIndexJob::getSource() -> void* { return this->data.get(); }
+
+auto SearchIndexJob::getType() -> JobType { return JOB_TYPE_SEARCH_INDEX; }
+
+void SearchIndexJob::run() {
+    for (size_t i = this->firstPdfPage; i < this->endPdfPage; i++) {
+        if (this->data->cancelled) {
+            return;
+        }
+        indexPdfPage(i);
+    }
+    for (const LazyPage& page: this->lazyPages) {
+        if (this->data->cancelled) {
+            return;
+        }
+        indexLazyPage(page);
+    }
+
+    if (this->completesIndex) {
+        std::lock_guard lock(this->data->mutex);
+        this->data->complete = true;
+    }
+}
+
+void SearchIndexJob::indexPdfPage(size_t pdfPageNo) {
+    XojPdfPageSPtr page = this->pdf.getPage(pdfPageNo);
+    if (!page) {
+        return;
+    }
+    std::string text = StringUtils::toLowerCase(page->getText());
+
+    std::vector<uint32_t> trigrams = SearchIndexData::getTrigrams(text);
+
+    std::lock_guard lock(this->data->mutex);
+    this->data->addPdfPage(pdfPageNo, std::move(text), trigrams);
+}
+
+void SearchIndexJob::indexLazyPage(const LazyPage& page) {
+    std::vector<std::string> texts;
+    for (const auto& layer: page.second->load()) {
+        if (!layer->isVisible()) {
+            continue;
+        }
+        for (const Element* e: layer->getElementsView()) {
+            if (e->getType() == ELEMENT_TEXT) {
+                texts.push_back(StringUtils::toLowerCase(static_cast<const Text*>(e)->getText()));
+            }
+        }
+    }
+
+    std::lock_guard lock(this->data->mutex);
+    this->data->typedText[page.first] = std::move(texts);
+}
@@ -0,0 +1,67 @@
+/*
+ * Xournal++
+ *
+ * A job which extracts the text of a document for the search index
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <memory>   // for shared_ptr, weak_ptr
+#include <utility>  // for pair
+#include <vector>   // for vector
+
+#include "pdf/base/XojPdfDocument.h"  // for XojPdfDocument
+
+#include "Job.h"  // for Job, JobType
+
+class LazyPageContent;
+class SearchIndexData;
+class XojPage;
+
+/**
+ * @brief Fills a SearchIndexData with the text of some PDF pages, and the text elements of some pages not loaded yet
+ *
+ * A document is indexed by a series of such jobs (see XournalScheduler::addBuildSearchIndex()), so that the other jobs
+ * get the workers in between. They share the same source, and thus run one after the other, in order.
+ */
+class SearchIndexJob: public Job {
+public:
+    using LazyPage = std::pair<std::weak_ptr<XojPage>, std::shared_ptr<const LazyPageContent>>;
+
+    /**
+     * @param pdf A copy of the PDF document, kept alive even if the document changes in the meantime
+     * @param firstPdfPage, endPdfPage The range of PDF pages to index
+     * @param lazyPages Pages whose layers are not loaded, with their content
+     * @param completesIndex If this is the last job indexing the document
+     */
+    SearchIndexJob(std::shared_ptr<SearchIndexData> data, const XojPdfDocument& pdf, size_t firstPdfPage,
+                   size_t endPdfPage, std::vector<LazyPage> lazyPages, bool completesIndex);
+
+protected:
+    ~SearchIndexJob() override;
+
+public:
+    void* getSource() override;
+
+    void run() override;
+
+    JobType getType() override;
+
+private:
+    void indexPdfPage(size_t pdfPageNo);
+    void indexLazyPage(const LazyPage& page);
+
+private:
+    std::shared_ptr<SearchIndexData> data;
+    XojPdfDocument pdf;
+    size_t firstPdfPage;
+    size_t endPdfPage;
+    std::vector<LazyPage> lazyPages;
+    bool completesIndex;
+};
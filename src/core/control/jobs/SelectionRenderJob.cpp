@@ -0,0 +1,85 @@
+#include "SelectionRenderJob.h"
+
+#include <cmath>    // for abs
+#include <cstddef>  // for size_t
+#include <utility>  // for move
+
+#include "gui/XournalView.h"  // for XournalView
+#include "view/View.h"        // for Context, ElementView
+
+/// The elements drawn between two checks for a newer rendering
+static constexpr size_t ELEMENTS_PER_BATCH = 64;
+
+auto SelectionRenderParams::matches(const SelectionRenderParams& other) const -> bool {
+    return static_cast<int>(std::abs(width) * zoom) == static_cast<int>(std::abs(other.width) * other.zoom) &&
+           static_cast<int>(std::abs(height) * zoom) == static_cast<int>(std::abs(other.height) * other.zoom) &&
+           (width < 0) == (other.width < 0) && (height < 0) == (other.height < 0);
+}
+
+auto SelectionRenderParams::createContext() const -> xoj::util::CairoSPtr {
+    xoj::util::CairoSurfaceSPtr buffer(cairo_image_surface_create(CAIRO_FORMAT_ARGB32,
+                                                                  static_cast<int>(std::abs(width) * zoom),
+                                                                  static_cast<int>(std::abs(height) * zoom)),
+                                       xoj::util::adopt);
+    xoj::util::CairoSPtr cr(cairo_create(buffer.get()), xoj::util::adopt);
+
+    double fx = width / originalWidth;
+    double fy = height / originalHeight;
+    int dx = static_cast<int>(relativeX * zoom);
+    int dy = static_cast<int>(relativeY * zoom);
+
+    cairo_translate(cr.get(), fx < 0 ? -width * zoom : 0, fy < 0 ? -height * zoom : 0);
+    cairo_scale(cr.get(), fx, fy);
+    cairo_translate(cr.get(), -dx, -dy);
+    cairo_scale(cr.get(), zoom, zoom);
+    return cr;
+}
+
+SelectionRenderJob::SelectionRenderJob(std::shared_ptr<SelectionRenderTarget> target, std::vector<ElementPtr> elements,
+                                       const SelectionRenderParams& params, XournalView* xournal):
+        target(std::move(target)),
+        elements(std::move(elements)),
+        params(params),
+        xournal(xournal),
+        generation(this->target->generation) {}
+
+SelectionRenderJob::~SelectionRenderJob() = default;
+
+auto SelectionRenderJob::getSource() -> void* { return this->target.get(); }
+
+auto SelectionRenderJob::getType() -> JobType { return JOB_TYPE_SELECTION; }
+
+auto SelectionRenderJob::isCurrent() const -> bool { return this->target->generation == this->generation; }
+
+void SelectionRenderJob::run() {
+    if (!isCurrent()) {
+        return;
+    }
+
+    xoj::util::CairoSPtr cr = this->params.createContext();
+    auto context = xoj::view::Context::createDefault(cr.get());
+    for (size_t i = 0; i < this->elements.size(); i++) {
+        if (i % ELEMENTS_PER_BATCH == 0 && !isCurrent()) {
+            return;
+        }
+        xoj::view::ElementView::createFromElement(this->elements[i].get())->draw(context);
+    }
+    cairo_surface_flush(cairo_get_target(cr.get()));
+
+    {
+        std::lock_guard lock(this->target->mutex);
+        if (!isCurrent()) {
+            return;
+        }
+        this->target->buffer.reset(cairo_get_target(cr.get()), xoj::util::ref);
+        this->target->params = this->params;
+    }
+    callAfterRun();
+}
+
+void SelectionRenderJob::afterRun() {
+    // The generation only changes in the UI thread: if it still matches, the selection and its view still exist
+    if (isCurrent()) {
+        this->xournal->repaintSelection();
+    }
+}
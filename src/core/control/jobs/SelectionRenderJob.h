@@ -0,0 +1,108 @@
+/*
+ * Xournal++
+ *
+ * A job which rasterizes the content of a selection
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <atomic>  // for atomic
+#include <memory>  // for shared_ptr
+#include <mutex>   // for mutex
+#include <vector>  // for vector
+
+#include "model/Element.h"            // for ElementPtr
+#include "util/raii/CairoWrappers.h"  // for CairoSPtr, CairoSurfaceSPtr
+
+#include "Job.h"  // for Job, JobType
+
+class XournalView;
+
+/**
+ * @brief What the buffer of a selection is rendered for
+ */
+struct SelectionRenderParams {
+    /// The size of the selection in page units, negative if it is mirrored
+    double width;
+    double height;
+    double zoom;
+
+    /// The size of the elements when they were selected
+    double originalWidth;
+    double originalHeight;
+
+    /// The position of the elements when they were selected
+    double relativeX;
+    double relativeY;
+
+    /**
+     * @return If a buffer rendered for `other` can be painted without being rescaled
+     */
+    bool matches(const SelectionRenderParams& other) const;
+
+    /**
+     * Creates the buffer, and a context mapping the page coordinates of the elements to it
+     */
+    xoj::util::CairoSPtr createContext() const;
+};
+
+/**
+ * @brief The buffer of a selection, shared between the EditSelectionContents (in the UI thread) and its jobs
+ */
+class SelectionRenderTarget {
+public:
+    /// Incremented in the UI thread when the rendering in progress is obsolete: the jobs of older generations stop
+    std::atomic<unsigned int> generation = 0;
+
+    /// Protects the members below
+    std::mutex mutex;
+
+    /// The last buffer rendered by a job, not yet picked up by the selection
+    xoj::util::CairoSurfaceSPtr buffer;
+    SelectionRenderParams params{};
+};
+
+/**
+ * @brief Rasterizes the clones of the selected elements on a worker thread, and repaints the selection once done
+ */
+class SelectionRenderJob: public Job {
+public:
+    /**
+     * @param elements Clones of the elements, in the order they are drawn
+     * @param xournal The view to repaint when the buffer is ready
+     */
+    SelectionRenderJob(std::shared_ptr<SelectionRenderTarget> target, std::vector<ElementPtr> elements,
+                       const SelectionRenderParams& params, XournalView* xournal);
+
+protected:
+    ~SelectionRenderJob() override;
+
+public:
+    void* getSource() override;
+
+    void run() override;
+
+    JobType getType() override;
+
+protected:
+    void afterRun() override;
+
+private:
+    /**
+     * @return If the selection still waits for this rendering
+     */
+    bool isCurrent() const;
+
+private:
+    std::shared_ptr<SelectionRenderTarget> target;
+    std::vector<ElementPtr> elements;
+    SelectionRenderParams params;
+    XournalView* xournal;
+
+    unsigned int generation;
+};
@@ -1,19 +1,33 @@
 #include "XournalScheduler.h"
 
-#include <array>   // for array
-#include <deque>   // for _Deque_iterator, deque, operator!=
-#include <mutex>   // for lock_guard
-#include <string>  // for string
-
+#include <algorithm>  // for min
+#include <array>      // for array
+#include <cstddef>    // for size_t
+#include <deque>      // for _Deque_iterator, deque, operator!=
+#include <mutex>      // for lock_guard
+#include <string>     // for string
+#include <utility>    // for move
+#include <vector>     // for vector
+
+#include "control/SearchIndex.h"     // for SearchIndexData
 #include "control/jobs/Scheduler.h"  // for JOB_PRIORITY_URGENT, JOB_PRIORIT...
+#include "util/safe_casts.h"         // for as_signed
 
-#include "PreviewJob.h"  // for PreviewJob
-#include "RenderJob.h"   // for RenderJob
+#include "PdfPrefetchJob.h"      // for PdfPrefetchJob
+#include "PreviewJob.h"          // for PreviewJob
+#include "RenderJob.h"           // for RenderJob
+#include "SearchIndexJob.h"      // for SearchIndexJob
+#include "SelectionRenderJob.h"  // for SelectionRenderJob
 
 class SidebarPreviewBaseEntry;
 class XojPageView;
 
-XournalScheduler::XournalScheduler() { this->name = "XournalScheduler"; }
+/// The pages indexed by each SearchIndexJob
+static constexpr size_t SEARCH_INDEX_PAGES_PER_JOB = 16;
+
+XournalScheduler::XournalScheduler(unsigned int threadCount): Scheduler(threadCount) {
+    this->name = "XournalScheduler";
+}
 
 XournalScheduler::~XournalScheduler() = default;
 
@@ -26,6 +40,18 @@ void XournalScheduler::removeSidebar(SidebarPreviewBaseEntry* preview) {
 
 void XournalScheduler::removePage(XojPageView* view) { removeSource(view, JOB_TYPE_RENDER, JOB_PRIORITY_URGENT); }
 
+void XournalScheduler::removePdfCache(PdfCache* cache) {
+    removeSource(cache, JOB_TYPE_PDF_PREFETCH, JOB_PRIORITY_LOW, false);
+}
+
+void XournalScheduler::removeSelection(SelectionRenderTarget* target) {
+    removeSource(target, JOB_TYPE_SELECTION, JOB_PRIORITY_URGENT, false);
+}
+
+void XournalScheduler::removeSearchIndex(SearchIndexData* data) {
+    removeSource(data, JOB_TYPE_SEARCH_INDEX, JOB_PRIORITY_LOW, false);
+}
+
 void XournalScheduler::removeAllJobs() {
     std::lock_guard lock{this->jobQueueMutex};
 
@@ -36,10 +62,11 @@ void XournalScheduler::removeAllJobs() {
         while (it != queue.end()) {
             Job* job = *it;
 
-            // Only remove PREVIEW and RENDER jobs; we aren't
+            // Only remove PREVIEW, RENDER, PDF_PREFETCH and SEARCH_INDEX jobs; we aren't
             // responsible for other types of jobs.
             JobType type = job->getType();
-            if (type == JOB_TYPE_PREVIEW || type == JOB_TYPE_RENDER) {
+            if (type == JOB_TYPE_PREVIEW || type == JOB_TYPE_RENDER || type == JOB_TYPE_PDF_PREFETCH ||
+                type == JOB_TYPE_SEARCH_INDEX) {
                 job->deleteJob();
 
                 it = queue.erase(it);
@@ -53,7 +80,7 @@ void XournalScheduler::removeAllJobs() {
     }
 }
 
-void XournalScheduler::finishTask() { std::lock_guard lock{this->jobRunningMutex}; }
+void XournalScheduler::finishTask() { awaitRunningJobs(); }
 
 void XournalScheduler::removeSource(void* source, JobType type, JobPriority priority, bool awaitFinishTask) {
     {
@@ -77,10 +104,10 @@ void XournalScheduler::removeSource(void* source, JobType type, JobPriority prio
         }
     }
 
-    // wait until the last job is done
+    // wait until the last job working on "source" is done
     // we can be sure we don't access "source"
     if (awaitFinishTask) {
-        finishTask();
+        awaitSource(source, type);
     }
 }
 
@@ -117,3 +144,53 @@ void XournalScheduler::addRerenderPage(XojPageView* view) {
     addJob(job, JOB_PRIORITY_URGENT);
     job->unref();
 }
+
+void XournalScheduler::addPdfPrefetch(std::shared_ptr<PdfCache> cache, std::vector<size_t> pdfPages, double zoom,
+                                      int DPIScaling) {
+    // The pages around the previous current page are not needed anymore
+    removePdfCache(cache.get());
+
+    auto* job = new PdfPrefetchJob(std::move(cache), std::move(pdfPages), zoom, DPIScaling);
+    addJob(job, JOB_PRIORITY_LOW);
+    job->unref();
+}
+
+void XournalScheduler::addRenderSelection(std::shared_ptr<SelectionRenderTarget> target,
+                                          std::vector<ElementPtr> elements, const SelectionRenderParams& params,
+                                          XournalView* xournal) {
+    // The previous size of the selection is not needed anymore
+    removeSelection(target.get());
+
+    auto* job = new SelectionRenderJob(std::move(target), std::move(elements), params, xournal);
+    addJob(job, JOB_PRIORITY_URGENT);
+    job->unref();
+}
+
+void XournalScheduler::addBuildSearchIndex(std::shared_ptr<SearchIndexData> data, const XojPdfDocument& pdf,
+                                           std::vector<SearchIndexJob::LazyPage> lazyPages) {
+    const size_t pdfPageCount = pdf.getPageCount();
+    {
+        std::lock_guard lock(data->mutex);
+        data->pdfText.resize(pdfPageCount);
+    }
+
+    // One job per chunk of pages, so that the render jobs get the workers in between
+    size_t pdfPage = 0;
+    size_t lazyPage = 0;
+    bool last = false;
+    while (!last) {
+        const size_t endPdfPage = std::min(pdfPage + SEARCH_INDEX_PAGES_PER_JOB, pdfPageCount);
+        const size_t endLazyPage =
+                std::min(lazyPage + SEARCH_INDEX_PAGES_PER_JOB - (endPdfPage - pdfPage), lazyPages.size());
+        std::vector<SearchIndexJob::LazyPage> chunk(lazyPages.begin() + as_signed(lazyPage),
+                                                    lazyPages.begin() + as_signed(endLazyPage));
+        last = endPdfPage == pdfPageCount && endLazyPage == lazyPages.size();
+
+        auto* job = new SearchIndexJob(data, pdf, pdfPage, endPdfPage, std::move(chunk), last);
+        addJob(job, JOB_PRIORITY_LOW);
+        job->unref();
+
+        pdfPage = endPdfPage;
+        lazyPage = endLazyPage;
+    }
+}
@@ -13,16 +13,30 @@
 
 #pragma once
 
-#include "control/jobs/Job.h"  // for JobType
+#include <cstddef>  // for size_t
+#include <memory>   // for shared_ptr
+#include <vector>   // for vector
+
+#include "control/jobs/Job.h"             // for JobType
+#include "control/jobs/SearchIndexJob.h"  // for SearchIndexJob::LazyPage
+#include "model/Element.h"                // for ElementPtr
 
 #include "Scheduler.h"  // for JobPriority, Scheduler
 
+class PdfCache;
+class SearchIndexData;
+class SelectionRenderTarget;
 class SidebarPreviewBaseEntry;
 class XojPageView;
+class XournalView;
+struct SelectionRenderParams;
 
 class XournalScheduler: public Scheduler {
 public:
-    XournalScheduler();
+    /**
+     * @param threadCount The number of worker threads, 0 means one per available CPU core
+     */
+    explicit XournalScheduler(unsigned int threadCount);
     ~XournalScheduler() override;
 
 public:
@@ -32,6 +46,19 @@ public:
      */
     void removeSidebar(SidebarPreviewBaseEntry* preview);
     void removePage(XojPageView* view);
+    /**
+     * Removes the prefetching jobs of the cache which are not running yet. The running ones keep the cache alive.
+     */
+    void removePdfCache(PdfCache* cache);
+    /**
+     * Removes the renderings of a selection which are not running yet. The running ones stop on their own once the
+     * generation of the target changes.
+     */
+    void removeSelection(SelectionRenderTarget* target);
+    /**
+     * Removes the indexing of a document if it is not running yet. The running one stops once data is cancelled.
+     */
+    void removeSearchIndex(SearchIndexData* data);
 
     /**
      * Removes all PreviewJob%s / RenderJob%s scheduled to be run
@@ -42,13 +69,33 @@ public:
     void addRerenderPage(XojPageView* view);
 
     /**
-     * Blocks until all currently running Job%s have been executed
+     * Rasterizes PDF pages in advance, replacing the pages still waiting to be prefetched for the same cache
+     */
+    void addPdfPrefetch(std::shared_ptr<PdfCache> cache, std::vector<size_t> pdfPages, double zoom, int DPIScaling);
+
+    /**
+     * Rasterizes the elements of a selection, replacing the renderings of the same selection which have not started
+     * @param elements Clones of the selected elements
+     */
+    void addRenderSelection(std::shared_ptr<SelectionRenderTarget> target, std::vector<ElementPtr> elements,
+                            const SelectionRenderParams& params, XournalView* xournal);
+
+    /**
+     * Extracts the text of a document for a SearchIndex, with one job per chunk of pages. The jobs run alongside the
+     * render jobs, one at a time.
+     */
+    void addBuildSearchIndex(std::shared_ptr<SearchIndexData> data, const XojPdfDocument& pdf,
+                             std::vector<SearchIndexJob::LazyPage> lazyPages);
+
+    /**
+     * Blocks until all Job%s running at the time of the call have been executed
      */
     void finishTask();
 
 private:
     /**
-     * Remove source, e.g. if a page is removed they don't need to repaint
+     * Remove source, e.g. if a page is removed they don't need to repaint.
+     * If awaitFinishTask is set, blocks until no job working on source is running anymore.
      */
     void removeSource(void* source, JobType type, JobPriority priority, bool awaitFinishTask = true);
 
@@ -1,7 +1,7 @@
 #include "LayerController.h"
 
 #include <memory>   // for __shared_ptr_access, make...
-#include <utility>  // for move
+#include <utility>  // for move, as_const
 #include <vector>   // for vector
 
 #include "control/Control.h"                 // for Control
@@ -345,7 +345,7 @@ auto LayerController::getCurrentLayerName() const -> std::string {
 
     if (currentID == 0) {  // If is background
         return page->getBackgroundName();
-    } else if (auto layer = page->getSelectedLayer(); layer->hasName()) {
+    } else if (auto layer = std::as_const(*page).getSelectedLayer(); layer->hasName()) {
         return layer->getName();
     } else {
         return FS(_F("Layer {1}") % static_cast<long>(currentID));
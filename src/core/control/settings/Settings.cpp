@@ -187,9 +187,16 @@ void Settings::loadDefault() {
 
     this->pageRerenderThreshold = 5.0;
     this->pdfPageCacheSize = 10;
+    this->pdfPagePrefetch = 3U;
     this->preloadPagesBefore = 3U;
     this->preloadPagesAfter = 5U;
     this->eagerPageCleanup = true;
+    this->schedulerThreadCount = 0U;
+    this->lazyPageLoading = false;
+    this->lazyPageMemoryBudget = 256U;
+    this->renderCacheBudget = 512U;
+    this->thumbnailCacheSize = 64U;
+    this->undoMemoryLimit = 256U;
 
     this->selectionBorderColor = Colors::red;
     this->selectionMarkerColor = Colors::xopp_cornflowerblue;
@@ -535,12 +542,26 @@ void Settings::parseItem(xmlDocPtr doc, xmlNodePtr cur) {
         this->pageRerenderThreshold = g_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("pdfPageCacheSize")) == 0) {
         this->pdfPageCacheSize = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("pdfPagePrefetch")) == 0) {
+        this->pdfPagePrefetch = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("preloadPagesBefore")) == 0) {
         this->preloadPagesBefore = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("preloadPagesAfter")) == 0) {
         this->preloadPagesAfter = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("eagerPageCleanup")) == 0) {
         this->eagerPageCleanup = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("schedulerThreadCount")) == 0) {
+        this->schedulerThreadCount = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("lazyPageLoading")) == 0) {
+        this->lazyPageLoading = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("lazyPageMemoryBudget")) == 0) {
+        this->lazyPageMemoryBudget = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("renderCacheBudget")) == 0) {
+        this->renderCacheBudget = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("thumbnailCacheSize")) == 0) {
+        this->thumbnailCacheSize = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("undoMemoryLimit")) == 0) {
+        this->undoMemoryLimit = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("selectionBorderColor")) == 0) {
         this->selectionBorderColor = Color(g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10));
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("selectionMarkerColor")) == 0) {
@@ -1144,9 +1165,23 @@ void Settings::save() {
 
     SAVE_INT_PROP(pdfPageCacheSize);
     ATTACH_COMMENT("The count of rendered PDF pages which will be cached.");
+    SAVE_UINT_PROP(pdfPagePrefetch);
+    ATTACH_COMMENT("The count of PDF pages before and after the current one rendered in advance, 0 = disabled.");
     SAVE_UINT_PROP(preloadPagesBefore);
     SAVE_UINT_PROP(preloadPagesAfter);
     SAVE_BOOL_PROP(eagerPageCleanup);
+    SAVE_UINT_PROP(schedulerThreadCount);
+    ATTACH_COMMENT("The number of background rendering threads, 0 = one per CPU core.");
+    SAVE_BOOL_PROP(lazyPageLoading);
+    ATTACH_COMMENT("Only load the contents of the pages of .xopp files when they are first displayed.");
+    SAVE_UINT_PROP(lazyPageMemoryBudget);
+    ATTACH_COMMENT("The size in MiB above which contents loaded lazily are unloaded again, if they are unchanged.");
+    SAVE_UINT_PROP(renderCacheBudget);
+    ATTACH_COMMENT("The size in MiB of the rendered pages, PDF backgrounds and previews kept in memory.");
+    SAVE_UINT_PROP(thumbnailCacheSize);
+    ATTACH_COMMENT("The size in MiB of the page previews cached on disk, 0 to disable the cache.");
+    SAVE_UINT_PROP(undoMemoryLimit);
+    ATTACH_COMMENT("The size in MiB of the undo history above which its older steps are compressed, 0 for no limit.");
 
     SAVE_STRING_PROP(pageTemplate);
     ATTACH_COMMENT("Config for new pages");
@@ -2125,6 +2160,16 @@ void Settings::setPdfPageCacheSize(int size) {
     save();
 }
 
+auto Settings::getPdfPagePrefetch() const -> unsigned int { return this->pdfPagePrefetch; }
+
+void Settings::setPdfPagePrefetch(unsigned int n) {
+    if (this->pdfPagePrefetch == n) {
+        return;
+    }
+    this->pdfPagePrefetch = n;
+    save();
+}
+
 auto Settings::getPreloadPagesBefore() const -> unsigned int { return this->preloadPagesBefore; }
 
 void Settings::setPreloadPagesBefore(unsigned int n) {
@@ -2155,6 +2200,66 @@ void Settings::setEagerPageCleanup(bool b) {
     save();
 }
 
+auto Settings::getSchedulerThreadCount() const -> unsigned int { return this->schedulerThreadCount; }
+
+void Settings::setSchedulerThreadCount(unsigned int n) {
+    if (this->schedulerThreadCount == n) {
+        return;
+    }
+    this->schedulerThreadCount = n;
+    save();
+}
+
+auto Settings::isLazyPageLoading() const -> bool { return this->lazyPageLoading; }
+
+void Settings::setLazyPageLoading(bool lazy) {
+    if (this->lazyPageLoading == lazy) {
+        return;
+    }
+    this->lazyPageLoading = lazy;
+    save();
+}
+
+auto Settings::getLazyPageMemoryBudget() const -> unsigned int { return this->lazyPageMemoryBudget; }
+
+void Settings::setLazyPageMemoryBudget(unsigned int megabytes) {
+    if (this->lazyPageMemoryBudget == megabytes) {
+        return;
+    }
+    this->lazyPageMemoryBudget = megabytes;
+    save();
+}
+
+auto Settings::getRenderCacheBudget() const -> unsigned int { return this->renderCacheBudget; }
+
+void Settings::setRenderCacheBudget(unsigned int megabytes) {
+    if (this->renderCacheBudget == megabytes) {
+        return;
+    }
+    this->renderCacheBudget = megabytes;
+    save();
+}
+
+auto Settings::getThumbnailCacheSize() const -> unsigned int { return this->thumbnailCacheSize; }
+
+void Settings::setThumbnailCacheSize(unsigned int megabytes) {
+    if (this->thumbnailCacheSize == megabytes) {
+        return;
+    }
+    this->thumbnailCacheSize = megabytes;
+    save();
+}
+
+auto Settings::getUndoMemoryLimit() const -> unsigned int { return this->undoMemoryLimit; }
+
+void Settings::setUndoMemoryLimit(unsigned int megabytes) {
+    if (this->undoMemoryLimit == megabytes) {
+        return;
+    }
+    this->undoMemoryLimit = megabytes;
+    save();
+}
+
 auto Settings::getBorderColor() const -> Color { return this->selectionBorderColor; }
 
 void Settings::setBorderColor(Color color) {
@@ -399,6 +399,12 @@ public:
     int getPdfPageCacheSize() const;
     [[maybe_unused]] void setPdfPageCacheSize(int size);
 
+    /**
+     * Number of PDF pages before and after the current page rasterized in advance (0 = disabled)
+     */
+    unsigned int getPdfPagePrefetch() const;
+    [[maybe_unused]] void setPdfPagePrefetch(unsigned int n);
+
     unsigned int getPreloadPagesBefore() const;
     void setPreloadPagesBefore(unsigned int n);
 
@@ -408,6 +414,42 @@ public:
     bool isEagerPageCleanup() const;
     void setEagerPageCleanup(bool b);
 
+    /**
+     * Number of worker threads used by the scheduler for background jobs (0 = one per CPU core)
+     */
+    unsigned int getSchedulerThreadCount() const;
+    [[maybe_unused]] void setSchedulerThreadCount(unsigned int n);
+
+    /**
+     * If the layers of the pages are only loaded when first accessed, see LoadHandler::setLoadPagesLazily()
+     */
+    bool isLazyPageLoading() const;
+    [[maybe_unused]] void setLazyPageLoading(bool lazy);
+
+    /**
+     * Size in MiB of the pages loaded lazily above which unchanged pages are unloaded again
+     */
+    unsigned int getLazyPageMemoryBudget() const;
+    [[maybe_unused]] void setLazyPageMemoryBudget(unsigned int megabytes);
+
+    /**
+     * Size in MiB of the rendered page buffers, PDF pages and previews kept for repainting, see RenderCache
+     */
+    unsigned int getRenderCacheBudget() const;
+    [[maybe_unused]] void setRenderCacheBudget(unsigned int megabytes);
+
+    /**
+     * Size in MiB of the page previews cached on disk, 0 disables the cache, see ThumbnailCache
+     */
+    unsigned int getThumbnailCacheSize() const;
+    [[maybe_unused]] void setThumbnailCacheSize(unsigned int megabytes);
+
+    /**
+     * Size in MiB of the undo history above which its older steps are compressed, 0 for no limit, see UndoRedoHandler
+     */
+    unsigned int getUndoMemoryLimit() const;
+    [[maybe_unused]] void setUndoMemoryLimit(unsigned int megabytes);
+
     std::string const& getPageTemplate() const;
     void setPageTemplate(const std::string& pageTemplate);
 
@@ -982,6 +1024,11 @@ private:
      */
     int pdfPageCacheSize{};
 
+    /**
+     *  The count of PDF pages before and after the current one which are rasterized in advance
+     */
+    unsigned int pdfPagePrefetch{};
+
     /**
      *  Percentage by which the page's zoom must change
      * for PDF pages to re-render while zooming.
@@ -1183,6 +1230,33 @@ private:
      */
     bool eagerPageCleanup{};
 
+    /**
+     * The number of scheduler worker threads rendering pages and previews in parallel.
+     * 0 means one thread per available CPU core.
+     */
+    unsigned int schedulerThreadCount{};
+
+    /**
+     * Load the layers of the pages on demand, and the memory budget (MiB) of the layers loaded this way
+     */
+    bool lazyPageLoading{};
+    unsigned int lazyPageMemoryBudget{};
+
+    /**
+     * The memory budget (MiB) of the rendered images kept for repainting
+     */
+    unsigned int renderCacheBudget{};
+
+    /**
+     * The size (MiB) of the page previews cached on disk
+     */
+    unsigned int thumbnailCacheSize{};
+
+    /**
+     * The size (MiB) of the undo history above which its older steps are compressed
+     */
+    unsigned int undoMemoryLimit{};
+
     /**
      * Stabilizer related settings
      */
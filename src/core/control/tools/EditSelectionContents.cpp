@@ -2,14 +2,17 @@
 
 #include <algorithm>  // for min, max, transform
 #include <cmath>      // for abs, isnan
+#include <cstddef>    // for size_t
 #include <iterator>   // for back_insert_iterator
 #include <limits>     // for numeric_limits
 #include <memory>     // for make_unique, __shar...
-#include <utility>
+#include <mutex>      // for lock_guard
+#include <utility>    // for move
 
 #include <glib.h>  // for g_idle_add, g_sourc...
 
 #include "control/Control.h"                      // for Control
+#include "control/jobs/XournalScheduler.h"        // for XournalScheduler
 #include "control/settings/Settings.h"            // for Settings
 #include "control/tools/CursorSelectionType.h"    // for CURSOR_SELECTION_TO...
 #include "gui/PageView.h"                         // for XojPageView
@@ -44,6 +47,9 @@ class XojFont;
 using std::vector;
 using xoj::util::Rectangle;
 
+/// Selections with more elements are rendered on a worker thread, not to block the UI while they are moved around
+static constexpr size_t SYNC_RENDERING_MAX_ELEMENTS = 200;
+
 EditSelectionContents::EditSelectionContents(Rectangle<double> bounds, Rectangle<double> snappedBounds,
                                              const PageRef& sourcePage, Layer* sourceLayer, XojPageView* sourceView):
         originalBounds(bounds),
@@ -63,7 +69,7 @@ EditSelectionContents::~EditSelectionContents() {
         this->rescaleId = 0;
     }
 
-    deleteViewBuffer();
+    cancelRendering();
 }
 
 /**
@@ -328,10 +334,10 @@ void EditSelectionContents::fillUndoItem(DeleteUndoAction* undo) {
  * Callback to redrawing the buffer asynchron
  */
 auto EditSelectionContents::repaintSelection(EditSelectionContents* selection) -> bool {
-    // delete the selection buffer, force a redraw
-    selection->deleteViewBuffer();
-    selection->sourceView->getXournal()->repaintSelection();
     selection->rescaleId = 0;
+    if (selection->requestRendering(selection->pendingParams)) {
+        selection->sourceView->getXournal()->repaintSelection();
+    }
 
     return false;
 }
@@ -341,9 +347,52 @@ auto EditSelectionContents::repaintSelection(EditSelectionContents* selection) -
  * it will be recreated when the selection is painted next time
  */
 void EditSelectionContents::deleteViewBuffer() {
-    if (this->crBuffer) {
-        cairo_surface_destroy(this->crBuffer);
-        this->crBuffer = nullptr;
+    cancelRendering();
+    this->requestedParams.reset();
+    // Large selections keep showing the old buffer until the new one is rendered
+    this->bufferOutdated = true;
+}
+
+auto EditSelectionContents::requestRendering(const SelectionRenderParams& params) -> bool {
+    cancelRendering();
+    this->requestedParams = params;
+
+    if (this->selected.size() <= SYNC_RENDERING_MAX_ELEMENTS) {
+        xoj::util::CairoSPtr cr = params.createContext();
+        xoj::view::ElementContainerView view(this);
+        view.draw(xoj::view::Context::createDefault(cr.get()));
+
+        this->crBuffer.reset(cairo_get_target(cr.get()), xoj::util::ref);
+        this->bufferParams = params;
+        this->bufferOutdated = false;
+        return true;
+    }
+
+    // The job draws clones: the elements may be edited in the meantime. The points of the strokes are shared.
+    std::vector<ElementPtr> clones;
+    clones.reserve(this->selected.size());
+    for (const Element* e: this->selected) {
+        clones.emplace_back(e->clone());
+    }
+    XournalView* xournal = this->sourceView->getXournal();
+    xournal->getControl()->getScheduler()->addRenderSelection(this->renderTarget, std::move(clones), params, xournal);
+    return false;
+}
+
+void EditSelectionContents::cancelRendering() {
+    // The jobs still queued stop as soon as they start
+    this->renderTarget->generation++;
+
+    std::lock_guard lock(this->renderTarget->mutex);
+    this->renderTarget->buffer.reset();
+}
+
+void EditSelectionContents::takeRenderedBuffer() {
+    std::lock_guard lock(this->renderTarget->mutex);
+    if (this->renderTarget->buffer) {
+        this->crBuffer = std::move(this->renderTarget->buffer);
+        this->bufferParams = this->renderTarget->params;
+        this->bufferOutdated = false;
     }
 }
 
@@ -491,29 +540,33 @@ void EditSelectionContents::paint(cairo_t* cr, double x, double y, double rotati
         this->rotation = rotation;
     }
 
-    if (this->crBuffer == nullptr) {
-        this->crBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, static_cast<int>(std::abs(width) * zoom),
-                                                    static_cast<int>(std::abs(height) * zoom));
-        cairo_t* cr2 = cairo_create(this->crBuffer);
-
-        int dx = static_cast<int>(this->relativeX * zoom);
-        int dy = static_cast<int>(this->relativeY * zoom);
-
-        cairo_translate(cr2, fx < 0 ? -width * zoom : 0, fy < 0 ? -height * zoom : 0);
-        cairo_scale(cr2, fx, fy);
-        cairo_translate(cr2, -dx, -dy);
-        cairo_scale(cr2, zoom, zoom);
-
-        xoj::view::ElementContainerView view(this);
-        view.draw(xoj::view::Context::createDefault(cr2));
+    // The buffer does not depend on the position nor on the rotation (applied by the caller): moving the selection
+    // only paints it elsewhere
+    SelectionRenderParams params{width, height, zoom, this->originalBounds.width, this->originalBounds.height,
+                                 this->relativeX, this->relativeY};
+    takeRenderedBuffer();
+    bool upToDate = this->crBuffer && !this->bufferOutdated && this->bufferParams.matches(params);
+    bool requested = this->requestedParams && this->requestedParams->matches(params);
+    if (!upToDate && !requested) {
+        this->pendingParams = params;
+        if (!this->crBuffer || (this->bufferOutdated && this->selected.size() <= SYNC_RENDERING_MAX_ELEMENTS)) {
+            // Nothing to show meanwhile
+            requestRendering(params);
+        } else if (!this->rescaleId) {
+            // Rendered once the user pauses, the current buffer is scaled until then
+            this->rescaleId = g_idle_add(xoj::util::wrap_v<repaintSelection>, this);
+        }
+    }
 
-        cairo_destroy(cr2);
+    if (!this->crBuffer) {
+        // A large selection, rendered in the background
+        return;
     }
 
     cairo_save(cr);
 
-    int wImg = cairo_image_surface_get_width(this->crBuffer);
-    int hImg = cairo_image_surface_get_height(this->crBuffer);
+    int wImg = cairo_image_surface_get_width(this->crBuffer.get());
+    int hImg = cairo_image_surface_get_height(this->crBuffer.get());
 
     int wTarget = static_cast<int>(std::abs(width) * zoom);
     int hTarget = static_cast<int>(std::abs(height) * zoom);
@@ -521,17 +574,14 @@ void EditSelectionContents::paint(cairo_t* cr, double x, double y, double rotati
     double sx = static_cast<double>(wTarget) / wImg;
     double sy = static_cast<double>(hTarget) / hImg;
 
-    if (wTarget != wImg || hTarget != hImg || std::abs(rotation) > std::numeric_limits<double>::epsilon()) {
-        if (!this->rescaleId) {
-            this->rescaleId = g_idle_add(xoj::util::wrap_v<repaintSelection>, this);
-        }
+    if (wTarget != wImg || hTarget != hImg) {
         cairo_scale(cr, sx, sy);
     }
 
     double dx = static_cast<int>(std::min(x, x + width) * zoom / sx);
     double dy = static_cast<int>(std::min(y, y + height) * zoom / sy);
 
-    cairo_set_source_surface(cr, this->crBuffer, dx, dy);
+    cairo_set_source_surface(cr, this->crBuffer.get(), dx, dy);
     cairo_paint(cr);
 
     cairo_restore(cr);
@@ -11,22 +11,24 @@
 
 #pragma once
 
-#include <memory>   // for unique_ptr
-#include <utility>  // for pair
-#include <vector>   // for vector
+#include <memory>    // for shared_ptr, unique_ptr
+#include <optional>  // for optional
+#include <utility>   // for pair
+#include <vector>    // for vector
 
 #include <cairo.h>  // for cairo_surface_t, cairo_t
 
-#include "control/ToolEnums.h"               // for ToolSize
-#include "model/Element.h"                   // for Element::Index, Element
-#include "model/ElementContainer.h"          // for ElementContainer
-#include "model/ElementInsertionPosition.h"  // for InsertionOrder
-#include "model/PageRef.h"                   // for PageRef
-#include "undo/UndoAction.h"                 // for UndoAction (ptr only)
-#include "util/Color.h"                      // for Color
-#include "util/PointerContainerView.h"       // for PointerContainerView
-#include "util/Rectangle.h"                  // for Rectangle
-#include "util/serializing/Serializable.h"   // for Serializable
+#include "control/ToolEnums.h"                // for ToolSize
+#include "control/jobs/SelectionRenderJob.h"  // for SelectionRenderParams, SelectionRenderTarget
+#include "model/Element.h"                    // for Element::Index, Element
+#include "model/ElementContainer.h"           // for ElementContainer
+#include "model/ElementInsertionPosition.h"   // for InsertionOrder
+#include "model/PageRef.h"                    // for PageRef
+#include "undo/UndoAction.h"                  // for UndoAction (ptr only)
+#include "util/Color.h"                       // for Color
+#include "util/PointerContainerView.h"        // for PointerContainerView
+#include "util/Rectangle.h"                   // for Rectangle
+#include "util/serializing/Serializable.h"    // for Serializable
 
 #include "CursorSelectionType.h"  // for CursorSelectionType
 
@@ -139,6 +141,22 @@ private:
      */
     static auto repaintSelection(EditSelectionContents* selection) -> bool;
 
+    /**
+     * Renders the buffer for the given parameters: small selections right away, large ones on a worker thread
+     * @return If the buffer has been rendered synchronously
+     */
+    bool requestRendering(const SelectionRenderParams& params);
+
+    /**
+     * Drops the rendering in progress, its result would be outdated
+     */
+    void cancelRendering();
+
+    /**
+     * Takes the buffer rendered by the last job, if any
+     */
+    void takeRenderedBuffer();
+
 public:
     /**
      * Gets the original view of the contents
@@ -206,9 +224,26 @@ private:
     InsertionOrder insertionOrder;
 
     /**
-     * The rendered elements
+     * The rendered elements, scaled to the current size of the selection until it is rendered again
+     */
+    xoj::util::CairoSurfaceSPtr crBuffer;
+    SelectionRenderParams bufferParams{};
+
+    /**
+     * The elements have changed since crBuffer was rendered
+     */
+    bool bufferOutdated = false;
+
+    /**
+     * The rendering in progress, to not request it again, and the one to request once idle
+     */
+    std::optional<SelectionRenderParams> requestedParams;
+    SelectionRenderParams pendingParams{};
+
+    /**
+     * Receives the buffers rendered by the SelectionRenderJob%s
      */
-    cairo_surface_t* crBuffer = nullptr;
+    std::shared_ptr<SelectionRenderTarget> renderTarget = std::make_shared<SelectionRenderTarget>();
 
     /**
      * The source id for the rescaling task
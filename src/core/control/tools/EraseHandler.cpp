@@ -1,8 +1,10 @@
 #include "EraseHandler.h"
 
-#include <memory>   // for make_unique, unique_ptr
-#include <utility>  // for move
-#include <vector>   // for vector
+#include <memory>        // for make_unique, unique_ptr
+#include <mutex>         // for lock_guard
+#include <shared_mutex>  // for shared_lock
+#include <utility>       // for move, pair
+#include <vector>        // for vector
 
 #include <gdk/gdk.h>  // for GdkRectangle
 #include <glib.h>     // for gint
@@ -24,6 +26,7 @@
 #include "undo/EraseUndoAction.h"             // for EraseUndoAction
 #include "undo/UndoRedoHandler.h"             // for UndoRedoHandler
 #include "util/Range.h"                       // for Range
+#include "util/Rectangle.h"                   // for Rectangle
 #include "util/SmallVector.h"                 // for SmallVector
 
 EraseHandler::EraseHandler(UndoRedoHandler* undo, Document* doc, const PageRef& page, ToolHandler* handler,
@@ -39,7 +42,9 @@ EraseHandler::EraseHandler(UndoRedoHandler* undo, Document* doc, const PageRef&
         halfEraserSize(0) {}
 
 EraseHandler::~EraseHandler() {
-    if (this->eraseDeleteUndoAction) {
+    if (this->eraseDeleteUndoAction || this->eraseUndoAction || !this->motionBuffer.empty()) {
+        // The gesture was not finalized, e.g. the page view is deleted while erasing
+        std::lock_guard<Document> lock(*this->doc);
         this->finalize();
     }
 }
@@ -55,30 +60,31 @@ void EraseHandler::erase(double x, double y, size_t timestamp) {
     Range range(x, y);
 
     Layer* l = page->getSelectedLayer();
-    
+
     // Record eraser motion if motion export is enabled
     bool recordingEnabled = settings && settings->getMotionExportEnabled();
     if (recordingEnabled) {
         Point eraserPoint(x, y, -1.0);  // No pressure for eraser
-        this->doc->lock();
-        size_t pageIndex = this->doc->indexOf(page);
-        this->doc->getEraserMotionRecording().addMotionPoint(eraserPoint, timestamp, halfEraserSize * 2, pageIndex);
-        this->doc->unlock();
+        this->motionBuffer.emplace_back(eraserPoint, timestamp, halfEraserSize * 2);
     }
 
-    size_t strokeIndex = 0;
-    for (Element* e: xoj::refElementContainer(l->getElements())) {
+    // Only the strokes close to the eraser are candidates: use the spatial index of the layer
+    std::vector<std::pair<Stroke*, Element::Index>> candidates;
+    for (Element* e: l->getElementsInArea(xoj::util::Rectangle<double>(eraserRect.x, eraserRect.y, eraserRect.width,
+                                                                        eraserRect.height))) {
         if (e->getType() == ELEMENT_STROKE && e->intersectsArea(&eraserRect)) {
-            eraseStroke(l, dynamic_cast<Stroke*>(e), x, y, range);
-            
-            // Record which stroke was affected
-            if (recordingEnabled) {
-                this->doc->lock();
-                this->doc->getEraserMotionRecording().addAffectedStrokeToLast(strokeIndex);
-                this->doc->unlock();
-            }
+            // The recorded index is the position of the stroke before this eraser event
+            candidates.emplace_back(dynamic_cast<Stroke*>(e), recordingEnabled ? l->indexOf(e) : -1);
+        }
+    }
+
+    for (auto [s, strokeIndex]: candidates) {
+        eraseStroke(l, s, x, y, range);
+
+        // Record which stroke was affected
+        if (recordingEnabled && strokeIndex >= 0) {
+            this->motionBuffer.back().addAffectedStroke(static_cast<size_t>(strokeIndex));
         }
-        strokeIndex++;
     }
 
     this->view->rerenderRange(range);
@@ -94,9 +100,11 @@ void EraseHandler::eraseStroke(Layer* l, Stroke* s, double x, double y, Range& r
             }
 
             // delete the entire stroke
-            this->doc->lock();
-            auto [stroke, pos] = l->removeElement(s);
-            this->doc->unlock();
+            auto [stroke, pos] = [&]() {
+                std::shared_lock<Document> docLock(*this->doc);
+                std::lock_guard pageLock(this->page->getContentLock());
+                return l->removeElement(s);
+            }();
 
             if (pos == -1) {
                 return;
@@ -136,10 +144,12 @@ void EraseHandler::eraseStroke(Layer* l, Stroke* s, double x, double y, Range& r
                 this->undo->addUndoAction(std::move(eraseUndo));
             }
 
-            doc->lock();
-            erasable = new ErasableStroke(*s);
-            s->setErasable(erasable);
-            doc->unlock();
+            {
+                std::shared_lock<Document> docLock(*this->doc);
+                std::lock_guard pageLock(this->page->getContentLock());
+                erasable = new ErasableStroke(*s);
+                s->setErasable(erasable);
+            }
             this->eraseUndoAction->addOriginal(l, s, pos);
             erasable->beginErasure(intersectionParameters, range);
         }
@@ -165,4 +175,17 @@ void EraseHandler::finalize() {
     } else if (this->eraseDeleteUndoAction) {
         this->eraseDeleteUndoAction = nullptr;
     }
+    flushMotionRecording();
+}
+
+void EraseHandler::flushMotionRecording() {
+    if (this->motionBuffer.empty()) {
+        return;
+    }
+    size_t pageIndex = this->doc->indexOf(this->page);
+    for (EraserMotionPoint& p: this->motionBuffer) {
+        p.pageIndex = pageIndex;
+    }
+    this->doc->getEraserMotionRecording().addMotionPoints(std::move(this->motionBuffer));
+    this->motionBuffer.clear();
 }
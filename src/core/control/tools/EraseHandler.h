@@ -12,8 +12,10 @@
 #pragma once
 
 #include <cstddef>  // for size_t
+#include <vector>   // for vector
 
-#include "model/PageRef.h"  // for PageRef
+#include "model/EraserMotionRecording.h"  // for EraserMotionPoint
+#include "model/PageRef.h"                // for PageRef
 
 class DeleteUndoAction;
 class Document;
@@ -30,6 +32,9 @@ class EraseHandler {
 public:
     EraseHandler(UndoRedoHandler* undo, Document* doc, const PageRef& page, ToolHandler* handler,
                  LegacyRedrawable* view, Settings* settings = nullptr);
+    /**
+     * Finalizes the gesture if finalize() was not called, locking the document: the document must not be locked
+     */
     virtual ~EraseHandler();
 
 public:
@@ -40,11 +45,21 @@ public:
      * @param timestamp Timestamp in milliseconds (for motion recording)
      */
     void erase(double x, double y, size_t timestamp = 0);
+
+    /**
+     * @brief End the gesture: finalizes the undo action and flushes the recorded motion to the document.
+     * The document has to be locked.
+     */
     void finalize();
 
 private:
     void eraseStroke(Layer* l, Stroke* s, double x, double y, Range& range);
 
+    /**
+     * @brief Append the motion recorded during the gesture to the recording of the document, which has to be locked
+     */
+    void flushMotionRecording();
+
 private:
     PageRef page;
     ToolHandler* handler;
@@ -58,6 +73,12 @@ private:
 
     double halfEraserSize;
 
+    /**
+     * The eraser motion of the current gesture. Only used by the input thread, so it is filled without locking the
+     * document, and flushed once at the end of the gesture. The page index is set when flushing.
+     */
+    std::vector<EraserMotionPoint> motionBuffer;
+
 private:
     /**
      * Coefficient for adding padding to the erased sections of strokes.
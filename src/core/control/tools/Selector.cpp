@@ -10,6 +10,7 @@
 #include "model/Document.h"        // for Document
 #include "model/Layer.h"           // for Layer
 #include "model/XojPage.h"         // for XojPage
+#include "util/Rectangle.h"        // for Rectangle
 #include "util/safe_casts.h"       // for as_unsigned
 
 Selector::Selector(bool multiLayer):
@@ -30,13 +31,11 @@ auto Selector::finalize(PageRef page, bool disableMultilayer, Document* doc) ->
                 continue;
             }
             bool selectionOnLayer = false;
-            Element::Index pos = 0;
-            for (const auto& e: l->getElementsView()) {
+            for (const auto* e: l->getElementsInArea(xoj::util::Rectangle<double>(this->bbox))) {
                 if (e->isInSelection(this)) {
-                    this->selectedElements.emplace_back(e, pos);
+                    this->selectedElements.emplace_back(e, l->indexOf(e));
                     selectionOnLayer = true;
                 }
-                pos++;
             }
             if (selectionOnLayer) {
                 layerId = layers.size() - as_unsigned(std::distance(layers.rbegin(), it));
@@ -46,13 +45,12 @@ auto Selector::finalize(PageRef page, bool disableMultilayer, Document* doc) ->
     } else {
         std::lock_guard lock(*doc);
         const Layer* l = page->getSelectedLayer();
-        Element::Index pos = 0;
-        for (const auto& e: l->getElementsView()) {
+        // Only the elements intersecting the bounding box of the selection can be selected
+        for (const auto* e: l->getElementsInArea(xoj::util::Rectangle<double>(this->bbox))) {
             if (e->isInSelection(this)) {
-                this->selectedElements.emplace_back(e, pos);
+                this->selectedElements.emplace_back(e, l->indexOf(e));
                 layerId = page->getSelectedLayerId();
             }
-            pos++;
         }
     }
 
@@ -1,11 +1,13 @@
 #include "StrokeHandler.h"
 
-#include <algorithm>  // for max, min
-#include <cmath>      // for ceil, pow, abs
-#include <limits>     // for numeric_limits
-#include <memory>     // for unique_ptr, mak...
-#include <utility>    // for move
-#include <vector>     // for vector
+#include <algorithm>     // for max, min
+#include <cmath>         // for ceil, pow, abs
+#include <limits>        // for numeric_limits
+#include <memory>        // for unique_ptr, mak...
+#include <mutex>         // for lock_guard
+#include <shared_mutex>  // for shared_lock
+#include <utility>       // for move
+#include <vector>        // for vector
 
 #include <gdk/gdk.h>  // for GdkEventKey
 
@@ -190,14 +192,14 @@ void StrokeHandler::onButtonReleaseEvent(const PositionInputData& pos, double zo
     Settings* settings = control->getSettings();
     if (settings->getEmptyLastPageAppend() == EmptyLastPageAppendType::OnDrawOfLastPage) {
         auto* doc = control->getDocument();
-        doc->lock();
+        doc->lock_shared();
         auto pdfPageCount = doc->getPdfPageCount();
-        doc->unlock();
+        doc->unlock_shared();
         if (pdfPageCount == 0) {
             auto currentPage = control->getCurrentPageNo();
-            doc->lock();
+            doc->lock_shared();
             auto lastPage = doc->getPageCount() - 1;
-            doc->unlock();
+            doc->unlock_shared();
             if (currentPage == lastPage) {
                 control->insertNewPage(currentPage + 1, false);
             }
@@ -219,9 +221,12 @@ void StrokeHandler::onButtonReleaseEvent(const PositionInputData& pos, double zo
 
     auto ptr = stroke.get();
     Document* doc = control->getDocument();
-    doc->lock();
-    layer->addElement(std::move(stroke));
-    doc->unlock();
+    {
+        // Only this page changes: do not wait for renderers of other pages
+        std::shared_lock<Document> docLock(*doc);
+        std::lock_guard pageLock(page->getContentLock());
+        layer->addElement(std::move(stroke));
+    }
 
     // Blitt the stroke to the page's buffer and delete all views.
     // Passing the empty Range() as no actual redrawing is necessary at this point
@@ -259,9 +264,11 @@ void StrokeHandler::strokeRecognizerDetected(std::unique_ptr<Stroke> recognized,
     undo->addUndoAction(std::make_unique<RecognizerUndoAction>(page, layer, std::move(stroke), recognizedPtr));
 
     Document* doc = control->getDocument();
-    doc->lock();
-    layer->addElement(std::move(recognized));
-    doc->unlock();
+    {
+        std::shared_lock<Document> docLock(*doc);
+        std::lock_guard pageLock(page->getContentLock());
+        layer->addElement(std::move(recognized));
+    }
 
     Range range(recognizedPtr->getX(), recognizedPtr->getY());
     range.addPoint(recognizedPtr->getX() + recognizedPtr->getElementWidth(),
@@ -0,0 +1,236 @@
+#include "XmlWriter.h"
+
+#include <algorithm>     // for min
+#include <array>         // for array
+#include <charconv>      // for to_chars
+#include <system_error>  // for errc
+
+#include <glib.h>  // for g_ascii_formatd, g_base64_encode_step, g_base64_encode_close
+
+#include "util/Assert.h"        // for xoj_assert
+#include "util/OutputStream.h"  // for OutputStream
+#include "util/Util.h"          // for PRECISION_FORMAT_STRING
+
+/// The buffer is handed to the stream once it is bigger than this
+static constexpr size_t FLUSH_THRESHOLD = 64 * 1024;
+
+/// Size of the chunks in which binary data is base64 encoded
+static constexpr size_t BASE64_CHUNK_SIZE = 48 * 1024;
+
+XmlWriter::XmlWriter(OutputStream* out): out(out) { this->buffer.reserve(FLUSH_THRESHOLD + BASE64_CHUNK_SIZE); }
+
+XmlWriter::~XmlWriter() = default;
+
+void XmlWriter::writeDeclaration() { this->buffer += "<?xml version=\"1.0\" standalone=\"no\"?>\n"; }
+
+void XmlWriter::startElement(const char* tag) {
+    if (!this->tags.empty()) {
+        closeStartTag(true);
+    }
+    this->buffer += '<';
+    this->buffer += tag;
+    this->tags.push_back(tag);
+    this->startTagOpen = true;
+}
+
+void XmlWriter::endElement() {
+    xoj_assert(!this->tags.empty());
+    finishBase64();
+    if (this->startTagOpen) {
+        this->buffer += "/>\n";
+        this->startTagOpen = false;
+    } else {
+        this->buffer += "</";
+        this->buffer += this->tags.back();
+        this->buffer += ">\n";
+    }
+    this->tags.pop_back();
+    flushIfFull();
+}
+
+void XmlWriter::closeStartTag(bool withChild) {
+    finishBase64();
+    if (this->startTagOpen) {
+        // Child elements start on a new line, content directly follows the tag
+        this->buffer += withChild ? ">\n" : ">";
+        this->startTagOpen = false;
+    }
+}
+
+void XmlWriter::writeAttribute(const char* name, const char* value) {
+    writeAttribute(name, std::string(value ? value : ""));
+}
+
+void XmlWriter::writeAttribute(const char* name, const std::string& value) {
+    xoj_assert(this->startTagOpen);
+    this->buffer += ' ';
+    this->buffer += name;
+    this->buffer += "=\"";
+    appendEscaped(value, true);
+    this->buffer += '"';
+}
+
+void XmlWriter::writeAttribute(const char* name, double value) {
+    xoj_assert(this->startTagOpen);
+    this->buffer += ' ';
+    this->buffer += name;
+    this->buffer += "=\"";
+    appendDouble(value);
+    this->buffer += '"';
+}
+
+void XmlWriter::writeAttribute(const char* name, int value) {
+    xoj_assert(this->startTagOpen);
+    this->buffer += ' ';
+    this->buffer += name;
+    this->buffer += "=\"";
+    std::array<char, 16> str{};
+    auto [end, ec] = std::to_chars(str.data(), str.data() + str.size(), value);
+    xoj_assert(ec == std::errc());
+    this->buffer.append(str.data(), end);
+    this->buffer += '"';
+}
+
+void XmlWriter::writeAttribute(const char* name, size_t value) {
+    xoj_assert(this->startTagOpen);
+    this->buffer += ' ';
+    this->buffer += name;
+    this->buffer += "=\"";
+    std::array<char, 24> str{};
+    auto [end, ec] = std::to_chars(str.data(), str.data() + str.size(), value);
+    xoj_assert(ec == std::errc());
+    this->buffer.append(str.data(), end);
+    this->buffer += '"';
+}
+
+void XmlWriter::writeAttribute(const char* name, const std::vector<double>& values) {
+    xoj_assert(this->startTagOpen);
+    this->buffer += ' ';
+    this->buffer += name;
+    this->buffer += "=\"";
+    bool first = true;
+    for (double v: values) {
+        if (!first) {
+            this->buffer += ' ';
+        }
+        first = false;
+        appendDouble(v);
+    }
+    this->buffer += '"';
+    flushIfFull();
+}
+
+void XmlWriter::writeText(const std::string& text) {
+    closeStartTag(false);
+    appendEscaped(text, false);
+    flushIfFull();
+}
+
+void XmlWriter::writeCoordinates(const std::vector<Point>& points) {
+    closeStartTag(false);
+    bool first = true;
+    for (const Point& p: points) {
+        if (!first) {
+            this->buffer += ' ';
+        }
+        first = false;
+        appendDouble(p.x);
+        this->buffer += ' ';
+        appendDouble(p.y);
+        flushIfFull();
+    }
+}
+
+void XmlWriter::writeBase64(const unsigned char* data, size_t length) {
+    closeStartTag(false);
+    if (!this->base64Open) {
+        this->base64Open = true;
+        this->base64State = 0;
+        this->base64Save = 0;
+    }
+    while (length > 0) {
+        const size_t chunk = std::min(length, BASE64_CHUNK_SIZE);
+        const size_t pos = this->buffer.size();
+        // See the documentation of g_base64_encode_step for the required size
+        this->buffer.resize(pos + (chunk / 3 + 1) * 4 + 4);
+        const gsize written = g_base64_encode_step(data, chunk, false, this->buffer.data() + pos,
+                                                   &this->base64State, &this->base64Save);
+        this->buffer.resize(pos + written);
+        data += chunk;
+        length -= chunk;
+        flushIfFull();
+    }
+}
+
+void XmlWriter::finishBase64() {
+    if (!this->base64Open) {
+        return;
+    }
+    std::array<char, 5> str{};
+    const gsize written = g_base64_encode_close(false, str.data(), &this->base64State, &this->base64Save);
+    this->buffer.append(str.data(), written);
+    this->base64Open = false;
+}
+
+auto XmlWriter::pngWriteFunction(XmlWriter* writer, const unsigned char* data, unsigned int length)
+        -> cairo_status_t {
+    writer->writeBase64(data, length);
+    return CAIRO_STATUS_SUCCESS;
+}
+
+void XmlWriter::writePng(cairo_surface_t* img) {
+    closeStartTag(false);
+    if (img == nullptr) {
+        g_error("XmlWriter::writePng(); img == nullptr");
+        return;
+    }
+    cairo_surface_write_to_png_stream(img, reinterpret_cast<cairo_write_func_t>(&pngWriteFunction), this);
+    finishBase64();
+}
+
+void XmlWriter::appendEscaped(const std::string& text, bool attribute) {
+    for (char c: text) {
+        switch (c) {
+            case '&':
+                this->buffer += "&amp;";
+                break;
+            case '<':
+                this->buffer += "&lt;";
+                break;
+            case '>':
+                this->buffer += "&gt;";
+                break;
+            case '"':
+                this->buffer += attribute ? "&quot;" : "\"";
+                break;
+            case '\n':
+                this->buffer += attribute ? "&#10;" : "\n";
+                break;
+            case '\r':
+                this->buffer += attribute ? "&#13;" : "\r";
+                break;
+            default:
+                this->buffer += c;
+        }
+    }
+}
+
+void XmlWriter::appendDouble(double value) {
+    std::array<char, G_ASCII_DTOSTR_BUF_SIZE> str{};
+    // g_ascii_ version uses C locale always.
+    g_ascii_formatd(str.data(), G_ASCII_DTOSTR_BUF_SIZE, Util::PRECISION_FORMAT_STRING, value);
+    this->buffer += str.data();
+}
+
+void XmlWriter::flushIfFull() {
+    if (this->buffer.size() >= FLUSH_THRESHOLD) {
+        flush();
+    }
+}
+
+void XmlWriter::flush() {
+    if (!this->buffer.empty()) {
+        this->out->write(this->buffer.data(), this->buffer.size());
+        this->buffer.clear();
+    }
+}
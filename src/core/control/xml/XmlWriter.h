@@ -0,0 +1,104 @@
+/*
+ * Xournal++
+ *
+ * Streaming XML writer
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include <cairo.h>  // for cairo_surface_t, cairo_status_t
+
+#include "model/Point.h"  // for Point
+
+class OutputStream;
+
+/**
+ * @brief Writes XML directly to an OutputStream, without building a tree in memory
+ *
+ * Elements are opened with startElement() and closed with endElement(). The attributes of an element must be written
+ * right after startElement(), before any child element or content. An element without any child nor content is written
+ * as an empty-element tag.
+ *
+ * The output is formatted into a reusable buffer, which is handed to the stream in large chunks.
+ */
+class XmlWriter {
+public:
+    explicit XmlWriter(OutputStream* out);
+    XmlWriter(const XmlWriter&) = delete;
+    XmlWriter& operator=(const XmlWriter&) = delete;
+    ~XmlWriter();
+
+public:
+    void writeDeclaration();
+
+    void startElement(const char* tag);
+    void endElement();
+
+    void writeAttribute(const char* name, const char* value);
+    void writeAttribute(const char* name, const std::string& value);
+    void writeAttribute(const char* name, double value);
+    void writeAttribute(const char* name, int value);
+    void writeAttribute(const char* name, size_t value);
+    void writeAttribute(const char* name, const std::vector<double>& values);
+
+    /**
+     * Writes escaped text as content of the current element
+     */
+    void writeText(const std::string& text);
+
+    /**
+     * Writes the coordinates of the points as content of the current element ("x1 y1 x2 y2 ...")
+     */
+    void writeCoordinates(const std::vector<Point>& points);
+
+    /**
+     * Writes binary data as base64 content of the current element.
+     * Consecutive calls are encoded as one single base64 string.
+     */
+    void writeBase64(const unsigned char* data, size_t length);
+
+    /**
+     * Writes the image as base64 encoded PNG content of the current element
+     */
+    void writePng(cairo_surface_t* img);
+
+    /**
+     * Hands the buffered output to the stream
+     */
+    void flush();
+
+private:
+    void closeStartTag(bool withChild);
+    void finishBase64();
+
+    void appendEscaped(const std::string& text, bool attribute);
+    void appendDouble(double value);
+    void flushIfFull();
+
+    static auto pngWriteFunction(XmlWriter* writer, const unsigned char* data, unsigned int length) -> cairo_status_t;
+
+private:
+    OutputStream* out;
+
+    std::string buffer;
+
+    /// Tags of the open elements
+    std::vector<const char*> tags;
+
+    /// If the start tag of the innermost element is not yet terminated
+    bool startTagOpen = false;
+
+    /// State of the base64 encoder, if a base64 content is being written
+    bool base64Open = false;
+    int base64State = 0;
+    int base64Save = 0;
+};
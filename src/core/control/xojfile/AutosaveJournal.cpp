@@ -0,0 +1,182 @@
+#include "AutosaveJournal.h"
+
+#include <fstream>        // for ifstream, ofstream
+#include <memory>         // for unique_ptr
+#include <optional>       // for optional
+#include <sstream>        // for istringstream, ostringstream
+#include <system_error>   // for error_code
+#include <unordered_map>  // for unordered_map
+#include <utility>        // for pair, move
+
+#include <glib.h>  // for g_warning, g_message
+
+#include "control/xojfile/LoadHandler.h"  // for LoadHandler
+#include "control/xojfile/SaveHandler.h"  // for SaveHandler
+#include "model/Document.h"               // for Document
+#include "model/PageRef.h"                // for PageRef
+#include "util/PathUtil.h"                // for readString
+#include "util/PlaceholderString.h"       // for PlaceholderString
+#include "util/StringUtils.h"             // for char_cast
+#include "util/i18n.h"                    // for FS, _F
+
+auto AutosaveJournal::getPath(const fs::path& autosaveFile) -> fs::path {
+    fs::path journal = autosaveFile;
+    journal += u8".journal";
+    return journal;
+}
+
+auto AutosaveJournal::append(const fs::path& journal, const Record& record, const Document* changedPages)
+        -> std::string {
+    // The pages are written as a regular .xopp file, which is then copied to the journal
+    fs::path tempfile = journal;
+    tempfile += u8"~";
+
+    SaveHandler handler;
+    handler.prepareSave(changedPages, journal);
+    handler.saveTo(tempfile);
+    if (!handler.getErrorMessage().empty()) {
+        return handler.getErrorMessage();
+    }
+
+    auto data = Util::readString(tempfile, false, std::ios::in | std::ios::binary);
+    std::error_code ec;
+    fs::remove(tempfile, ec);
+    if (!data) {
+        return FS(_F("Could not read \"{1}\"") % tempfile.u8string());
+    }
+
+    std::ostringstream header;
+    header << MAGIC << ' ' << data->size() << ' ' << record.pages.size();
+    for (PageId id: record.pages) {
+        header << ' ' << id;
+    }
+    header << ' ' << record.changedPages.size();
+    for (PageId id: record.changedPages) {
+        header << ' ' << id;
+    }
+    header << '\n';
+
+    std::ofstream out(journal, std::ios::out | std::ios::binary | std::ios::app);
+    out << header.str();
+    out.write(data->data(), static_cast<std::streamsize>(data->size()));
+    out.flush();
+    if (!out.good()) {
+        return FS(_F("Could not write \"{1}\"") % journal.u8string());
+    }
+    return {};
+}
+
+/**
+ * Reads the header line of a record
+ *
+ * @return The record and the size of the .xopp file following the header, std::nullopt if the header is invalid
+ */
+static auto readHeader(const std::string& line, const char* magic)
+        -> std::optional<std::pair<AutosaveJournal::Record, size_t>> {
+    std::istringstream in(line);
+    std::string tag;
+    size_t fileSize = 0;
+    size_t pageCount = 0;
+    if (!(in >> tag >> fileSize >> pageCount) || tag != magic) {
+        return std::nullopt;
+    }
+
+    AutosaveJournal::Record record;
+    record.pages.resize(pageCount);
+    for (auto& id: record.pages) {
+        if (!(in >> id)) {
+            return std::nullopt;
+        }
+    }
+    size_t changedCount = 0;
+    if (!(in >> changedCount)) {
+        return std::nullopt;
+    }
+    record.changedPages.resize(changedCount);
+    for (auto& id: record.changedPages) {
+        if (!(in >> id)) {
+            return std::nullopt;
+        }
+    }
+    return std::make_pair(std::move(record), fileSize);
+}
+
+auto AutosaveJournal::replay(Document* doc, const fs::path& journal) -> size_t {
+    std::ifstream in(journal, std::ios::in | std::ios::binary);
+    if (!in.is_open()) {
+        return 0;
+    }
+
+    std::unordered_map<PageId, PageRef> pagesById;
+    std::vector<PageRef> pages;
+    pages.reserve(doc->getPageCount());
+    for (size_t i = 0; i < doc->getPageCount(); i++) {
+        pages.push_back(doc->getPage(i));
+        pagesById.emplace(i, pages.back());
+    }
+
+    fs::path tempfile = journal;
+    tempfile += u8"~";
+
+    size_t applied = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        auto header = readHeader(line, MAGIC);
+        if (!header) {
+            g_warning("Invalid record in the autosave journal \"%s\"", char_cast(journal.u8string().c_str()));
+            break;
+        }
+        auto& [record, fileSize] = *header;
+
+        std::string data(fileSize, '\0');
+        if (!in.read(data.data(), static_cast<std::streamsize>(fileSize))) {
+            // The last record is incomplete
+            break;
+        }
+
+        {
+            std::ofstream out(tempfile, std::ios::out | std::ios::binary | std::ios::trunc);
+            out.write(data.data(), static_cast<std::streamsize>(data.size()));
+            if (!out.good()) {
+                break;
+            }
+        }
+        LoadHandler loader;
+        auto changed = loader.loadDocument(tempfile);
+        std::error_code ec;
+        fs::remove(tempfile, ec);
+        if (!changed || changed->getPageCount() != record.changedPages.size()) {
+            g_warning("Invalid record in the autosave journal \"%s\"", char_cast(journal.u8string().c_str()));
+            break;
+        }
+
+        for (size_t i = 0; i < record.changedPages.size(); i++) {
+            pagesById[record.changedPages[i]] = changed->getPage(i);
+        }
+
+        std::vector<PageRef> newPages;
+        newPages.reserve(record.pages.size());
+        for (PageId id: record.pages) {
+            auto it = pagesById.find(id);
+            if (it == pagesById.end()) {
+                break;
+            }
+            newPages.push_back(it->second);
+        }
+        if (newPages.size() != record.pages.size()) {
+            g_warning("Invalid record in the autosave journal \"%s\"", char_cast(journal.u8string().c_str()));
+            break;
+        }
+        pages = std::move(newPages);
+        applied++;
+    }
+
+    if (applied > 0) {
+        for (size_t i = doc->getPageCount(); i > 0; i--) {
+            doc->deletePage(i - 1);
+        }
+        doc->addPages(pages.begin(), pages.end());
+        g_message("Applied %zu records of the autosave journal", applied);
+    }
+    return applied;
+}
@@ -0,0 +1,70 @@
+/*
+ * Xournal++
+ *
+ * Journal of the changes made since an autosave
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include "filesystem.h"  // for path
+
+class Document;
+
+/**
+ * @brief Append-only log of the pages changed since the autosave file was written
+ *
+ * The journal is stored next to the autosave file (see getPath()). It is a sequence of records, each one describing
+ * the document at the time of an autosave:
+ *  - the ids of the pages of the document, in order,
+ *  - a complete .xopp file containing only the pages changed since the previous record.
+ *
+ * The pages of the autosave file have the ids 0 to n-1, pages inserted later get new ids.
+ *
+ * A record is made of one text line followed by the .xopp file:
+ *     xopp-journal <file size> <page count> <page ids...> <changed page count> <changed page ids...>\n
+ */
+class AutosaveJournal {
+public:
+    using PageId = size_t;
+
+    struct Record {
+        /// The ids of all the pages of the document, in order
+        std::vector<PageId> pages;
+
+        /// The ids of the changed pages, in the order they are stored in the record
+        std::vector<PageId> changedPages;
+    };
+
+    /**
+     * @return The path of the journal of the given autosave file
+     */
+    static fs::path getPath(const fs::path& autosaveFile);
+
+    /**
+     * Appends a record to the journal.
+     *
+     * @param changedPages A document containing only the changed pages, in the order of record.changedPages
+     * @return An error message, empty on success
+     */
+    static std::string append(const fs::path& journal, const Record& record, const Document* changedPages);
+
+    /**
+     * Applies the records of the journal to the document loaded from the autosave file. Reading stops at the first
+     * incomplete or invalid record (e.g. if Xournal++ crashed while writing it).
+     *
+     * @return The number of records applied
+     */
+    static size_t replay(Document* doc, const fs::path& journal);
+
+private:
+    static constexpr const char* MAGIC = "xopp-journal";
+};
@@ -0,0 +1,100 @@
+#include "LazyPageStore.h"
+
+#include <utility>  // for move
+#include <vector>   // for vector
+
+#include <glib.h>         // for g_file_open_tmp, g_warning
+#include <glib/gstdio.h>  // for g_close
+
+#include "model/Layer.h"      // for Layer
+#include "util/utf8_view.h"  // for utf8
+
+#include "LoadHandler.h"  // for LoadHandler
+
+/**
+ * The layers of one page, stored in the file of the store
+ */
+class LazyPageStore::Content final: public LazyPageContent {
+public:
+    Content(std::shared_ptr<LazyPageStore> store, uint64_t offset, size_t length):
+            store(std::move(store)), offset(offset), length(length) {}
+
+    auto load() const -> std::vector<std::unique_ptr<Layer>> override {
+        auto xml = this->store->read(this->offset, this->length);
+        if (!xml) {
+            g_warning("LazyPageStore: could not read the layers of a page from the temporary file");
+            return {};
+        }
+        LoadHandler handler;
+        return handler.loadLayers(*xml, this->store);
+    }
+
+    auto getSize() const -> size_t override { return this->length; }
+
+private:
+    std::shared_ptr<LazyPageStore> store;
+    uint64_t offset;
+    size_t length;
+};
+
+LazyPageStore::LazyPageStore(int fileVersion, bool isGzFile): fileVersion(fileVersion), gzFile(isGzFile) {}
+
+LazyPageStore::~LazyPageStore() {
+    if (this->file.is_open()) {
+        this->file.close();
+    }
+    if (!this->filepath.empty()) {
+        std::error_code ec;
+        fs::remove(this->filepath, ec);
+    }
+}
+
+auto LazyPageStore::open() -> bool {
+    GError* error = nullptr;
+    gchar* name = nullptr;
+    gint fd = g_file_open_tmp("xournalpp-pages-XXXXXX.xml", &name, &error);
+    if (fd == -1) {
+        g_warning("LazyPageStore: could not create a temporary file: %s", error->message);
+        g_error_free(error);
+        return false;
+    }
+    g_close(fd, nullptr);
+    this->filepath = fs::path(xoj::util::utf8(name));
+    g_free(name);
+
+    this->file.open(this->filepath, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+    return this->file.is_open();
+}
+
+auto LazyPageStore::add(std::string_view xml) -> std::shared_ptr<const LazyPageContent> {
+    std::lock_guard lock(this->fileMutex);
+    this->file.seekp(static_cast<std::streamoff>(this->size));
+    this->file.write(xml.data(), static_cast<std::streamsize>(xml.size()));
+    if (!this->file) {
+        this->file.clear();
+        return nullptr;
+    }
+    auto content = std::make_shared<Content>(shared_from_this(), this->size, xml.size());
+    this->size += xml.size();
+    return content;
+}
+
+auto LazyPageStore::read(uint64_t offset, size_t length) -> std::optional<std::string> {
+    std::lock_guard lock(this->fileMutex);
+    std::string xml(length, '\0');
+    this->file.seekg(static_cast<std::streamoff>(offset));
+    this->file.read(xml.data(), static_cast<std::streamsize>(length));
+    if (!this->file) {
+        this->file.clear();
+        return std::nullopt;
+    }
+    return xml;
+}
+
+auto LazyPageStore::getFileVersion() const -> int { return this->fileVersion; }
+
+auto LazyPageStore::isGzFile() const -> bool { return this->gzFile; }
+
+void LazyPageStore::setAudioFiles(std::map<std::string, fs::path> files) { this->audioFiles = std::move(files); }
+
+auto LazyPageStore::getAudioFiles() const -> const std::map<std::string, fs::path>& { return this->audioFiles; }
@@ -0,0 +1,91 @@
+/*
+ * Xournal++
+ *
+ * Keeps the layers of the pages loaded lazily until they are needed
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstdint>      // for uint64_t
+#include <fstream>      // for fstream
+#include <map>          // for map
+#include <memory>       // for shared_ptr, enable_shared_from_this
+#include <mutex>        // for mutex
+#include <optional>     // for optional
+#include <string>       // for string
+#include <string_view>  // for string_view
+
+#include "model/LazyPageContent.h"  // for LazyPageContent
+
+#include "filesystem.h"  // for path
+
+/**
+ * @brief Temporary file holding the XML of the layers of the pages skipped by a lazy load (see
+ * LoadHandler::setLoadPagesLazily())
+ *
+ * The XML of each page is appended to the file while the document is loaded. It is read again and parsed the first
+ * time the layers of a page are accessed, and every time after they have been unloaded.
+ *
+ * The store is shared by the contents it creates, the file is deleted once no page uses it anymore.
+ */
+class LazyPageStore final: public std::enable_shared_from_this<LazyPageStore> {
+public:
+    /**
+     * @param fileVersion The version of the loaded file
+     * @param isGzFile If the loaded file is an old .xoj file, where attachments are files next to it
+     */
+    LazyPageStore(int fileVersion, bool isGzFile);
+    LazyPageStore(const LazyPageStore&) = delete;
+    LazyPageStore& operator=(const LazyPageStore&) = delete;
+    ~LazyPageStore();
+
+public:
+    /**
+     * Creates the temporary file
+     *
+     * @return false on error, the pages then have to be loaded directly
+     */
+    bool open();
+
+    /**
+     * Appends the XML of the layers of a page
+     *
+     * @return The content to set to the page (see XojPage::setLazyContent()), nullptr on error
+     */
+    std::shared_ptr<const LazyPageContent> add(std::string_view xml);
+
+    /**
+     * Reads back XML appended by add()
+     */
+    std::optional<std::string> read(uint64_t offset, size_t length);
+
+    int getFileVersion() const;
+    bool isGzFile() const;
+
+    /**
+     * The audio attachments extracted while loading the document, by name in the .xopp file.
+     * Only set before the contents are used.
+     */
+    void setAudioFiles(std::map<std::string, fs::path> files);
+    const std::map<std::string, fs::path>& getAudioFiles() const;
+
+private:
+    class Content;
+
+    const int fileVersion;
+    const bool gzFile;
+
+    std::map<std::string, fs::path> audioFiles;
+
+    fs::path filepath;
+    std::fstream file;
+    uint64_t size = 0;
+
+    /// Guards file, pages are loaded from different threads
+    std::mutex fileMutex;
+};
@@ -2,9 +2,11 @@
 
 #include <algorithm>    // for copy
 #include <cmath>        // for isnan
+#include <cstddef>      // for ptrdiff_t
 #include <cstdlib>      // for atoi, size_t
 #include <cstring>      // for strcmp, strlen
 #include <iterator>     // for back_inserter
+#include <map>          // for map
 #include <memory>       // for __shared_ptr_access
 #include <regex>        // for regex_search, smatch
 #include <type_traits>  // for remove_reference<>::type
@@ -14,6 +16,7 @@
 #include <glib-object.h>  // for g_object_unref
 
 #include "control/pagetype/PageTypeHandler.h"  // for PageTypeHandler
+#include "control/xojfile/AutosaveJournal.h"   // for AutosaveJournal
 #include "model/BackgroundImage.h"             // for BackgroundImage
 #include "model/Font.h"                        // for XojFont
 #include "model/Image.h"                       // for Image
@@ -29,13 +32,16 @@
 #include "util/Assert.h"                       // for xoj_assert
 #include "util/GzUtil.h"                       // for GzUtil
 #include "util/LoopUtil.h"
+#include "util/NumberScanner.h"      // for NumberScanner
 #include "util/PlaceholderString.h"  // for PlaceholderString
+#include "util/ReadAheadStream.h"    // for ReadAheadStream
 #include "util/StringUtils.h"        // for char_cast
 #include "util/i18n.h"               // for _F, FC, FS, _
 #include "util/raii/GObjectSPtr.h"
 #include "util/safe_casts.h"  // for as_signed, as_unsigned
 #include "util/utf8_view.h"   // for utf8_view
 
+#include "LazyPageStore.h"      // for LazyPageStore
 #include "LoadHandlerHelper.h"  // for getAttrib, getAttribDo...
 
 using std::string;
@@ -53,6 +59,30 @@ using std::string;
 namespace {
 constexpr size_t MAX_VERSION_LENGTH = 50;
 constexpr size_t MAX_MIMETYPE_LENGTH = 25;
+
+constexpr std::string_view LAYER_START_TAG = "<layer";
+constexpr std::string_view PAGE_END_TAG = "</page";
+
+/**
+ * @return The position of the first occurrence of tag (e.g. "<layer", but not "<layers") in data. If data ends with
+ * the beginning of tag, which cannot be decided yet, the position of this beginning is returned too.
+ */
+auto findTag(std::string_view data, std::string_view tag) -> size_t {
+    for (size_t i = data.find('<'); i != std::string_view::npos; i = data.find('<', i + 1)) {
+        std::string_view rest = data.substr(i);
+        if (rest.size() <= tag.size()) {
+            if (tag.substr(0, rest.size()) == rest) {
+                return i;
+            }
+        } else if (rest.substr(0, tag.size()) == tag) {
+            char next = rest[tag.size()];
+            if (next == '>' || next == '/' || g_ascii_isspace(next)) {
+                return i;
+            }
+        }
+    }
+    return std::string_view::npos;
+}
 }  // namespace
 
 LoadHandler::LoadHandler():
@@ -104,6 +134,11 @@ void LoadHandler::initAttributes() {
     this->text = nullptr;
     this->pages.clear();
 
+    this->lazyPageStore = nullptr;
+    this->lazyLayers.clear();
+    this->skippingLayers = false;
+    this->lazyCarry.clear();
+
     if (this->audioFiles) {
         g_hash_table_unref(this->audioFiles);
     }
@@ -206,6 +241,7 @@ auto LoadHandler::readContentFile(char* buffer, zip_uint64_t len) -> zip_int64_t
     }
 
     xoj_assert(this->zipContentFile != nullptr);
+    std::lock_guard lock(this->zipMutex);
     zip_int64_t lengthRead = zip_fread(this->zipContentFile, buffer, len);
     if (lengthRead > 0) {
         return lengthRead;
@@ -228,20 +264,26 @@ auto LoadHandler::parseXml() -> bool {
     GMarkupParseContext* context =
             g_markup_parse_context_new(&parser, static_cast<GMarkupParseFlags>(0), this, nullptr);
 
-    zip_int64_t len = 0;
-    do {
-        char buffer[1024];
-        len = readContentFile(buffer, sizeof(buffer));
-        if (len > 0) {
-            valid = g_markup_parse_context_parse(context, buffer, len, &error);
+    {
+        // Decompress the file on another thread while parsing
+        xoj::util::ReadAheadStream content([this](char* buffer, size_t len) -> std::ptrdiff_t {
+            return readContentFile(buffer, len);
+        });
+        for (auto chunk = content.next(); !chunk.empty() && valid; chunk = content.next()) {
+            valid = this->loadPagesLazily ? parseChunkLazily(context, chunk) : parseChunk(context, chunk);
+
+            if (error) {
+                g_warning("LoadHandler::parseXml: %s\n", error->message);
+                valid = false;
+                break;
+            }
         }
+    }
 
-        if (error) {
-            g_warning("LoadHandler::parseXml: %s\n", error->message);
-            valid = false;
-            break;
-        }
-    } while (len >= 0 && valid && !error);
+    if (valid && (this->skippingLayers || !this->lazyCarry.empty())) {
+        // The file is cut off: let the parser report it
+        valid = parseChunk(context, this->lazyLayers + this->lazyCarry);
+    }
 
     if (valid) {
         valid = g_markup_parse_context_end_parse(context, &error);
@@ -274,6 +316,89 @@ auto LoadHandler::parseXml() -> bool {
     return valid;
 }
 
+auto LoadHandler::parseChunk(GMarkupParseContext* context, std::string_view chunk) -> bool {
+    return g_markup_parse_context_parse(context, chunk.data(), as_signed(chunk.size()), &error);
+}
+
+auto LoadHandler::parseChunkLazily(GMarkupParseContext* context, std::string_view chunk) -> bool {
+    std::string buffer = std::exchange(this->lazyCarry, {});
+    buffer += chunk;
+    std::string_view data = buffer;
+
+    while (!data.empty()) {
+        if (!this->loadPagesLazily) {
+            return parseChunk(context, data);
+        }
+
+        if (!this->skippingLayers) {
+            size_t layerStart = findTag(data, LAYER_START_TAG);
+            if (layerStart == std::string_view::npos) {
+                return parseChunk(context, data);
+            }
+            if (layerStart + LAYER_START_TAG.size() >= data.size()) {
+                // Maybe the start of a layer: decide with the next chunk
+                this->lazyCarry = data.substr(layerStart);
+                return parseChunk(context, data.substr(0, layerStart));
+            }
+            if (!parseChunk(context, data.substr(0, layerStart))) {
+                return false;
+            }
+            data.remove_prefix(layerStart);
+
+            if (this->pos == PARSER_POS_IN_PAGE) {
+                // Skip all the layers of the page, until its end
+                this->skippingLayers = true;
+            } else {
+                if (!parseChunk(context, data.substr(0, LAYER_START_TAG.size()))) {
+                    return false;
+                }
+                data.remove_prefix(LAYER_START_TAG.size());
+            }
+        } else {
+            size_t pageEnd = findTag(data, PAGE_END_TAG);
+            if (pageEnd == std::string_view::npos) {
+                this->lazyLayers += data;
+                return true;
+            }
+            this->lazyLayers += data.substr(0, pageEnd);
+            if (pageEnd + PAGE_END_TAG.size() >= data.size()) {
+                this->lazyCarry = data.substr(pageEnd);
+                return true;
+            }
+            data.remove_prefix(pageEnd);
+
+            this->skippingLayers = false;
+            if (!storeLazyLayers(context)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+auto LoadHandler::storeLazyLayers(GMarkupParseContext* context) -> bool {
+    std::string xml = std::exchange(this->lazyLayers, {});
+
+    // Attachments are read from the .xopp file, which is closed after loading: parse the layers now
+    if (xml.find("<attachment") == std::string::npos) {
+        if (!this->lazyPageStore) {
+            this->lazyPageStore = std::make_shared<LazyPageStore>(this->fileVersion, this->isGzFile);
+            if (!this->lazyPageStore->open()) {
+                g_warning("LoadHandler: could not load the pages lazily, loading them directly");
+                this->loadPagesLazily = false;
+            }
+        }
+        if (this->loadPagesLazily) {
+            if (auto content = this->lazyPageStore->add(xml)) {
+                this->page->setLazyContent(std::move(content));
+                return true;
+            }
+        }
+    }
+
+    return parseChunk(context, xml);
+}
+
 void LoadHandler::parseStart() {
     if (strcmp(elementName, "xournal") == 0) {
         endRootTag = "xournal";
@@ -562,13 +687,9 @@ void LoadHandler::parseStroke() {
         pressure = endPtr;
     }
 
-    while (*pressure != 0) {
-        char* tmpptr = nullptr;
-        double val = g_ascii_strtod(pressure, &tmpptr);
-        if (tmpptr == pressure) {
-            break;
-        }
-        pressure = tmpptr;
+    xoj::util::NumberScanner pressures(pressure);
+    this->pressureBuffer.reserve(pressures.countTokens());
+    for (double val = 0; pressures.readDouble(val);) {
         this->pressureBuffer.push_back(val);
     }
 
@@ -648,62 +769,42 @@ void LoadHandler::parseStroke() {
         size_t pointsParsed = 0;
         
         // Parse motion data: timestamp1,x1,y1,z1,isEraser1 timestamp2,x2,y2,z2,isEraser2 ...
-        const char* ptr = motionData;
-        while (*ptr != '\0') {
+        xoj::util::NumberScanner scanner(motionData);
+        while (!scanner.atEnd()) {
             size_t timestamp = 0;
             double x = 0.0, y = 0.0, z = 0.0;
-            int isEraser = 0;
-            
-            char* endPtr = nullptr;
-            timestamp = static_cast<size_t>(g_ascii_strtoull(ptr, &endPtr, 10));
-            if (endPtr == ptr || *endPtr != ',') {
+            size_t isEraser = 0;
+
+            if (!scanner.readUnsigned(timestamp) || !scanner.skip(',')) {
                 g_warning("%s", FC(_F("Motion recording parse error: invalid timestamp at position {1}") %
-                                   (ptr - motionData)));
+                                   scanner.position()));
                 break;
             }
-            ptr = endPtr + 1;
-            
-            x = g_ascii_strtod(ptr, &endPtr);
-            if (endPtr == ptr || *endPtr != ',') {
+            if (!scanner.readDouble(x) || !scanner.skip(',')) {
                 g_warning("%s", FC(_F("Motion recording parse error: invalid x coordinate at position {1}") %
-                                   (ptr - motionData)));
+                                   scanner.position()));
                 break;
             }
-            ptr = endPtr + 1;
-            
-            y = g_ascii_strtod(ptr, &endPtr);
-            if (endPtr == ptr || *endPtr != ',') {
+            if (!scanner.readDouble(y) || !scanner.skip(',')) {
                 g_warning("%s", FC(_F("Motion recording parse error: invalid y coordinate at position {1}") %
-                                   (ptr - motionData)));
+                                   scanner.position()));
                 break;
             }
-            ptr = endPtr + 1;
-            
-            z = g_ascii_strtod(ptr, &endPtr);
-            if (endPtr == ptr || *endPtr != ',') {
+            if (!scanner.readDouble(z) || !scanner.skip(',')) {
                 g_warning("%s", FC(_F("Motion recording parse error: invalid z coordinate at position {1}") %
-                                   (ptr - motionData)));
+                                   scanner.position()));
                 break;
             }
-            ptr = endPtr + 1;
-            
-            isEraser = static_cast<int>(g_ascii_strtoull(ptr, &endPtr, 10));
-            if (endPtr == ptr) {
+            if (!scanner.readUnsigned(isEraser)) {
                 g_warning("%s", FC(_F("Motion recording parse error: invalid isEraser flag at position {1}") %
-                                   (ptr - motionData)));
+                                   scanner.position()));
                 break;
             }
-            ptr = endPtr;
-            
-            // Skip whitespace
-            while (*ptr == ' ' || *ptr == '\t' || *ptr == '\n' || *ptr == '\r') {
-                ptr++;
-            }
-            
+
             motionRecording->addMotionPoint(Point(x, y, z), timestamp, isEraser != 0);
             pointsParsed++;
         }
-        
+
         if (motionRecording->hasMotionData()) {
             stroke->setMotionRecording(std::move(motionRecording));
         } else if (pointsParsed == 0) {
@@ -823,7 +924,7 @@ void LoadHandler::parseAttachment() {
             break;
         }
         case PARSER_POS_IN_TEXIMAGE: {
-            this->teximage->loadData(std::move(imgData), nullptr);
+            this->teximage->loadDataLazily(std::move(imgData), false);
             break;
         }
         default:
@@ -877,6 +978,7 @@ void LoadHandler::parseAudio() {
 
     GOutputStream* outputStream = g_io_stream_get_output_stream(G_IO_STREAM(fileStream));
 
+    std::lock_guard lock(this->zipMutex);
     zip_stat_t attachmentFileStat;
     int statStatus = zip_stat(this->zipFp, filename, 0, &attachmentFileStat);
     if (statStatus != 0) {
@@ -973,7 +1075,7 @@ void LoadHandler::parserEndElement(GMarkupParseContext* context, const gchar* el
         handler->pos = PASER_POS_FINISHED;
     } else if (handler->pos == PARSER_POS_IN_PAGE && strcmp(elementName, "page") == 0) {
         // handle unnecessary layer insertion in case of existing layers in file
-        if (handler->page->getLayerCount() == 0) {
+        if (handler->page->isContentLoaded() && handler->page->getLayerCount() == 0) {
             handler->page->addLayer(new Layer());
         }
         handler->pos = PARSER_POS_STARTED;
@@ -992,7 +1094,7 @@ void LoadHandler::parserEndElement(GMarkupParseContext* context, const gchar* el
         handler->pos = PARSER_POS_IN_LAYER;
         handler->text = nullptr;
     } else if (handler->pos == PARSER_POS_IN_IMAGE && strcmp(elementName, "image") == 0) {
-        xoj_assert_message(handler->image->getImage() != nullptr, "image can't be rendered");
+        xoj_assert_message(handler->image->hasData(), "image has no data");
         handler->pos = PARSER_POS_IN_LAYER;
         handler->image = nullptr;
     } else if (handler->pos == PARSER_POS_IN_TEXIMAGE && strcmp(elementName, "teximage") == 0) {
@@ -1078,30 +1180,22 @@ void LoadHandler::parserText(GMarkupParseContext* context, const gchar* text, gs
 
     auto* handler = static_cast<LoadHandler*>(userdata);
     if (handler->pos == PARSER_POS_IN_STROKE) {
-        const char* ptr = text;
-        int n = 0;
+        xoj::util::NumberScanner scanner(text, text + textLen);
+        std::vector<Point> points;
+        points.reserve(scanner.countTokens() / 2);
 
-        bool xRead = false;
+        size_t n = 0;
         double x = 0;
-
-        while (textLen > 0) {
-            double tmp = g_ascii_strtod(text, const_cast<char**>(&ptr));
-            if (ptr == text) {
+        double y = 0;
+        while (scanner.readDouble(x)) {
+            n++;
+            if (!scanner.readDouble(y)) {
                 break;
             }
-            textLen -= as_unsigned(ptr - text);
-            text = ptr;
             n++;
-
-            if (!xRead) {
-                xRead = true;
-                x = tmp;
-            } else {
-                xRead = false;
-                handler->stroke->addPoint(Point(x, tmp));
-            }
+            points.emplace_back(x, y);
         }
-        handler->stroke->freeUnusedPointItems();
+        handler->stroke->setPointVector(std::move(points));
 
         if (n < 4 || (n & 1)) {
             error2(*error, "%s", FC(_F("Wrong count of points ({1})") % n));
@@ -1137,28 +1231,14 @@ void LoadHandler::parserText(GMarkupParseContext* context, const gchar* text, gs
     }
 }
 
-auto LoadHandler::parseBase64(const gchar* base64, gsize length) -> string {
-    // We have to copy the string in order to null terminate it, sigh.
-    auto* base64data = static_cast<gchar*>(g_memdup(base64, static_cast<guint>(length) + 1));
-    base64data[length] = '\0';
-
-    gsize binaryBufferLen = 0;
-    guchar* binaryBuffer = g_base64_decode(base64data, &binaryBufferLen);
-    g_free(base64data);
-
-    string str = string(reinterpret_cast<char*>(binaryBuffer), binaryBufferLen);
-    g_free(binaryBuffer);
-
-    return str;
-}
-
 void LoadHandler::readImage(const gchar* base64string, gsize base64stringLen) {
     xoj_assert(this->image != nullptr);
     if (base64stringLen == 0 || (base64stringLen == 1 && base64string[0] == '\n') || this->image->hasData()) {
         return;
     }
 
-    this->image->setImage(parseBase64(const_cast<char*>(base64string), base64stringLen));
+    // Decoded when first rendered
+    this->image->setImageBase64(std::string(base64string, base64stringLen));
 }
 
 void LoadHandler::readTexImage(const gchar* base64string, gsize base64stringLen) {
@@ -1166,7 +1246,8 @@ void LoadHandler::readTexImage(const gchar* base64string, gsize base64stringLen)
         return;
     }
 
-    this->teximage->loadData(parseBase64(const_cast<char*>(base64string), base64stringLen));
+    // Decoded when first rendered
+    this->teximage->loadDataLazily(std::string(base64string, base64stringLen), true);
 }
 
 auto LoadHandler::loadDocument(fs::path const& filepath) -> std::unique_ptr<Document> {
@@ -1202,10 +1283,28 @@ auto LoadHandler::loadDocument(fs::path const& filepath) -> std::unique_ptr<Docu
 
     closeFile();
 
+    if (this->lazyPageStore) {
+        std::map<std::string, fs::path> audioFiles;
+        GHashTableIter iter;
+        gpointer name = nullptr;
+        gpointer tmpFilename = nullptr;
+        g_hash_table_iter_init(&iter, this->audioFiles);
+        while (g_hash_table_iter_next(&iter, &name, &tmpFilename)) {
+            audioFiles.emplace(static_cast<char*>(name), string(static_cast<char*>(tmpFilename)));
+        }
+        this->lazyPageStore->setAudioFiles(std::move(audioFiles));
+    }
+
+    // Changes made after the last complete autosave
+    if (auto journal = AutosaveJournal::getPath(filepath); fs::exists(journal)) {
+        AutosaveJournal::replay(this->doc.get(), journal);
+    }
+
     return std::move(this->doc);
 }
 
 auto LoadHandler::readZipAttachment(fs::path const& filename) -> std::unique_ptr<std::string> {
+    std::lock_guard lock(this->zipMutex);
     zip_stat_t attachmentFileStat;
     const int statStatus = zip_stat(this->zipFp, char_cast(filename.u8string().c_str()), 0, &attachmentFileStat);
     if (statStatus != 0) {
@@ -1252,9 +1351,53 @@ auto LoadHandler::getTempFileForPath(fs::path const& filename) -> fs::path {
     if (tmpFilename) {
         return string(static_cast<char*>(tmpFilename));
     }
+    if (this->lazyPageStore) {
+        // Loading the layers of a page skipped by a lazy load
+        const auto& files = this->lazyPageStore->getAudioFiles();
+        if (auto it = files.find(std::string(char_cast(filename.u8string()))); it != files.end()) {
+            return it->second;
+        }
+    }
 
     error("%s", FC(_F("Requested temporary file was not found for attachment {1}") % filename.u8string()));
     return "";
 }
 
 auto LoadHandler::getFileVersion() const -> int { return this->fileVersion; }
+
+void LoadHandler::setLoadPagesLazily(bool lazy) { this->loadPagesLazily = lazy; }
+
+auto LoadHandler::loadLayers(std::string_view xml, std::shared_ptr<LazyPageStore> store)
+        -> std::vector<std::unique_ptr<Layer>> {
+    initAttributes();
+    this->fileVersion = store->getFileVersion();
+    this->isGzFile = store->isGzFile();
+    this->lazyPageStore = std::move(store);
+
+    this->page = std::make_shared<XojPage>(0, 0, /*suppressLayer*/ true);
+    this->pos = PARSER_POS_IN_PAGE;
+
+    const GMarkupParser parser = {LoadHandler::parserStartElement, LoadHandler::parserEndElement,
+                                  LoadHandler::parserText, nullptr, nullptr};
+    GMarkupParseContext* context =
+            g_markup_parse_context_new(&parser, static_cast<GMarkupParseFlags>(0), this, nullptr);
+
+    // The layers are wrapped in an element ignored by parsePage(), as the parser expects a single root element
+    bool valid = parseChunk(context, "<layers>") && parseChunk(context, xml) && parseChunk(context, "</layers>") &&
+                 g_markup_parse_context_end_parse(context, &error);
+    if (!valid) {
+        g_warning("LoadHandler::loadLayers: %s", error != nullptr ? error->message : "Unknown parser error");
+    }
+    if (error != nullptr) {
+        g_error_free(error);
+        error = nullptr;
+    }
+    g_markup_parse_context_free(context);
+
+    std::vector<std::unique_ptr<Layer>> layers;
+    for (Layer* l: std::exchange(this->page->layer, {})) {
+        layers.emplace_back(l);
+    }
+    this->page = nullptr;
+    return layers;
+}
@@ -11,11 +11,13 @@
 
 #pragma once
 
-#include <cstddef>   // for size_t
-#include <memory>    // for unique_ptr
-#include <optional>  // for optional
-#include <string>    // for string
-#include <vector>    // for vector
+#include <cstddef>      // for size_t
+#include <memory>       // for unique_ptr, shared_ptr
+#include <mutex>        // for mutex
+#include <optional>     // for optional
+#include <string>       // for string
+#include <string_view>  // for string_view
+#include <vector>       // for vector
 
 #include <glib.h>     // for gchar, GError, gsize, GMarkupPars...
 #include <zip.h>      // for zip_file_t, zip_t
@@ -32,6 +34,7 @@
 
 class Image;
 class Layer;
+class LazyPageStore;
 class Stroke;
 class TexImage;
 class Text;
@@ -65,6 +68,20 @@ public:
     /** @return The version of the loaded file */
     int getFileVersion() const;
 
+    /**
+     * Only create the layers of the pages when they are first accessed (see XojPage::setLazyContent()), their XML is
+     * kept in a temporary file meanwhile. The layers of pages with attachments are always loaded directly.
+     */
+    void setLoadPagesLazily(bool lazy);
+
+    /**
+     * Parses the layers of a page skipped by a lazy load
+     *
+     * @param xml The XML of the layers, as in the loaded file
+     * @param store The store holding the skipped pages of the document
+     */
+    std::vector<std::unique_ptr<Layer>> loadLayers(std::string_view xml, std::shared_ptr<LazyPageStore> store);
+
 private:
     void parseStart();
     void parseContents();
@@ -85,6 +102,13 @@ private:
     bool closeFile();
     bool openFile(fs::path const& filepath);
     bool parseXml();
+    bool parseChunk(GMarkupParseContext* context, std::string_view chunk);
+
+    /**
+     * Same as parseChunk(), but the layers of the pages are stored in lazyPageStore instead of being parsed
+     */
+    bool parseChunkLazily(GMarkupParseContext* context, std::string_view chunk);
+    bool storeLazyLayers(GMarkupParseContext* context);
 
     void fixNullPressureValues();
     static void parserText(GMarkupParseContext* context, const gchar* text, gsize textLen, gpointer userdata,
@@ -107,8 +131,6 @@ private:
     void readTexImage(const gchar* base64string, gsize base64stringLen);
 
 private:
-    static std::string parseBase64(const gchar* base64, gsize length);
-
     /**
      * Returns the contents of the zip attachment with the given file name, or
      * nullopt if there is no such file.
@@ -134,6 +156,8 @@ private:
 
     zip_t* zipFp;
     zip_file_t* zipContentFile;
+    /// The content file is decompressed on another thread (see parseXml()), while attachments are read by the parser
+    std::mutex zipMutex;
     gzFile gzFp;
     bool isGzFile = false;
 
@@ -160,6 +184,15 @@ private:
     int loadedTimeStamp;
     std::string loadedFilename;
 
+    /// See setLoadPagesLazily()
+    bool loadPagesLazily = false;
+    std::shared_ptr<LazyPageStore> lazyPageStore;
+    /// The XML of the layers of the current page while they are skipped
+    std::string lazyLayers;
+    bool skippingLayers = false;
+    /// The end of the last chunk, if it may be the beginning of a tag searched by parseChunkLazily()
+    std::string lazyCarry;
+
     DocumentHandler dHanlder;
     std::unique_ptr<Document> doc;
 
@@ -1,21 +1,18 @@
 #include "SaveHandler.h"
 
-#include <cinttypes>   // for PRIx32
-#include <cstdint>     // for uint32_t
-#include <cstdio>      // for sprintf, size_t
-#include <sstream>     // for ostringstream
+#include <cinttypes>     // for PRIx32
+#include <cstdint>       // for uint32_t
+#include <cstdio>        // for sprintf, size_t
+#include <shared_mutex>  // for shared_lock
+#include <sstream>       // for ostringstream
 
 #include <cairo.h>                  // for cairo_surface_t
 #include <gdk-pixbuf/gdk-pixbuf.h>  // for gdk_pixbuf_save
 #include <glib.h>                   // for g_free, g_strdup_printf
 
+#include "control/jobs/ProgressListener.h"     // for ProgressListener
 #include "control/pagetype/PageTypeHandler.h"  // for PageTypeHandler
-#include "control/xml/XmlAudioNode.h"          // for XmlAudioNode
-#include "control/xml/XmlImageNode.h"          // for XmlImageNode
-#include "control/xml/XmlNode.h"               // for XmlNode
-#include "control/xml/XmlPointNode.h"          // for XmlPointNode
-#include "control/xml/XmlTexNode.h"            // for XmlTexNode
-#include "control/xml/XmlTextNode.h"           // for XmlTextNode
+#include "control/xml/XmlWriter.h"             // for XmlWriter
 #include "model/AudioElement.h"                // for AudioElement
 #include "model/BackgroundImage.h"             // for BackgroundImage
 #include "model/Document.h"                    // for Document
@@ -33,6 +30,7 @@
 #include "model/Text.h"                        // for Text
 #include "model/XojPage.h"                     // for XojPage
 #include "pdf/base/XojPdfDocument.h"           // for XojPdfDocument
+#include "util/Assert.h"                       // for xoj_assert
 #include "util/OutputStream.h"                 // for GzOutputStream, Output...
 #include "util/PathUtil.h"                     // for clearExtensions, normalizeAssetPath
 #include "util/PlaceholderString.h"            // for PlaceholderString
@@ -47,40 +45,16 @@ SaveHandler::SaveHandler() {
 }
 
 void SaveHandler::prepareSave(const Document* doc, const fs::path& target) {
-    if (this->root) {
-        // cleanup old data
-        backgroundImages.clear();
-    }
-
-    this->firstPdfPageVisited = false;
-    this->attachBgId = 1;
-
-    root.reset(new XmlNode("xournal"));
-
-    writeHeader();
-
-    cairo_surface_t* preview = doc->getPreview();
-    if (preview) {
-        auto* image = new XmlImageNode("preview");
-        image->setImage(preview);
-        this->root->addChild(image);
-    }
-
-    for (size_t i = 0; i < doc->getPageCount(); i++) {
-        PageRef p = doc->getPage(i);
-        p->getBackgroundImage().clearSaveState();
-    }
-
-    for (size_t i = 0; i < doc->getPageCount(); i++) {
-        PageRef p = doc->getPage(i);
-        visitPage(root.get(), p, doc, static_cast<int>(i), target);
-    }
+    this->doc = doc;
+    this->target = target;
 }
 
-void SaveHandler::writeHeader() {
-    this->root->setAttrib("creator", PROJECT_STRING);
-    this->root->setAttrib("fileversion", FILE_FORMAT_VERSION);
-    this->root->addChild(new XmlTextNode("title", std::string{"Xournal++ document - see "} + PROJECT_HOMEPAGE_URL));
+void SaveHandler::writeHeader(XmlWriter& xml) {
+    xml.writeAttribute("creator", PROJECT_STRING);
+    xml.writeAttribute("fileversion", FILE_FORMAT_VERSION);
+    xml.startElement("title");
+    xml.writeText(std::string{"Xournal++ document - see "} + PROJECT_HOMEPAGE_URL);
+    xml.endElement();
 }
 
 auto SaveHandler::getColorStr(Color c, unsigned char alpha) -> std::string {
@@ -90,75 +64,75 @@ auto SaveHandler::getColorStr(Color c, unsigned char alpha) -> std::string {
     return color;
 }
 
-void SaveHandler::writeTimestamp(XmlAudioNode* xmlAudioNode, const AudioElement* audioElement) {
+void SaveHandler::writeTimestamp(XmlWriter& xml, const AudioElement* audioElement) {
     if (!audioElement->getAudioFilename().empty()) {
-        /** set stroke timestamp value to the XmlPointNode */
-        xmlAudioNode->setAttrib("ts", audioElement->getTimestamp());
+        /** set stroke timestamp value to the element */
+        xml.writeAttribute("ts", audioElement->getTimestamp());
         auto audioFilename = audioElement->getAudioFilename().generic_u8string();
         auto casted = char_cast(audioFilename);
-        xmlAudioNode->setAttrib("fn", std::string{casted.begin(), casted.end()});
+        xml.writeAttribute("fn", std::string{casted.begin(), casted.end()});
     }
 }
 
-void SaveHandler::visitStroke(XmlPointNode* stroke, const Stroke* s) {
+void SaveHandler::visitStroke(XmlWriter& xml, const Stroke* s) {
     StrokeTool t = s->getToolType();
 
     unsigned char alpha = 0xff;
 
     if (t == StrokeTool::PEN) {
-        stroke->setAttrib("tool", "pen");
-        writeTimestamp(stroke, s);
+        xml.writeAttribute("tool", "pen");
+        writeTimestamp(xml, s);
     } else if (t == StrokeTool::ERASER) {
-        stroke->setAttrib("tool", "eraser");
+        xml.writeAttribute("tool", "eraser");
     } else if (t == StrokeTool::HIGHLIGHTER) {
-        stroke->setAttrib("tool", "highlighter");
+        xml.writeAttribute("tool", "highlighter");
         alpha = 0x7f;
     } else {
         g_warning("Unknown StrokeTool::Value");
-        stroke->setAttrib("tool", "pen");
+        xml.writeAttribute("tool", "pen");
     }
 
-    stroke->setAttrib("color", getColorStr(s->getColor(), alpha).c_str());
+    xml.writeAttribute("color", getColorStr(s->getColor(), alpha));
 
     const auto& pts = s->getPointVector();
 
-    stroke->setPoints(pts);
-
     if (s->hasPressure()) {
-        std::vector<double> values;
-        values.reserve(pts.size() + 1);
-        values.emplace_back(s->getWidth());
-        std::transform(pts.begin(), pts.end() - 1, std::back_inserter(values), [](const Point& p) { return p.z; });
-        stroke->setAttrib("width", std::move(values));
+        widthValues.clear();
+        widthValues.reserve(pts.size() + 1);
+        widthValues.emplace_back(s->getWidth());
+        std::transform(pts.begin(), pts.end() - 1, std::back_inserter(widthValues), [](const Point& p) { return p.z; });
+        xml.writeAttribute("width", widthValues);
     } else {
-        stroke->setAttrib("width", s->getWidth());
+        xml.writeAttribute("width", s->getWidth());
     }
 
-    visitStrokeExtended(stroke, s);
+    visitStrokeExtended(xml, s);
+
+    xml.writeCoordinates(pts);
 }
 
 /**
  * Export the fill attributes
  */
-void SaveHandler::visitStrokeExtended(XmlPointNode* stroke, const Stroke* s) {
+void SaveHandler::visitStrokeExtended(XmlWriter& xml, const Stroke* s) {
     if (s->getFill() != -1) {
-        stroke->setAttrib("fill", s->getFill());
+        xml.writeAttribute("fill", s->getFill());
     }
 
     const StrokeCapStyle capStyle = s->getStrokeCapStyle();
     if (capStyle == StrokeCapStyle::BUTT) {
-        stroke->setAttrib("capStyle", "butt");
+        xml.writeAttribute("capStyle", "butt");
     } else if (capStyle == StrokeCapStyle::ROUND) {
-        stroke->setAttrib("capStyle", "round");
+        xml.writeAttribute("capStyle", "round");
     } else if (capStyle == StrokeCapStyle::SQUARE) {
-        stroke->setAttrib("capStyle", "square");
+        xml.writeAttribute("capStyle", "square");
     } else {
         g_warning("Unknown stroke cap type: %i", capStyle);
-        stroke->setAttrib("capStyle", "round");
+        xml.writeAttribute("capStyle", "round");
     }
 
     if (s->getLineStyle().hasDashes()) {
-        stroke->setAttrib("style", StrokeStyle::formatStyle(s->getLineStyle()));
+        xml.writeAttribute("style", StrokeStyle::formatStyle(s->getLineStyle()));
     }
 
     // Export motion recording if present (for video rendering)
@@ -185,73 +159,79 @@ void SaveHandler::visitStrokeExtended(XmlPointNode* stroke, const Stroke* s) {
         
         std::string motionData = motionStream.str();
         if (!motionData.empty()) {
-            stroke->setAttrib("motion", motionData.c_str());
+            xml.writeAttribute("motion", motionData);
         }
     }
 }
 
-void SaveHandler::visitLayer(XmlNode* page, const Layer* l) {
-    auto* layer = new XmlNode("layer");
-    page->addChild(layer);
+void SaveHandler::visitLayer(XmlWriter& xml, const Layer* l) {
+    xml.startElement("layer");
     if (l->hasName()) {
-        layer->setAttrib("name", l->getName().c_str());
+        xml.writeAttribute("name", l->getName());
     }
 
     for (const auto& e: l->getElementsView()) {
         if (e->getType() == ELEMENT_STROKE) {
             auto* s = dynamic_cast<const Stroke*>(e);
-            auto* stroke = new XmlPointNode("stroke");
-            layer->addChild(stroke);
-            visitStroke(stroke, s);
+            xml.startElement("stroke");
+            visitStroke(xml, s);
+            xml.endElement();
         } else if (e->getType() == ELEMENT_TEXT) {
             const Text* t = dynamic_cast<const Text*>(e);
-            auto* text = new XmlTextNode("text", t->getText());
-            layer->addChild(text);
+            xml.startElement("text");
 
             const XojFont& f = t->getFont();
 
-            text->setAttrib("font", f.getName().c_str());
-            text->setAttrib("size", f.getSize());
-            text->setAttrib("x", t->getX());
-            text->setAttrib("y", t->getY());
-            text->setAttrib("color", getColorStr(t->getColor()).c_str());
+            xml.writeAttribute("font", f.getName());
+            xml.writeAttribute("size", f.getSize());
+            xml.writeAttribute("x", t->getX());
+            xml.writeAttribute("y", t->getY());
+            xml.writeAttribute("color", getColorStr(t->getColor()));
+
+            writeTimestamp(xml, t);
 
-            writeTimestamp(text, t);
+            xml.writeText(t->getText());
+            xml.endElement();
         } else if (e->getType() == ELEMENT_IMAGE) {
             auto* i = dynamic_cast<const Image*>(e);
-            auto* image = new XmlImageNode("image");
-            layer->addChild(image);
+            xml.startElement("image");
 
-            image->setImage(i->getImage());
+            xml.writeAttribute("left", i->getX());
+            xml.writeAttribute("top", i->getY());
+            xml.writeAttribute("right", i->getX() + i->getElementWidth());
+            xml.writeAttribute("bottom", i->getY() + i->getElementHeight());
 
-            image->setAttrib("left", i->getX());
-            image->setAttrib("top", i->getY());
-            image->setAttrib("right", i->getX() + i->getElementWidth());
-            image->setAttrib("bottom", i->getY() + i->getElementHeight());
+            xml.writePng(i->getImage());
+            xml.endElement();
         } else if (e->getType() == ELEMENT_TEXIMAGE) {
             auto* i = dynamic_cast<const TexImage*>(e);
-            auto* image = new XmlTexNode("teximage", std::string(i->getBinaryData()));
-            layer->addChild(image);
-
-            image->setAttrib("text", i->getText().c_str());
-            image->setAttrib("left", i->getX());
-            image->setAttrib("top", i->getY());
-            image->setAttrib("right", i->getX() + i->getElementWidth());
-            image->setAttrib("bottom", i->getY() + i->getElementHeight());
+            xml.startElement("teximage");
+
+            xml.writeAttribute("text", i->getText());
+            xml.writeAttribute("left", i->getX());
+            xml.writeAttribute("top", i->getY());
+            xml.writeAttribute("right", i->getX() + i->getElementWidth());
+            xml.writeAttribute("bottom", i->getY() + i->getElementHeight());
+
+            const std::string& data = i->getBinaryData();
+            xml.writeBase64(reinterpret_cast<const unsigned char*>(data.data()), data.size());
+            xml.endElement();
         }
     }
+
+    xml.endElement();
 }
 
-void SaveHandler::visitPage(XmlNode* root, ConstPageRef p, const Document* doc, int id, const fs::path& target) {
-    auto* page = new XmlNode("page");
-    root->addChild(page);
-    page->setAttrib("width", p->getWidth());
-    page->setAttrib("height", p->getHeight());
+void SaveHandler::visitPage(XmlWriter& xml, ConstPageRef p, const Document* doc, int id, const fs::path& target) {
+    std::shared_lock pageLock(p->getContentLock());
 
-    auto* background = new XmlNode("background");
-    page->addChild(background);
+    xml.startElement("page");
+    xml.writeAttribute("width", p->getWidth());
+    xml.writeAttribute("height", p->getHeight());
 
-    writeBackgroundName(background, p);
+    xml.startElement("background");
+
+    writeBackgroundName(xml, p);
 
     if (p->getBackgroundType().isPdfPage()) {
         /**
@@ -259,16 +239,16 @@ void SaveHandler::visitPage(XmlNode* root, ConstPageRef p, const Document* doc,
          * DO NOT CHANGE THE ORDER OF THE ATTRIBUTES!
          */
 
-        background->setAttrib("type", "pdf");
+        xml.writeAttribute("type", "pdf");
         if (!firstPdfPageVisited) {
             firstPdfPageVisited = true;
 
             if (doc->isAttachPdf()) {
-                background->setAttrib("domain", "attach");
+                xml.writeAttribute("domain", "attach");
                 auto filepath = doc->getFilepath();
                 Util::clearExtensions(filepath);
                 filepath += ".xopp.bg.pdf";
-                background->setAttrib("filename", "bg.pdf");
+                xml.writeAttribute("filename", "bg.pdf");
 
                 GError* error = nullptr;
                 if (!exists(filepath)) {
@@ -286,84 +266,76 @@ void SaveHandler::visitPage(XmlNode* root, ConstPageRef p, const Document* doc,
                 }
             } else {
                 // "absolute" just means path. For backward compatibility, it is hard to change the word
-                background->setAttrib("domain", "absolute");
+                xml.writeAttribute("domain", "absolute");
                 auto normalizedPath = Util::normalizeAssetPath(doc->getPdfFilepath(), target.parent_path(),
                                                                doc->getPathStorageMode());
-                background->setAttrib("filename", char_cast(normalizedPath.c_str()));
+                xml.writeAttribute("filename", char_cast(normalizedPath.c_str()));
             }
         }
-        background->setAttrib("pageno", p->getPdfPageNr() + 1);
+        xml.writeAttribute("pageno", p->getPdfPageNr() + 1);
     } else if (p->getBackgroundType().isImagePage()) {
-        background->setAttrib("type", "pixmap");
+        xml.writeAttribute("type", "pixmap");
 
-        int cloneId = p->getBackgroundImage().getCloneId();
-        if (cloneId != -1) {
-            background->setAttrib("domain", "clone");
-            char* filename = g_strdup_printf("%i", cloneId);
-            background->setAttrib("filename", filename);
+        const BackgroundImage& img = p->getBackgroundImage();
+        if (auto it = this->backgroundCloneIds.find(img.getContentKey()); it != this->backgroundCloneIds.end()) {
+            xml.writeAttribute("domain", "clone");
+            char* filename = g_strdup_printf("%i", it->second);
+            xml.writeAttribute("filename", filename);
             g_free(filename);
-        } else if (p->getBackgroundImage().isAttached() && p->getBackgroundImage().getPixbuf()) {
+        } else if (img.isAttached() && img.getPixbuf()) {
             char* filename = g_strdup_printf("bg_%d.png", this->attachBgId++);
-            background->setAttrib("domain", "attach");
-            background->setAttrib("filename", filename);
-
-            backgroundImages.emplace_back(p->getBackgroundImage());
+            xml.writeAttribute("domain", "attach");
+            xml.writeAttribute("filename", filename);
 
-            /*
-             * Because BackgroundImage is basically a wrapped pointer, the following lines actually modify
-             * *(p->getBackgroundImage().content) and thus the Document.
-             * TODO Find a better way
-             */
-            backgroundImages.back().setFilepath(filename);
-            backgroundImages.back().setCloneId(id);
+            backgroundImages.emplace_back(img, filename);
+            this->backgroundCloneIds.emplace(img.getContentKey(), id);
 
             g_free(filename);
         } else {
             // "absolute" just means path. For backward compatibility, it is hard to change the word
-            background->setAttrib("domain", "absolute");
+            xml.writeAttribute("domain", "absolute");
             auto normalizedPath = Util::normalizeAssetPath(p->getBackgroundImage().getFilepath(), target.parent_path(),
                                                            doc->getPathStorageMode());
-            background->setAttrib("filename", char_cast(normalizedPath.c_str()));
+            xml.writeAttribute("filename", char_cast(normalizedPath.c_str()));
 
-            BackgroundImage img = p->getBackgroundImage();
-
-            /*
-             * Because BackgroundImage is basically a wrapped pointer, the following line actually modifies
-             * *(p->getBackgroundImage().content) and thus the Document.
-             * TODO Find a better way
-             */
-            img.setCloneId(id);
+            if (img.getContentKey()) {
+                this->backgroundCloneIds.emplace(img.getContentKey(), id);
+            }
         }
     } else {
-        writeSolidBackground(background, p);
+        writeSolidBackground(xml, p);
     }
 
+    xml.endElement();
+
     // no layer, but we need to write one layer, else the old Xournal cannot read the file
     if (p->getLayerCount() == 0) {
-        auto* layer = new XmlNode("layer");
-        page->addChild(layer);
+        xml.startElement("layer");
+        xml.endElement();
     }
 
     for (const Layer* l: p->getLayersView()) {
-        visitLayer(page, l);
+        visitLayer(xml, l);
     }
+
+    xml.endElement();
 }
 
-void SaveHandler::writeSolidBackground(XmlNode* background, ConstPageRef p) {
-    background->setAttrib("type", "solid");
-    background->setAttrib("color", getColorStr(p->getBackgroundColor()));
-    background->setAttrib("style", PageTypeHandler::getStringForPageTypeFormat(p->getBackgroundType().format));
+void SaveHandler::writeSolidBackground(XmlWriter& xml, ConstPageRef p) {
+    xml.writeAttribute("type", "solid");
+    xml.writeAttribute("color", getColorStr(p->getBackgroundColor()));
+    xml.writeAttribute("style", PageTypeHandler::getStringForPageTypeFormat(p->getBackgroundType().format));
 
     // Not compatible with Xournal, so the background needs
     // to be changed to a basic one!
     if (!p->getBackgroundType().config.empty()) {
-        background->setAttrib("config", p->getBackgroundType().config);
+        xml.writeAttribute("config", p->getBackgroundType().config);
     }
 }
 
-void SaveHandler::writeBackgroundName(XmlNode* background, ConstPageRef p) {
+void SaveHandler::writeBackgroundName(XmlWriter& xml, ConstPageRef p) {
     if (p->backgroundHasName()) {
-        background->setAttrib("name", p->getBackgroundName());
+        xml.writeAttribute("name", p->getBackgroundName());
     }
 }
 
@@ -385,13 +357,47 @@ void SaveHandler::saveTo(const fs::path& filepath, ProgressListener* listener) {
 }
 
 void SaveHandler::saveTo(OutputStream* out, const fs::path& filepath, ProgressListener* listener) {
-    // XMLNode should be locale-safe ( store doubles using Locale 'C' format
+    xoj_assert(this->doc);
+
+    this->backgroundImages.clear();
+    this->backgroundCloneIds.clear();
+    this->firstPdfPageVisited = false;
+    this->attachBgId = 1;
+
+    const size_t pageCount = doc->getPageCount();
 
-    out->write("<?xml version=\"1.0\" standalone=\"no\"?>\n");
-    root->writeOut(out, listener);
+    // XmlWriter is locale-safe (stores doubles using Locale 'C' format)
+    XmlWriter xml(out);
+    xml.writeDeclaration();
+    xml.startElement("xournal");
 
-    for (const BackgroundImage& img: backgroundImages) {
-        auto tmpfn = (fs::path(filepath) += ".") += img.getFilepath();
+    writeHeader(xml);
+
+    if (cairo_surface_t* preview = doc->getPreview(); preview) {
+        xml.startElement("preview");
+        xml.writePng(preview);
+        xml.endElement();
+    }
+
+    if (listener) {
+        listener->setMaximumState(pageCount);
+    }
+    for (size_t i = 0; i < pageCount; i++) {
+        if (this->cancelled) {
+            xml.flush();
+            return;
+        }
+        visitPage(xml, doc->getPage(i), doc, static_cast<int>(i), target);
+        if (listener) {
+            listener->setCurrentState(i + 1);
+        }
+    }
+
+    xml.endElement();
+    xml.flush();
+
+    for (const auto& [img, filename]: backgroundImages) {
+        auto tmpfn = (fs::path(filepath) += ".") += filename;
         // Are we certain that does not modify the GdkPixbuf?
         if (!gdk_pixbuf_save(const_cast<GdkPixbuf*>(img.getPixbuf()), char_cast(tmpfn.u8string().c_str()), "png",
                              nullptr, nullptr)) {
@@ -405,3 +411,7 @@ void SaveHandler::saveTo(OutputStream* out, const fs::path& filepath, ProgressLi
 }
 
 auto SaveHandler::getErrorMessage() -> const std::string& { return this->errorMessage; }
+
+void SaveHandler::cancel() { this->cancelled = true; }
+
+auto SaveHandler::isCancelled() const -> bool { return this->cancelled; }
@@ -11,59 +11,97 @@
 
 #pragma once
 
-#include <memory>  // for unique_ptr
-#include <string>  // for string
-#include <vector>  // for vector
+#include <atomic>         // for atomic
+#include <string>         // for string
+#include <unordered_map>  // for unordered_map
+#include <utility>        // for pair
+#include <vector>         // for vector
 
-#include "control/xml/XmlNode.h"    // for XmlNode
 #include "model/BackgroundImage.h"  // for BackgroundImage
 #include "model/PageRef.h"          // for PageRef
 #include "util/Color.h"             // for Color
 
 #include "filesystem.h"  // for path
 
-class XmlPointNode;
 class ProgressListener;
 class AudioElement;
 class Document;
 class Layer;
 class OutputStream;
 class Stroke;
-class XmlAudioNode;
+class XmlWriter;
 
+/**
+ * Saves a document in the .xopp format.
+ *
+ * The XML is streamed directly to the (compressed) output while walking over the pages, layers and elements, so the
+ * memory needed does not depend on the size of the document.
+ */
 class SaveHandler {
 public:
     SaveHandler();
 
 public:
+    /**
+     * Sets the document to save. The document is only read by saveTo(): it must not be modified (i.e. the caller must
+     * keep it locked) until saveTo() returned.
+     *
+     * @param target The path the document is saved to, used to store relative paths to its assets
+     */
     void prepareSave(const Document* doc, const fs::path& target);
     void saveTo(const fs::path& filepath, ProgressListener* listener = nullptr);
     void saveTo(OutputStream* out, const fs::path& filepath, ProgressListener* listener = nullptr);
     const std::string& getErrorMessage();
 
+    /**
+     * Makes a running saveTo() stop after the current page, leaving an incomplete file.
+     * May be called from any thread.
+     */
+    void cancel();
+    bool isCancelled() const;
+
 protected:
     static std::string getColorStr(Color c, unsigned char alpha = 0xff);
 
-    virtual void visitPage(XmlNode* root, ConstPageRef p, const Document* doc, int id, const fs::path& target);
-    virtual void visitLayer(XmlNode* page, const Layer* l);
-    virtual void visitStroke(XmlPointNode* stroke, const Stroke* s);
+    virtual void visitPage(XmlWriter& xml, ConstPageRef p, const Document* doc, int id, const fs::path& target);
+    virtual void visitLayer(XmlWriter& xml, const Layer* l);
+    virtual void visitStroke(XmlWriter& xml, const Stroke* s);
 
     /**
      * Export the fill attributes
      */
-    virtual void visitStrokeExtended(XmlPointNode* stroke, const Stroke* s);
+    virtual void visitStrokeExtended(XmlWriter& xml, const Stroke* s);
 
-    virtual void writeHeader();
-    virtual void writeSolidBackground(XmlNode* background, ConstPageRef p);
-    virtual void writeTimestamp(XmlAudioNode* xmlAudioNode, const AudioElement* audioElement);
-    virtual void writeBackgroundName(XmlNode* background, ConstPageRef p);
+    virtual void writeHeader(XmlWriter& xml);
+    virtual void writeSolidBackground(XmlWriter& xml, ConstPageRef p);
+    virtual void writeTimestamp(XmlWriter& xml, const AudioElement* audioElement);
+    virtual void writeBackgroundName(XmlWriter& xml, ConstPageRef p);
 
 protected:
-    std::unique_ptr<XmlNode> root{};
+    const Document* doc = nullptr;
+    fs::path target;
+
     bool firstPdfPageVisited;
     int attachBgId;
 
     std::string errorMessage;
 
-    std::vector<BackgroundImage> backgroundImages{};
+    std::atomic<bool> cancelled = false;
+
+    /**
+     * The attached background images to write next to the file, with their file names. The document is never
+     * modified by a save (it may be a snapshot sharing the images with the live document, saved from another thread).
+     */
+    std::vector<std::pair<BackgroundImage, std::string>> backgroundImages{};
+
+    /**
+     * The index of the first page using each background image (see BackgroundImage::getContentKey()), written as
+     * "clone" by the other pages using it
+     */
+    std::unordered_map<const void*, int> backgroundCloneIds{};
+
+    /**
+     * Reused for the width attribute of the strokes with pressure
+     */
+    std::vector<double> widthValues{};
 };
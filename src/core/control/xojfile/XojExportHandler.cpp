@@ -4,8 +4,7 @@
 #include <string>  // for string, allocator, ope...
 
 #include "control/pagetype/PageTypeHandler.h"  // for PageTypeHandler
-#include "control/xml/XmlNode.h"               // for XmlNode
-#include "control/xml/XmlTextNode.h"           // for XmlTextNode
+#include "control/xml/XmlWriter.h"             // for XmlWriter
 #include "model/PageType.h"                    // for PageTypeFormat, PageType
 #include "model/XojPage.h"                     // for XojPage
 
@@ -13,8 +12,6 @@
 
 class AudioElement;
 class Stroke;
-class XmlAudioNode;
-class XmlPointNode;
 
 XojExportHandler::XojExportHandler() = default;
 
@@ -23,22 +20,23 @@ XojExportHandler::~XojExportHandler() = default;
 /**
  * Export the fill attributes
  */
-void XojExportHandler::visitStrokeExtended(XmlPointNode* stroke, const Stroke* s) {
+void XojExportHandler::visitStrokeExtended(XmlWriter& xml, const Stroke* s) {
     // Fill is not exported in .xoj
     // Line style is also not supported
 }
 
-void XojExportHandler::writeHeader() {
-    this->root->setAttrib("creator", PROJECT_STRING);
+void XojExportHandler::writeHeader(XmlWriter& xml) {
+    xml.writeAttribute("creator", PROJECT_STRING);
     // Keep this version on 2, as this is anyway not read by Xournal
-    this->root->setAttrib("fileversion", "2");
-    this->root->addChild(
-            new XmlTextNode("title", std::string{"Xournal document (Compatibility) - see "} + PROJECT_HOMEPAGE_URL));
+    xml.writeAttribute("fileversion", "2");
+    xml.startElement("title");
+    xml.writeText(std::string{"Xournal document (Compatibility) - see "} + PROJECT_HOMEPAGE_URL);
+    xml.endElement();
 }
 
-void XojExportHandler::writeSolidBackground(XmlNode* background, ConstPageRef p) {
-    background->setAttrib("type", "solid");
-    background->setAttrib("color", getColorStr(p->getBackgroundColor()));
+void XojExportHandler::writeSolidBackground(XmlWriter& xml, ConstPageRef p) {
+    xml.writeAttribute("type", "solid");
+    xml.writeAttribute("color", getColorStr(p->getBackgroundColor()));
 
     PageTypeFormat bgFormat = p->getBackgroundType().format;
     std::string format;
@@ -49,13 +47,13 @@ void XojExportHandler::writeSolidBackground(XmlNode* background, ConstPageRef p)
         format = "plain";
     }
 
-    background->setAttrib("style", format);
+    xml.writeAttribute("style", format);
 }
 
-void XojExportHandler::writeTimestamp(XmlAudioNode* xmlAudioNode, const AudioElement* audioElement) {
+void XojExportHandler::writeTimestamp(XmlWriter& xml, const AudioElement* audioElement) {
     // Do nothing since timestamp are not supported by Xournal
 }
 
-void XojExportHandler::writeBackgroundName(XmlNode* background, ConstPageRef p) {
+void XojExportHandler::writeBackgroundName(XmlWriter& xml, ConstPageRef p) {
     // Do nothing since background name is not supported by Xournal
 }
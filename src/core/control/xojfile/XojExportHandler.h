@@ -18,9 +18,7 @@
 
 class AudioElement;
 class Stroke;
-class XmlAudioNode;
-class XmlNode;
-class XmlPointNode;
+class XmlWriter;
 
 
 class XojExportHandler: public SaveHandler {
@@ -32,11 +30,11 @@ protected:
     /**
      * Export the fill attributes
      */
-    void visitStrokeExtended(XmlPointNode* stroke, const Stroke* s) override;
-    void writeHeader() override;
-    void writeSolidBackground(XmlNode* background, ConstPageRef p) override;
-    void writeTimestamp(XmlAudioNode* xmlAudioNode, const AudioElement* audioElement) override;
-    void writeBackgroundName(XmlNode* background, ConstPageRef p) override;
+    void visitStrokeExtended(XmlWriter& xml, const Stroke* s) override;
+    void writeHeader(XmlWriter& xml) override;
+    void writeSolidBackground(XmlWriter& xml, ConstPageRef p) override;
+    void writeTimestamp(XmlWriter& xml, const AudioElement* audioElement) override;
+    void writeBackgroundName(XmlWriter& xml, ConstPageRef p) override;
 
 private:
 };
@@ -19,6 +19,7 @@
 
 #include "control/AudioController.h"                // for AudioController
 #include "control/Control.h"                        // for Control
+#include "control/RenderCache.h"                    // for RenderCache
 #include "control/ScrollHandler.h"                  // for ScrollHandler
 #include "control/SearchControl.h"                  // for SearchControl
 #include "control/Tool.h"                           // for Tool
@@ -67,8 +68,9 @@
 #include "undo/TextBoxUndoAction.h"                 // for TextBoxUndoAction
 #include "undo/UndoRedoHandler.h"                   // for UndoRedoHandler
 #include "util/Assert.h"                            // for xoj_assert
-#include "util/Color.h"                             // for rgb_to_GdkRGBA
+#include "util/Color.h"                             // for rgb_to_GdkRGBA, cairo_set_source_rgbi
 #include "util/Range.h"                             // for Range
+#include "util/Recolor.h"                           // for Recolor
 #include "util/Rectangle.h"                         // for Rectangle
 #include "util/Util.h"                              // for npos
 #include "util/XojMsgBox.h"                         // for XojMsgBox
@@ -111,6 +113,7 @@ XojPageView::~XojPageView() {
     this->unregisterFromHandler();
 
     this->xournal->getControl()->getScheduler()->removePage(this);
+    this->xournal->getControl()->getRenderCache()->remove(this);
 
     this->overlayViews.clear();
     endText();
@@ -121,11 +124,36 @@ void XojPageView::addOverlayView(std::unique_ptr<xoj::view::OverlayView> overlay
     this->overlayViews.emplace_back(std::move(overlay));
 }
 
-void XojPageView::setIsVisible(bool visible) { this->visible = visible; }
+void XojPageView::setIsVisible(bool visible) {
+    if (this->visible.exchange(visible) && !visible && this->page->isContentLoaded()) {
+        // The contours of the pressure strokes are only cached for the visible pages (see RenderJob)
+        for (const Layer* l: this->page->getLayersView()) {
+            for (const Element* e: l->getElementsView()) {
+                if (e->getType() == ELEMENT_STROKE) {
+                    static_cast<const Stroke*>(e)->dropContour();
+                }
+            }
+        }
+    }
+}
 
 void XojPageView::deleteViewBuffer() {
     std::lock_guard lock(this->drawingMutex);
     this->buffer.reset();
+    this->xournal->getControl()->getRenderCache()->remove(this, 0);
+}
+
+auto XojPageView::evictRenderCache(size_t) -> bool {
+    if (this->visible) {
+        return false;
+    }
+    // Called with the cache locked: never wait for a render job holding the mutex
+    std::unique_lock lock(this->drawingMutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        return false;
+    }
+    this->buffer.reset();
+    return true;
 }
 
 auto XojPageView::containsPoint(int x, int y, bool local) const -> bool {
@@ -834,9 +862,8 @@ void XojPageView::drawAndDeleteToolView(xoj::view::ToolView* v, const Range& rg)
         v->isViewOf(this->textEditor.get())) {
         // Draw the inputHandler's view onto the page buffer.
         std::lock_guard lock(this->drawingMutex);
-        if (auto cr = buffer.get(); cr) {
-            v->drawWithoutDrawingAids(cr);
-        } else {
+        Range area = rg.empty() ? Range(0, 0, getWidth(), getHeight()) : rg;
+        if (!this->buffer.drawOnTiles(getZoom(), area, [v](cairo_t* cr) { v->drawWithoutDrawingAids(cr); })) {
             rerenderPage();
         }
     }
@@ -956,8 +983,6 @@ void XojPageView::drawLoadingPage(cairo_t* cr) {
     cairo_move_to(cr, (page->getWidth() - ex.width) / 2 - ex.x_bearing,
                   (page->getHeight() - ex.height) / 2 - ex.y_bearing);
     cairo_show_text(cr, txtLoading.c_str());
-
-    rerenderPage();
 }
 
 bool XojPageView::displayLinkPopover(std::shared_ptr<XojPdfPage> page, double pageX, double pageY) {
@@ -1051,21 +1076,56 @@ auto XojPageView::paintPage(cairo_t* cr, GdkRectangle* rect) -> bool {
     xoj::util::CairoSaveGuard saveGuard(cr);
     cairo_scale(cr, zoom, zoom);
 
+    // The render job renders the tiles of the visible part of the page
+    Range visible = getVisiblePart();
+    {
+        std::lock_guard lock(this->repaintRectMutex);
+        this->visibleRange = visible;
+    }
+    this->xournal->getControl()->getRenderCache()->touch(this, 0);
+
+    const auto& recolorParams = this->settings->getRecolorParameters();
+    auto recolor = recolorParams.recolorizeMainView ? std::make_optional(recolorParams.recolor) : std::nullopt;
+
     {
         std::lock_guard lock(this->drawingMutex);  // Lock the mutex first
         xoj::util::CairoSaveGuard saveGuard(cr);   // see comment at the end of the scope
-        if (!this->hasBuffer()) {
+
+        double minX;
+        double minY;
+        double maxX;
+        double maxY;
+        cairo_clip_extents(cr, &minX, &minY, &maxX, &maxY);
+        Range area = Range(minX, minY, maxX, maxY).intersect(Range(0, 0, getWidth(), getHeight()));
+
+        // The tiles are recolored once, when they are rendered or when the recoloring changes
+        this->buffer.setRecolor(recolor);
+
+        if (!this->buffer.hasTilesIn(area)) {
             drawLoadingPage(cr);
+            if (recolor) {
+                cairo_rectangle(cr, 0, 0, getWidth(), getHeight());
+                cairo_clip(cr);
+                recolor->recolorCurrentCairoRegion(cr);
+            }
+            this->xournal->getControl()->getScheduler()->addRerenderPage(this);
             return true;
         }
 
-        if (this->buffer.getZoom() != zoom) {
-            rerenderPage();
-            cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_FAST);
+        if (recolor && !this->buffer.getMissingTiles(area, zoom).empty()) {
+            // The widget does not recolor the page area: paint the recolored background it would show
+            Util::cairo_set_source_rgbi(cr, recolor->convertColor(this->settings->getBackgroundColor()));
+            cairo_rectangle(cr, area.minX, area.minY, area.getWidth(), area.getHeight());
+            cairo_fill(cr);
+        }
+
+        // Tiles of other zoom levels are painted scaled until those of the current zoom are rendered
+        bool complete = this->buffer.paintTo(cr, area, zoom);
+        if (!complete || !this->buffer.getMissingTiles(visible, zoom).empty()) {
+            this->xournal->getControl()->getScheduler()->addRerenderPage(this);
         }
-        this->buffer.paintTo(cr);
     }  // Restore the state of cr and then release the mutex
-       // restoring the state of cr ensures this->buffer.surface is not longer referenced as the source in cr.
+       // restoring the state of cr ensures the tiles' surfaces are not longer referenced as the source in cr.
 
     /**
      * All the overlay painters below follow the assumption:
@@ -1073,8 +1133,18 @@ auto XojPageView::paintPage(cairo_t* cr, GdkRectangle* rect) -> bool {
      *
      * To anyone adding another painter here: please keep this assumption true
      */
-    for (const auto& v: this->overlayViews) {
-        v->draw(cr);
+    auto drawOverlays = [&](cairo_t* cr) {
+        for (const auto& v: this->overlayViews) {
+            v->draw(cr);
+        }
+    };
+    if (recolor && !this->overlayViews.empty()) {
+        // The overlays are recolored on their own, over the recolored tiles
+        cairo_rectangle(cr, 0, 0, getWidth(), getHeight());
+        cairo_clip(cr);
+        recolor->paintRecolored(cr, drawOverlays);
+    } else {
+        drawOverlays(cr);
     }
 
     return true;
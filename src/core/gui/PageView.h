@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <atomic>   // for atomic
 #include <cstddef>  // for size_t
 #include <memory>   // for unique_ptr, shared_ptr
 #include <mutex>    // for mutex
@@ -21,14 +22,16 @@
 #include <gdk/gdk.h>  // for GdkEventKey, GdkRGBA, GdkRectangle
 #include <gtk/gtk.h>  // for GtkWidget
 
+#include "control/RenderCache.h"       // for RenderCache
 #include "gui/inputdevices/DeviceId.h"
 #include "gui/inputdevices/InputEvents.h"
 #include "model/PageListener.h"       // for PageListener
 #include "model/PageRef.h"            // for PageRef
 #include "util/Rectangle.h"           // for Rectangle
 #include "util/raii/CairoWrappers.h"  // for CairoSurfaceSPtr
-#include "view/Mask.h"                // for Mask
+#include "util/Range.h"               // for Range
 #include "view/Repaintable.h"         // for Repaintable
+#include "view/TiledBuffer.h"         // for TiledBuffer
 
 #include "Layout.h"            // for Layout
 #include "LegacyRedrawable.h"  // for LegacyRedrawable
@@ -56,7 +59,11 @@ class OverlayView;
 class ToolView;
 }  // namespace xoj::view
 
-class XojPageView: public LegacyRedrawable, public PageListener, public xoj::view::Repaintable {
+class XojPageView:
+        public LegacyRedrawable,
+        public PageListener,
+        public xoj::view::Repaintable,
+        public RenderCache::Client {
 public:
     XojPageView(XournalView* xournal, const PageRef& page);
     ~XojPageView() override;
@@ -95,6 +102,10 @@ public:
 
     void setSelected(bool selected);
 
+    /**
+     * Marks the page as visible or not. Frees the contours of its pressure strokes when it leaves the view.
+     * Must be called from the UI thread.
+     */
     void setIsVisible(bool visible);
 
     bool isSelected() const;
@@ -117,6 +128,11 @@ public:
 
     void deleteViewBuffer() override;
 
+    /**
+     * Deletes the buffer if the page is not visible, see RenderCache
+     */
+    bool evictRenderCache(size_t id) override;
+
     /**
      * Returns whether this PageView contains the
      * given point on the display
@@ -279,10 +295,11 @@ private:
      */
     Text* oldtext;
 
-    bool visible = true;
+    /// Read by the RenderCache from other threads
+    std::atomic<bool> visible = true;
     bool selected = false;
 
-    xoj::view::Mask buffer;
+    xoj::view::TiledBuffer buffer;
     std::mutex drawingMutex;
 
     bool inEraser = false;
@@ -301,6 +318,8 @@ private:
     std::vector<xoj::util::Rectangle<double>> rerenderRects;
     bool rerenderComplete = false;
     bool sizeChanged = false;
+    /// The part of the page visible when it was last painted, whose tiles are rendered (see RenderJob)
+    Range visibleRange;
 
     int dispX{};  // position on display - set in Layout::layoutPages
     int dispY{};
@@ -9,13 +9,14 @@
 
 #include "control/Control.h"           // for Control
 #include "control/ScrollHandler.h"     // for ScrollHandler
+#include "control/SearchIndex.h"       // for SearchIndex
 #include "control/zoom/ZoomControl.h"  // for ZoomControl
 #include "gui/MainWindow.h"            // for MainWindow
 #include "model/Document.h"            // for Document
 #include "util/PlaceholderString.h"    // for PlaceholderString
 #include "util/i18n.h"                 // for _, FC, _F
 
-SearchBar::SearchBar(Control* control): control(control) {
+SearchBar::SearchBar(Control* control): control(control), index(std::make_unique<SearchIndex>(control)) {
     MainWindow* win = control->getWindow();
 
     GtkWidget* close = win->get("buttonCloseSearch");
@@ -92,6 +93,16 @@ void SearchBar::search(const char* text) {
                 gtk_label_set_text(GTK_LABEL(lbSearchState), msg);
                 g_free(msg);
             }
+        } else if (auto pages = findOtherPages(text); !pages.empty()) {
+            size_t total = 0;
+            for (const auto& hit: pages) {
+                total += hit.occurrences;
+            }
+            SearchIndex::rank(pages);
+            gtk_label_set_text(GTK_LABEL(lbSearchState),
+                               FC(_F("Text not found on this page, found {1} times on {2} pages (most on page {3})") %
+                                  total % pages.size() % (pages.front().page + 1)));
+            found = true;
         } else {
             gtk_label_set_text(GTK_LABEL(lbSearchState), _("Text not found"));
         }
@@ -125,11 +136,19 @@ void SearchBar::search(Fun next) {
         return;
     }
     const size_t originalPage = page;
+    const size_t pageCount = control->getDocument()->getPageCount();
+
+    auto pages = findPages(text);
+    if (pages && pages->empty()) {
+        // The index may miss a match, e.g. if Poppler extracts the text of the page differently: search page by page
+        pages.reset();
+    }
 
     XojPdfRectangle matchRect = XojPdfRectangle();
-    // Search backwards through the pages, wrapping around if needed.
-    for (;;) {
-        next(text);
+    // Search through the pages, wrapping around if needed. With the index, only the pages containing the text are
+    // searched: the original page may be skipped, so also stop once as many pages as the document has were searched.
+    for (size_t searched = 1;; searched++) {
+        next(text, pages ? &*pages : nullptr);
         const bool found = control->searchTextOnPage(text, page, indexInPage, &occurrences, &matchRect);
 
         if (found) {
@@ -141,7 +160,7 @@ void SearchBar::search(Fun next) {
                                                       occurrences % (page + 1) % indexInPage)));
             return;
         }
-        if (page == originalPage) {
+        if (page == originalPage || searched > pageCount) {
             gtk_label_set_text(GTK_LABEL(lbSearchState), _("Text not found, searched on all pages"));
             return;
         }
@@ -150,13 +169,17 @@ void SearchBar::search(Fun next) {
 
 void SearchBar::searchNext() {
     size_t pageCount = control->getDocument()->getPageCount();
-    search([&](const char* text) {
+    search([&](const char* text, const std::vector<size_t>* pages) {
         indexInPage++;
         if (indexInPage > occurrences) {
             control->searchTextOnPage(text, page, 1, &occurrences, nullptr);  // clear the active marker
-            page++;
-            if (page >= pageCount) {
-                page = 0;
+            if (pages) {
+                page = SearchIndex::nextPage(*pages, page);
+            } else {
+                page++;
+                if (page >= pageCount) {
+                    page = 0;
+                }
             }
             indexInPage = 1;
         }
@@ -165,13 +188,17 @@ void SearchBar::searchNext() {
 
 void SearchBar::searchPrevious() {
     size_t pageCount = control->getDocument()->getPageCount();
-    search([&](const char* text) {
+    search([&](const char* text, const std::vector<size_t>* pages) {
         indexInPage--;
         if (indexInPage == 0 || indexInPage >= occurrences) {
             control->searchTextOnPage(text, page, 1, &occurrences, nullptr);  // clear the active marker
-            page--;
-            if (page > pageCount) {
-                page = pageCount - 1;
+            if (pages) {
+                page = SearchIndex::previousPage(*pages, page);
+            } else {
+                page--;
+                if (page > pageCount) {
+                    page = pageCount - 1;
+                }
             }
             control->searchTextOnPage(text, page, 1, &occurrences, nullptr);
             indexInPage = occurrences;
@@ -188,11 +215,32 @@ void SearchBar::showSearchBar(bool show) {
         gtk_widget_show_all(searchBar);
         gtk_widget_grab_focus(searchTextField);
         this->indexInPage = 0;
+        this->index->build();
     } else {
         gtk_widget_hide(searchBar);
+        // Do not keep a worker busy for a search which will not come
+        this->index->stopBuilding();
         const size_t pageCount = control->getDocument()->getPageCount();
         for (size_t i = pageCount - 1; i < pageCount; i--) {
             control->searchTextOnPage("", i, 0, nullptr, nullptr);
         }
     }
 }
+
+auto SearchBar::findOtherPages(const char* text) const -> std::vector<SearchIndex::PageHit> {
+    if (!this->index->isReady()) {
+        return {};
+    }
+    return this->index->search(text);
+}
+
+auto SearchBar::findPages(const char* text) const -> std::optional<std::vector<size_t>> {
+    if (!this->index->isReady()) {
+        return std::nullopt;
+    }
+    std::vector<size_t> pages;
+    for (const auto& hit: this->index->search(text)) {
+        pages.push_back(hit.page);
+    }
+    return pages;
+}
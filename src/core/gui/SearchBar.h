@@ -11,9 +11,16 @@
 
 #pragma once
 
+#include <cstddef>   // for size_t
+#include <memory>    // for unique_ptr
+#include <optional>  // for optional
+#include <vector>    // for vector
+
 #include <gtk/gtk.h>             // for GtkButton, GtkEntry
 #include <gtk/gtkcssprovider.h>  // for GtkCssProvider
 
+#include "control/SearchIndex.h"  // for SearchIndex
+
 class Control;
 class XojPdfRectangle;
 
@@ -36,10 +43,13 @@ private:
      * iterating through the pages via page = next(page). The search stops after the first page with at least one match.
      * All the match on that page are stored in XojPageView::search of the corresponding page. The current page is not
      * search!
-     * @param next The parameter `next` must be convertible to size_t(size_t) and satisfy the following assertions
+     * @param next The parameter `next` must be convertible to void(const char* text, const std::vector<size_t>* pages)
+     *             and satisfy the following assertions
      *              * Iterating from page = next(currentPage) by page = next(page) must reach page == currentPage at
-     * some point.
+     * some point, or visit every page.
      *              * If page is a valid page number, then so is next(page).
+     *             pages is the list of the pages containing the text according to the SearchIndex, or nullptr if the
+     *             index is not ready yet: next() should only visit these pages.
      */
     template <class Fun>
     void search(Fun next);
@@ -53,6 +63,17 @@ private:
      */
     void searchPrevious();
 
+    /**
+     * @return The pages containing the text according to the index, in increasing order, or std::nullopt if the index
+     * is not ready yet
+     */
+    std::optional<std::vector<size_t>> findPages(const char* text) const;
+
+    /**
+     * @return The pages containing the text according to the index, or nothing if the index is not ready yet
+     */
+    std::vector<SearchIndex::PageHit> findOtherPages(const char* text) const;
+
     void search(const char* text);
     bool searchTextonCurrentPage(const char* text, size_t index, size_t* occurrences, XojPdfRectangle* matchRect);
 
@@ -62,4 +83,6 @@ private:
     size_t page = 0;
     size_t indexInPage = 0;
     size_t occurrences = 0;
+
+    std::unique_ptr<SearchIndex> index;
 };
@@ -4,6 +4,8 @@
 #include <iterator>   // for begin
 #include <memory>     // for unique_ptr, make_unique
 #include <optional>   // for optional
+#include <utility>    // for move
+#include <vector>     // for vector
 
 #include <gdk/gdk.h>         // for GdkEventKey, GDK_SHIF...
 #include <gdk/gdkkeysyms.h>  // for GDK_KEY_Page_Down
@@ -11,6 +13,7 @@
 
 #include "control/Control.h"                     // for Control
 #include "control/PdfCache.h"                    // for PdfCache
+#include "control/RenderCache.h"                 // for RenderCache
 #include "control/ScrollHandler.h"               // for ScrollHandler
 #include "control/ToolHandler.h"                 // for ToolHandler
 #include "control/actions/ActionDatabase.h"      // for ActionDatabase
@@ -39,7 +42,6 @@
 #include "util/Point.h"                          // for Point
 #include "util/Rectangle.h"                      // for Rectangle
 #include "util/Util.h"                           // for npos
-#include "util/glib_casts.h"                     // for wrap_v
 #include "util/gtk4_helper.h"                    // for gtk_scrolled_window_set_child
 #include "util/safe_casts.h"                     // for round_cast
 
@@ -64,12 +66,7 @@ std::pair<size_t, size_t> XournalView::preloadPageBounds(size_t page, size_t max
 
 XournalView::XournalView(GtkWidget* parent, Control* control, ScrollHandling* scrollHandling):
         scrollHandling(scrollHandling), control(control) {
-    Document* doc = control->getDocument();
-    doc->lock();
-    if (doc->getPdfPageCount() != 0) {
-        this->cache = std::make_unique<PdfCache>(doc->getPdfDocument(), control->getSettings());
-    }
-    doc->unlock();
+    control->updatePdfCache();
 
     registerListener(control);
 
@@ -99,23 +96,14 @@ XournalView::XournalView(GtkWidget* parent, Control* control, ScrollHandling* sc
     gtk_widget_grab_default(this->widget);
 
     gtk_widget_grab_focus(this->widget);
-
-    this->cleanupTimeout = g_timeout_add_seconds(5, xoj::util::wrap_v<clearMemoryTimer>, this);
 }
 
 XournalView::~XournalView() {
-    g_source_remove(this->cleanupTimeout);
-
     gtk_widget_destroy(this->widget);
     this->widget = nullptr;
 }
 
 
-auto XournalView::clearMemoryTimer(XournalView* widget) -> gboolean {
-    widget->cleanupBufferCache();
-    return G_SOURCE_CONTINUE;
-}
-
 auto XournalView::cleanupBufferCache() -> void {
     const auto& [pagesLower, pagesUpper] = this->preloadPageBounds(this->currentPage, this->viewPages.size());
     xoj_assert(pagesLower <= pagesUpper);
@@ -339,9 +327,10 @@ auto XournalView::onKeyReleaseEvent(const KeyEvent& event) -> bool {
 }
 
 void XournalView::onSettingsChanged() {
-    if (this->cache) {
-        this->cache->updateSettings(control->getSettings());
+    if (auto cache = control->getPdfCache()) {
+        cache->updateSettings(control->getSettings());
     }
+    control->getRenderCache()->setBudget(size_t{control->getSettings()->getRenderCacheBudget()} * 1024 * 1024);
 }
 
 // send the focus back to the appropriate widget
@@ -419,6 +408,36 @@ void XournalView::pageSelected(size_t page) {
             this->viewPages[i]->rerenderPage();
         }
     }
+
+    prefetchPdfPages(page);
+}
+
+void XournalView::prefetchPdfPages(size_t page) {
+    const size_t n = control->getSettings()->getPdfPagePrefetch();
+    auto cache = control->getPdfCache();
+    if (!cache || n == 0 || page == npos || page >= this->viewPages.size()) {
+        return;
+    }
+
+    // The next pages first: they are the most likely to be shown
+    std::vector<size_t> pdfPages;
+    auto addPage = [&](size_t i) {
+        if (size_t pdfPage = this->viewPages[i]->getPage()->getPdfPageNr(); pdfPage != npos) {
+            pdfPages.push_back(pdfPage);
+        }
+    };
+    for (size_t d = 1; d <= n; d++) {
+        if (page + d < this->viewPages.size()) {
+            addPage(page + d);
+        }
+        if (d <= page) {
+            addPage(page - d);
+        }
+    }
+
+    // Same zoom as the PdfCache::render() calls of the RenderJobs
+    const int dpiScaling = getDpiScaleFactor();
+    control->getScheduler()->addPdfPrefetch(std::move(cache), std::move(pdfPages), getZoom() * dpiScaling, dpiScaling);
 }
 
 auto XournalView::getControl() const -> Control* { return control; }
@@ -522,14 +541,12 @@ auto XournalView::getVisibleRect(const XojPageView* redrawable) const -> Rectang
 }
 
 void XournalView::recreatePdfCache() {
-    this->cache.reset();
-
-    Document* doc = control->getDocument();
-    doc->lock();
-    if (doc->getPdfPageCount() != 0) {
-        this->cache = std::make_unique<PdfCache>(doc->getPdfDocument(), control->getSettings());
+    auto oldCache = control->getPdfCache();
+    control->updatePdfCache();
+    if (oldCache && oldCache != control->getPdfCache()) {
+        // The pages of the previous PDF are not needed anymore
+        control->getScheduler()->removePdfCache(oldCache.get());
     }
-    doc->unlock();
 }
 
 /**
@@ -626,7 +643,7 @@ auto XournalView::getTextEditor() const -> TextEditor* {
     return nullptr;
 }
 
-auto XournalView::getCache() const -> PdfCache* { return this->cache.get(); }
+auto XournalView::getCache() const -> std::shared_ptr<PdfCache> { return control->getPdfCache(); }
 
 void XournalView::pageInserted(size_t page) {
     Document* doc = control->getDocument();
@@ -12,8 +12,7 @@
 #pragma once
 
 #include <cstddef>  // for size_t
-#include <limits>   // for numeric_limits
-#include <memory>   // for unique_ptr
+#include <memory>   // for unique_ptr, shared_ptr
 #include <string>   // for string
 #include <utility>  // for pair
 #include <vector>   // for vector
@@ -106,7 +105,10 @@ public:
     double getZoom() const;
     int getDpiScaleFactor() const;
     Document* getDocument() const;
-    PdfCache* getCache() const;
+    /**
+     * @return The PDF cache shared with the sidebar, see Control::getPdfCache()
+     */
+    std::shared_ptr<PdfCache> getCache() const;
     RepaintHandler* getRepaintHandler() const;
     GtkWidget* getWidget() const;
     XournalppCursor* getCursor() const;
@@ -116,7 +118,7 @@ public:
     xoj::util::Rectangle<double>* getVisibleRect(const XojPageView* redrawable) const;
 
     /**
-     * Recreate the PDF cache, for example after the underlying PDF file has changed
+     * Recreate the PDF cache if the underlying PDF file has changed
      */
     void recreatePdfCache();
 
@@ -160,10 +162,13 @@ private:
 
     std::pair<size_t, size_t> preloadPageBounds(size_t page, size_t maxPage);
 
-    static auto clearMemoryTimer(XournalView* widget) -> gboolean;
-
     void cleanupBufferCache();
 
+    /**
+     * Rasterizes the PDF backgrounds of the pages around the given one in advance, see Settings::getPdfPagePrefetch()
+     */
+    void prefetchPdfPages(size_t page);
+
 private:
     /**
      * Scrollbars
@@ -179,17 +184,10 @@ private:
     size_t currentPage = 0;
     size_t lastSelectedPage = npos;
 
-    std::unique_ptr<PdfCache> cache;
-
     /**
      * Handler for rerendering pages / repainting pages
      */
     std::unique_ptr<RepaintHandler> repaintHandler;
 
-    /**
-     * Memory cleanup timeout
-     */
-    guint cleanupTimeout = std::numeric_limits<guint>::max();
-
     friend class Layout;
 };
@@ -9,7 +9,6 @@
 #include "control/PdfCache.h"  // for PdfCache
 #include "gui/Builder.h"       // for Builder
 #include "gui/MainWindow.h"    // for MainWindow
-#include "model/Document.h"    // for Document
 #include "util/Util.h"         // for npos
 #include "util/glib_casts.h"   // for wrap_for_once_v
 #include "util/gtk4_helper.h"
@@ -30,13 +29,7 @@ SidebarPreviewBase::SidebarPreviewBase(Control* control, const char* menuId, con
     gtk_scrolled_window_set_child(GTK_SCROLLED_WINDOW(scrollableBox.get()), GTK_WIDGET(miniaturesContainer.get()));
     gtk_widget_set_vexpand(scrollableBox.get(), true);
 
-    Document* doc = this->control->getDocument();
-    doc->lock();
-    if (doc->getPdfPageCount() != 0) {
-        this->cache = std::make_unique<PdfCache>(doc->getPdfDocument(), control->getSettings());
-    }
-    doc->unlock();
-
+    this->control->updatePdfCache();
 
     registerListener(this->control);
     this->control->addChangedDocumentListener(this);
@@ -80,7 +73,7 @@ void SidebarPreviewBase::newWidth(double width) {
 
 auto SidebarPreviewBase::getZoom() const -> double { return this->zoom; }
 
-auto SidebarPreviewBase::getCache() -> PdfCache* { return this->cache.get(); }
+auto SidebarPreviewBase::getCache() const -> std::shared_ptr<PdfCache> { return this->control->getPdfCache(); }
 
 void SidebarPreviewBase::layout() {
     if (enabled) {
@@ -94,14 +87,8 @@ auto SidebarPreviewBase::getWidget() -> GtkWidget* { return this->mainBox.get();
 
 void SidebarPreviewBase::documentChanged(DocumentChangeType type) {
     if (type == DOCUMENT_CHANGE_COMPLETE || type == DOCUMENT_CHANGE_CLEARED) {
-        this->cache.reset();
-
-        Document* doc = control->getDocument();
-        doc->lock();
-        if (doc->getPdfPageCount() != 0) {
-            this->cache = std::make_unique<PdfCache>(doc->getPdfDocument(), control->getSettings());
-        }
-        doc->unlock();
+        // The main view may not have been notified yet
+        control->updatePdfCache();
         updatePreviews();
     }
 }
@@ -12,7 +12,7 @@
 #pragma once
 
 #include <cstddef>  // for size_t
-#include <memory>   // for unique_ptr
+#include <memory>   // for shared_ptr, unique_ptr
 #include <vector>   // for vector
 
 #include <gtk/gtk.h>  // for GtkWidget, GtkAllocation
@@ -62,9 +62,10 @@ public:
     double getZoom() const;
 
     /**
-     * Gets the PDF cache for preview rendering
+     * Gets the PDF cache for preview rendering, shared with the main view: the previews are downscaled from its
+     * renderings when possible
      */
-    PdfCache* getCache();
+    std::shared_ptr<PdfCache> getCache() const;
 
 public:
     // DocumentListener interface (only the part handled by SidebarPreviewBase)
@@ -96,11 +97,6 @@ private:
     /// last recorded width of the sidebar
     double lastWidth = -1;
 
-    /**
-     * For preview rendering
-     */
-    std::unique_ptr<PdfCache> cache;
-
 protected:
     /// The scrollable area with the miniatures
     xoj::util::WidgetSPtr scrollableBox;
@@ -5,6 +5,7 @@
 #include <gtk/gtk.h>      //
 
 #include "control/Control.h"                // for Control
+#include "control/RenderCache.h"            // for RenderCache
 #include "control/jobs/XournalScheduler.h"  // for XournalScheduler
 #include "control/settings/Settings.h"      // for Settings
 #include "gui/Shadow.h"                     // for Shadow
@@ -48,6 +49,7 @@ SidebarPreviewBaseEntry::SidebarPreviewBaseEntry(SidebarPreviewBase* sidebar, co
 
 SidebarPreviewBaseEntry::~SidebarPreviewBaseEntry() {
     this->sidebar->getControl()->getScheduler()->removeSidebar(this);
+    this->sidebar->getControl()->getRenderCache()->remove(this);
 }
 
 auto SidebarPreviewBaseEntry::drawCallback(GtkWidget* widget, cairo_t* cr, SidebarPreviewBaseEntry* preview)
@@ -65,6 +67,16 @@ void SidebarPreviewBaseEntry::setSelected(bool selected) {
     gtk_widget_queue_draw(this->button.get());
 }
 
+auto SidebarPreviewBaseEntry::evictRenderCache(size_t) -> bool {
+    // Called with the cache locked: never wait for a preview job holding the mutex
+    std::unique_lock lock(this->drawingMutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        return false;
+    }
+    this->buffer.reset();
+    return true;
+}
+
 void SidebarPreviewBaseEntry::repaint() { sidebar->getControl()->getScheduler()->addRepaintSidebar(this); }
 
 void SidebarPreviewBaseEntry::drawLoadingPage() {
@@ -109,6 +121,10 @@ void SidebarPreviewBaseEntry::paint(cairo_t* cr) {
 
     this->drawingMutex.unlock();
 
+    if (!doRepaint) {
+        sidebar->getControl()->getRenderCache()->touch(this, 0);
+    }
+
     double height = page->getHeight() * sidebar->getZoom();
     double width = page->getWidth() * sidebar->getZoom();
 
@@ -17,7 +17,8 @@
 #include <glib.h>     // for gboolean
 #include <gtk/gtk.h>  // for GtkWidget
 
-#include "model/PageRef.h"  // for PageRef
+#include "control/RenderCache.h"  // for RenderCache
+#include "model/PageRef.h"        // for PageRef
 #include "util/raii/CairoWrappers.h"
 #include "util/raii/GObjectSPtr.h"
 
@@ -41,10 +42,10 @@ typedef enum {
 } PreviewRenderType;
 
 
-class SidebarPreviewBaseEntry {
+class SidebarPreviewBaseEntry: public RenderCache::Client {
 public:
     SidebarPreviewBaseEntry(SidebarPreviewBase* sidebar, const PageRef& page);
-    virtual ~SidebarPreviewBaseEntry();
+    ~SidebarPreviewBaseEntry() override;
 
 public:
     virtual GtkWidget* getWidget() const;
@@ -56,6 +57,11 @@ public:
     virtual void repaint();
     virtual void updateSize();
 
+    /**
+     * Deletes the buffer, it is rendered again when the preview is shown, see RenderCache
+     */
+    bool evictRenderCache(size_t id) override;
+
     /**
      * @return What should be rendered
      */
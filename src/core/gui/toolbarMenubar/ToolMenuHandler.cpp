@@ -300,7 +300,9 @@ void ToolMenuHandler::initToolItems() {
     // Undo / Redo Texts are updated
     emplaceItem<TooltipToolButton>(
             "UNDO", Cat::MISC, Action::UNDO, iconName("edit-undo"), _("Undo"),
-            [undoredo = control->getUndoRedoHandler()]() { return undoredo->undoDescription(); });
+            [undoredo = control->getUndoRedoHandler()]() {
+                return undoredo->undoDescription() + "\n" + undoredo->getMemoryUsageDescription();
+            });
     emplaceItem<TooltipToolButton>(
             "REDO", Cat::MISC, Action::REDO, iconName("edit-redo"), _("Redo"),
             [undoredo = control->getUndoRedoHandler()]() { return undoredo->redoDescription(); });
@@ -238,6 +238,9 @@ void gtk_xournal_repaint_area(GtkWidget* widget, int x1, int y1, int x2, int y2)
     gtk_widget_queue_draw_area(widget, x1, y1, x2 - x1, y2 - y1);
 }
 
+/// Padding around the bounding box of a selection, covering its handles and buttons
+static constexpr double SELECTION_PADDING = 40;
+
 static auto gtk_xournal_draw(GtkWidget* widget, cairo_t* cr) -> gboolean {
     g_return_val_if_fail(widget != nullptr, false);
     g_return_val_if_fail(GTK_IS_XOURNAL(widget), false);
@@ -265,23 +268,41 @@ static auto gtk_xournal_draw(GtkWidget* widget, cairo_t* cr) -> gboolean {
     Util::cairo_set_source_rgbi(cr, settings->getBackgroundColor());
     cairo_paint(cr);
 
+    std::optional<Recolor> recolor = settings->getRecolorParameters().recolorizeMainView ?
+                                             std::make_optional(settings->getRecolorParameters().recolor) :
+                                             std::nullopt;
+
     // Add a padding for the shadow of the pages
     xoj::util::Rectangle<double> clippingRect(x1 - 10, y1 - 10, x2 - x1 + 20, y2 - y1 + 20);
 
+    std::vector<XojPageView*> visiblePages;
     for (auto&& pv: xournal->view->getViewPages()) {
-        int px = pv->getX();
-        int py = pv->getY();
-        int pw = pv->getDisplayWidth();
-        int ph = pv->getDisplayHeight();
-
-        if (!clippingRect.intersects(pv->getRect())) {
-            continue;
+        if (clippingRect.intersects(pv->getRect())) {
+            visiblePages.push_back(pv.get());
         }
+    }
 
-        gtk_xournal_draw_shadow(xournal, cr, px, py, pw, ph, pv->isSelected());
+    for (XojPageView* pv: visiblePages) {
+        gtk_xournal_draw_shadow(xournal, cr, pv->getX(), pv->getY(), pv->getDisplayWidth(), pv->getDisplayHeight(),
+                                pv->isSelected());
+    }
 
+    if (recolor) {
+        // Only the background and the shadows around the pages are recolored here: the pages paint recolored tiles
         cairo_save(cr);
-        cairo_translate(cr, px, py);
+        cairo_rectangle(cr, x1, y1, x2 - x1, y2 - y1);
+        for (XojPageView* pv: visiblePages) {
+            cairo_rectangle(cr, pv->getX(), pv->getY(), pv->getDisplayWidth(), pv->getDisplayHeight());
+        }
+        cairo_set_fill_rule(cr, CAIRO_FILL_RULE_EVEN_ODD);
+        cairo_clip(cr);
+        recolor->recolorCurrentCairoRegion(cr);
+        cairo_restore(cr);
+    }
+
+    for (XojPageView* pv: visiblePages) {
+        cairo_save(cr);
+        cairo_translate(cr, pv->getX(), pv->getY());
 
         pv->paintPage(cr, nullptr);
         cairo_restore(cr);
@@ -292,20 +313,24 @@ static auto gtk_xournal_draw(GtkWidget* widget, cairo_t* cr) -> gboolean {
         double zoom = xournal->view->getZoom();
 
         LegacyRedrawable* red = xournal->selection->getView();
-        cairo_translate(cr, red->getX(), red->getY());
-
-        xournal->selection->paint(cr, zoom);
+        auto paintSelection = [&](cairo_t* cr) {
+            cairo_translate(cr, red->getX(), red->getY());
+            xournal->selection->paint(cr, zoom);
+        };
+
+        if (recolor) {
+            // Restrict the recolored group to the selection and the handles around it
+            auto bbox = xournal->selection->getBoundingBoxInView();
+            cairo_rectangle(cr, bbox.x - SELECTION_PADDING, bbox.y - SELECTION_PADDING,
+                            bbox.width + 2 * SELECTION_PADDING, bbox.height + 2 * SELECTION_PADDING);
+            cairo_clip(cr);
+            recolor->paintRecolored(cr, paintSelection);
+        } else {
+            paintSelection(cr);
+        }
         cairo_restore(cr);
     }
 
-    std::optional<Recolor> recolor = settings->getRecolorParameters().recolorizeMainView ?
-                                             std::make_optional(settings->getRecolorParameters().recolor) :
-                                             std::nullopt;
-
-    if (recolor) {
-        recolor->recolorCurrentCairoRegion(cr);
-    }
-
     return true;
 }
 
@@ -38,7 +38,6 @@ struct BackgroundImage::Content {
 
     fs::path path;
     GdkPixbuf* pixbuf = nullptr;
-    int pageId = -1;
     bool attach = false;
 };
 
@@ -52,15 +51,7 @@ void BackgroundImage::loadFile(GInputStream* stream, fs::path const& path, GErro
     this->img = std::make_shared<Content>(stream, path, error);
 }
 
-auto BackgroundImage::getCloneId() const -> int { return this->img ? this->img->pageId : -1; }
-
-void BackgroundImage::setCloneId(int id) {
-    if (this->img) {
-        this->img->pageId = id;
-    }
-}
-
-void BackgroundImage::clearSaveState() { this->setCloneId(-1); }
+auto BackgroundImage::getContentKey() const -> const void* { return this->img.get(); }
 
 auto BackgroundImage::getFilepath() const -> fs::path { return this->img ? this->img->path : fs::path{}; }
 
@@ -27,9 +27,11 @@ struct BackgroundImage {
     void loadFile(fs::path const& filepath, GError** error);
     void loadFile(GInputStream* stream, fs::path const& filepath, GError** error);
 
-    int getCloneId() const;
-    void setCloneId(int id);
-    void clearSaveState();
+    /**
+     * Identifies the content of the image, shared by the copies of this BackgroundImage (e.g. the pages using the
+     * same image, or a snapshot of the document). nullptr if empty.
+     */
+    const void* getContentKey() const;
 
     fs::path getFilepath() const;
     void setFilepath(fs::path filepath);
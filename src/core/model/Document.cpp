@@ -1,10 +1,13 @@
 #include "Document.h"
 
-#include <codecvt>  // for codecvt_utf8_utf16
+#include <algorithm>  // for sort
+#include <codecvt>    // for codecvt_utf8_utf16
 #include <cstddef>
 #include <ctime>  // for size_t, localtime, strf...
 #include <iomanip>
 #include <memory>
+#include <numeric>       // for iota
+#include <shared_mutex>  // for shared_lock
 #include <sstream>
 #include <string>  // for string
 #include <string_view>
@@ -89,6 +92,10 @@ void Document::unlock() {
 */
 auto Document::tryLock() -> bool { return this->documentLock.try_lock(); }
 
+void Document::lock_shared() { this->documentLock.lock_shared(); }
+
+void Document::unlock_shared() { this->documentLock.unlock_shared(); }
+
 void Document::clearDocument(bool destroy) {
     if (this->preview) {
         cairo_surface_destroy(this->preview);
@@ -108,6 +115,7 @@ void Document::clearDocument(bool destroy) {
 
     this->pages.clear();
     this->pageIndex.reset();
+    this->pageNumbers.clear();
     freeTreeContentModel();
 
     this->filepath = fs::path{};
@@ -288,11 +296,14 @@ void Document::buildTreeContentsModel(GtkTreeIter* parent, XojPdfBookmarkIterato
 
 void Document::indexPdfPages() {
     auto index = std::make_unique<PageIndex>();
+    this->pageNumbers.clear();
+    this->pageNumbers.reserve(this->pages.size());
     for (size_t i = 0; i < this->pages.size(); ++i) {
         const auto& p = this->pages[i];
         if (p->getBackgroundType().isPdfPage()) {
             index->emplace(p->getPdfPageNr(), i);
         }
+        this->pageNumbers.emplace(p.get(), i);
     }
     this->pageIndex.swap(index);
 }
@@ -442,15 +453,9 @@ void Document::addPage(const PageRef& p) {
     updateIndexPageNumbers();
 }
 
-auto Document::indexOf(const PageRef& page) -> size_t {
-    for (size_t i = 0; i < this->pages.size(); i++) {
-        PageRef pg = this->pages[i];
-        if (pg == page) {
-            return i;
-        }
-    }
-
-    return npos;
+auto Document::indexOf(const PageRef& page) const -> size_t {
+    auto it = this->pageNumbers.find(page.get());
+    return it == this->pageNumbers.end() ? npos : it->second;
 }
 
 auto Document::getPage(size_t page) const -> PageRef {
@@ -496,6 +501,73 @@ auto Document::operator=(const Document& doc) -> Document& {
     return *this;
 }
 
+auto Document::createSnapshot() const -> std::unique_ptr<Document> {
+    std::vector<size_t> pageIndices(this->pages.size());
+    std::iota(pageIndices.begin(), pageIndices.end(), size_t{0});
+    return createSnapshot(pageIndices);
+}
+
+auto Document::createSnapshot(const std::vector<size_t>& pageIndices) const -> std::unique_ptr<Document> {
+    auto snapshot = std::make_unique<Document>(nullptr);
+
+    snapshot->pdfDocument = this->pdfDocument;
+    snapshot->filepath = this->filepath;
+    snapshot->pdfFilepath = this->pdfFilepath;
+    snapshot->attachPdf = this->attachPdf;
+    snapshot->pathStorageMode = this->pathStorageMode;
+    snapshot->setPreview(this->preview);
+
+    snapshot->pages.reserve(pageIndices.size());
+    for (size_t i: pageIndices) {
+        const PageRef& p = this->pages[i];
+        std::shared_lock pageLock(p->getContentLock());
+        snapshot->pages.emplace_back(p->clone());
+    }
+    snapshot->indexPdfPages();
+
+    return snapshot;
+}
+
+auto Document::unloadLazyPages(size_t budget, size_t keepPage) -> size_t {
+    size_t loadedSize = 0;
+    std::vector<size_t> candidates;
+    for (size_t i = 0; i < this->pages.size(); i++) {
+        const PageRef& p = this->pages[i];
+        if (p->isContentLoaded()) {
+            loadedSize += p->getLazyContentSize();
+            if (i != keepPage && p->getLazyContentSize() > 0) {
+                candidates.push_back(i);
+            }
+        }
+    }
+    if (loadedSize <= budget) {
+        return 0;
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [this](size_t a, size_t b) {
+        return this->pages[a]->getLastContentAccess() < this->pages[b]->getLastContentAccess();
+    });
+
+    size_t unloaded = 0;
+    for (size_t i: candidates) {
+        const PageRef& p = this->pages[i];
+        // The page is being read by another thread (rendering, export, ...): keep it
+        std::unique_lock pageLock(p->getContentLock(), std::try_to_lock);
+        if (!pageLock.owns_lock()) {
+            continue;
+        }
+        size_t size = p->getLazyContentSize();
+        if (p->unloadContent()) {
+            loadedSize -= size;
+            unloaded++;
+            if (loadedSize <= budget) {
+                break;
+            }
+        }
+    }
+    return unloaded;
+}
+
 void Document::setCreateBackupOnSave(bool backup) { this->createBackupOnSave = backup; }
 
 auto Document::shouldCreateBackupOnSave() const -> bool { return this->createBackupOnSave; }
@@ -5,6 +5,13 @@
  *
  * All methods are unlocked, you need to lock the document before you change something and unlock after.
  *
+ * Locking model:
+ *  - lock() / unlock() (exclusive): required to change the document structure (insert / delete pages, PDF background,
+ *    ...). Holding it excludes everybody else, so it may also be used to modify any page.
+ *  - lock_shared() / unlock_shared(): enough to read the document structure. Readers of page contents (rendering,
+ *    exporting, saving) additionally hold the page's content lock shared, writers modifying a single page hold it
+ *    exclusively (see XojPage::getContentLock()). The document lock is always taken before a page lock.
+ *
  * @author Xournal++ Team
  * https://github.com/xournalpp/xournalpp
  *
@@ -16,6 +23,7 @@
 #include <cstddef>        // for size_t
 #include <memory>         // for unique_ptr
 #include <mutex>          // for mutex
+#include <shared_mutex>   // for shared_mutex
 #include <string>         // for string
 #include <unordered_map>  // for unordered_map
 #include <vector>         // for vector
@@ -65,7 +73,10 @@ public:
     static double getPageWidth(PageRef p);
     static double getPageHeight(PageRef p);
 
-    size_t indexOf(const PageRef& page);
+    /**
+     * @return The index of the page in the document, npos if it is not in the document. Constant time.
+     */
+    size_t indexOf(const PageRef& page) const;
 
     /**
      * @return The last error message to show to the user
@@ -76,6 +87,33 @@ public:
 
     Document& operator=(const Document& doc);
 
+    /**
+     * Creates a copy of the document which can be read from another thread while this document is being edited.
+     * The pages are cloned (the point data of the strokes is shared until modified), the PDF background is shared.
+     *
+     * The document must be locked (at least shared) by the caller, each page is locked while it is copied.
+     * The snapshot has no DocumentHandler: it may not be modified.
+     */
+    std::unique_ptr<Document> createSnapshot() const;
+
+    /**
+     * Same as createSnapshot(), but only the given pages are copied (in the given order)
+     */
+    std::unique_ptr<Document> createSnapshot(const std::vector<size_t>& pageIndices) const;
+
+    /**
+     * Unloads the layers of the pages loaded lazily (see XojPage::setLazyContent()) that were accessed least recently,
+     * until the estimated size of the loaded layers fits in the budget. The page keepPage is never unloaded, neither
+     * are pages currently locked by another thread.
+     *
+     * Only call this on the UI thread, with the document locked exclusively: the readers of a page may be holding
+     * Layer or Element pointers obtained through its const getters.
+     *
+     * @param budget The budget, in bytes
+     * @return The number of pages unloaded
+     */
+    size_t unloadLazyPages(size_t budget, size_t keepPage);
+
     void setFilepath(fs::path filepath);
     fs::path getFilepath() const;
     fs::path getPdfFilepath() const;
@@ -101,6 +139,12 @@ public:
     void unlock();
     bool tryLock();
 
+    /**
+     * Shared locking of the document structure, named to be usable with std::shared_lock<Document>
+     */
+    void lock_shared();
+    void unlock_shared();
+
     inline Util::PathStorageMode getPathStorageMode() const { return pathStorageMode; }
     inline void setPathStorageMode(Util::PathStorageMode m) { pathStorageMode = m; }
 
@@ -158,7 +202,12 @@ private:
     std::unique_ptr<PageIndex> pageIndex;
 
     /**
-     * Creates an index from pdf page number to document page number
+     * Index from page to document page number, see indexOf(). Rebuilt with the pdf page index.
+     */
+    std::unordered_map<const XojPage*, size_t> pageNumbers;
+
+    /**
+     * Creates an index from pdf page number to document page number, and the index of the pages
      *
      * Clears the index first in case it is already exists.
      */
@@ -182,7 +231,7 @@ private:
     /**
      * The lock of the document
      */
-    std::mutex documentLock;
+    std::shared_mutex documentLock;
     
     /**
      * Eraser motion recording for video export
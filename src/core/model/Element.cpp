@@ -1,11 +1,14 @@
 #include "Element.h"
 
 #include <algorithm>  // for max, min
+#include <array>      // for array
 #include <cmath>      // for ceil, floor, NAN
-#include <cstdint>    // for uint32_t
+#include <cstdint>    // for uint32_t, uintptr_t
+#include <mutex>      // for mutex, lock_guard
 
 #include <glib.h>  // for gint
 
+#include "model/LayerSpatialIndex.h"              // for LayerSpatialIndex
 #include "util/safe_casts.h"                      // for as_unsigned
 #include "util/serializing/ObjectInputStream.h"   // for ObjectInputStream
 #include "util/serializing/ObjectOutputStream.h"  // for ObjectOutputStream
@@ -14,38 +17,48 @@ using xoj::util::Rectangle;
 
 Element::Element(ElementType type): type(type) {}
 
+/// The size computations are serialized by a few mutexes shared by all the elements, instead of one per element
+static auto sizeMutex(const Element* e) -> std::mutex& {
+    static std::array<std::mutex, 16> mutexes;
+    return mutexes[(reinterpret_cast<std::uintptr_t>(e) / alignof(Element)) % mutexes.size()];
+}
+
+void Element::ensureSizeCalculated() const {
+    if (this->sizeCalculated) {
+        return;
+    }
+    std::lock_guard lock(sizeMutex(this));
+    if (!this->sizeCalculated) {
+        calcSize();
+        this->sizeCalculated = true;
+    }
+}
+
 auto Element::getType() const -> ElementType { return this->type; }
 
 void Element::setX(double x) {
     this->x = x;
     this->sizeCalculated = false;
+    boundsChanged();
 }
 
 void Element::setY(double y) {
     this->y = y;
     this->sizeCalculated = false;
+    boundsChanged();
 }
 
 auto Element::getX() const -> double {
-    if (!this->sizeCalculated) {
-        this->sizeCalculated = true;
-        calcSize();
-    }
+    ensureSizeCalculated();
     return x;
 }
 
 auto Element::getY() const -> double {
-    if (!this->sizeCalculated) {
-        this->sizeCalculated = true;
-        calcSize();
-    }
+    ensureSizeCalculated();
     return y;
 }
 auto Element::getSnappedBounds() const -> Rectangle<double> {
-    if (!this->sizeCalculated) {
-        this->sizeCalculated = true;
-        calcSize();
-    }
+    ensureSizeCalculated();
     return this->snappedBounds;
 }
 
@@ -53,21 +66,22 @@ void Element::move(double dx, double dy) {
     this->x += dx;
     this->y += dy;
     this->snappedBounds = this->snappedBounds.translated(dx, dy);
+    boundsChanged();
 }
 
-auto Element::getElementWidth() const -> double {
-    if (!this->sizeCalculated) {
-        this->sizeCalculated = true;
-        calcSize();
+void Element::boundsChanged() {
+    if (this->indexLink.index) {
+        this->indexLink.index->markDirty(this);
     }
+}
+
+auto Element::getElementWidth() const -> double {
+    ensureSizeCalculated();
     return this->width;
 }
 
 auto Element::getElementHeight() const -> double {
-    if (!this->sizeCalculated) {
-        this->sizeCalculated = true;
-        calcSize();
-    }
+    ensureSizeCalculated();
     return this->height;
 }
 
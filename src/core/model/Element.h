@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <atomic>   // for atomic_bool, memory_order_acquire
 #include <cstddef>  // for ptrdiff_t
 #include <memory>   // for unique_ptr
 #include <vector>   // for vector
@@ -21,6 +22,7 @@
 #include "util/Rectangle.h"                 // for Rectangle
 #include "util/serializing/Serializable.h"  // for Serializable
 
+class LayerSpatialIndex;
 class ObjectInputStream;
 class ObjectOutputStream;
 
@@ -90,9 +92,40 @@ private:
 protected:
     virtual void calcSize() const = 0;
 
+    /**
+     * Calls calcSize() if the size is not calculated yet. Several threads may read the same page at once (e.g. the
+     * main view and the sidebar previews): the computation is serialized, and the size is only seen once complete.
+     */
+    void ensureSizeCalculated() const;
+
+    /**
+     * Must be called by every method changing the bounding box of the element, so that the spatial index of the
+     * Layer containing the element (if any) stays up to date.
+     */
+    void boundsChanged();
+
 protected:
+    /**
+     * A bool which can be read by several threads at once, and copied with the element. Reading true guarantees the
+     * size written before setting it is visible.
+     */
+    class SizeFlag {
+    public:
+        SizeFlag() = default;
+        SizeFlag(const SizeFlag& other): value(static_cast<bool>(other)) {}
+        SizeFlag& operator=(const SizeFlag& other) { return *this = static_cast<bool>(other); }
+        SizeFlag& operator=(bool v) {
+            value.store(v, std::memory_order_release);
+            return *this;
+        }
+        operator bool() const { return value.load(std::memory_order_acquire); }
+
+    private:
+        std::atomic_bool value = false;
+    };
+
     // If the size has been calculated
-    mutable bool sizeCalculated = false;
+    mutable SizeFlag sizeCalculated;
 
     mutable double width = 0;
     mutable double height = 0;
@@ -114,6 +147,19 @@ private:
      * The color in RGB format
      */
     Color color{0U};
+
+    /**
+     * The spatial index of the Layer containing this element. A copy of an element is not part of any Layer.
+     */
+    struct IndexLink {
+        IndexLink() = default;
+        IndexLink(const IndexLink&) {}
+        IndexLink& operator=(const IndexLink&) { return *this; }
+
+        LayerSpatialIndex* index = nullptr;
+    } indexLink;
+
+    friend class LayerSpatialIndex;
 };
 
 namespace xoj {
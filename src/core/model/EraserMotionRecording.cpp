@@ -12,10 +12,22 @@
 
 #include "EraserMotionRecording.h"
 
+#include <iterator>  // for make_move_iterator
+#include <utility>   // for move
+
 void EraserMotionRecording::addMotionPoint(const Point& point, size_t timestamp, double eraserSize, size_t pageIndex) {
     motionPoints.emplace_back(point, timestamp, eraserSize, pageIndex);
 }
 
+void EraserMotionRecording::addMotionPoints(std::vector<EraserMotionPoint> points) {
+    if (motionPoints.empty()) {
+        motionPoints = std::move(points);
+    } else {
+        motionPoints.insert(motionPoints.end(), std::make_move_iterator(points.begin()),
+                            std::make_move_iterator(points.end()));
+    }
+}
+
 void EraserMotionRecording::addAffectedStrokeToLast(size_t strokeIndex) {
     if (!motionPoints.empty()) {
         motionPoints.back().addAffectedStroke(strokeIndex);
@@ -65,6 +65,12 @@ public:
      */
     void addMotionPoint(const Point& point, size_t timestamp, double eraserSize, size_t pageIndex = 0);
 
+    /**
+     * @brief Append the motion points recorded during a gesture
+     * @param points The motion points, in chronological order
+     */
+    void addMotionPoints(std::vector<EraserMotionPoint> points);
+
     /**
      * @brief Add information about an affected stroke to the last motion point
      * @param strokeIndex Index of the affected stroke
@@ -1,14 +1,13 @@
 #include "Image.h"
 
 #include <algorithm>  // for min
-#include <array>      // for array
 #include <cmath>      // for sqrt
 #include <memory>
 #include <utility>  // for move, pair
 
 #include <cairo.h>    // for cairo_surface_destroy
 #include <gdk/gdk.h>  // for gdk_cairo_set_sourc...
-#include <glib.h>     // for guchar
+#include <glib.h>     // for guchar, g_base64_decode
 
 #include "model/Element.h"   // for Element, ELEMENT_IMAGE
 #include "util/Assert.h"     // for xoj_assert
@@ -43,7 +42,11 @@ auto Image::clone() const -> ElementPtr {
     img->setColor(this->getColor());
     img->width = this->width;
     img->height = this->height;
+
+    std::lock_guard lock(this->dataMutex);
     img->data = this->data;
+    img->base64Data = this->base64Data;
+    img->imageSize = this->imageSize;
 
     img->image = cairo_surface_reference(this->image);
     img->snappedBounds = this->snappedBounds;
@@ -55,56 +58,55 @@ auto Image::clone() const -> ElementPtr {
 void Image::setWidth(double width) {
     this->width = width;
     this->calcSize();
+    boundsChanged();
 }
 
 void Image::setHeight(double height) {
     this->height = height;
     this->calcSize();
+    boundsChanged();
 }
 
 void Image::setImage(std::string_view data) { setImage(std::string(data)); }
 
 void Image::setImage(std::string&& data) {
+    std::lock_guard lock(this->dataMutex);
     if (this->image) {
         cairo_surface_destroy(this->image);
         this->image = nullptr;
     }
     this->data = std::move(data);
+    this->base64Data.clear();
+    this->imageSize = NOSIZE;
 
     if (this->format) {
         gdk_pixbuf_format_free(this->format);
         this->format = nullptr;
     }
+}
 
-    // FIXME: awful hack to try to parse the format
-    std::array<char*, 4096> buffer{};
-    xoj::util::GObjectSPtr<GdkPixbufLoader> loader(gdk_pixbuf_loader_new(), xoj::util::adopt);
-    size_t remaining = this->data.size();
-    while (remaining > 0) {
-        size_t readLen = std::min(remaining, buffer.size());
-        if (!gdk_pixbuf_loader_write(loader.get(), reinterpret_cast<const guchar*>(this->data.c_str()), readLen,
-                                     nullptr))
-            break;
-        remaining -= readLen;
+void Image::setImageBase64(std::string&& base64) {
+    setImage(std::string());
+    std::lock_guard lock(this->dataMutex);
+    this->base64Data = std::move(base64);
+}
 
-        // Try to determine the format early, if possible
-        this->format = gdk_pixbuf_loader_get_format(loader.get());
-        if (this->format) {
-            break;
-        }
-    }
-    gdk_pixbuf_loader_close(loader.get(), nullptr);
-    // if the format was not determined early, it can probably be determined now
-    if (!this->format) {
-        this->format = gdk_pixbuf_loader_get_format(loader.get());
+void Image::decodeBase64() const {
+    if (this->base64Data.empty()) {
+        return;
     }
-    xoj_assert_message(this->format != nullptr, "could not parse the image format!");
+    gsize length = 0;
+    guchar* decoded = g_base64_decode(this->base64Data.c_str(), &length);
+    this->data.assign(reinterpret_cast<const char*>(decoded), length);
+    g_free(decoded);
 
-    // the format is owned by the pixbuf, so create a copy
-    this->format = gdk_pixbuf_format_copy(this->format);
+    this->base64Data.clear();
+    this->base64Data.shrink_to_fit();
 }
 
 void Image::setImage(GdkPixbuf* img) {
+    std::lock_guard lock(this->dataMutex);
+    this->base64Data.clear();
     if (this->image) {
         cairo_surface_destroy(this->image);
         this->image = nullptr;
@@ -129,6 +131,12 @@ void Image::setImage(GdkPixbuf* img) {
 }
 
 auto Image::renderBuffer() const -> std::optional<std::string> {
+    std::lock_guard lock(this->dataMutex);
+    return renderBufferLocked();
+}
+
+auto Image::renderBufferLocked() const -> std::optional<std::string> {
+    decodeBase64();
     xoj_assert_message(data.length() > 0, "image has no data, cannot render it!");
     if (this->image) {
         // Already rendered
@@ -197,7 +205,8 @@ auto Image::renderBuffer() const -> std::optional<std::string> {
 }
 
 auto Image::getImage() const -> cairo_surface_t* {
-    if (auto opt = renderBuffer(); opt.has_value()) {
+    std::lock_guard lock(this->dataMutex);
+    if (auto opt = renderBufferLocked(); opt.has_value()) {
         // An error occurred
         g_warning("%s", opt->c_str());
     }
@@ -216,6 +225,7 @@ void Image::scale(double x0, double y0, double fx, double fy, double rotation,
     this->width *= fx;
     this->height *= fy;
     this->calcSize();
+    boundsChanged();
 }
 
 void Image::rotate(double x0, double y0, double th) {}
@@ -228,6 +238,8 @@ void Image::serialize(ObjectOutputStream& out) const {
     out.writeDouble(this->width);
     out.writeDouble(this->height);
 
+    std::lock_guard lock(this->dataMutex);
+    decodeBase64();
     out.writeImage(this->data);
 
     out.endObject();
@@ -241,12 +253,7 @@ void Image::readSerialized(ObjectInputStream& in) {
     this->width = in.readDouble();
     this->height = in.readDouble();
 
-    if (this->image) {
-        cairo_surface_destroy(this->image);
-        this->image = nullptr;
-    }
-
-    this->data = in.readImage();
+    setImage(in.readImage());
 
     in.endObject();
     this->calcSize();
@@ -257,12 +264,58 @@ void Image::calcSize() const {
     this->sizeCalculated = true;
 }
 
-bool Image::hasData() const { return !this->data.empty(); }
+bool Image::hasData() const {
+    std::lock_guard lock(this->dataMutex);
+    return !this->data.empty() || !this->base64Data.empty();
+}
 
-const unsigned char* Image::getRawData() const { return reinterpret_cast<const unsigned char*>(this->data.data()); }
+const unsigned char* Image::getRawData() const {
+    std::lock_guard lock(this->dataMutex);
+    decodeBase64();
+    return reinterpret_cast<const unsigned char*>(this->data.data());
+}
+
+size_t Image::getRawDataLength() const {
+    std::lock_guard lock(this->dataMutex);
+    decodeBase64();
+    return this->data.size();
+}
 
-size_t Image::getRawDataLength() const { return this->data.size(); }
+std::pair<int, int> Image::getImageSize() const {
+    std::lock_guard lock(this->dataMutex);
+    return this->imageSize;
+}
+
+GdkPixbufFormat* Image::getImageFormat() const {
+    std::lock_guard lock(this->dataMutex);
+    if (this->format) {
+        return this->format;
+    }
+    decodeBase64();
 
-std::pair<int, int> Image::getImageSize() const { return this->imageSize; }
+    // FIXME: awful hack to try to parse the format
+    constexpr size_t CHUNK_SIZE = 4096;
+    xoj::util::GObjectSPtr<GdkPixbufLoader> loader(gdk_pixbuf_loader_new(), xoj::util::adopt);
+    for (size_t pos = 0; pos < this->data.size(); pos += CHUNK_SIZE) {
+        size_t readLen = std::min(this->data.size() - pos, CHUNK_SIZE);
+        if (!gdk_pixbuf_loader_write(loader.get(), reinterpret_cast<const guchar*>(this->data.c_str() + pos), readLen,
+                                     nullptr))
+            break;
 
-GdkPixbufFormat* Image::getImageFormat() const { return this->format; }
+        // Try to determine the format early, if possible
+        this->format = gdk_pixbuf_loader_get_format(loader.get());
+        if (this->format) {
+            break;
+        }
+    }
+    gdk_pixbuf_loader_close(loader.get(), nullptr);
+    // if the format was not determined early, it can probably be determined now
+    if (!this->format) {
+        this->format = gdk_pixbuf_loader_get_format(loader.get());
+    }
+    xoj_assert_message(this->format != nullptr, "could not parse the image format!");
+
+    // the format is owned by the pixbuf, so create a copy
+    this->format = gdk_pixbuf_format_copy(this->format);
+    return this->format;
+}
@@ -12,6 +12,7 @@
 #pragma once
 
 #include <cstddef>      // for size_t
+#include <mutex>        // for mutex
 #include <optional>     // for optional
 #include <string>       // for string
 #include <string_view>  // for string_view
@@ -45,6 +46,9 @@ public:
     /// Set the image data by moving the data.
     void setImage(std::string&& data);
 
+    /// Set the image data from its base64 encoding. It is only decoded when first needed, e.g. for rendering.
+    void setImageBase64(std::string&& base64);
+
     /// Set the image data by copying the data from the provided pixbuf.
     ///
     /// \deprecated Pass the raw image data instead.
@@ -87,7 +91,16 @@ public:
 private:
     void calcSize() const override;
 
+    /// Decodes the data passed to setImageBase64(), if any. dataMutex must be locked.
+    void decodeBase64() const;
+
+    /// Renders the image, see renderBuffer(). dataMutex must be locked.
+    std::optional<std::string> renderBufferLocked() const;
+
 private:
+    /// Guards the lazily computed members below, so that the image can be rendered from several threads
+    mutable std::mutex dataMutex;
+
     /// Temporary surface used as a render buffer.
     mutable cairo_surface_t* image = nullptr;
 
@@ -95,5 +108,8 @@ private:
     mutable GdkPixbufFormat* format = nullptr;
     mutable std::pair<int, int> imageSize = {-1, -1};
 
-    std::string data;
+    mutable std::string data;
+
+    /// Base64 encoded data, not decoded yet
+    mutable std::string base64Data;
 };
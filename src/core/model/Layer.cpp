@@ -1,6 +1,9 @@
 #include "Layer.h"
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -38,6 +41,7 @@ void Layer::addElement(ElementPtr e) {
         return;
     }
 
+    this->spatialIndex.append(e.get());
     this->elements.emplace_back(std::move(e));
 }
 
@@ -56,13 +60,28 @@ void Layer::insertElement(ElementPtr e, Element::Index pos) {
 
     // If the element should be inserted at the top
     if (pos >= static_cast<int>(this->elements.size())) {
+        this->spatialIndex.append(e.get());
         this->elements.push_back(std::move(e));
     } else {
-        this->elements.insert(this->elements.begin() + pos, std::move(e));
+        auto it = this->elements.insert(this->elements.begin() + pos, std::move(e));
+        const Element* prev = it == this->elements.begin() ? nullptr : std::prev(it)->get();
+        this->spatialIndex.insert(it->get(), prev, std::next(it)->get(), this->elements);
     }
 }
 
 auto Layer::indexOf(const Element* e) const -> Element::Index {
+    if (auto order = this->spatialIndex.getOrder(e)) {
+        // The order keys are increasing along the list: bisect
+        auto it = std::lower_bound(this->elements.begin(), this->elements.end(), *order,
+                                   [&](const ElementPtr& elt, uint64_t o) {
+                                       return this->spatialIndex.getOrder(elt.get()).value_or(0) < o;
+                                   });
+        if (it != this->elements.end() && it->get() == e) {
+            return std::distance(this->elements.begin(), it);
+        }
+        xoj_assert(false);
+    }
+
     for (unsigned int i = 0; i < this->elements.size(); i++) {
         if (this->elements[i].get() == e) {
             return i;
@@ -75,6 +94,7 @@ auto Layer::indexOf(const Element* e) const -> Element::Index {
 auto Layer::removeElement(const Element* e) -> InsertionPosition {
     for (unsigned int i = 0; i < this->elements.size(); i++) {
         if (e == this->elements[i].get()) {
+            this->spatialIndex.remove(e);
             auto res = std::move(this->elements[i]);
             this->elements.erase(this->elements.begin() + i);
             return InsertionPosition{std::move(res), i};
@@ -88,6 +108,7 @@ auto Layer::removeElement(const Element* e) -> InsertionPosition {
 
 auto Layer::removeElementAt(const Element* e, Element::Index pos) -> InsertionPosition {
     if (pos >= 0 && as_unsigned(pos) < elements.size() && this->elements[as_unsigned(pos)].get() == e) {
+        this->spatialIndex.remove(e);
         auto iter = std::next(this->elements.begin(), pos);
         auto res = std::move(*iter);
         this->elements.erase(iter);
@@ -111,13 +132,17 @@ auto Layer::removeElementsAt(InsertionOrderRef const& elts) -> InsertionOrder {
                 continue;
             }
         }
+        this->spatialIndex.remove(e);
         res.emplace_back(std::move(elements[static_cast<size_t>(pos)]), pos);
     }
     this->elements.erase(std::remove(this->elements.begin(), this->elements.end(), nullptr), this->elements.end());
     return res;
 }
 
-auto Layer::clearNoFree() -> std::vector<ElementPtr> { return std::move(this->elements); }
+auto Layer::clearNoFree() -> std::vector<ElementPtr> {
+    this->spatialIndex.clear();
+    return std::move(this->elements);
+}
 
 auto Layer::isAnnotated() const -> bool { return !this->elements.empty(); }
 
@@ -137,6 +162,15 @@ auto Layer::getElementsView() const -> xoj::util::PointerContainerView<std::vect
     return this->elements;
 }
 
+auto Layer::getElementsInArea(const xoj::util::Rectangle<double>& area) -> std::vector<Element*> {
+    return this->spatialIndex.query(area);
+}
+
+auto Layer::getElementsInArea(const xoj::util::Rectangle<double>& area) const -> std::vector<const Element*> {
+    auto res = this->spatialIndex.query(area);
+    return {res.begin(), res.end()};
+}
+
 
 auto Layer::hasName() const -> bool { return name.has_value(); }
 
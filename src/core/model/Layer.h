@@ -18,9 +18,11 @@
 #include <vector>    // for vector
 
 #include "util/PointerContainerView.h"
+#include "util/Rectangle.h"  // for Rectangle
 
 #include "Element.h"                   // for Element, Element::Index
 #include "ElementInsertionPosition.h"  // for InsertionOrder
+#include "LayerSpatialIndex.h"         // for LayerSpatialIndex
 
 template <class T>
 using optional = std::optional<T>;
@@ -52,6 +54,15 @@ public:
      */
     auto indexOf(const Element* e) const -> Element::Index;
 
+    /**
+     * Returns the Element%s whose bounding box intersects (or touches) the given area, in drawing order.
+     * Callers needing an exact test should still check Element::intersectsArea() on the result.
+     *
+     * This uses the spatial index of the layer: the cost only depends on the number of elements near the area.
+     */
+    auto getElementsInArea(const xoj::util::Rectangle<double>& area) -> std::vector<Element*>;
+    auto getElementsInArea(const xoj::util::Rectangle<double>& area) const -> std::vector<const Element*>;
+
     /**
      * Removes an Element from the Layer and optionally deletes it
      * @return the position the element occupied
@@ -120,6 +131,11 @@ public:
 private:
     std::vector<ElementPtr> elements;
 
+    /**
+     * Spatial index of the elements. Declared after `elements`, so it is destroyed first.
+     */
+    LayerSpatialIndex spatialIndex;
+
     bool visible = true;
 
     std::optional<std::string> name;
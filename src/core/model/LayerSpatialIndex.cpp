@@ -0,0 +1,263 @@
+#include "LayerSpatialIndex.h"
+
+#include <algorithm>  // for sort, find, clamp, remove_if, transform
+#include <cmath>      // for floor, isfinite
+#include <iterator>   // for back_inserter
+
+#include "util/Assert.h"  // for xoj_assert
+
+using xoj::util::Rectangle;
+
+/// Gap between two consecutive order keys when (re)numbering, leaving room for insertions
+static constexpr uint64_t ORDER_GAP = uint64_t{1} << 20U;
+
+/// Far away coordinates are clamped, so that the cell numbers fit in 32 bits
+static constexpr double COORDINATE_LIMIT = 1e9;
+
+LayerSpatialIndex::~LayerSpatialIndex() { clear(); }
+
+void LayerSpatialIndex::append(Element* e) {
+    std::lock_guard lock(mutex);
+    this->lastOrder += ORDER_GAP;
+    addUnlocked(e, this->lastOrder);
+}
+
+void LayerSpatialIndex::insert(Element* e, const Element* prev, const Element* next,
+                               const std::vector<ElementPtr>& elements) {
+    std::lock_guard lock(mutex);
+
+    auto orderOf = [&](const Element* elt) -> std::optional<uint64_t> {
+        if (auto it = entries.find(elt); it != entries.end()) {
+            return it->second.order;
+        }
+        return std::nullopt;
+    };
+
+    uint64_t lower = 0;
+    if (prev) {
+        auto o = orderOf(prev);
+        xoj_assert(o);
+        lower = o.value_or(0);
+    }
+    if (!next) {
+        this->lastOrder = std::max(this->lastOrder, lower) + ORDER_GAP;
+        addUnlocked(e, this->lastOrder);
+        return;
+    }
+    auto upper = orderOf(next);
+    xoj_assert(upper);
+
+    if (upper && *upper > lower + 1) {
+        addUnlocked(e, lower + (*upper - lower) / 2);
+    } else {
+        // No room left: give every element of the layer a fresh key
+        addUnlocked(e, 0);
+        renumberUnlocked(elements);
+    }
+}
+
+void LayerSpatialIndex::addUnlocked(Element* e, uint64_t order) {
+    auto [it, inserted] = entries.try_emplace(e, Entry{e, order});
+    xoj_assert(inserted);
+    if (!inserted) {
+        return;
+    }
+    e->indexLink.index = this;
+    // The bounding box is computed on the next query: new elements are often still being filled
+    it->second.dirty = true;
+    dirty.push_back(&it->second);
+}
+
+void LayerSpatialIndex::remove(const Element* e) {
+    std::lock_guard lock(mutex);
+    auto it = entries.find(e);
+    if (it == entries.end()) {
+        return;
+    }
+    Entry& entry = it->second;
+    if (entry.dirty) {
+        dirty.erase(std::find(dirty.begin(), dirty.end(), &entry));
+    } else {
+        unplaceUnlocked(entry);
+    }
+    entry.element->indexLink.index = nullptr;
+    entries.erase(it);
+}
+
+void LayerSpatialIndex::clear() {
+    std::lock_guard lock(mutex);
+    for (auto& [e, entry]: entries) {
+        entry.element->indexLink.index = nullptr;
+    }
+    entries.clear();
+    cells.clear();
+    unplaced.clear();
+    dirty.clear();
+    this->lastOrder = 0;
+}
+
+void LayerSpatialIndex::markDirty(const Element* e) {
+    std::lock_guard lock(mutex);
+    auto it = entries.find(e);
+    if (it == entries.end() || it->second.dirty) {
+        return;
+    }
+    unplaceUnlocked(it->second);
+    it->second.dirty = true;
+    dirty.push_back(&it->second);
+}
+
+auto LayerSpatialIndex::getOrder(const Element* e) const -> std::optional<uint64_t> {
+    std::lock_guard lock(mutex);
+    if (auto it = entries.find(e); it != entries.end()) {
+        return it->second.order;
+    }
+    return std::nullopt;
+}
+
+auto LayerSpatialIndex::size() const -> size_t {
+    std::lock_guard lock(mutex);
+    return entries.size();
+}
+
+auto LayerSpatialIndex::query(const Rectangle<double>& area) const -> std::vector<Element*> {
+    std::lock_guard lock(mutex);
+    flushDirtyUnlocked();
+
+    std::vector<Entry*> hits;
+    const uint64_t stamp = ++queryStamp;
+
+    auto visit = [&](Entry* entry) {
+        if (entry->stamp == stamp) {
+            return;
+        }
+        entry->stamp = stamp;
+        hits.push_back(entry);
+    };
+
+    for (Entry* entry: unplaced) {
+        visit(entry);
+    }
+
+    if (auto range = cellRangeOf(area)) {
+        // Iterate over the cells of the area, or over the occupied cells if that is cheaper
+        const auto areaCells = (int64_t{range->maxX} - range->minX + 1) * (int64_t{range->maxY} - range->minY + 1);
+        auto checkCell = [&](const std::vector<Entry*>& cell) {
+            for (Entry* entry: cell) {
+                xoj_assert(entry->cells);
+                const auto& c = *entry->cells;
+                if (c.maxX < range->minX || c.minX > range->maxX || c.maxY < range->minY || c.minY > range->maxY) {
+                    continue;
+                }
+                visit(entry);
+            }
+        };
+        if (areaCells <= static_cast<int64_t>(cells.size())) {
+            for (int32_t x = range->minX; x <= range->maxX; x++) {
+                for (int32_t y = range->minY; y <= range->maxY; y++) {
+                    if (auto it = cells.find(cellKey(x, y)); it != cells.end()) {
+                        checkCell(it->second);
+                    }
+                }
+            }
+        } else {
+            for (const auto& [key, cell]: cells) {
+                checkCell(cell);
+            }
+        }
+    }
+
+    // The cells are coarse: do the exact bounding box check on the candidates
+    auto outside = [&](const Entry* entry) {
+        if (!entry->cells) {
+            return false;
+        }
+        const auto b = entry->element->boundingRect();
+        return b.x > area.x + area.width || b.x + b.width < area.x || b.y > area.y + area.height ||
+               b.y + b.height < area.y;
+    };
+    hits.erase(std::remove_if(hits.begin(), hits.end(), outside), hits.end());
+
+    std::sort(hits.begin(), hits.end(), [](const Entry* a, const Entry* b) { return a->order < b->order; });
+
+    std::vector<Element*> result;
+    result.reserve(hits.size());
+    std::transform(hits.begin(), hits.end(), std::back_inserter(result), [](const Entry* e) { return e->element; });
+    return result;
+}
+
+void LayerSpatialIndex::placeUnlocked(Entry& entry) const {
+    xoj_assert(!entry.cells);
+    auto range = cellRangeOf(entry.element->boundingRect());
+    if (!range || (int64_t{range->maxX} - range->minX + 1) * (int64_t{range->maxY} - range->minY + 1) >
+                          MAX_CELLS_PER_ELEMENT) {
+        unplaced.push_back(&entry);
+        return;
+    }
+    entry.cells = range;
+    for (int32_t x = range->minX; x <= range->maxX; x++) {
+        for (int32_t y = range->minY; y <= range->maxY; y++) {
+            cells[cellKey(x, y)].push_back(&entry);
+        }
+    }
+}
+
+void LayerSpatialIndex::unplaceUnlocked(Entry& entry) {
+    if (!entry.cells) {
+        if (auto it = std::find(unplaced.begin(), unplaced.end(), &entry); it != unplaced.end()) {
+            *it = unplaced.back();
+            unplaced.pop_back();
+        }
+        return;
+    }
+    const auto& range = *entry.cells;
+    for (int32_t x = range.minX; x <= range.maxX; x++) {
+        for (int32_t y = range.minY; y <= range.maxY; y++) {
+            auto cellIt = cells.find(cellKey(x, y));
+            xoj_assert(cellIt != cells.end());
+            auto& cell = cellIt->second;
+            if (auto it = std::find(cell.begin(), cell.end(), &entry); it != cell.end()) {
+                *it = cell.back();
+                cell.pop_back();
+            }
+            if (cell.empty()) {
+                cells.erase(cellIt);
+            }
+        }
+    }
+    entry.cells.reset();
+}
+
+void LayerSpatialIndex::flushDirtyUnlocked() const {
+    for (Entry* entry: dirty) {
+        entry->dirty = false;
+        placeUnlocked(*entry);
+    }
+    dirty.clear();
+}
+
+void LayerSpatialIndex::renumberUnlocked(const std::vector<ElementPtr>& elements) {
+    uint64_t order = 0;
+    for (const auto& e: elements) {
+        if (auto it = entries.find(e.get()); it != entries.end()) {
+            order += ORDER_GAP;
+            it->second.order = order;
+        }
+    }
+    this->lastOrder = order;
+}
+
+auto LayerSpatialIndex::cellRangeOf(const Rectangle<double>& rect) -> std::optional<CellRange> {
+    if (!std::isfinite(rect.x) || !std::isfinite(rect.y) || !std::isfinite(rect.width) ||
+        !std::isfinite(rect.height) || rect.width < 0 || rect.height < 0) {
+        return std::nullopt;
+    }
+    auto cell = [](double v) {
+        return static_cast<int32_t>(std::floor(std::clamp(v, -COORDINATE_LIMIT, COORDINATE_LIMIT) / CELL_SIZE));
+    };
+    return CellRange{cell(rect.x), cell(rect.y), cell(rect.x + rect.width), cell(rect.y + rect.height)};
+}
+
+auto LayerSpatialIndex::cellKey(int32_t x, int32_t y) -> uint64_t {
+    return (uint64_t{static_cast<uint32_t>(x)} << 32U) | static_cast<uint32_t>(y);
+}
@@ -0,0 +1,140 @@
+/*
+ * Xournal++
+ *
+ * A spatial index of the elements of a layer
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstdint>        // for uint64_t
+#include <mutex>          // for mutex
+#include <optional>       // for optional
+#include <unordered_map>  // for unordered_map
+#include <vector>         // for vector
+
+#include "util/Rectangle.h"  // for Rectangle
+
+#include "Element.h"  // for Element, ElementPtr
+
+/**
+ * @brief Uniform grid over the bounding boxes of the Element%s of a Layer
+ *
+ * Each element is registered in every grid cell its bounding box touches. Elements covering a huge number of cells
+ * (or with an invalid bounding box) are kept in a separate list which is always returned as candidates.
+ *
+ * Every element also gets an order key, increasing with its position in the Layer. This allows returning query results
+ * in drawing order and finding the position of an element in the Layer by bisection.
+ *
+ * Elements notify the index whenever their bounding box changes (see Element::boundsChanged()). Such elements, as well
+ * as newly added ones, are kept in a dirty list and (re-)inserted in the grid on the next query, so that several
+ * modifications in a row only cost one insertion.
+ *
+ * All methods are internally synchronized, so queries may run concurrently from several render threads.
+ */
+class LayerSpatialIndex {
+public:
+    LayerSpatialIndex() = default;
+    LayerSpatialIndex(const LayerSpatialIndex&) = delete;
+    LayerSpatialIndex& operator=(const LayerSpatialIndex&) = delete;
+    ~LayerSpatialIndex();
+
+    /**
+     * Adds an element after all already indexed elements
+     */
+    void append(Element* e);
+
+    /**
+     * Adds an element between prev and next (any of which may be nullptr at the ends of the layer).
+     * If there is no room for a new order key, all keys are reassigned from `elements`, which must already contain e.
+     */
+    void insert(Element* e, const Element* prev, const Element* next, const std::vector<ElementPtr>& elements);
+
+    /**
+     * Removes an element from the index (does nothing if it is not indexed)
+     */
+    void remove(const Element* e);
+
+    /**
+     * Removes all elements from the index
+     */
+    void clear();
+
+    /**
+     * To be called when the bounding box of an indexed element changed
+     */
+    void markDirty(const Element* e);
+
+    /**
+     * @return the order key of the element, if it is indexed. Keys are increasing with the position in the layer.
+     */
+    auto getOrder(const Element* e) const -> std::optional<uint64_t>;
+
+    /**
+     * @return The elements whose bounding box intersects (or touches) the given area, in layer order.
+     * This is a superset of the elements for which Element::intersectsArea() returns true.
+     */
+    auto query(const xoj::util::Rectangle<double>& area) const -> std::vector<Element*>;
+
+    /**
+     * @return the number of indexed elements
+     */
+    auto size() const -> size_t;
+
+public:
+    /**
+     * Edge length of a grid cell, in page coordinates
+     */
+    static constexpr double CELL_SIZE = 32.0;
+
+    /**
+     * Elements covering more cells are not put in the grid
+     */
+    static constexpr int64_t MAX_CELLS_PER_ELEMENT = 256;
+
+private:
+    struct CellRange {
+        int32_t minX;
+        int32_t minY;
+        int32_t maxX;
+        int32_t maxY;
+    };
+
+    struct Entry {
+        Element* element;
+        uint64_t order;
+        /// The cells the element is registered in, if it is in the grid
+        std::optional<CellRange> cells;
+        bool dirty = false;
+        /// Last query which returned this element, used to skip duplicates
+        uint64_t stamp = 0;
+    };
+
+    void addUnlocked(Element* e, uint64_t order);
+    void placeUnlocked(Entry& entry) const;
+    void unplaceUnlocked(Entry& entry);
+    void flushDirtyUnlocked() const;
+    void renumberUnlocked(const std::vector<ElementPtr>& elements);
+
+    static auto cellRangeOf(const xoj::util::Rectangle<double>& rect) -> std::optional<CellRange>;
+    static auto cellKey(int32_t x, int32_t y) -> uint64_t;
+
+private:
+    mutable std::mutex mutex;
+
+    mutable std::unordered_map<const Element*, Entry> entries;
+    mutable std::unordered_map<uint64_t, std::vector<Entry*>> cells;
+
+    /// Elements not in the grid: huge or invalid bounding boxes
+    mutable std::vector<Entry*> unplaced;
+
+    /// Elements whose bounding box changed since they were put in the grid
+    mutable std::vector<Entry*> dirty;
+
+    uint64_t lastOrder = 0;
+    mutable uint64_t queryStamp = 0;
+};
@@ -0,0 +1,39 @@
+/*
+ * Xournal++
+ *
+ * The source of the layers of a page loaded on demand
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <memory>   // for unique_ptr
+#include <vector>   // for vector
+
+class Layer;
+
+/**
+ * @brief Creates the layers of a page when they are first accessed (see XojPage::setLazyContent())
+ *
+ * The content is immutable, so it can be shared by the copies of a page and used again after the layers have been
+ * unloaded.
+ */
+class LazyPageContent {
+public:
+    virtual ~LazyPageContent() = default;
+
+    /**
+     * Creates the layers of the page. May be called from any thread, also concurrently for different pages.
+     */
+    virtual std::vector<std::unique_ptr<Layer>> load() const = 0;
+
+    /**
+     * @return An estimate of the memory used by the layers once loaded, in bytes
+     */
+    virtual size_t getSize() const = 0;
+};
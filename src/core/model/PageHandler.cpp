@@ -9,7 +9,16 @@ class Rectangle;
 
 using xoj::util::Rectangle;
 
-PageHandler::PageHandler() = default;
+/**
+ * The revisions are ticks of a clock shared by all the pages, so that a new page never reuses the revision of a deleted
+ * page
+ */
+static auto nextRevision() -> uint64_t {
+    static std::atomic<uint64_t> clock = 0;
+    return ++clock;
+}
+
+PageHandler::PageHandler(): revision(nextRevision()) {}
 
 PageHandler::~PageHandler() = default;
 
@@ -17,24 +26,33 @@ void PageHandler::addListener(PageListener* l) { this->listeners.push_back(l); }
 
 void PageHandler::removeListener(PageListener* l) { this->listeners.remove(l); }
 
+auto PageHandler::getRevision() const -> uint64_t { return this->revision; }
+
+void PageHandler::bumpRevision() { this->revision = nextRevision(); }
+
 void PageHandler::fireRectChanged(Rectangle<double>& rect) {
+    bumpRevision();
     for (PageListener* pl: this->listeners) { pl->rectChanged(rect); }
 }
 
 void PageHandler::fireRangeChanged(Range& range) {
+    bumpRevision();
     for (PageListener* pl: this->listeners) { pl->rangeChanged(range); }
 }
 
 void PageHandler::fireElementChanged(const Element* elem) {
+    bumpRevision();
     for (PageListener* pl: this->listeners) { pl->elementChanged(elem); }
 }
 
 void PageHandler::fireElementsChanged(const std::vector<const Element*>& elements, Range range) {
+    bumpRevision();
     for (PageListener* pl: this->listeners) {
         pl->elementsChanged(elements, range);
     }
 }
 
 void PageHandler::firePageChanged() {
+    bumpRevision();
     for (PageListener* pl: this->listeners) { pl->pageChanged(); }
 }
@@ -11,7 +11,9 @@
 
 #pragma once
 
-#include <list>  // for list
+#include <atomic>   // for atomic
+#include <cstdint>  // for uint64_t
+#include <list>     // for list
 #include <vector>
 
 #include "util/Range.h"  // for Range
@@ -41,6 +43,18 @@ public:
     void fireElementsChanged(const std::vector<const Element*>& elements, Range range = Range());
     void firePageChanged();
 
+    /**
+     * @return A number increased by every change notification, and unique among all the pages: if it did not change,
+     * the page did not change either. May be called from any thread.
+     */
+    uint64_t getRevision() const;
+
+protected:
+    /**
+     * Marks the page as changed, for the changes which are not notified through the methods above
+     */
+    void bumpRevision();
+
 private:
     void addListener(PageListener* l);
     void removeListener(PageListener* l);
@@ -48,5 +62,7 @@ private:
 private:
     std::list<PageListener*> listeners;
 
+    std::atomic<uint64_t> revision;
+
     friend class PageListener;
 };
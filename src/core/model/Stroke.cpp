@@ -104,6 +104,7 @@ auto Stroke::cloneStroke() const -> std::unique_ptr<Stroke> {
     auto s = std::make_unique<Stroke>();
     s->applyStyleFrom(this);
     s->points = this->points;
+    s->contour = this->contour;
     s->x = this->x;
     s->y = this->y;
     s->Element::width = this->Element::width;
@@ -127,18 +128,19 @@ std::unique_ptr<Stroke> Stroke::cloneSection(const PathParameter& lowerBound, co
     auto s = std::make_unique<Stroke>();
     s->applyStyleFrom(this);
 
-    s->points.reserve(upperBound.index - lowerBound.index + 2);
+    auto& pts = s->points.mut();
+    pts.reserve(upperBound.index - lowerBound.index + 2);
 
-    s->points.emplace_back(this->getPoint(lowerBound));
+    pts.emplace_back(this->getPoint(lowerBound));
 
     auto beginIt = std::next(this->points.cbegin(), (std::ptrdiff_t)lowerBound.index + 1);
     auto endIt = std::next(this->points.cbegin(), (std::ptrdiff_t)upperBound.index + 1);
-    std::copy(beginIt, endIt, std::back_inserter(s->points));
+    std::copy(beginIt, endIt, std::back_inserter(pts));
 
-    s->points.emplace_back(this->getPoint(upperBound));
+    pts.emplace_back(this->getPoint(upperBound));
 
     // Remove unused pressure value
-    s->points.back().z = Point::NO_PRESSURE;
+    pts.back().z = Point::NO_PRESSURE;
 
     return s;
 }
@@ -152,22 +154,23 @@ std::unique_ptr<Stroke> Stroke::cloneCircularSectionOfClosedStroke(const PathPar
     auto s = std::make_unique<Stroke>();
     s->applyStyleFrom(this);
 
-    s->points.reserve(this->points.size() - startParam.index + endParam.index + 1);
+    auto& pts = s->points.mut();
+    pts.reserve(this->points.size() - startParam.index + endParam.index + 1);
 
-    s->points.emplace_back(this->getPoint(startParam));
+    pts.emplace_back(this->getPoint(startParam));
 
     auto startIt = std::next(this->points.cbegin(), (std::ptrdiff_t)startParam.index + 1);
     // Skip the last point: points.back().equalPos(points.front()) == true and we want this point only once
     xoj_assert(startIt != this->points.cend());
-    std::copy(startIt, std::prev(this->points.cend()), std::back_inserter(s->points));
+    std::copy(startIt, std::prev(this->points.cend()), std::back_inserter(pts));
 
     auto endIt = std::next(this->points.cbegin(), (std::ptrdiff_t)endParam.index + 1);
-    std::copy(this->points.cbegin(), endIt, std::back_inserter(s->points));
+    std::copy(this->points.cbegin(), endIt, std::back_inserter(pts));
 
-    s->points.emplace_back(this->getPoint(endParam));
+    pts.emplace_back(this->getPoint(endParam));
 
     // Remove unused pressure value
-    s->points.back().z = Point::NO_PRESSURE;
+    pts.back().z = Point::NO_PRESSURE;
 
     return s;
 }
@@ -211,8 +214,9 @@ void Stroke::readSerialized(ObjectInputStream& in) {
 
     this->capStyle = static_cast<StrokeCapStyle>(in.readInt());
 
-    in.readData(this->points);
+    in.readData(this->points.mut());
     this->lineStyle.readSerialized(in);
+    this->contour.invalidate();
 
     // Read motion recording if present (optional, for backward compatibility)
     // The serialization format includes a boolean flag first, so we just need
@@ -253,6 +257,7 @@ void Stroke::setFill(int fill) { this->fill = fill; }
 void Stroke::setWidth(double width) {
     this->width = width;
     this->sizeCalculated = false;
+    boundsChanged();
 }
 
 auto Stroke::getWidth() const -> double { return this->width; }
@@ -273,7 +278,9 @@ auto Stroke::isInSelection(ShapeContainer* container) const -> bool {
 }
 
 void Stroke::addPoint(const Point& p) {
-    this->points.emplace_back(p);
+    this->points.mut().emplace_back(p);
+    this->contour.invalidate();
+    boundsChanged();
     if (!sizeCalculated) {
         return;
     }
@@ -291,8 +298,10 @@ auto Stroke::getPointCount() const -> size_t { return this->points.size(); }
 auto Stroke::getPointVector() const -> std::vector<Point> const& { return points; }
 
 void Stroke::deletePointsFrom(size_t index) {
-    points.resize(std::min(index, points.size()));
+    points.mut().resize(std::min(index, points.size()));
+    this->contour.invalidate();
     this->sizeCalculated = false;
+    boundsChanged();
 }
 
 auto Stroke::getPoint(size_t index) const -> Point {
@@ -315,6 +324,7 @@ Point Stroke::getPoint(PathParameter parameter) const {
 auto Stroke::getPoints() const -> const Point* { return this->points.data(); }
 
 void Stroke::setPointVectorInternal(const Range* const snappingBox) {
+    this->contour.invalidate();
     if (!snappingBox || this->points.empty() || this->points.front().z != Point::NO_PRESSURE) {
         // We cannot deduce the bounding box from the snapping box if the stroke has pressure values
         this->sizeCalculated = false;
@@ -327,6 +337,7 @@ void Stroke::setPointVectorInternal(const Range* const snappingBox) {
         Element::height = snappingBox->getHeight() + this->width;
         this->sizeCalculated = true;
     }
+    boundsChanged();
 }
 
 void Stroke::setPointVector(const std::vector<Point>& other, const Range* const snappingBox) {
@@ -340,24 +351,29 @@ void Stroke::setPointVector(std::vector<Point>&& other, const Range* const snapp
 }
 
 
-void Stroke::freeUnusedPointItems() { this->points = {begin(this->points), end(this->points)}; }
+void Stroke::freeUnusedPointItems() { this->points = std::vector<Point>(this->points.begin(), this->points.end()); }
 
 void Stroke::setToolType(StrokeTool type) { this->toolType = type; }
 
 auto Stroke::getToolType() const -> StrokeTool { return this->toolType; }
 
-void Stroke::setLineStyle(const LineStyle& style) { this->lineStyle = style; }
+void Stroke::setLineStyle(const LineStyle& style) {
+    this->lineStyle = style;
+    this->contour.invalidate();
+}
 
 auto Stroke::getLineStyle() const -> const LineStyle& { return this->lineStyle; }
 
 void Stroke::move(double dx, double dy) {
-    for (auto&& point: points) {
+    for (auto&& point: points.mut()) {
         point.x += dx;
         point.y += dy;
     }
     Element::x += dx;
     Element::y += dy;
     Element::snappedBounds = Element::snappedBounds.translated(dx, dy);
+    this->contour.translate(dx, dy);
+    boundsChanged();
 }
 
 void Stroke::rotate(double x0, double y0, double th) {
@@ -367,10 +383,12 @@ void Stroke::rotate(double x0, double y0, double th) {
     cairo_matrix_rotate(&rotMatrix, th);
     cairo_matrix_translate(&rotMatrix, -x0, -y0);
 
-    for (auto&& p: points) {
+    for (auto&& p: points.mut()) {
         cairo_matrix_transform_point(&rotMatrix, &p.x, &p.y);
     }
+    this->contour.invalidate();
     this->sizeCalculated = false;
+    boundsChanged();
     // Width and Height will likely be changed after this operation
 }
 
@@ -384,7 +402,7 @@ void Stroke::scale(double x0, double y0, double fx, double fy, double rotation,
     cairo_matrix_rotate(&scaleMatrix, -rotation);
     cairo_matrix_translate(&scaleMatrix, -x0, -y0);
 
-    for (auto&& p: points) {
+    for (auto&& p: points.mut()) {
         cairo_matrix_transform_point(&scaleMatrix, &p.x, &p.y);
 
         if (p.z != Point::NO_PRESSURE) {
@@ -393,7 +411,9 @@ void Stroke::scale(double x0, double y0, double fx, double fy, double rotation,
     }
     this->width *= fz;
 
+    this->contour.invalidate();
     this->sizeCalculated = false;
+    boundsChanged();
 }
 
 auto Stroke::hasPressure() const -> bool {
@@ -403,8 +423,18 @@ auto Stroke::hasPressure() const -> bool {
     return false;
 }
 
+auto Stroke::getContour() const -> std::shared_ptr<const xoj::view::PrecomputedStrokeContour> {
+    return this->contour.get(this->points, this->lineStyle.getDashes());
+}
+
+auto Stroke::getCachedContour() const -> std::shared_ptr<const xoj::view::PrecomputedStrokeContour> {
+    return this->contour.getIfCached();
+}
+
+void Stroke::dropContour() const { this->contour.drop(); }
+
 auto Stroke::getAvgPressure() const -> double {
-    return std::accumulate(begin(this->points), end(this->points), 0.0,
+    return std::accumulate(this->points.begin(), this->points.end(), 0.0,
                            [](double l, Point const& p) { return l + p.z; }) /
            static_cast<double>(this->points.size());
 }
@@ -417,8 +447,8 @@ void Stroke::updateBoundsLastTwoPressures() {
     auto const pointCount = this->getPointCount();
     xoj_assert(pointCount >= 2);
 
-    Point& p = this->points.back();
-    Point& p2 = this->points[pointCount - 2];
+    const Point& p = this->points.back();
+    const Point& p2 = this->points[pointCount - 2];
     double pressure = p2.z;
 
     updateSnappedBounds(snappedBounds, p);
@@ -430,26 +460,31 @@ void Stroke::scalePressure(double factor) {
     if (!hasPressure()) {
         return;
     }
-    for (auto&& p: this->points) {
+    for (auto&& p: this->points.mut()) {
         p.z *= factor;
     }
+    this->contour.invalidate();
     this->sizeCalculated = false;
+    boundsChanged();
 }
 
 void Stroke::setLastPressure(double pressure) {
     if (!this->points.empty()) {
         xoj_assert(pressure != Point::NO_PRESSURE);
-        Point& back = this->points.back();
+        Point& back = this->points.mut().back();
         back.z = pressure;
+        this->contour.invalidate();
     }
 }
 
 void Stroke::setSecondToLastPressure(double pressure) {
     auto const pointCount = this->getPointCount();
     if (pointCount >= 2) {
-        Point& p = this->points[pointCount - 2];
+        Point& p = this->points.mut()[pointCount - 2];
         p.z = pressure;
+        this->contour.invalidate();
         updateBoundsLastTwoPressures();
+        boundsChanged();
     }
 }
 
@@ -461,9 +496,12 @@ void Stroke::setPressure(const std::vector<double>& pressure) {
     }
 
     auto max_size = std::min(pressure.size(), this->points.size() - 1);
+    auto& pts = this->points.mut();
     for (size_t i = 0U; i != max_size; ++i) {
-        this->points[i].z = pressure[i];
+        pts[i].z = pressure[i];
     }
+    this->contour.invalidate();
+    boundsChanged();
 }
 
 /**
@@ -16,11 +16,13 @@
 #include <vector>   // for vector
 
 #include "model/Element.h"
+#include "util/CopyOnWriteVector.h"  // for CopyOnWriteVector
 
 #include "AudioElement.h"     // for AudioElement
 #include "LineStyle.h"        // for LineStyle
 #include "MotionRecording.h"  // for MotionRecording
 #include "Point.h"            // for Point
+#include "StrokeContour.h"    // for StrokeContourCache, PrecomputedStrokeContour
 
 class Element;
 class ObjectInputStream;
@@ -177,6 +179,22 @@ public:
     bool hasPressure() const;
     double getAvgPressure() const;
 
+    /**
+     * @brief The contour of the stroke with pressure (dashed according to the line style), drawn by filling it.
+     * It is computed on first use and kept until the points or the line style change.
+     */
+    std::shared_ptr<const xoj::view::PrecomputedStrokeContour> getContour() const;
+
+    /**
+     * @return The contour of the stroke if it is computed already, nullptr otherwise
+     */
+    std::shared_ptr<const xoj::view::PrecomputedStrokeContour> getCachedContour() const;
+
+    /**
+     * Frees the contour, e.g. when the page leaves the view. It is computed again on the next call to getContour().
+     */
+    void dropContour() const;
+
     void move(double dx, double dy) override;
     void scale(double x0, double y0, double fx, double fy, double rotation, bool restoreLineWidth) override;
     void rotate(double x0, double y0, double th) override;
@@ -222,8 +240,11 @@ private:
     double width = 0;
     StrokeTool toolType = StrokeTool::PEN;
 
-    // The array with the points
-    std::vector<Point> points{};
+    // The array with the points, shared with the clones of the stroke until one of them is modified
+    xoj::util::CopyOnWriteVector<Point> points{};
+
+    /// The contour of the points, see getContour()
+    xoj::view::StrokeContourCache contour;
 
     /**
      * Dashed line
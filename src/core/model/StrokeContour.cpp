@@ -6,6 +6,7 @@
 #include "model/MathVect.h"
 #include "model/Point.h"
 #include "util/Assert.h"
+#include "util/raii/CairoWrappers.h"
 #include "util/safe_casts.h"
 
 static_assert(std::numeric_limits<double>::is_iec559);  // Ensures atan2(0., 0.) does not error
@@ -352,3 +353,92 @@ void xoj::view::StrokeContourDashes::drawDebug(cairo_t* cr) const {
         xtraFun(cr);
     }
 }
+
+
+// Precomputed contours
+
+/// Accuracy of the arcs of a precomputed contour, in points: the contour stays smooth up to a zoom of 1000%
+static constexpr double CONTOUR_TOLERANCE = 0.01;
+
+xoj::view::PrecomputedStrokeContour::PrecomputedStrokeContour(const std::vector<Point>& path,
+                                                              const std::vector<double>& dashPattern):
+        contour(nullptr, cairo_path_destroy) {
+    // The path is built on an identity matrix: it is in user space, whatever the context it is drawn to
+    xoj::util::CairoSurfaceSPtr surface(cairo_recording_surface_create(CAIRO_CONTENT_ALPHA, nullptr),
+                                        xoj::util::adopt);
+    xoj::util::CairoSPtr cr(cairo_create(surface.get()), xoj::util::adopt);
+    cairo_set_tolerance(cr.get(), CONTOUR_TOLERANCE);
+
+    if (dashPattern.empty()) {
+        StrokeContour(path).addToCairo(cr.get());
+    } else {
+        StrokeContourDashes(path, dashPattern).addToCairo(cr.get(), 0.);
+    }
+    this->contour.reset(cairo_copy_path(cr.get()));
+}
+
+xoj::view::PrecomputedStrokeContour::PrecomputedStrokeContour(const PrecomputedStrokeContour& other, double dx,
+                                                              double dy):
+        contour(nullptr, cairo_path_destroy) {
+    xoj::util::CairoSurfaceSPtr surface(cairo_recording_surface_create(CAIRO_CONTENT_ALPHA, nullptr),
+                                        xoj::util::adopt);
+    xoj::util::CairoSPtr cr(cairo_create(surface.get()), xoj::util::adopt);
+    // The path is appended in the translated user space, and copied back in the original one
+    cairo_translate(cr.get(), dx, dy);
+    other.addToCairo(cr.get());
+    cairo_identity_matrix(cr.get());
+    this->contour.reset(cairo_copy_path(cr.get()));
+}
+
+xoj::view::PrecomputedStrokeContour::~PrecomputedStrokeContour() = default;
+
+void xoj::view::PrecomputedStrokeContour::addToCairo(cairo_t* cr) const {
+    if (this->contour->status == CAIRO_STATUS_SUCCESS) {
+        cairo_append_path(cr, this->contour.get());
+    }
+}
+
+xoj::view::StrokeContourCache::StrokeContourCache() = default;
+
+xoj::view::StrokeContourCache::StrokeContourCache(const StrokeContourCache& other) {
+    std::lock_guard lock(other.mutex);
+    this->contour = other.contour;
+}
+
+auto xoj::view::StrokeContourCache::operator=(const StrokeContourCache& other) -> StrokeContourCache& {
+    if (this != &other) {
+        std::scoped_lock lock(this->mutex, other.mutex);
+        this->contour = other.contour;
+    }
+    return *this;
+}
+
+xoj::view::StrokeContourCache::~StrokeContourCache() = default;
+
+auto xoj::view::StrokeContourCache::get(const std::vector<Point>& path, const std::vector<double>& dashPattern) const
+        -> std::shared_ptr<const PrecomputedStrokeContour> {
+    std::lock_guard lock(this->mutex);
+    if (!this->contour) {
+        this->contour = std::make_shared<const PrecomputedStrokeContour>(path, dashPattern);
+    }
+    return this->contour;
+}
+
+auto xoj::view::StrokeContourCache::getIfCached() const -> std::shared_ptr<const PrecomputedStrokeContour> {
+    std::lock_guard lock(this->mutex);
+    return this->contour;
+}
+
+void xoj::view::StrokeContourCache::invalidate() { drop(); }
+
+void xoj::view::StrokeContourCache::translate(double dx, double dy) {
+    std::lock_guard lock(this->mutex);
+    if (this->contour) {
+        this->contour = std::make_shared<const PrecomputedStrokeContour>(*this->contour, dx, dy);
+    }
+}
+
+void xoj::view::StrokeContourCache::drop() const {
+    std::lock_guard lock(this->mutex);
+    this->contour.reset();
+}
@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include <memory>  // for shared_ptr, unique_ptr
+#include <mutex>   // for mutex
 #include <vector>  // for vector
 
 #include <cairo.h>
@@ -41,4 +43,56 @@ private:
     const std::vector<Point>& path;
     const std::vector<double>& dashPattern;
 };
+
+/**
+ * @brief The contour of a stroke (see StrokeContour and StrokeContourDashes), computed once.
+ *
+ * Adding it to a cairo context merely copies the path, instead of computing the angles and arcs along the whole
+ * stroke again. The contour is immutable: it can be drawn from several threads at once.
+ */
+class PrecomputedStrokeContour final {
+public:
+    /// Computes the contour of path, with dashes unless dashPattern is empty
+    PrecomputedStrokeContour(const std::vector<Point>& path, const std::vector<double>& dashPattern);
+    /// Copies the contour of other, translated by (dx, dy)
+    PrecomputedStrokeContour(const PrecomputedStrokeContour& other, double dx, double dy);
+    ~PrecomputedStrokeContour();
+    void addToCairo(cairo_t* cr) const;
+
+private:
+    std::unique_ptr<cairo_path_t, void (*)(cairo_path_t*)> contour;
+};
+
+/**
+ * @brief The contour of a stroke, computed on first use and kept until invalidate() or drop() is called.
+ * Copies share the contour of the original. Thread safe.
+ */
+class StrokeContourCache final {
+public:
+    StrokeContourCache();
+    StrokeContourCache(const StrokeContourCache& other);
+    StrokeContourCache& operator=(const StrokeContourCache& other);
+    ~StrokeContourCache();
+
+    /// Returns the contour of path, computing it if it is not cached
+    std::shared_ptr<const PrecomputedStrokeContour> get(const std::vector<Point>& path,
+                                                        const std::vector<double>& dashPattern) const;
+
+    /// Returns the contour if it is cached, nullptr otherwise
+    std::shared_ptr<const PrecomputedStrokeContour> getIfCached() const;
+
+    /// Drops the contour, after the stroke changed
+    void invalidate();
+
+    /// Moves the contour along with the stroke, instead of computing it again
+    void translate(double dx, double dy);
+
+    /// Frees the contour to save memory, the stroke did not change
+    void drop() const;
+
+private:
+    /// Guards contour
+    mutable std::mutex mutex;
+    mutable std::shared_ptr<const PrecomputedStrokeContour> contour;
+};
 };  // namespace xoj::view
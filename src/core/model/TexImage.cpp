@@ -1,12 +1,17 @@
 #include "TexImage.h"
 
+#include <cmath>    // for abs
+#include <limits>   // for numeric_limits
 #include <memory>
+#include <mutex>    // for lock_guard
 #include <utility>  // for move
 
+#include <glib.h>              // for g_base64_decode, g_free
 #include <poppler-document.h>  // for poppler_document_ge...
 #include <poppler-page.h>      // for poppler_page_get_size
 
 #include "model/Element.h"                        // for Element, ELEMENT_TE...
+#include "pdf/popplerapi/PopplerGlibDocument.h"   // for PopplerGlibDocument
 #include "util/Rectangle.h"                       // for Rectangle
 #include "util/raii/GObjectSPtr.h"                // for GObjectSPtr
 #include "util/serializing/ObjectInputStream.h"   // for ObjectInputStream
@@ -18,13 +23,16 @@ TexImage::TexImage(): Element(ELEMENT_TEXIMAGE) { this->sizeCalculated = true; }
 
 TexImage::~TexImage() { freeImageAndPdf(); }
 
-void TexImage::freeImageAndPdf() {
+void TexImage::freeImageAndPdf() const {
     if (this->image) {
         cairo_surface_destroy(this->image);
         this->image = nullptr;
     }
 
-    this->pdf.reset();
+    if (this->pdf) {
+        std::lock_guard lock(PopplerGlibDocument::getPopplerMutex());
+        this->pdf.reset();
+    }
 }
 
 auto TexImage::cloneTexImage() const -> std::unique_ptr<TexImage> {
@@ -39,6 +47,13 @@ auto TexImage::cloneTexImage() const -> std::unique_ptr<TexImage> {
     img->snappedBounds = this->snappedBounds;
     img->sizeCalculated = this->sizeCalculated;
 
+    std::lock_guard lock(this->dataMutex);
+    if (!this->pendingData.empty()) {
+        img->pendingData = this->pendingData;
+        img->pendingBase64 = this->pendingBase64;
+        return img;
+    }
+
     // Clone has a copy of our PDF.
     img->pdf = this->pdf;
 
@@ -55,14 +70,17 @@ auto TexImage::clone() const -> ElementPtr { return cloneTexImage(); }
 void TexImage::setWidth(double width) {
     this->width = width;
     this->calcSize();
+    boundsChanged();
 }
 
 void TexImage::setHeight(double height) {
     this->height = height;
     this->calcSize();
+    boundsChanged();
 }
 
-auto TexImage::cairoReadFunction(TexImage* image, unsigned char* data, unsigned int length) -> cairo_status_t {
+auto TexImage::cairoReadFunction(const TexImage* image, unsigned char* data, unsigned int length)
+        -> cairo_status_t {
     for (unsigned int i = 0; i < length; i++, image->read++) {
         if (image->read >= image->binaryData.length()) {
             return CAIRO_STATUS_READ_ERROR;
@@ -76,15 +94,54 @@ auto TexImage::cairoReadFunction(TexImage* image, unsigned char* data, unsigned
 /**
  * Gets the binary data, a .PNG image or a .PDF
  */
-auto TexImage::getBinaryData() const -> std::string const& { return this->binaryData; }
+auto TexImage::getBinaryData() const -> std::string const& {
+    std::lock_guard lock(this->dataMutex);
+    loadPendingData();
+    return this->binaryData;
+}
 
 void TexImage::setText(std::string text) { this->text = std::move(text); }
 
 auto TexImage::getText() const -> std::string { return this->text; }
 
 auto TexImage::loadData(std::string&& bytes, GError** err) -> bool {
+    std::lock_guard lock(this->dataMutex);
+    this->pendingData.clear();
+    this->freeImageAndPdf();
+    this->binaryData = std::move(bytes);
+    if (!loadBinaryData(err)) {
+        return false;
+    }
+
+    if (this->pdf && std::abs(this->width * this->height) <= std::numeric_limits<double>::epsilon()) {
+        std::lock_guard popplerLock(PopplerGlibDocument::getPopplerMutex());
+        xoj::util::GObjectSPtr<PopplerPage> page(poppler_document_get_page(this->pdf.get(), 0), xoj::util::adopt);
+        poppler_page_get_size(page.get(), &this->width, &this->height);
+    }
+    return true;
+}
+
+void TexImage::loadDataLazily(std::string&& bytes, bool base64) {
+    if (std::abs(this->width * this->height) <= std::numeric_limits<double>::epsilon()) {
+        // The size is read from the PDF
+        if (base64) {
+            gsize length = 0;
+            guchar* decoded = g_base64_decode(bytes.c_str(), &length);
+            bytes.assign(reinterpret_cast<const char*>(decoded), length);
+            g_free(decoded);
+        }
+        loadData(std::move(bytes), nullptr);
+        return;
+    }
+
+    std::lock_guard lock(this->dataMutex);
     this->freeImageAndPdf();
-    this->binaryData = bytes;
+    this->binaryData.clear();
+    this->pendingData = std::move(bytes);
+    this->pendingBase64 = base64;
+}
+
+auto TexImage::loadBinaryData(GError** err) const -> bool {
     if (this->binaryData.length() < 4) {
         return false;
     }
@@ -92,6 +149,7 @@ auto TexImage::loadData(std::string&& bytes, GError** err) -> bool {
     const std::string type = binaryData.substr(1, 3);
     if (type == "PDF") {
         // Note: binaryData must not be modified while pdf is live.
+        std::lock_guard lock(PopplerGlibDocument::getPopplerMutex());
         auto* bytes = g_bytes_new_with_free_func(this->binaryData.data(), this->binaryData.size(), nullptr, nullptr);
         this->pdf.reset(poppler_document_new_from_bytes(bytes, nullptr, err), xoj::util::adopt);
         g_bytes_unref(bytes);
@@ -99,13 +157,10 @@ auto TexImage::loadData(std::string&& bytes, GError** err) -> bool {
         if (!pdf.get() || poppler_document_get_n_pages(this->pdf.get()) < 1) {
             return false;
         }
-        if (std::abs(this->width * this->height) <= std::numeric_limits<double>::epsilon()) {
-            xoj::util::GObjectSPtr<PopplerPage> page(poppler_document_get_page(this->pdf.get(), 0), xoj::util::adopt);
-            poppler_page_get_size(page.get(), &this->width, &this->height);
-        }
     } else if (type == "PNG") {
+        this->read = 0;
         this->image = cairo_image_surface_create_from_png_stream(
-                reinterpret_cast<cairo_read_func_t>(&cairoReadFunction), this);
+                reinterpret_cast<cairo_read_func_t>(&cairoReadFunction), const_cast<TexImage*>(this));
     } else {
         g_warning("Unknown Latex image type: \"%s\"", type.c_str());
     }
@@ -113,9 +168,43 @@ auto TexImage::loadData(std::string&& bytes, GError** err) -> bool {
     return true;
 }
 
-auto TexImage::getImage() const -> cairo_surface_t* { return this->image; }
+void TexImage::loadPendingData() const {
+    if (this->pendingData.empty()) {
+        return;
+    }
 
-auto TexImage::getPdf() const -> PopplerDocument* { return this->pdf.get(); }
+    if (this->pendingBase64) {
+        gsize length = 0;
+        guchar* decoded = g_base64_decode(this->pendingData.c_str(), &length);
+        this->binaryData.assign(reinterpret_cast<const char*>(decoded), length);
+        g_free(decoded);
+    } else {
+        this->binaryData = std::move(this->pendingData);
+    }
+    this->pendingData.clear();
+    this->pendingData.shrink_to_fit();
+
+    GError* err = nullptr;
+    if (!loadBinaryData(&err)) {
+        g_warning("Could not load the LaTeX image \"%s\": %s", this->text.c_str(),
+                  err != nullptr ? err->message : "invalid data");
+    }
+    if (err != nullptr) {
+        g_error_free(err);
+    }
+}
+
+auto TexImage::getImage() const -> cairo_surface_t* {
+    std::lock_guard lock(this->dataMutex);
+    loadPendingData();
+    return this->image;
+}
+
+auto TexImage::getPdf() const -> PopplerDocument* {
+    std::lock_guard lock(this->dataMutex);
+    loadPendingData();
+    return this->pdf.get();
+}
 
 void TexImage::scale(double x0, double y0, double fx, double fy, double rotation,
                      bool) {  // line width scaling option is not used
@@ -126,6 +215,7 @@ void TexImage::scale(double x0, double y0, double fx, double fy, double rotation
     this->width *= fx;
     this->height *= fy;
     this->calcSize();
+    boundsChanged();
 }
 
 void TexImage::rotate(double x0, double y0, double th) {
@@ -141,6 +231,8 @@ void TexImage::serialize(ObjectOutputStream& out) const {
     out.writeDouble(this->height);
     out.writeString(this->text);
 
+    std::lock_guard lock(this->dataMutex);
+    loadPendingData();
     out.writeString(this->binaryData);
 
     out.endObject();
@@ -155,8 +247,6 @@ void TexImage::readSerialized(ObjectInputStream& in) {
     this->height = in.readDouble();
     this->text = in.readString();
 
-    freeImageAndPdf();
-
     std::string data = in.readString();
     this->loadData(std::move(data), nullptr);
 
@@ -12,6 +12,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>   // for mutex
 #include <string>  // for string
 
 #include <cairo.h>    // for cairo_surface_t, cairo_status_t
@@ -71,6 +72,14 @@ public:
      */
     bool loadData(std::string&& bytes, GError** err = nullptr);
 
+    /**
+     * Sets the binary data (PNG or PDF) without loading it: it is loaded when first needed, e.g. for rendering.
+     * The data is loaded immediately if the size of the image is not set yet, to read it from the PDF.
+     *
+     * @param base64 If the data is base64 encoded
+     */
+    void loadDataLazily(std::string&& bytes, bool base64);
+
 public:
     // Serialize interface
     void serialize(ObjectOutputStream& out) const override;
@@ -79,33 +88,54 @@ public:
 private:
     void calcSize() const override;
 
-    static cairo_status_t cairoReadFunction(TexImage* image, unsigned char* data, unsigned int length);
+    static cairo_status_t cairoReadFunction(const TexImage* image, unsigned char* data, unsigned int length);
 
     /**
      * Free image and PDF
      */
-    void freeImageAndPdf();
+    void freeImageAndPdf() const;
+
+    /**
+     * Creates the image or the PDF from binaryData. dataMutex must be locked.
+     */
+    bool loadBinaryData(GError** err) const;
+
+    /**
+     * Loads the data passed to loadDataLazily(), if any. dataMutex must be locked.
+     */
+    void loadPendingData() const;
 
 private:
+    /**
+     * Guards the lazily loaded members below, so that the image can be rendered from several threads
+     */
+    mutable std::mutex dataMutex;
+
     /**
      * Tex PDF Document, if rendered as PDF
      */
-    xoj::util::GObjectSPtr<PopplerDocument> pdf;
+    mutable xoj::util::GObjectSPtr<PopplerDocument> pdf;
 
     /**
      * Tex image, if rendered as image. Note: this is deprecated and subject to removal in a later version.
      */
-    cairo_surface_t* image = nullptr;
+    mutable cairo_surface_t* image = nullptr;
 
     /**
      * PNG Image / PDF Document
      */
-    std::string binaryData;
+    mutable std::string binaryData;
+
+    /**
+     * Data passed to loadDataLazily(), not loaded yet
+     */
+    mutable std::string pendingData;
+    mutable bool pendingBase64 = false;
 
     /**
      * Read position for PNG binaryData (deprecated).
      */
-    std::string::size_type read = 0;
+    mutable std::string::size_type read = 0;
 
     /**
      * Tex String
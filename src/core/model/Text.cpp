@@ -1,17 +1,21 @@
 #include "Text.h"
 
+#include <algorithm>  // for find_if, max
+#include <atomic>     // for atomic
+#include <cstddef>    // for size_t
 #include <memory>
-#include <utility>  // for move
+#include <thread>     // for thread
+#include <utility>    // for move
 
-#include <glib.h>  // for g_warning
+#include <glib.h>              // for g_warning
 #include <pango/pangocairo.h>
 
-#include "model/AudioElement.h"   // for AudioElement
-#include "model/Element.h"        // for ELEMENT_TEXT, Eleme...
-#include "model/Font.h"           // for XojFont
-#include "pdf/base/XojPdfPage.h"  // for XojPdfRectangle
-#include "util/Rectangle.h"       // for Rectangle
-#include "util/Stacktrace.h"      // for Stacktrace
+#include "model/AudioElement.h"                   // for AudioElement
+#include "model/Element.h"                        // for ELEMENT_TEXT, Eleme...
+#include "model/Font.h"                           // for XojFont
+#include "pdf/base/XojPdfPage.h"                  // for XojPdfRectangle
+#include "util/Rectangle.h"                       // for Rectangle
+#include "util/Stacktrace.h"                      // for Stacktrace
 #include "util/StringUtils.h"
 #include "util/raii/GObjectSPtr.h"
 #include "util/serializing/ObjectInputStream.h"   // for ObjectInputStream
@@ -19,6 +23,18 @@
 
 using xoj::util::Rectangle;
 
+static auto countDrawingThreads(size_t renderThreadCount) -> size_t {
+    // The UI thread, and the export threads: one per core (see ImageExport and MotionExporter)
+    return renderThreadCount + 1 + std::max(1U, std::thread::hardware_concurrency());
+}
+
+/// One layout for each thread drawing the text. The scheduler runs one render thread per core by default.
+static std::atomic<size_t> maxCachedLayouts = countDrawingThreads(std::max(1U, std::thread::hardware_concurrency()));
+
+void Text::setRenderThreadCount(size_t renderThreadCount) {
+    maxCachedLayouts = countDrawingThreads(renderThreadCount);
+}
+
 Text::Text(): AudioElement(ELEMENT_TEXT) {
     this->font.setName("Sans");
     this->font.setSize(12);
@@ -51,6 +67,7 @@ auto Text::getFont() const -> const XojFont& { return font; }
 void Text::setFont(const XojFont& font) {
     this->font = font;
     sizeCalculated = false;
+    boundsChanged();
 }
 
 auto Text::getFontSize() const -> double { return font.getSize(); }
@@ -61,15 +78,15 @@ auto Text::getText() const -> const std::string& { return this->text; }
 
 void Text::setText(std::string text) {
     this->text = std::move(text);
+    invalidateLayouts();
     sizeCalculated = false;
+    boundsChanged();
 }
 
 void Text::calcSize() const {
-    auto layout = createPangoLayout();
-    pango_layout_set_text(layout.get(), this->text.c_str(), static_cast<int>(this->text.length()));
     int w = 0;
     int h = 0;
-    pango_layout_get_size(layout.get(), &w, &h);
+    withPangoLayout(nullptr, [&](PangoLayout* layout) { pango_layout_get_size(layout, &w, &h); });
     this->width = (static_cast<double>(w)) / PANGO_SCALE;
     this->height = (static_cast<double>(h)) / PANGO_SCALE;
     this->updateSnapping();
@@ -110,6 +127,61 @@ void Text::updatePangoFont(PangoLayout* layout) const {
     pango_font_description_free(desc);
 }
 
+void Text::updatePangoFontOptions(cairo_t* cr, PangoLayout* layout) {
+    PangoContext* context = pango_layout_get_context(layout);
+    const cairo_font_options_t* current = pango_cairo_context_get_font_options(context);
+    if (!cr) {
+        if (current) {
+            pango_cairo_context_set_font_options(context, nullptr);
+            pango_layout_context_changed(layout);
+        }
+        return;
+    }
+
+    // Same options as pango_cairo_update_layout()
+    cairo_font_options_t* options = cairo_font_options_create();
+    cairo_surface_get_font_options(cairo_get_target(cr), options);
+    cairo_font_options_t* crOptions = cairo_font_options_create();
+    cairo_get_font_options(cr, crOptions);
+    cairo_font_options_merge(options, crOptions);
+    cairo_font_options_destroy(crOptions);
+
+    // Changing the options (or the matrix) of the context discards the whole layout: only do it when needed
+    if (!current || !cairo_font_options_equal(current, options)) {
+        pango_cairo_context_set_font_options(context, options);
+        pango_layout_context_changed(layout);
+    }
+    cairo_font_options_destroy(options);
+}
+
+auto Text::getCachedLayout(cairo_t* cr) const -> PangoLayout* {
+    if (this->layoutFont.getName() != this->font.getName() || this->layoutFont.getSize() != this->font.getSize()) {
+        this->layouts.clear();
+        this->layoutFont = this->font;
+    }
+
+    PangoFontMap* fontMap = pango_cairo_font_map_get_default();
+    auto it = std::find_if(this->layouts.begin(), this->layouts.end(),
+                           [fontMap](const CachedLayout& l) { return l.fontMap == fontMap; });
+    if (it == this->layouts.end()) {
+        if (this->layouts.size() >= maxCachedLayouts) {
+            this->layouts.erase(this->layouts.begin());
+        }
+        // The layout keeps a reference to the font map: its address is not reused while it is in the cache
+        auto layout = createPangoLayout();
+        pango_layout_set_text(layout.get(), this->text.c_str(), static_cast<int>(this->text.length()));
+        it = this->layouts.insert(this->layouts.end(), CachedLayout{fontMap, std::move(layout)});
+    }
+
+    updatePangoFontOptions(cr, it->layout.get());
+    return it->layout.get();
+}
+
+void Text::invalidateLayouts() {
+    std::lock_guard lock(this->layoutMutex);
+    this->layouts.clear();
+}
+
 void Text::scale(double x0, double y0, double fx, double fy, double rotation,
                  bool) {  // line width scaling option is not used
     // only proportional scale allowed...
@@ -129,6 +201,7 @@ void Text::scale(double x0, double y0, double fx, double fy, double rotation,
     this->font.setSize(size);
 
     sizeCalculated = false;
+    boundsChanged();
 }
 
 void Text::rotate(double x0, double y0, double th) {}
@@ -155,6 +228,7 @@ void Text::readSerialized(ObjectInputStream& in) {
     this->AudioElement::readSerialized(in);
 
     this->text = in.readString();
+    invalidateLayouts();
 
     font.readSerialized(in);
 
@@ -171,29 +245,38 @@ auto Text::findText(const std::string& search) const -> std::vector<XojPdfRectan
         return {};
     }
 
-    auto layout = this->createPangoLayout();
-    pango_layout_set_text(layout.get(), this->text.c_str(), static_cast<int>(this->text.length()));
-
-
     std::string text = StringUtils::toLowerCase(this->text);
 
     std::string pattern = StringUtils::toLowerCase(search);
 
-    std::vector<XojPdfRectangle> list;
-
+    std::vector<size_t> matches;
     for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1)) {
-        XojPdfRectangle mark;
-        PangoRectangle rect = {0};
-        pango_layout_index_to_pos(layout.get(), static_cast<int>(pos), &rect);
-        mark.x1 = (static_cast<double>(rect.x)) / PANGO_SCALE + this->getX();
-        mark.y1 = (static_cast<double>(rect.y)) / PANGO_SCALE + this->getY();
+        matches.push_back(pos);
+    }
+    if (matches.empty()) {
+        return {};
+    }
 
-        pango_layout_index_to_pos(layout.get(), static_cast<int>(pos + patternLength - 1), &rect);
-        mark.x2 = (static_cast<double>(rect.x) + rect.width) / PANGO_SCALE + this->getX();
-        mark.y2 = (static_cast<double>(rect.y) + rect.height) / PANGO_SCALE + this->getY();
+    // Not in the lambda: they may compute the size of the text, which locks the layouts
+    const double x = this->getX();
+    const double y = this->getY();
 
-        list.push_back(mark);
-    }
+    std::vector<XojPdfRectangle> list;
+    withPangoLayout(nullptr, [&](PangoLayout* layout) {
+        for (size_t pos: matches) {
+            XojPdfRectangle mark;
+            PangoRectangle rect = {0};
+            pango_layout_index_to_pos(layout, static_cast<int>(pos), &rect);
+            mark.x1 = (static_cast<double>(rect.x)) / PANGO_SCALE + x;
+            mark.y1 = (static_cast<double>(rect.y)) / PANGO_SCALE + y;
+
+            pango_layout_index_to_pos(layout, static_cast<int>(pos + patternLength - 1), &rect);
+            mark.x2 = (static_cast<double>(rect.x) + rect.width) / PANGO_SCALE + x;
+            mark.y2 = (static_cast<double>(rect.y) + rect.height) / PANGO_SCALE + y;
+
+            list.push_back(mark);
+        }
+    });
 
     return list;
 }
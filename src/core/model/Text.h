@@ -11,9 +11,12 @@
 
 #pragma once
 
-#include <string>  // for string
+#include <cstddef>  // for size_t
+#include <mutex>    // for mutex, lock_guard
+#include <string>   // for string
 #include <vector>
 
+#include <cairo.h>  // for cairo_t
 #include <pango/pango.h>
 
 #include "model/Element.h"
@@ -51,6 +54,32 @@ public:
     xoj::util::GObjectSPtr<PangoLayout> createPangoLayout() const;
     void updatePangoFont(PangoLayout* layout) const;
 
+    /**
+     * @brief Sizes the layout cache of the texts for the threads which may draw them at once: the render threads, the
+     * UI thread and the export threads
+     * @param renderThreadCount The number of threads of the scheduler
+     */
+    static void setRenderThreadCount(size_t renderThreadCount);
+
+    /**
+     * @brief Calls f(PangoLayout*) with the layout of the text, and returns its result
+     *
+     * The layouts are built lazily and kept until the text or the font changes, one for each thread and font options.
+     * The layouts are locked while f runs, so that the text can be drawn from the render threads.
+     * f must neither modify the layout nor call other methods of the text which may need a layout (e.g. getX()).
+     *
+     * @param cr The context the layout is drawn to, or nullptr to measure the text
+     */
+    template <typename Fun>
+    auto withPangoLayout(cairo_t* cr, Fun&& f) const;
+
+    /**
+     * Sets the font options of cr to the context of the layout, if they changed. Unlike pango_cairo_update_layout(),
+     * the transformation matrix is not set: the layout is laid out in user space.
+     * @param cr The context the layout is drawn to, or nullptr for the default font options
+     */
+    static void updatePangoFontOptions(cairo_t* cr, PangoLayout* layout);
+
     void scale(double x0, double y0, double fx, double fy, double rotation, bool restoreLineWidth) override;
     void rotate(double x0, double y0, double th) override;
 
@@ -68,6 +97,13 @@ protected:
     void calcSize() const override;
     void updateSnapping() const;
 
+private:
+    /// Returns the cached layout for cr, see withPangoLayout(). layoutMutex must be locked.
+    PangoLayout* getCachedLayout(cairo_t* cr) const;
+
+    /// Drops the cached layouts, after the text changed
+    void invalidateLayouts();
+
 public:
     std::vector<XojPdfRectangle> findText(const std::string& search) const;
 
@@ -77,4 +113,24 @@ private:
     std::string text;
 
     bool inEditing = false;
+
+    struct CachedLayout {
+        /// The default font map of the thread which built the layout: pango font maps must not be shared
+        PangoFontMap* fontMap;
+        xoj::util::GObjectSPtr<PangoLayout> layout;
+    };
+
+    /// Guards the members below
+    mutable std::mutex layoutMutex;
+
+    mutable std::vector<CachedLayout> layouts;
+
+    /// The font the layouts were built with: the font may be modified through getFont()
+    mutable XojFont layoutFont;
 };
+
+template <typename Fun>
+auto Text::withPangoLayout(cairo_t* cr, Fun&& f) const {
+    std::lock_guard lock(this->layoutMutex);
+    return f(getCachedLayout(cr));
+}
@@ -11,6 +11,9 @@
 
 #include "BackgroundImage.h"  // for BackgroundImage
 
+/// Clock of the accesses to the layers of all pages, see XojPage::getLastContentAccess()
+static std::atomic<uint64_t> contentAccessClock{0};
+
 XojPage::XojPage(double width, double height, bool suppressLayerCreation): width(width), height(height), bgType(PageTypeFormat::Lined) {
     if (!suppressLayerCreation) {
         // ensure at least one valid layer exists
@@ -31,20 +34,87 @@ XojPage::XojPage(XojPage const& page):
         currentLayer(page.currentLayer),
         bgType(page.bgType),
         pdfBackgroundPage(page.pdfBackgroundPage),
-        backgroundColor(page.backgroundColor) {
+        backgroundColor(page.backgroundColor),
+        backgroundVisible(page.backgroundVisible),
+        backgroundName(page.backgroundName) {
+    if (page.lazyContent && !page.contentPinned) {
+        // The layers are the same as the lazy content: share it instead of copying the layers
+        this->lazyContent = page.lazyContent;
+        this->contentLoaded = false;
+        return;
+    }
+
+    page.loadContent();
     this->layer.reserve(page.layer.size());
     std::transform(begin(page.layer), end(page.layer), std::back_inserter(this->layer),
                    [](auto* layer) { return layer->clone(); });
 }
 
-auto XojPage::clone() -> XojPage* { return new XojPage(*this); }
+auto XojPage::clone() const -> XojPage* { return new XojPage(*this); }
+
+auto XojPage::getContentLock() const -> std::shared_mutex& { return this->contentLock; }
+
+void XojPage::setLazyContent(std::shared_ptr<const LazyPageContent> content) {
+    xoj_assert(this->layer.empty());
+    this->lazyContent = std::move(content);
+    this->contentLoaded = false;
+    this->contentPinned = false;
+}
+
+auto XojPage::isContentLoaded() const -> bool { return this->contentLoaded; }
+
+auto XojPage::getLazyContentSize() const -> size_t { return this->lazyContent ? this->lazyContent->getSize() : 0; }
+
+auto XojPage::getLazyContent() const -> std::shared_ptr<const LazyPageContent> { return this->lazyContent; }
+
+auto XojPage::getLastContentAccess() const -> uint64_t { return this->lastContentAccess; }
+
+void XojPage::loadContent() const {
+    this->lastContentAccess.store(++contentAccessClock, std::memory_order_relaxed);
+    if (this->contentLoaded.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    std::lock_guard lock(this->loadMutex);
+    if (this->contentLoaded.load(std::memory_order_relaxed)) {
+        return;
+    }
+    auto layers = this->lazyContent->load();
+    this->layer.reserve(layers.size());
+    std::transform(layers.begin(), layers.end(), std::back_inserter(this->layer),
+                   [](auto& layer) { return layer.release(); });
+    if (this->layer.empty()) {
+        // ensure at least one valid layer exists
+        this->layer.push_back(new Layer());
+    }
+    this->contentLoaded.store(true, std::memory_order_release);
+}
+
+void XojPage::pinContent() {
+    loadContent();
+    this->contentPinned = true;
+}
+
+auto XojPage::unloadContent() -> bool {
+    if (!this->lazyContent || this->contentPinned || !this->contentLoaded) {
+        return false;
+    }
+    for (Layer* l: this->layer) { delete l; }
+    this->layer.clear();
+    this->contentLoaded = false;
+    return true;
+}
 
 void XojPage::addLayer(Layer* layer) {
+    pinContent();
+    bumpRevision();
     this->layer.push_back(layer);
     this->currentLayer = npos;
 }
 
 void XojPage::insertLayer(Layer* layer, Layer::Index index) {
+    pinContent();
+    bumpRevision();
     if (index >= this->layer.size()) {
         addLayer(layer);
         return;
@@ -55,6 +125,8 @@ void XojPage::insertLayer(Layer* layer, Layer::Index index) {
 }
 
 void XojPage::removeLayer(Layer* l) {
+    pinContent();
+    bumpRevision();
     if (auto it = std::find(layer.begin(), layer.end(), l); it != layer.end()) {
         this->layer.erase(it);
     }
@@ -67,17 +139,27 @@ void XojPage::removeLayer(Layer* l) {
 
 void XojPage::setSelectedLayerId(Layer::Index id) { this->currentLayer = id; }
 
-auto XojPage::getLayers() -> std::vector<Layer*>& { return this->layer; }
+auto XojPage::getLayers() -> std::vector<Layer*>& {
+    pinContent();
+    return this->layer;
+}
 
-auto XojPage::getLayersView() const -> xoj::util::PointerContainerView<std::vector<Layer*>> { return this->layer; }
+auto XojPage::getLayersView() const -> xoj::util::PointerContainerView<std::vector<Layer*>> {
+    loadContent();
+    return this->layer;
+}
 
-auto XojPage::getLayerCount() const -> Layer::Index { return this->layer.size(); }
+auto XojPage::getLayerCount() const -> Layer::Index {
+    loadContent();
+    return this->layer.size();
+}
 
 /**
  * Layer ID 0 = Background, Layer ID 1 = Layer 1
  */
 auto XojPage::getSelectedLayerId() -> Layer::Index {
     if (this->currentLayer == npos) {
+        loadContent();
         this->currentLayer = this->layer.size();
     }
 
@@ -85,11 +167,13 @@ auto XojPage::getSelectedLayerId() -> Layer::Index {
 }
 
 void XojPage::setLayerVisible(Layer::Index layerId, bool visible) {
+    bumpRevision();
     if (layerId == 0) {
         backgroundVisible = visible;
         return;
     }
 
+    pinContent();
     layerId--;
     if (layerId >= this->layer.size()) {
         return;
@@ -103,6 +187,7 @@ auto XojPage::isLayerVisible(Layer::Index layerId) const -> bool {
         return backgroundVisible;
     }
 
+    loadContent();
     layerId--;
     if (layerId >= this->layer.size()) {
         return false;
@@ -112,16 +197,21 @@ auto XojPage::isLayerVisible(Layer::Index layerId) const -> bool {
 }
 
 void XojPage::setBackgroundPdfPageNr(size_t page) {
+    bumpRevision();
     this->pdfBackgroundPage = page;
     this->bgType.format = PageTypeFormat::Pdf;
     this->bgType.config = "";
 }
 
-void XojPage::setBackgroundColor(Color color) { this->backgroundColor = color; }
+void XojPage::setBackgroundColor(Color color) {
+    bumpRevision();
+    this->backgroundColor = color;
+}
 
 auto XojPage::getBackgroundColor() const -> Color { return this->backgroundColor; }
 
 void XojPage::setSize(double width, double height) {
+    bumpRevision();
     this->width = width;
     this->height = height;
 }
@@ -133,6 +223,7 @@ auto XojPage::getHeight() const -> double { return this->height; }
 auto XojPage::getPdfPageNr() const -> size_t { return this->pdfBackgroundPage; }
 
 auto XojPage::isAnnotated() const -> bool {
+    loadContent();
     for (Layer* l: this->layer) {
         if (l->isAnnotated()) {
             return true;
@@ -142,6 +233,7 @@ auto XojPage::isAnnotated() const -> bool {
 }
 
 void XojPage::setBackgroundType(const PageType& bgType) {
+    bumpRevision();
     this->bgType = bgType;
 
     if (!bgType.isPdfPage()) {
@@ -157,9 +249,13 @@ auto XojPage::getBackgroundType() const -> PageType { return this->bgType; }
 auto XojPage::getBackgroundImage() -> BackgroundImage& { return this->backgroundImage; }
 auto XojPage::getBackgroundImage() const -> const BackgroundImage& { return this->backgroundImage; }
 
-void XojPage::setBackgroundImage(BackgroundImage img) { this->backgroundImage = std::move(img); }
+void XojPage::setBackgroundImage(BackgroundImage img) {
+    bumpRevision();
+    this->backgroundImage = std::move(img);
+}
 
 auto XojPage::getSelectedLayer() -> Layer* {
+    pinContent();
     xoj_assert(!layer.empty());
     size_t layer = getSelectedLayerId();
 
@@ -170,6 +266,18 @@ auto XojPage::getSelectedLayer() -> Layer* {
     return this->layer[layer];
 }
 
+auto XojPage::getSelectedLayer() const -> const Layer* {
+    loadContent();
+    xoj_assert(!layer.empty());
+    size_t layer = this->currentLayer == npos ? this->layer.size() : this->currentLayer;
+
+    if (layer > 0) {
+        layer--;
+    }
+
+    return this->layer[layer];
+}
+
 auto XojPage::getBackgroundName() const -> std::string { return backgroundName.value_or(_("Background")); }
 
 auto XojPage::backgroundHasName() const -> bool { return backgroundName.has_value(); }
@@ -11,10 +11,15 @@
 
 #pragma once
 
-#include <cstddef>   // for size_t
-#include <optional>  // for optional
-#include <string>    // for string
-#include <vector>    // for vector
+#include <atomic>        // for atomic
+#include <cstddef>       // for size_t
+#include <cstdint>       // for uint64_t
+#include <memory>        // for shared_ptr
+#include <mutex>         // for mutex
+#include <optional>      // for optional
+#include <shared_mutex>  // for shared_mutex
+#include <string>        // for string
+#include <vector>        // for vector
 
 #include "util/Color.h"  // for Color
 #include "util/PointerContainerView.h"
@@ -22,6 +27,7 @@
 
 #include "BackgroundImage.h"  // for BackgroundImage
 #include "Layer.h"            // for Layer, Layer::Index
+#include "LazyPageContent.h"  // for LazyPageContent
 #include "PageHandler.h"      // for PageHandler
 #include "PageType.h"         // for PageType
 
@@ -63,6 +69,13 @@ public:
     Color getBackgroundColor() const;
 
     std::vector<Layer*>& getLayers();
+
+    /**
+     * The layers of a page loaded lazily are created on first access, even by the const getters (this one,
+     * getLayerCount(), isLayerVisible(), ...), and may be deleted again by unloadContent(). The Layers and Elements
+     * returned are thus only valid as long as the content lock is held (see getContentLock()), or on the UI thread
+     * until control returns to the main loop.
+     */
     xoj::util::PointerContainerView<std::vector<Layer*>> getLayersView() const;
 
     Layer::Index getLayerCount() const;
@@ -71,6 +84,7 @@ public:
     bool isLayerVisible(Layer::Index layerId) const;
 
     Layer* getSelectedLayer();
+    const Layer* getSelectedLayer() const;
 
     BackgroundImage& getBackgroundImage();
     const BackgroundImage& getBackgroundImage() const;
@@ -83,7 +97,62 @@ public:
     /**
      * Copies this page an all it's contents to a new page
      */
-    XojPage* clone();
+    XojPage* clone() const;
+
+    /**
+     * The lock of the page contents (layers and elements).
+     * Hold it shared while reading the page from another thread, and exclusively while modifying the page without
+     * holding the Document lock exclusively. Always lock the Document (at least shared) first.
+     */
+    std::shared_mutex& getContentLock() const;
+
+    /**
+     * Lets the layers of this page be created by content when they are first accessed, instead of now.
+     * The page must not have any layer yet.
+     */
+    void setLazyContent(std::shared_ptr<const LazyPageContent> content);
+
+    /**
+     * @return false if the layers are still to be created by the lazy content of the page
+     */
+    bool isContentLoaded() const;
+
+    /**
+     * @return The estimated size of the layers if the page was loaded lazily, 0 otherwise
+     */
+    size_t getLazyContentSize() const;
+
+    /**
+     * @return The content the layers are created from if the page was loaded lazily, nullptr otherwise. As long as
+     * isContentLoaded() is false, it holds the current content of the page.
+     */
+    std::shared_ptr<const LazyPageContent> getLazyContent() const;
+
+    /**
+     * @return When the layers were last accessed, as a tick of a clock shared by all pages
+     */
+    uint64_t getLastContentAccess() const;
+
+    /**
+     * Deletes the layers of a page loaded lazily, they are created again from the lazy content on the next access.
+     * Does nothing if the layers may have been modified, i.e. if they have been accessed through a non-const method.
+     *
+     * Only call this on the UI thread, with the Document locked exclusively and the content lock held exclusively.
+     *
+     * @return true if the layers were unloaded
+     */
+    bool unloadContent();
+
+private:
+    /**
+     * Creates the layers from the lazy content if needed, called by all the methods accessing the layers
+     */
+    void loadContent() const;
+
+    /**
+     * Same as loadContent(), and prevents the layers from being unloaded as they may be modified from now on
+     */
+    void pinContent();
 
 private:
     /**
@@ -98,9 +167,31 @@ private:
     double height = 0;
 
     /**
-     * The layer list
+     * The layer list, empty as long as the lazy content is not loaded
+     */
+    mutable std::vector<Layer*> layer;
+
+    /**
+     * Creates the layers of a page loaded lazily, see setLazyContent()
      */
-    std::vector<Layer*> layer;
+    std::shared_ptr<const LazyPageContent> lazyContent;
+
+    /**
+     * If the layers are created, always true if there is no lazy content
+     */
+    mutable std::atomic<bool> contentLoaded = true;
+
+    /**
+     * If the layers may have been modified, so they must not be unloaded
+     */
+    std::atomic<bool> contentPinned = false;
+
+    mutable std::atomic<uint64_t> lastContentAccess = 0;
+
+    /**
+     * Serializes the loading of the lazy content by concurrent readers
+     */
+    mutable std::mutex loadMutex;
 
     /**
      * The current selected layer ID
@@ -132,6 +223,11 @@ private:
      */
     std::optional<std::string> backgroundName;
 
+    /**
+     * Guards the page contents, see getContentLock()
+     */
+    mutable std::shared_mutex contentLock;
+
     // Allow LoadHandler to add layers directly
     friend class LoadHandler;
 
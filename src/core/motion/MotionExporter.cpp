@@ -1,28 +1,195 @@
 #include "MotionExporter.h"
 
-#include <algorithm>  // for min, max
-#include <cstdio>     // for snprintf
-#include <fstream>    // for ofstream
-#include <locale>     // for std::locale, std::locale::classic
-
-#include <glib.h>  // for g_message, g_warning
-
-#include "control/settings/Settings.h"    // for Settings
-#include "model/Document.h"               // for Document
-#include "model/EraserMotionRecording.h"  // for EraserMotionRecording
-#include "model/LineStyle.h"              // for LineStyle
-#include "model/MotionRecording.h"        // for MotionRecording
-#include "model/PageType.h"               // for PageType, PageTypeFormat
-#include "model/Stroke.h"                 // for Stroke
-#include "model/XojPage.h"                // for XojPage
-#include "util/Color.h"                   // for Color
-#include "util/PathUtil.h"                // for toUri
+#include <algorithm>     // for min, max
+#include <array>         // for array
+#include <cmath>         // for ceil
+#include <cstdio>        // for snprintf
+#include <fstream>       // for ofstream
+#include <locale>        // for std::locale, std::locale::classic
+#include <memory>        // for unique_ptr
+#include <shared_mutex>  // for shared_lock
+#include <thread>        // for thread
+#include <vector>        // for vector
+
+#include <cairo.h>  // for cairo_image_surface_create, cairo_...
+#include <glib.h>   // for g_message, g_warning
+
+#include "control/settings/Settings.h"        // for Settings
+#include "model/Document.h"                   // for Document
+#include "model/EraserMotionRecording.h"      // for EraserMotionRecording
+#include "model/Layer.h"                      // for Layer
+#include "model/LineStyle.h"                  // for LineStyle
+#include "model/MotionRecording.h"            // for MotionRecording
+#include "model/PageType.h"                   // for PageType, PageTypeFormat
+#include "model/Stroke.h"                     // for Stroke
+#include "model/XojPage.h"                    // for XojPage
+#include "pdf/base/XojPdfPage.h"              // for XojPdfPageSPtr
+#include "util/Color.h"                       // for Color
+#include "util/StringUtils.h"                 // for char_cast
+#include "util/Util.h"                        // for npos
+#include "util/raii/CairoWrappers.h"          // for CairoSurfaceSPtr, CairoSPtr
+#include "view/DocumentView.h"                // for DocumentView
+#include "view/View.h"                        // for Context, ElementView
+#include "view/background/BackgroundFlags.h"  // for BackgroundFlags, HIDE_PDF_BACKGROUND
+
+#include "MotionTimeline.h"  // for MotionTimeline
 
 using std::string;
 using std::vector;
 
+/// Pixels per point of the rendered frames
+static constexpr double FRAME_ZOOM = 1.5;
+
+/**
+ * Renders the frames of one worker. The canvas holds the current page with the strokes completed so far, it is only
+ * redrawn from scratch when the replay moves to another page.
+ */
+class MotionExporter::FrameRenderer final {
+public:
+    FrameRenderer(MotionExporter& exporter, const Document& doc, const MotionTimeline& timeline):
+            exporter(exporter), doc(doc), timeline(timeline) {}
+
+    /**
+     * Renders a frame and writes it to the output folder. The frames must be rendered in increasing order.
+     */
+    auto render(size_t frame) -> bool {
+        size_t timestamp = this->timeline.getFrameTimestamp(frame, this->exporter.frameRate);
+        size_t page = this->timeline.getPageAt(timestamp);
+        if (page != this->page) {
+            showPage(page);
+        }
+        advanceTo(timestamp);
+
+        xoj::util::CairoSurfaceSPtr surface(
+                cairo_image_surface_create(CAIRO_FORMAT_RGB24, this->exporter.frameWidth, this->exporter.frameHeight),
+                xoj::util::adopt);
+        xoj::util::CairoSPtr cr(cairo_create(surface.get()), xoj::util::adopt);
+        cairo_set_source_surface(cr.get(), this->canvas.get(), 0, 0);
+        cairo_paint(cr.get());
+
+        cairo_scale(cr.get(), FRAME_ZOOM, FRAME_ZOOM);
+        drawStrokesInProgress(cr.get(), timestamp);
+        drawEraser(cr.get(), timestamp);
+
+        std::array<char, 32> name{};
+        snprintf(name.data(), name.size(), "frame_%06zu.png", frame);
+        auto filepath = this->exporter.outputPath / name.data();
+        return cairo_surface_write_to_png(surface.get(), char_cast(filepath.u8string().c_str())) ==
+               CAIRO_STATUS_SUCCESS;
+    }
+
+private:
+    /**
+     * Redraws the canvas with the background and the elements which are not replayed
+     */
+    void showPage(size_t pageIndex) {
+        this->page = pageIndex;
+        this->strokesDrawn = 0;
+
+        this->canvas.reset(
+                cairo_image_surface_create(CAIRO_FORMAT_RGB24, this->exporter.frameWidth, this->exporter.frameHeight),
+                xoj::util::adopt);
+        this->cr.reset(cairo_create(this->canvas.get()), xoj::util::adopt);
+        cairo_set_source_rgb(this->cr.get(), 1, 1, 1);
+        cairo_paint(this->cr.get());
+        cairo_scale(this->cr.get(), FRAME_ZOOM, FRAME_ZOOM);
+
+        auto p = this->doc.getPage(pageIndex);
+        if (p->getBackgroundType().isPdfPage()) {
+            if (XojPdfPageSPtr pdfPage = this->doc.getPdfPage(p->getPdfPageNr())) {
+                pdfPage->render(this->cr.get());
+            }
+        }
+
+        xoj::view::BackgroundFlags flags = xoj::view::BACKGROUND_SHOW_ALL;
+        flags.showPDF = xoj::view::HIDE_PDF_BACKGROUND;  // Already rendered (if any)
+        this->view.initDrawing(p, this->cr.get(), true);
+        this->view.drawBackground(flags);
+        this->view.finializeDrawing();
+
+        auto context = xoj::view::Context::createDefault(this->cr.get());
+        for (const Layer* layer: p->getLayersView()) {
+            if (!layer->isVisible()) {
+                continue;
+            }
+            for (const Element* e: layer->getElementsView()) {
+                const auto* stroke = dynamic_cast<const Stroke*>(e);
+                if (stroke && MotionTimeline::isReplayed(stroke)) {
+                    continue;
+                }
+                xoj::view::ElementView::createFromElement(e)->draw(context);
+            }
+        }
+    }
+
+    /**
+     * Draws the strokes completed at the timestamp on the canvas
+     */
+    void advanceTo(size_t timestamp) {
+        const auto& strokes = this->timeline.getStrokes(this->page);
+        auto context = xoj::view::Context::createDefault(this->cr.get());
+        for (; this->strokesDrawn < strokes.size() && strokes[this->strokesDrawn].end <= timestamp;
+             this->strokesDrawn++) {
+            xoj::view::ElementView::createFromElement(strokes[this->strokesDrawn].stroke)->draw(context);
+        }
+    }
+
+    void drawStrokesInProgress(cairo_t* target, size_t timestamp) const {
+        const auto& strokes = this->timeline.getStrokes(this->page);
+        auto context = xoj::view::Context::createDefault(target);
+        for (size_t i = this->strokesDrawn; i < strokes.size(); i++) {
+            size_t count = MotionTimeline::getDrawnPointCount(strokes[i], timestamp);
+            if (count < 2) {
+                continue;
+            }
+            const auto& points = strokes[i].stroke->getPointVector();
+            Stroke partial;
+            partial.applyStyleFrom(strokes[i].stroke);
+            partial.setPointVector(
+                    std::vector<Point>(points.begin(), points.begin() + static_cast<std::ptrdiff_t>(count)));
+            xoj::view::ElementView::createFromElement(&partial)->draw(context);
+        }
+    }
+
+    /**
+     * The erased strokes are not in the document anymore: only the eraser itself is shown
+     */
+    void drawEraser(cairo_t* target, size_t timestamp) const {
+        const EraserMotionPoint* eraser = this->timeline.getEraserAt(this->page, timestamp);
+        if (!eraser) {
+            return;
+        }
+        double half = eraser->eraserSize / 2;
+        cairo_rectangle(target, eraser->point.x - half, eraser->point.y - half, eraser->eraserSize,
+                        eraser->eraserSize);
+        cairo_set_source_rgba(target, 1, 1, 1, 0.6);
+        cairo_fill_preserve(target);
+        cairo_set_source_rgb(target, 0.4, 0.4, 0.4);
+        cairo_set_line_width(target, 1);
+        cairo_stroke(target);
+    }
+
+    MotionExporter& exporter;
+    const Document& doc;
+    const MotionTimeline& timeline;
+
+    DocumentView view;
+
+    size_t page = npos;
+    xoj::util::CairoSurfaceSPtr canvas;
+    xoj::util::CairoSPtr cr;
+
+    /// Number of strokes of the timeline of the page drawn on the canvas
+    size_t strokesDrawn = 0;
+};
+
 MotionExporter::MotionExporter(Settings& settings, Document* document):
-        settings(settings), document(document), frameRate(30), exporting(false), progress(0.0), frameCount(0),
+        settings(settings),
+        document(document),
+        frameRate(30),
+        exporting(false),
+        stopRequested(false),
+        frameCount(0),
         totalFrames(0) {}
 
 MotionExporter::~MotionExporter() { this->stop(); }
@@ -51,27 +218,35 @@ auto MotionExporter::startExport(fs::path const& outputPath, int frameRate) -> b
     this->outputPath = outputPath;
     this->frameRate = frameRate;
     this->exporting = true;
-    this->progress = 0.0;
+    this->stopRequested = false;
     this->frameCount = 0;
 
     g_message("Starting motion export to: %s (frame rate: %d fps)", outputPath.string().c_str(), frameRate);
 
-    // Count total motion points across all pages to estimate total frames
+    // Render from a copy of the document: the user may go on editing it while the frames are rendered
+    std::unique_ptr<Document> snapshot;
+    EraserMotionRecording eraserRecording;
+    {
+        std::shared_lock<Document> docLock(*this->document);
+        snapshot = this->document->createSnapshot();
+        eraserRecording = this->document->getEraserMotionRecording();
+    }
+    const Document& doc = *snapshot;
+
+    // Count total motion points across all pages
     // Calculate total duration as sum of individual stroke durations (excluding idle time between strokes)
     size_t totalMotionPoints = 0;
     size_t totalDurationMs = 0;  // Sum of all stroke durations without idle time
 
-    for (size_t p = 0; p < this->document->getPageCount(); p++) {
-        auto page = this->document->getPage(p);
+    for (size_t p = 0; p < doc.getPageCount(); p++) {
+        auto page = doc.getPage(p);
         if (!page) {
             continue;
         }
 
-        const auto& layers = page->getLayers();
-        for (auto* layer : layers) {
-            const auto& elements = layer->getElements();
-            for (const auto& element : elements) {
-                if (auto* stroke = dynamic_cast<Stroke*>(element.get())) {
+        for (const auto* layer: page->getLayersView()) {
+            for (const auto* element: layer->getElementsView()) {
+                if (const auto* stroke = dynamic_cast<const Stroke*>(element)) {
                     if (stroke->hasMotionRecording()) {
                         auto* motion = stroke->getMotionRecording();
                         totalMotionPoints += motion->getMotionPointCount();
@@ -86,13 +261,7 @@ auto MotionExporter::startExport(fs::path const& outputPath, int frameRate) -> b
         }
     }
 
-    // Also check eraser motion recording data
-    const auto& eraserRecording = this->document->getEraserMotionRecording();
     size_t eraserMotionPoints = eraserRecording.getMotionPointCount();
-    size_t eraserDurationMs = 0;
-    if (eraserRecording.hasMotionData()) {
-        eraserDurationMs = eraserRecording.getEndTimestamp() - eraserRecording.getStartTimestamp();
-    }
 
     // Check if there's any motion data (stroke or eraser)
     if (totalMotionPoints == 0 && eraserMotionPoints == 0) {
@@ -101,16 +270,11 @@ auto MotionExporter::startExport(fs::path const& outputPath, int frameRate) -> b
         return false;
     }
 
-    // Calculate total frames based on total drawing time (excluding idle time between strokes)
-    // Include both stroke and eraser duration
-    size_t combinedDurationMs = totalDurationMs + eraserDurationMs;
-    if (combinedDurationMs > 0) {
-        this->totalFrames = (combinedDurationMs * frameRate) / 1000 + 1;
-    } else {
-        this->totalFrames = 1;
-    }
+    // The frames follow the drawing time, the idle time between strokes and eraser moves is skipped
+    MotionTimeline timeline(doc, eraserRecording);
+    this->totalFrames = std::max<size_t>(timeline.getFrameCount(frameRate), 1);
 
-    g_message("Found %zu stroke motion points and %zu eraser motion points, estimated %zu frames to export",
+    g_message("Found %zu stroke motion points and %zu eraser motion points, %zu frames to export",
               totalMotionPoints, eraserMotionPoints, this->totalFrames);
 
     // Export motion data as metadata file
@@ -157,8 +321,8 @@ auto MotionExporter::startExport(fs::path const& outputPath, int frameRate) -> b
         };
 
         // Export detailed motion data for each page
-        for (size_t p = 0; p < this->document->getPageCount(); p++) {
-            auto page = this->document->getPage(p);
+        for (size_t p = 0; p < doc.getPageCount(); p++) {
+            auto page = doc.getPage(p);
             if (!page) {
                 continue;
             }
@@ -189,11 +353,9 @@ auto MotionExporter::startExport(fs::path const& outputPath, int frameRate) -> b
             metadataFile << "      \"strokes\": [\n";
 
             bool firstStroke = true;
-            const auto& layers = page->getLayers();
-            for (auto* layer : layers) {
-                const auto& elements = layer->getElements();
-                for (const auto& element : elements) {
-                    if (auto* stroke = dynamic_cast<Stroke*>(element.get())) {
+            for (const auto* layer: page->getLayersView()) {
+                for (const auto* element: layer->getElementsView()) {
+                    if (const auto* stroke = dynamic_cast<const Stroke*>(element)) {
                         if (stroke->hasMotionRecording()) {
                             if (!firstStroke) {
                                 metadataFile << ",\n";
@@ -271,7 +433,7 @@ auto MotionExporter::startExport(fs::path const& outputPath, int frameRate) -> b
 
             metadataFile << "\n      ]\n";
             metadataFile << "    }";
-            if (p < this->document->getPageCount() - 1) {
+            if (p < doc.getPageCount() - 1) {
                 metadataFile << ",";
             }
             metadataFile << "\n";
@@ -279,7 +441,7 @@ auto MotionExporter::startExport(fs::path const& outputPath, int frameRate) -> b
 
         metadataFile << "  ],\n";
         
-        // Export eraser motion events (using eraserRecording from earlier scope)
+        // Export eraser motion events
         metadataFile << "  \"eraserEvents\": [\n";
         
         const auto& eraserPoints = eraserRecording.getMotionPoints();
@@ -313,6 +475,51 @@ auto MotionExporter::startExport(fs::path const& outputPath, int frameRate) -> b
         g_message("Motion metadata exported to: %s", metadataPath.string().c_str());
     }
 
+    // Render the frames, in contiguous ranges so that each worker can draw its canvas incrementally
+    this->frameWidth = 0;
+    this->frameHeight = 0;
+    for (size_t p = 0; p < doc.getPageCount(); p++) {
+        auto page = doc.getPage(p);
+        this->frameWidth = std::max(this->frameWidth, static_cast<int>(std::ceil(page->getWidth() * FRAME_ZOOM)));
+        this->frameHeight = std::max(this->frameHeight, static_cast<int>(std::ceil(page->getHeight() * FRAME_ZOOM)));
+    }
+    // Video encoders usually require even dimensions
+    this->frameWidth += this->frameWidth % 2;
+    this->frameHeight += this->frameHeight % 2;
+
+    size_t workerCount = this->settings.getSchedulerThreadCount();
+    if (workerCount == 0) {
+        workerCount = std::max(1U, std::thread::hardware_concurrency());
+    }
+    workerCount = std::min(workerCount, this->totalFrames);
+
+    std::atomic<bool> failed = false;
+    std::vector<std::thread> workers;
+    workers.reserve(workerCount);
+    for (size_t w = 0; w < workerCount; w++) {
+        size_t first = this->totalFrames * w / workerCount;
+        size_t last = this->totalFrames * (w + 1) / workerCount;
+        workers.emplace_back([this, &doc, &timeline, &failed, first, last]() {
+            if (!renderFrames(doc, timeline, first, last)) {
+                failed = true;
+            }
+        });
+    }
+    for (auto& worker: workers) {
+        worker.join();
+    }
+
+    if (failed) {
+        g_warning("Motion export: could not write the frames to %s", outputPath.string().c_str());
+        this->exporting = false;
+        return false;
+    }
+    if (this->stopRequested) {
+        g_message("Motion export stopped after %zu frames", this->frameCount.load());
+        this->exporting = false;
+        return false;
+    }
+
     // Create a README file with instructions
     fs::path readmePath = outputPath / "README.txt";
     std::ofstream readmeFile(readmePath);
@@ -328,19 +535,17 @@ auto MotionExporter::startExport(fs::path const& outputPath, int frameRate) -> b
         readmeFile << "      which excludes idle time between strokes. This makes video rendering\n";
         readmeFile << "      more efficient and focused on actual drawing activity.\n\n";
         readmeFile << "Files:\n";
+        readmeFile << "  - frame_NNNNNN.png: The rendered frames\n";
         readmeFile << "  - motion_metadata.json: Detailed motion data in JSON format\n";
         readmeFile << "  - README.txt: This file\n\n";
-        readmeFile << "To create a video from this data, you can use external tools like:\n";
-        readmeFile << "  1. Custom rendering script (using motion_metadata.json)\n";
-        readmeFile << "  2. FFmpeg (if you generate frame images)\n\n";
-        readmeFile << "Example FFmpeg command (after generating frames):\n";
+        readmeFile << "Note: Erased strokes are not part of the document anymore, the frames only show the\n";
+        readmeFile << "      position of the eraser.\n\n";
+        readmeFile << "To create a video from the frames, you can use FFmpeg:\n";
         readmeFile << "  ffmpeg -framerate " << frameRate
                    << " -pattern_type glob -i 'frame_*.png' -c:v libx264 -pix_fmt yuv420p output.mp4\n";
         readmeFile.close();
     }
 
-    this->progress = 1.0;
-    this->frameCount = this->totalFrames;
     this->exporting = false;
 
     g_message("Motion export completed successfully");
@@ -350,22 +555,30 @@ auto MotionExporter::startExport(fs::path const& outputPath, int frameRate) -> b
 void MotionExporter::stop() {
     if (this->exporting) {
         g_message("Stopping motion export");
-        this->exporting = false;
+        this->stopRequested = true;
     }
 }
 
 auto MotionExporter::isExporting() const -> bool { return this->exporting; }
 
-auto MotionExporter::getProgress() const -> double { return this->progress; }
+auto MotionExporter::getProgress() const -> double {
+    if (this->totalFrames == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(this->frameCount) / static_cast<double>(this->totalFrames);
+}
 
 auto MotionExporter::getFrameCount() const -> size_t { return this->frameCount; }
 
-auto MotionExporter::exportPageMotion(XojPage* page, size_t pageIndex) -> bool {
-    // This can be extended to export page-specific data
+auto MotionExporter::renderFrames(const Document& doc, const MotionTimeline& timeline, size_t first, size_t last)
+        -> bool {
+    FrameRenderer renderer(*this, doc, timeline);
+    for (size_t frame = first; frame < last && !this->stopRequested; frame++) {
+        if (!renderer.render(frame)) {
+            this->stopRequested = true;
+            return false;
+        }
+        this->frameCount++;
+    }
     return true;
 }
-
-auto MotionExporter::renderFrame(size_t frameIndex, size_t timestamp) -> bool {
-    // This can be extended to render actual frame images
-    return true;
-}
\ No newline at end of file
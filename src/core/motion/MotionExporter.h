@@ -11,17 +11,22 @@
 
 #pragma once
 
-#include <memory>   // for unique_ptr
-#include <string>   // for string
-#include <vector>   // for vector
+#include <atomic>   // for atomic
+#include <cstddef>  // for size_t
 
 #include "filesystem.h"  // for path
 
 class Document;
-class MotionRecording;
+class MotionTimeline;
 class Settings;
-class XojPage;
 
+/**
+ * @brief Replays the motion recordings of a document and renders them as PNG frames
+ *
+ * The frames are rendered from a snapshot of the document, split in contiguous ranges between worker threads. Each
+ * worker keeps the page it renders as a canvas with the strokes completed so far, so a frame only has to draw the
+ * strokes in progress on top of it.
+ */
 class MotionExporter final {
 public:
     explicit MotionExporter(Settings& settings, Document* document);
@@ -60,22 +65,24 @@ public:
     [[nodiscard]] size_t getFrameCount() const;
 
 private:
-    /**
-     * @brief Export motion data from a page
-     */
-    bool exportPageMotion(XojPage* page, size_t pageIndex);
+    class FrameRenderer;
 
     /**
-     * @brief Render a single frame at given timestamp
+     * @brief Render the frames [first, last) of the timeline, called by the worker threads
+     * @return false on error
      */
-    bool renderFrame(size_t frameIndex, size_t timestamp);
+    bool renderFrames(const Document& doc, const MotionTimeline& timeline, size_t first, size_t last);
 
     Settings& settings;
     Document* document;
     fs::path outputPath;
     int frameRate;
-    bool exporting;
-    double progress;
-    size_t frameCount;
+    std::atomic<bool> exporting;
+    std::atomic<bool> stopRequested;
+    std::atomic<size_t> frameCount;
     size_t totalFrames;
+
+    /// Size of the frames in pixels, fitting the largest page
+    int frameWidth = 0;
+    int frameHeight = 0;
 };
@@ -0,0 +1,154 @@
+#include "MotionTimeline.h"
+
+#include <algorithm>  // for sort, upper_bound, max, min
+
+#include "model/Document.h"               // for Document
+#include "model/Element.h"                // for Element, ELEMENT_STROKE
+#include "model/EraserMotionRecording.h"  // for EraserMotionRecording
+#include "model/Layer.h"                  // for Layer
+#include "model/MotionRecording.h"        // for MotionRecording
+#include "model/Stroke.h"                 // for Stroke
+#include "model/XojPage.h"                // for XojPage
+#include "util/Util.h"                    // for npos
+
+MotionTimeline::MotionTimeline(const Document& doc, const EraserMotionRecording& eraser):
+        eraser(eraser), strokes(doc.getPageCount()) {
+    for (size_t p = 0; p < doc.getPageCount(); p++) {
+        ConstPageRef page = doc.getPage(p);
+        for (const Layer* layer: page->getLayersView()) {
+            for (const Element* e: layer->getElementsView()) {
+                if (e->getType() != ELEMENT_STROKE) {
+                    continue;
+                }
+                const auto* stroke = dynamic_cast<const Stroke*>(e);
+                if (!isReplayed(stroke)) {
+                    continue;
+                }
+                const MotionRecording* motion = stroke->getMotionRecording();
+                size_t start = motion->getStartTimestamp();
+                size_t end = std::max(start, motion->getEndTimestamp());
+                this->strokes[p].push_back({stroke, start, end});
+                this->activities.push_back({start, end, p});
+            }
+        }
+        std::stable_sort(this->strokes[p].begin(), this->strokes[p].end(),
+                         [](const StrokeEntry& a, const StrokeEntry& b) { return a.end < b.end; });
+    }
+
+    const auto& points = eraser.getMotionPoints();
+    for (size_t i = 0; i < points.size(); i++) {
+        const EraserMotionPoint& point = points[i];
+        if (this->eraserRuns.empty() || this->eraserRuns.back().page != point.pageIndex ||
+            point.timestamp < this->eraserRuns.back().end ||
+            point.timestamp - this->eraserRuns.back().end > ERASER_RUN_GAP) {
+            this->eraserRuns.push_back({point.pageIndex, i, i, point.timestamp, point.timestamp});
+        } else {
+            this->eraserRuns.back().last = i;
+            this->eraserRuns.back().end = point.timestamp;
+        }
+    }
+    for (const EraserRun& run: this->eraserRuns) {
+        this->activities.push_back({run.start, run.end, run.page});
+    }
+    std::stable_sort(this->eraserRuns.begin(), this->eraserRuns.end(),
+                     [](const EraserRun& a, const EraserRun& b) { return a.start < b.start; });
+    std::stable_sort(this->activities.begin(), this->activities.end(),
+                     [](const Activity& a, const Activity& b) { return a.start < b.start; });
+
+    // Skip the idle time: merge the overlapping activities into segments, laid end to end
+    for (const Activity& a: this->activities) {
+        if (this->segments.empty() || a.start > this->segments.back().end) {
+            this->segments.push_back({a.start, a.end, 0});
+        } else {
+            this->segments.back().end = std::max(this->segments.back().end, a.end);
+        }
+    }
+    for (Segment& s: this->segments) {
+        s.time = this->duration;
+        this->duration += s.end - s.start;
+    }
+}
+
+auto MotionTimeline::isEmpty() const -> bool { return this->activities.empty(); }
+
+auto MotionTimeline::getDuration() const -> size_t { return this->duration; }
+
+auto MotionTimeline::getFrameCount(int frameRate) const -> size_t {
+    if (isEmpty() || frameRate <= 0) {
+        return 0;
+    }
+    auto fps = static_cast<size_t>(frameRate);
+    // Round up, so that the last frame shows the end of the timeline
+    return (this->duration * fps + 999) / 1000 + 1;
+}
+
+auto MotionTimeline::getFrameTimestamp(size_t frame, int frameRate) const -> size_t {
+    size_t time = frame * 1000 / static_cast<size_t>(std::max(frameRate, 1));
+    return toTimestamp(std::min(time, this->duration));
+}
+
+auto MotionTimeline::toTimestamp(size_t time) const -> size_t {
+    if (this->segments.empty()) {
+        return 0;
+    }
+    auto it = std::upper_bound(this->segments.begin(), this->segments.end(), time,
+                               [](size_t t, const Segment& s) { return t < s.time; });
+    if (it != this->segments.begin()) {
+        --it;
+    }
+    return it->start + std::min(time - it->time, it->end - it->start);
+}
+
+auto MotionTimeline::getPageAt(size_t timestamp) const -> size_t {
+    if (this->activities.empty()) {
+        return npos;
+    }
+    auto it = std::upper_bound(this->activities.begin(), this->activities.end(), timestamp,
+                               [](size_t ts, const Activity& a) { return ts < a.start; });
+    if (it != this->activities.begin()) {
+        --it;
+    }
+    return it->page;
+}
+
+auto MotionTimeline::getStrokes(size_t page) const -> const std::vector<StrokeEntry>& { return this->strokes[page]; }
+
+auto MotionTimeline::getEraserAt(size_t page, size_t timestamp) const -> const EraserMotionPoint* {
+    auto it = std::upper_bound(this->eraserRuns.begin(), this->eraserRuns.end(), timestamp,
+                               [](size_t ts, const EraserRun& r) { return ts < r.start; });
+    if (it == this->eraserRuns.begin()) {
+        return nullptr;
+    }
+    --it;
+    if (it->page != page || timestamp > it->end) {
+        return nullptr;
+    }
+
+    const auto& points = this->eraser.getMotionPoints();
+    auto first = points.begin() + static_cast<std::ptrdiff_t>(it->first);
+    auto last = points.begin() + static_cast<std::ptrdiff_t>(it->last) + 1;
+    auto point = std::upper_bound(first, last, timestamp,
+                                  [](size_t ts, const EraserMotionPoint& p) { return ts < p.timestamp; });
+    return &*std::prev(point);
+}
+
+auto MotionTimeline::getDrawnPointCount(const StrokeEntry& entry, size_t timestamp) -> size_t {
+    size_t pointCount = entry.stroke->getPointCount();
+    if (timestamp < entry.start) {
+        return 0;
+    }
+    if (timestamp >= entry.end) {
+        return pointCount;
+    }
+
+    const auto& motion = entry.stroke->getMotionRecording()->getMotionPoints();
+    auto recorded = static_cast<size_t>(
+            std::upper_bound(motion.begin(), motion.end(), timestamp,
+                             [](size_t ts, const MotionPoint& p) { return ts < p.timestamp; }) -
+            motion.begin());
+    return std::min(pointCount, (pointCount * recorded + motion.size() - 1) / motion.size());
+}
+
+auto MotionTimeline::isReplayed(const Stroke* stroke) -> bool {
+    return stroke->getMotionRecording() != nullptr && stroke->getMotionRecording()->hasMotionData();
+}
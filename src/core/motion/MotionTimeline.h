@@ -0,0 +1,137 @@
+/*
+ * Xournal++
+ *
+ * Replay order of the motion recordings of a document
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <vector>   // for vector
+
+class Document;
+class EraserMotionRecording;
+struct EraserMotionPoint;
+class Stroke;
+
+/**
+ * @brief Timeline of the strokes with a motion recording and of the eraser motion of a document
+ *
+ * Everything is replayed in the order it was recorded, but the idle time between two strokes or eraser moves is
+ * skipped: the time of the timeline (in ms) only runs while drawing or erasing. The timestamps of the recordings are
+ * called absolute timestamps.
+ *
+ * The timeline refers to the strokes of the document: it must not be modified while the timeline is in use.
+ */
+class MotionTimeline final {
+public:
+    /**
+     * A stroke drawn with motion recording
+     */
+    struct StrokeEntry {
+        const Stroke* stroke;
+        size_t start;  ///< Absolute timestamp of the first motion point
+        size_t end;    ///< Absolute timestamp of the last motion point
+    };
+
+    /**
+     * Eraser moves without interruption on a single page
+     */
+    struct EraserRun {
+        size_t page;
+        size_t first;  ///< Index of the first point in the eraser recording
+        size_t last;   ///< Index of the last point in the eraser recording
+        size_t start;
+        size_t end;
+    };
+
+    /**
+     * A gap between two eraser motion points larger than this (ms) ends an eraser run
+     */
+    static constexpr size_t ERASER_RUN_GAP = 500;
+
+    MotionTimeline(const Document& doc, const EraserMotionRecording& eraser);
+
+public:
+    /**
+     * @return If there is nothing to replay
+     */
+    bool isEmpty() const;
+
+    /**
+     * @return The length of the timeline in ms
+     */
+    size_t getDuration() const;
+
+    /**
+     * @return The number of frames needed to replay everything, the last one showing the final state
+     */
+    size_t getFrameCount(int frameRate) const;
+
+    /**
+     * @return The absolute timestamp shown by a frame
+     */
+    size_t getFrameTimestamp(size_t frame, int frameRate) const;
+
+    /**
+     * @return The absolute timestamp at the given time of the timeline
+     */
+    size_t toTimestamp(size_t time) const;
+
+    /**
+     * @return The page on which the last stroke or eraser run started at the absolute timestamp was drawn
+     */
+    size_t getPageAt(size_t timestamp) const;
+
+    /**
+     * @return The replayed strokes of a page, sorted by end timestamp
+     */
+    const std::vector<StrokeEntry>& getStrokes(size_t page) const;
+
+    /**
+     * @return The position of the eraser on the page at the absolute timestamp, nullptr if it is not in use then
+     */
+    const EraserMotionPoint* getEraserAt(size_t page, size_t timestamp) const;
+
+    /**
+     * @return The number of points of the stroke drawn at the absolute timestamp, proportional to the number of motion
+     * points recorded until then
+     */
+    static size_t getDrawnPointCount(const StrokeEntry& entry, size_t timestamp);
+
+    /**
+     * @return If the element is replayed, i.e. it is a stroke with a motion recording
+     */
+    static bool isReplayed(const Stroke* stroke);
+
+private:
+    /**
+     * Part of the timeline where something is drawn or erased without interruption
+     */
+    struct Segment {
+        size_t start;  ///< Absolute timestamps
+        size_t end;
+        size_t time;  ///< Time of the timeline at start
+    };
+
+    struct Activity {
+        size_t start;
+        size_t end;
+        size_t page;
+    };
+
+    const EraserMotionRecording& eraser;
+
+    std::vector<std::vector<StrokeEntry>> strokes;
+    std::vector<EraserRun> eraserRuns;
+
+    /// Sorted by start
+    std::vector<Activity> activities;
+    std::vector<Segment> segments;
+    size_t duration = 0;
+};
@@ -1,19 +1,22 @@
 #include "HybridPdfExport.h"
 
-#include <algorithm>  // for min
-#include <ctime>      // for time_t
-#include <sstream>    // for stringstream
-#include <vector>     // for vector
+#include <algorithm>     // for min
+#include <ctime>         // for time_t
+#include <system_error>  // for error_code
+#include <vector>        // for vector
 
-#include <cairo-pdf.h>  // for cairo_pdf_surface_create_for_stream
+#include <cairo-pdf.h>    // for cairo_pdf_surface_create
+#include <glib.h>         // for g_file_open_tmp
+#include <glib/gstdio.h>  // for g_close
 
 #include "control/jobs/ProgressListener.h"  // for ProgressListener
 #include "model/Document.h"                 // for Document
 #include "model/PageRef.h"                  // for PageRef
 #include "model/XojPage.h"                  // for XojPage
 #include "util/Assert.h"                    // for xoj_assert
+#include "util/StringUtils.h"               // for char_cast
 #include "util/i18n.h"                      // for _
-#include "util/serdesstream.h"              // for serdes_stream
+#include "util/utf8_view.h"                 // for utf8
 
 #include "filesystem.h"  // for path
 
@@ -23,13 +26,42 @@ HybridPdfExport::HybridPdfExport(const Document* doc, ProgressListener* progress
 
 HybridPdfExport::~HybridPdfExport() = default;
 
-static cairo_status_t writeFun(void* stream, const unsigned char* data, unsigned int length) {
-    *static_cast<std::stringstream*>(stream) << std::string_view((char*)data, length);
-    return CAIRO_STATUS_SUCCESS;
-}
+namespace {
+/**
+ * A temporary file, deleted when going out of scope
+ */
+class TmpFile {
+public:
+    TmpFile() {
+        GError* error = nullptr;
+        gchar* name = nullptr;
+        gint fd = g_file_open_tmp("xournalpp-overlay-XXXXXX.pdf", &name, &error);
+        if (fd == -1) {
+            g_warning("HybridPdfExport: could not create a temporary file: %s", error->message);
+            g_error_free(error);
+            return;
+        }
+        g_close(fd, nullptr);
+        this->path = fs::path(xoj::util::utf8(name));
+        g_free(name);
+    }
+
+    ~TmpFile() {
+        if (!this->path.empty()) {
+            std::error_code ec;
+            fs::remove(this->path, ec);
+        }
+    }
+
+    TmpFile(const TmpFile&) = delete;
+    TmpFile& operator=(const TmpFile&) = delete;
+
+    fs::path path;
+};
+}  // namespace
 
-auto HybridPdfExport::startPdf(std::stringstream& stream) -> bool {
-    this->surface = cairo_pdf_surface_create_for_stream(writeFun, &stream, 0, 0);
+auto HybridPdfExport::startPdf(const fs::path& overlayFile) -> bool {
+    this->surface = cairo_pdf_surface_create(char_cast(overlayFile.u8string().c_str()), 0, 0);
     this->cr = cairo_create(surface);
 
     configureCairoFontOptions();
@@ -47,10 +79,14 @@ auto HybridPdfExport::createPdf(fs::path const& file, const PageRangeVector& ran
         return false;
     }
 
-    // Export the annotations to a PDF stream via cairo
-    auto stream = serdes_stream<std::stringstream>();
+    // Export the annotations to a temporary PDF file via cairo: the memory used does not grow with the document
+    TmpFile overlay;
+    if (overlay.path.empty()) {
+        this->lastError = _("Failed to create a temporary file for the annotations");
+        return false;
+    }
 
-    if (!startPdf(stream)) {
+    if (!startPdf(overlay.path)) {
         this->lastError = _("Failed to initialize PDF Cairo surface");
         this->lastError += "\nCairo error: ";
         this->lastError += cairo_status_to_string(cairo_surface_status(this->surface));
@@ -93,7 +129,7 @@ auto HybridPdfExport::createPdf(fs::path const& file, const PageRangeVector& ran
         return false;
     }
 
-    return overlayAndSave(file, stream, overlayToBackgroundIndex);
+    return overlayAndSave(file, overlay.path, overlayToBackgroundIndex);
 }
 
 auto HybridPdfExport::createPdf(fs::path const& file, bool progressiveMode) -> bool {
@@ -12,7 +12,7 @@
 #pragma once
 
 #include <cstddef>  // for size_t
-#include <sstream>
+#include <vector>   // for vector
 
 #include "util/ElementRange.h"  // for PageRangeVector
 
@@ -45,8 +45,14 @@ public:
                                                      const std::vector<OutputPageInfo>& outputPageInfos);
 
 protected:
-    bool startPdf(std::stringstream& stream);
-    virtual bool overlayAndSave(const fs::path& saveDestination, std::stringstream& overlaystream,
+    /**
+     * Starts the overlay PDF, written by cairo to a temporary file as the pages are exported
+     */
+    bool startPdf(const fs::path& overlayFile);
+    /**
+     * @param overlayFile The overlay PDF, read by the PDF library on demand instead of being loaded in memory
+     */
+    virtual bool overlayAndSave(const fs::path& saveDestination, const fs::path& overlayFile,
                                 const std::vector<OutputPageInfo>& outputPageInfos) = 0;
     static std::string createPDFDateStringForNow();  // See PDF 1.7 specs - section 7.9.4
 };
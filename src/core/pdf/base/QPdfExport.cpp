@@ -3,8 +3,7 @@
 #ifdef ENABLE_QPDF
 
 #include <algorithm>
-#include <sstream>  // for ostringstream
-#include <vector>   // for vector
+#include <vector>  // for vector
 
 #include <qpdf/DLL.h>
 #if QPDF_MAJOR_VERSION == 11
@@ -82,12 +81,12 @@ static void reorderBackgrounds(QPDF& background, const std::vector<HybridPdfExpo
                              [](auto&& a) { return a.pdfBackgroundPageNumber != npos; }));
 }
 
-bool QPdfExport::overlayAndSave(const fs::path& saveDestination, std::stringstream& overlaystream,
+bool QPdfExport::overlayAndSave(const fs::path& saveDestination, const fs::path& overlayFile,
                                 const std::vector<OutputPageInfo>& outputPageInfos) {
     try {
-        auto overlaydata = overlaystream.str();  // Should probably be kept alive until we are done (not sure)
+        // The objects are read from the file when they are copied to the output
         QPDF overlay;
-        overlay.processMemoryFile("overlay", overlaydata.data(), overlaydata.length());
+        overlay.processFile(char_cast(overlayFile.u8string().c_str()));
 
         QPDF background;
         background.processFile(char_cast(doc->getPdfFilepath().u8string().c_str()));  // TODO: UTF8 is ok?
@@ -15,7 +15,7 @@
 
 #ifdef ENABLE_QPDF
 
-#include <sstream>
+#include <vector>  // for vector
 
 #include "HybridPdfExport.h"  // for HybridPdfExport
 #include "filesystem.h"       // for path
@@ -29,7 +29,7 @@ public:
     ~QPdfExport() override;
 
 protected:
-    bool overlayAndSave(const fs::path& saveDestination, std::stringstream& overlaystream,
+    bool overlayAndSave(const fs::path& saveDestination, const fs::path& overlayFile,
                         const std::vector<OutputPageInfo>& outputPageInfos) override;
 };
 
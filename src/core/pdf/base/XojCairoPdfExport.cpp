@@ -1,10 +1,12 @@
 #include "XojCairoPdfExport.h"
 
 #include <algorithm>  // for copy, min
-#include <map>        // for map
-#include <memory>     // for __shared_ptr_access
-#include <sstream>    // for ostringstream, operator<<
-#include <stack>      // for stack
+#include <map>           // for map
+#include <memory>        // for __shared_ptr_access
+#include <mutex>         // for unique_lock
+#include <shared_mutex>  // for shared_lock
+#include <sstream>       // for ostringstream, operator<<
+#include <stack>         // for stack
 #include <utility>    // for pair, make_pair
 #include <vector>     // for vector
 
@@ -138,6 +140,7 @@ bool XojCairoPdfExport::endPdf() {
 
 void XojCairoPdfExport::exportPage(size_t page, bool exportPdfBackground) {
     PageRef p = doc->getPage(page);
+    std::shared_lock pageLock(p->getContentLock());
 
     cairo_pdf_surface_set_size(this->surface, p->getWidth(), p->getHeight());
 
@@ -177,20 +180,29 @@ void XojCairoPdfExport::exportPageLayers(size_t page) {
 
     // We keep a copy of the layers initial Visible state
     std::map<Layer*, bool> initialVisibility;
-    for (const auto& layer: p->getLayers()) {
-        initialVisibility[layer] = layer->isVisible();
-        layer->setVisible(false);
+    std::vector<Layer*> layers;
+    {
+        std::unique_lock pageLock(p->getContentLock());
+        layers = p->getLayers();
+        for (const auto& layer: layers) {
+            initialVisibility[layer] = layer->isVisible();
+            layer->setVisible(false);
+        }
     }
 
     // We draw as many pages as there are layers. The first page has
     // only Layer 1 visible, the last has all layers visible.
-    for (const auto& layer: p->getLayers()) {
-        layer->setVisible(true);
+    for (const auto& layer: layers) {
+        {
+            std::unique_lock pageLock(p->getContentLock());
+            layer->setVisible(true);
+        }
         exportPage(page);
     }
 
     // We restore the initial visibilities
-    for (const auto& layer: p->getLayers()) layer->setVisible(initialVisibility[layer]);
+    std::unique_lock pageLock(p->getContentLock());
+    for (const auto& layer: layers) layer->setVisible(initialVisibility[layer]);
 }
 
 auto XojCairoPdfExport::createPdf(fs::path const& file, const PageRangeVector& range, bool progressiveMode) -> bool {
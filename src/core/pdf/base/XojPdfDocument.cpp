@@ -24,7 +24,7 @@ auto XojPdfDocument::operator=(const XojPdfDocument& doc) -> XojPdfDocument& {
     return *this;
 }
 
-auto XojPdfDocument::operator==(XojPdfDocument& doc) const -> bool { return this->doc->equals(doc.doc); }
+auto XojPdfDocument::operator==(const XojPdfDocument& doc) const -> bool { return this->doc->equals(doc.doc); }
 
 void XojPdfDocument::assign(XojPdfDocumentInterface* doc) { this->doc->assign(doc); }
 
@@ -34,7 +34,7 @@ public:
 
 public:
     XojPdfDocument& operator=(const XojPdfDocument& doc);
-    bool operator==(XojPdfDocument& doc) const;
+    bool operator==(const XojPdfDocument& doc) const;
     void assign(XojPdfDocumentInterface* doc) override;
     bool equals(XojPdfDocumentInterface* doc) const override;
 
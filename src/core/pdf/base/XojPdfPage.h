@@ -49,6 +49,10 @@ public:
     double y2 = -1;
 };
 
+/**
+ * A page of a PDF document. The methods may be called from any thread: the implementations serialize the calls into
+ * the PDF library, which is not thread safe (see PopplerGlibDocument::getPopplerMutex()).
+ */
 class XojPdfPage {
 public:
     struct TextSelection {
@@ -77,6 +81,11 @@ public:
 
     virtual std::vector<XojPdfRectangle> findText(const std::string& text) = 0;
 
+    /**
+     * @return The whole text of the page, the lines separated by '\n'
+     */
+    virtual std::string getText() = 0;
+
     /// Retrieve the text contained in the provided rectangle using the given
     /// selection style.
     /// @param rect start and end points
@@ -2,6 +2,7 @@
 
 #include <algorithm>  // for min
 #include <cstddef>    // for size_t
+#include <mutex>      // for lock_guard
 
 #include <glib.h>              // for g_warning, gchar
 #include <poppler-action.h>    // for poppler_dest_free, PopplerActi...
@@ -12,6 +13,8 @@
 #include "util/Util.h"                 // for npos
 #include "util/raii/CLibrariesSPtr.h"  // for ref
 
+#include "PopplerGlibDocument.h"  // for PopplerGlibDocument
+
 using std::string;
 
 PopplerGlibAction::PopplerGlibAction(PopplerAction* action, PopplerDocument* document):
@@ -50,6 +53,7 @@ auto PopplerGlibAction::getDestination(PopplerAction* action) -> std::shared_ptr
 auto PopplerGlibAction::getDestination() -> std::shared_ptr<const LinkDestination> { return destination; }
 
 void PopplerGlibAction::linkFromDest(LinkDestination& link, PopplerDest* pDest) {
+    std::lock_guard lock(PopplerGlibDocument::getPopplerMutex());
     switch (pDest->type) {
         case POPPLER_DEST_UNKNOWN:
             g_warning("PDF Contains unknown link destination");
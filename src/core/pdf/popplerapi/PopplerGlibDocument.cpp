@@ -1,6 +1,7 @@
 #include "PopplerGlibDocument.h"
 
 #include <memory>    // for make_shared, unique_ptr
+#include <mutex>     // for lock_guard, recursive_mutex
 #include <optional>  // for optional
 
 #include <poppler-document.h>  // for poppler_document_get_n_...
@@ -15,6 +16,11 @@ class XojPdfBookmarkIterator;
 
 using std::string;
 
+auto PopplerGlibDocument::getPopplerMutex() -> std::recursive_mutex& {
+    static std::recursive_mutex mutex;
+    return mutex;
+}
+
 PopplerGlibDocument::PopplerGlibDocument() = default;
 
 PopplerGlibDocument::PopplerGlibDocument(const PopplerGlibDocument& doc): document(doc.document) {
@@ -24,6 +30,7 @@ PopplerGlibDocument::PopplerGlibDocument(const PopplerGlibDocument& doc): docume
 }
 
 PopplerGlibDocument::~PopplerGlibDocument() {
+    std::lock_guard lock(getPopplerMutex());
     if (document) {
         g_object_unref(document);
         document = nullptr;
@@ -31,6 +38,7 @@ PopplerGlibDocument::~PopplerGlibDocument() {
 }
 
 void PopplerGlibDocument::assign(XojPdfDocumentInterface* doc) {
+    std::lock_guard lock(getPopplerMutex());
     if (document) {
         g_object_unref(document);
     }
@@ -46,6 +54,7 @@ auto PopplerGlibDocument::equals(XojPdfDocumentInterface* doc) const -> bool {
 }
 
 auto PopplerGlibDocument::save(fs::path const& file, GError** error) const -> bool {
+    std::lock_guard lock(getPopplerMutex());
     if (document == nullptr) {
         return false;
     }
@@ -58,6 +67,7 @@ auto PopplerGlibDocument::save(fs::path const& file, GError** error) const -> bo
 }
 
 auto PopplerGlibDocument::load(fs::path const& file, string password, GError** error) -> bool {
+    std::lock_guard lock(getPopplerMutex());
     auto uri = Util::toUri(file);
     if (!uri) {
         return false;
@@ -73,6 +83,7 @@ auto PopplerGlibDocument::load(fs::path const& file, string password, GError** e
 }
 
 auto PopplerGlibDocument::load(std::unique_ptr<std::string> data, string password, GError** error) -> bool {
+    std::lock_guard lock(getPopplerMutex());
     if (document) {
         g_object_unref(document);
     }
@@ -89,6 +100,7 @@ auto PopplerGlibDocument::load(std::unique_ptr<std::string> data, string passwor
 auto PopplerGlibDocument::isLoaded() const -> bool { return this->document != nullptr; }
 
 void PopplerGlibDocument::reset() {
+    std::lock_guard lock(getPopplerMutex());
     if (document) {
         g_object_unref(document);
         document = nullptr;
@@ -96,6 +108,7 @@ void PopplerGlibDocument::reset() {
 }
 
 auto PopplerGlibDocument::getPage(size_t page) const -> XojPdfPageSPtr {
+    std::lock_guard lock(getPopplerMutex());
     if (document == nullptr) {
         return nullptr;
     }
@@ -108,6 +121,7 @@ auto PopplerGlibDocument::getPage(size_t page) const -> XojPdfPageSPtr {
 }
 
 auto PopplerGlibDocument::getPageCount() const -> size_t {
+    std::lock_guard lock(getPopplerMutex());
     if (document == nullptr) {
         return 0;
     }
@@ -116,6 +130,7 @@ auto PopplerGlibDocument::getPageCount() const -> size_t {
 }
 
 auto PopplerGlibDocument::getContentsIter() const -> XojPdfBookmarkIterator* {
+    std::lock_guard lock(getPopplerMutex());
     if (document == nullptr) {
         return nullptr;
     }
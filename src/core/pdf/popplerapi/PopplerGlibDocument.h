@@ -12,6 +12,7 @@
 #pragma once
 
 #include <cstddef>  // for size_t
+#include <mutex>    // for recursive_mutex
 #include <string>   // for string
 
 #include <glib.h>     // for GError, gpointer, gsize
@@ -24,6 +25,10 @@
 
 class XojPdfBookmarkIterator;
 
+/**
+ * Poppler is not thread safe. The wrappers of this folder lock getPopplerMutex() around every call into it, so the
+ * PDF pages can be used from any thread: render and preview jobs, prefetch, exports and search indexing.
+ */
 class PopplerGlibDocument: public XojPdfDocumentInterface {
 public:
     PopplerGlibDocument();
@@ -45,6 +50,12 @@ public:
     size_t getPageCount() const override;
     XojPdfBookmarkIterator* getContentsIter() const override;
 
+    /**
+     * @return The lock held by every call into Poppler, whichever the document. Recursive, as some wrapper methods call
+     * each other.
+     */
+    static std::recursive_mutex& getPopplerMutex();
+
 private:
     PopplerDocument* document = nullptr;
 };
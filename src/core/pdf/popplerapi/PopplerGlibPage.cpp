@@ -3,6 +3,7 @@
 #include <algorithm>  // for max, min
 #include <cstdlib>    // for abs, NULL, ptrdiff_t
 #include <memory>     // for make_unique
+#include <mutex>      // for lock_guard
 #include <sstream>    // for operator<<, ostringstream, bas...
 
 #include <glib.h>          // for g_free, g_utf8_offset_to_pointer
@@ -16,16 +17,19 @@
 #include "util/raii/CLibrariesSPtr.h"  // for adopt
 #include "util/raii/CairoWrappers.h"   // for CairoRegionSPtr
 
-#include "PopplerGlibAction.h"  // for PopplerGlibAction
-#include "cairo.h"              // for cairo_region_create, cairo_reg...
+#include "PopplerGlibAction.h"    // for PopplerGlibAction
+#include "PopplerGlibDocument.h"  // for PopplerGlibDocument
+#include "cairo.h"                // for cairo_region_create, cairo_reg...
 
 PopplerGlibPage::PopplerGlibPage(PopplerPage* page, PopplerDocument* parentDoc): page(page), document(parentDoc) {
+    std::lock_guard lock(PopplerGlibDocument::getPopplerMutex());
     if (page != nullptr) {
         g_object_ref(page);
     }
 }
 
 PopplerGlibPage::PopplerGlibPage(const PopplerGlibPage& other): page(other.page), document(other.document) {
+    std::lock_guard lock(PopplerGlibDocument::getPopplerMutex());
     if (page != nullptr) {
         g_object_ref(page);
     }
@@ -34,6 +38,7 @@ PopplerGlibPage::PopplerGlibPage(const PopplerGlibPage& other): page(other.page)
 }
 
 PopplerGlibPage::~PopplerGlibPage() {
+    std::lock_guard lock(PopplerGlibDocument::getPopplerMutex());
     if (page) {
         g_object_unref(page);
         page = nullptr;
@@ -41,6 +46,7 @@ PopplerGlibPage::~PopplerGlibPage() {
 }
 
 PopplerGlibPage& PopplerGlibPage::operator=(const PopplerGlibPage& other) {
+    std::lock_guard lock(PopplerGlibDocument::getPopplerMutex());
     if (&other == this) {
         return *this;
     }
@@ -60,6 +66,7 @@ PopplerGlibPage& PopplerGlibPage::operator=(const PopplerGlibPage& other) {
 }
 
 auto PopplerGlibPage::getWidth() const -> double {
+    std::lock_guard lock(PopplerGlibDocument::getPopplerMutex());
     double width = 0;
     poppler_page_get_size(const_cast<PopplerPage*>(page), &width, nullptr);
 
@@ -67,6 +74,7 @@ auto PopplerGlibPage::getWidth() const -> double {
 }
 
 auto PopplerGlibPage::getHeight() const -> double {
+    std::lock_guard lock(PopplerGlibDocument::getPopplerMutex());
     double height = 0;
     poppler_page_get_size(const_cast<PopplerPage*>(page), nullptr, &height);
 
@@ -74,6 +82,7 @@ auto PopplerGlibPage::getHeight() const -> double {
 }
 
 void PopplerGlibPage::render(cairo_t* cr) const {
+    std::lock_guard lock(PopplerGlibDocument::getPopplerMutex());
     cairo_save(cr);
     cairo_set_source_rgb(cr, 1., 1., 1.);
     cairo_paint(cr);
@@ -81,11 +90,18 @@ void PopplerGlibPage::render(cairo_t* cr) const {
     cairo_restore(cr);
 }
 
-void PopplerGlibPage::renderForPrinting(cairo_t* cr) const { poppler_page_render_for_printing(page, cr); }
+void PopplerGlibPage::renderForPrinting(cairo_t* cr) const {
+    std::lock_guard lock(PopplerGlibDocument::getPopplerMutex());
+    poppler_page_render_for_printing(page, cr);
+}
 
-auto PopplerGlibPage::getPageId() const -> int { return poppler_page_get_index(page); }
+auto PopplerGlibPage::getPageId() const -> int {
+    std::lock_guard lock(PopplerGlibDocument::getPopplerMutex());
+    return poppler_page_get_index(page);
+}
 
 auto PopplerGlibPage::getPageLabel() const -> std::string {
+    std::lock_guard lock(PopplerGlibDocument::getPopplerMutex());
     gchar* label{poppler_page_get_label(page)};
     std::string cpp_label{label};
     g_free(label);
@@ -93,6 +109,7 @@ auto PopplerGlibPage::getPageLabel() const -> std::string {
 }
 
 auto PopplerGlibPage::findText(const std::string& text) -> std::vector<XojPdfRectangle> {
+    std::lock_guard lock(PopplerGlibDocument::getPopplerMutex());
     std::vector<XojPdfRectangle> findings;
 
     double height = getHeight();
@@ -106,6 +123,17 @@ auto PopplerGlibPage::findText(const std::string& text) -> std::vector<XojPdfRec
     return findings;
 }
 
+auto PopplerGlibPage::getText() -> std::string {
+    std::lock_guard lock(PopplerGlibDocument::getPopplerMutex());
+    char* text = poppler_page_get_text(page);
+    if (!text) {
+        return {};
+    }
+    std::string res(text);
+    g_free(text);
+    return res;
+}
+
 auto getPopplerSelectionStyle(XojPdfPageSelectionStyle style) -> PopplerSelectionStyle {
     switch (style) {
         case XojPdfPageSelectionStyle::Word:
@@ -122,6 +150,7 @@ auto getPopplerSelectionStyle(XojPdfPageSelectionStyle style) -> PopplerSelectio
 }
 
 auto PopplerGlibPage::selectText(const XojPdfRectangle& rect, XojPdfPageSelectionStyle style) -> std::string {
+    std::lock_guard lock(PopplerGlibDocument::getPopplerMutex());
     PopplerRectangle pRect = {rect.x1, rect.y1, rect.x2, rect.y2};
     const auto pStyle = getPopplerSelectionStyle(style);
     if (style == XojPdfPageSelectionStyle::Area) {
@@ -175,6 +204,7 @@ auto PopplerGlibPage::selectText(const XojPdfRectangle& rect, XojPdfPageSelectio
 }
 
 auto PopplerGlibPage::selectTextRegion(const XojPdfRectangle& rect, XojPdfPageSelectionStyle style) -> cairo_region_t* {
+    std::lock_guard lock(PopplerGlibDocument::getPopplerMutex());
     PopplerRectangle pRect = {rect.x1, rect.y1, rect.x2, rect.y2};
     const auto pStyle = getPopplerSelectionStyle(style);
     // The computed region is technically wrong for
@@ -192,6 +222,7 @@ cairo_rectangle_int_t cairoRectFromDouble(double x1, double y1, double width, do
 
 auto PopplerGlibPage::selectTextLines(const XojPdfRectangle& selectRect, XojPdfPageSelectionStyle style)
         -> TextSelection {
+    std::lock_guard lock(PopplerGlibDocument::getPopplerMutex());
     std::vector<XojPdfRectangle> textRects;
 
     // The selection rectangle may be "improper" by having x2 <= x1 or y1 <= y2 (e.g., if user
@@ -308,6 +339,7 @@ auto PopplerGlibPage::selectTextLines(const XojPdfRectangle& selectRect, XojPdfP
 }
 
 auto PopplerGlibPage::getLinks() -> std::vector<Link> {
+    std::lock_guard lock(PopplerGlibDocument::getPopplerMutex());
     std::vector<Link> results;
     const double height = getHeight();
 
@@ -36,6 +36,8 @@ public:
 
     std::vector<XojPdfRectangle> findText(const std::string& text) override;
 
+    std::string getText() override;
+
     std::string selectText(const XojPdfRectangle& rect, XojPdfPageSelectionStyle style) override;
 
     cairo_region_t* selectTextRegion(const XojPdfRectangle& rect, XojPdfPageSelectionStyle style) override;
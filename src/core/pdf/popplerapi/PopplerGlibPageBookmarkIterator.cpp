@@ -1,9 +1,12 @@
 #include "PopplerGlibPageBookmarkIterator.h"
 
+#include <mutex>  // for lock_guard
+
 #include <poppler-action.h>    // for poppler_action_free
 #include <poppler-document.h>  // for poppler_index_iter_free
 
-#include "pdf/popplerapi/PopplerGlibAction.h"  // for PopplerGlibAction
+#include "pdf/popplerapi/PopplerGlibAction.h"    // for PopplerGlibAction
+#include "pdf/popplerapi/PopplerGlibDocument.h"  // for PopplerGlibDocument
 
 class XojPdfAction;
 
@@ -13,6 +16,7 @@ PopplerGlibPageBookmarkIterator::PopplerGlibPageBookmarkIterator(PopplerIndexIte
 }
 
 PopplerGlibPageBookmarkIterator::~PopplerGlibPageBookmarkIterator() {
+    std::lock_guard lock(PopplerGlibDocument::getPopplerMutex());
     poppler_index_iter_free(iter);
     iter = nullptr;
 
@@ -22,11 +26,18 @@ PopplerGlibPageBookmarkIterator::~PopplerGlibPageBookmarkIterator() {
     }
 }
 
-auto PopplerGlibPageBookmarkIterator::next() -> bool { return poppler_index_iter_next(iter); }
+auto PopplerGlibPageBookmarkIterator::next() -> bool {
+    std::lock_guard lock(PopplerGlibDocument::getPopplerMutex());
+    return poppler_index_iter_next(iter);
+}
 
-auto PopplerGlibPageBookmarkIterator::isOpen() -> bool { return poppler_index_iter_is_open(iter); }
+auto PopplerGlibPageBookmarkIterator::isOpen() -> bool {
+    std::lock_guard lock(PopplerGlibDocument::getPopplerMutex());
+    return poppler_index_iter_is_open(iter);
+}
 
 auto PopplerGlibPageBookmarkIterator::getChildIter() -> XojPdfBookmarkIterator* {
+    std::lock_guard lock(PopplerGlibDocument::getPopplerMutex());
     PopplerIndexIter* child = poppler_index_iter_get_child(iter);
     if (child == nullptr) {
         return nullptr;
@@ -36,6 +47,7 @@ auto PopplerGlibPageBookmarkIterator::getChildIter() -> XojPdfBookmarkIterator*
 }
 
 auto PopplerGlibPageBookmarkIterator::getAction() -> XojPdfAction* {
+    std::lock_guard lock(PopplerGlibDocument::getPopplerMutex());
     PopplerAction* action = poppler_index_iter_get_action(iter);
 
     if (action == nullptr) {
@@ -0,0 +1,84 @@
+#include "CompressedStrokePoints.h"
+
+#include <new>      // for bad_alloc
+#include <utility>  // for move
+
+#include <glib.h>  // for GString, g_string_free
+#include <zlib.h>  // for compress2, uncompress, compressBound
+
+#include "model/Element.h"                          // for Element, ELEMENT_STROKE
+#include "model/Point.h"                            // for Point
+#include "model/Stroke.h"                           // for Stroke
+#include "util/serializing/BinObjectEncoding.h"     // for BinObjectEncoding
+#include "util/serializing/InputStreamException.h"  // for InputStreamException
+#include "util/serializing/ObjectInputStream.h"     // for ObjectInputStream
+#include "util/serializing/ObjectOutputStream.h"    // for ObjectOutputStream
+
+CompressedStrokePoints::CompressedStrokePoints(std::vector<Stroke*> strokes): strokes(std::move(strokes)) {
+    ObjectOutputStream out(new BinObjectEncoding());
+    out.writeObject("StrokePoints");
+    out.writeSizeT(this->strokes.size());
+    for (const Stroke* s: this->strokes) {
+        out.writeData(s->getPointVector());
+    }
+    out.endObject();
+
+    GString* raw = out.stealData();
+    this->rawSize = raw->len;
+    uLongf len = compressBound(raw->len);
+    this->data.resize(len);
+    int res = compress2(reinterpret_cast<Bytef*>(this->data.data()), &len, reinterpret_cast<const Bytef*>(raw->str),
+                        raw->len, Z_BEST_SPEED);
+    g_string_free(raw, true);
+    if (res != Z_OK) {
+        throw std::bad_alloc();
+    }
+    this->data.resize(len);
+    this->data.shrink_to_fit();
+
+    for (Stroke* s: this->strokes) {
+        s->setPointVector(std::vector<Point>{});
+    }
+}
+
+void CompressedStrokePoints::restore() {
+    std::string raw(this->rawSize, '\0');
+    uLongf len = this->rawSize;
+    if (uncompress(reinterpret_cast<Bytef*>(raw.data()), &len, reinterpret_cast<const Bytef*>(this->data.data()),
+                   this->data.size()) != Z_OK ||
+        len != this->rawSize) {
+        throw InputStreamException("Could not uncompress the points of the strokes", __FILE__, __LINE__);
+    }
+
+    ObjectInputStream in;
+    if (!in.read(raw.data(), raw.size())) {
+        throw InputStreamException("Could not read the points of the strokes", __FILE__, __LINE__);
+    }
+    in.readObject("StrokePoints");
+    if (in.readSizeT() != this->strokes.size()) {
+        throw InputStreamException("Stroke count mismatch", __FILE__, __LINE__);
+    }
+
+    // Read everything before changing any stroke, so that a corrupted stream leaves them all empty
+    std::vector<std::vector<Point>> points(this->strokes.size());
+    for (auto& p: points) {
+        in.readData(p);
+    }
+    in.endObject();
+
+    for (size_t i = 0; i < this->strokes.size(); i++) {
+        this->strokes[i]->setPointVector(std::move(points[i]));
+    }
+    this->data.clear();
+    this->data.shrink_to_fit();
+}
+
+auto CompressedStrokePoints::getByteSize() const -> size_t { return sizeof(*this) + this->data.capacity(); }
+
+auto CompressedStrokePoints::estimateByteSize(const Element& e) -> size_t {
+    if (e.getType() == ELEMENT_STROKE) {
+        return sizeof(Stroke) + dynamic_cast<const Stroke&>(e).getPointCount() * sizeof(Point);
+    }
+    // The data of the images is loaded lazily: only count the object
+    return sizeof(Stroke);
+}
@@ -0,0 +1,56 @@
+/*
+ * Xournal++
+ *
+ * The compressed points of the strokes kept by an undo action
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <string>   // for string
+#include <vector>   // for vector
+
+class Element;
+class Stroke;
+
+/**
+ * @brief Cold storage for the points of strokes which are deep in the undo history
+ *
+ * The points are serialized with an ObjectOutputStream and compressed with zlib, then the strokes are emptied. The
+ * Stroke objects themselves are kept: other undo actions may still point to them.
+ */
+class CompressedStrokePoints {
+public:
+    /**
+     * Compresses the points of the strokes and removes them from the strokes
+     * @throws std::bad_alloc if the points could not be compressed. The strokes are then left untouched.
+     */
+    explicit CompressedStrokePoints(std::vector<Stroke*> strokes);
+
+    /**
+     * Gives the points back to the strokes
+     * @throws InputStreamException if the data is corrupted
+     */
+    void restore();
+
+    /**
+     * @return The memory used by the compressed data, in bytes
+     */
+    size_t getByteSize() const;
+
+    /**
+     * @return An estimate of the memory used by the element, in bytes. The lazily loaded data of the images is not
+     * counted.
+     */
+    static size_t estimateByteSize(const Element& e);
+
+private:
+    std::vector<Stroke*> strokes;
+    std::string data;
+    size_t rawSize = 0;
+};
@@ -1,16 +1,20 @@
 #include "DeleteUndoAction.h"
 
 #include <memory>  // for __shared_ptr_access, __shared_pt...
+#include <new>     // for bad_alloc
+#include <vector>  // for vector
 
 #include <glib.h>  // for g_warning
 
 #include "control/Control.h"
 #include "model/Document.h"
-#include "model/Element.h"           // for Element, ELEMENT_IMAGE, ELEMENT_...
-#include "model/Layer.h"             // for Layer
-#include "model/XojPage.h"           // for XojPage
-#include "undo/UndoAction.h"         // for UndoAction
-#include "util/i18n.h"               // for _
+#include "model/Element.h"                          // for Element, ELEMENT_IMAGE, ELEMENT_...
+#include "model/Layer.h"                            // for Layer
+#include "model/Stroke.h"                           // for Stroke
+#include "model/XojPage.h"                          // for XojPage
+#include "undo/UndoAction.h"                        // for UndoAction
+#include "util/i18n.h"                              // for _
+#include "util/serializing/InputStreamException.h"  // for InputStreamException
 
 
 DeleteUndoAction::DeleteUndoAction(const PageRef& page, bool eraser): UndoAction("DeleteUndoAction"), eraser(eraser) {
@@ -103,3 +107,53 @@ auto DeleteUndoAction::getText() -> std::string {
 
     return text;
 }
+
+auto DeleteUndoAction::getByteSize() const -> size_t {
+    size_t size = sizeof(*this);
+    for (const auto& elem: elements) {
+        if (elem.elementOwn) {
+            size += CompressedStrokePoints::estimateByteSize(*elem.elementOwn);
+        }
+    }
+    return this->compressed ? size + this->compressed->getByteSize() : size;
+}
+
+auto DeleteUndoAction::compress() -> bool {
+    if (this->compressed || this->undone) {
+        return false;
+    }
+
+    std::vector<Stroke*> strokes;
+    for (const auto& elem: elements) {
+        if (elem.elementOwn && elem.elementOwn->getType() == ELEMENT_STROKE) {
+            strokes.push_back(static_cast<Stroke*>(elem.elementOwn.get()));
+        }
+    }
+    if (strokes.empty()) {
+        return false;
+    }
+
+    try {
+        this->compressed = std::make_unique<CompressedStrokePoints>(std::move(strokes));
+    } catch (const std::bad_alloc&) {
+        return false;
+    }
+    return true;
+}
+
+auto DeleteUndoAction::decompress() -> bool {
+    if (!this->compressed) {
+        return true;
+    }
+
+    auto compressed = std::move(this->compressed);
+    try {
+        compressed->restore();
+    } catch (const InputStreamException& e) {
+        g_warning("Could not restore the deleted strokes: %s", e.what());
+        return false;
+    }
+    return true;
+}
+
+auto DeleteUndoAction::isCompressed() const -> bool { return this->compressed != nullptr; }
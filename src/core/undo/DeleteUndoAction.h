@@ -11,14 +11,17 @@
 
 #pragma once
 
-#include <set>     // for multiset
-#include <string>  // for string
+#include <cstddef>  // for size_t
+#include <memory>   // for unique_ptr
+#include <set>      // for multiset
+#include <string>   // for string
 
 #include "model/Element.h"  // for Element, Element::Index
 #include "model/PageRef.h"  // for PageRef
 
-#include "PageLayerPosEntry.h"  // for PageLayerPosEntry
-#include "UndoAction.h"         // for UndoAction
+#include "CompressedStrokePoints.h"  // for CompressedStrokePoints
+#include "PageLayerPosEntry.h"       // for PageLayerPosEntry
+#include "UndoAction.h"              // for UndoAction
 
 class Control;
 class Layer;
@@ -35,8 +38,16 @@ public:
 
     std::string getText() override;
 
+    size_t getByteSize() const override;
+    bool compress() override;
+    bool decompress() override;
+    bool isCompressed() const override;
+
 private:
     // Todo (performance): replace by flat_multi_set / sorted_vector
     std::multiset<PageLayerPosEntry<Element>> elements{};
     bool eraser = true;
+
+    /// The points of the deleted strokes, while the action is deep in the undo history
+    std::unique_ptr<CompressedStrokePoints> compressed;
 };
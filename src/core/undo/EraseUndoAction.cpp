@@ -1,16 +1,20 @@
 #include "EraseUndoAction.h"
 
 #include <memory>  // for __shared_ptr_access, __shar...
+#include <new>     // for bad_alloc
 #include <vector>  // for vector
 
+#include <glib.h>  // for g_warning
+
 #include "control/Control.h"
 #include "model/Document.h"
-#include "model/Layer.h"                  // for Layer
-#include "model/Stroke.h"                 // for Stroke
-#include "model/XojPage.h"                // for XojPage
-#include "model/eraser/ErasableStroke.h"  // for ErasableStroke
-#include "undo/UndoAction.h"              // for UndoAction
-#include "util/i18n.h"                    // for _
+#include "model/Layer.h"                            // for Layer
+#include "model/Stroke.h"                           // for Stroke
+#include "model/XojPage.h"                          // for XojPage
+#include "model/eraser/ErasableStroke.h"            // for ErasableStroke
+#include "undo/UndoAction.h"                        // for UndoAction
+#include "util/i18n.h"                              // for _
+#include "util/serializing/InputStreamException.h"  // for InputStreamException
 
 
 EraseUndoAction::EraseUndoAction(const PageRef& page): UndoAction("EraseUndoAction") { this->page = page; }
@@ -104,3 +108,54 @@ auto EraseUndoAction::redo(Control* control) -> bool {
     this->undone = false;
     return true;
 }
+
+auto EraseUndoAction::getByteSize() const -> size_t {
+    size_t size = sizeof(*this);
+    for (const auto& entry: original) {
+        if (entry.elementOwn) {
+            size += CompressedStrokePoints::estimateByteSize(*entry.elementOwn);
+        }
+    }
+    return this->compressed ? size + this->compressed->getByteSize() : size;
+}
+
+auto EraseUndoAction::compress() -> bool {
+    // The edited strokes are in the document: only the original ones can be compressed
+    if (this->compressed || this->undone) {
+        return false;
+    }
+
+    std::vector<Stroke*> strokes;
+    for (const auto& entry: original) {
+        if (entry.elementOwn) {
+            strokes.push_back(entry.element);
+        }
+    }
+    if (strokes.empty()) {
+        return false;
+    }
+
+    try {
+        this->compressed = std::make_unique<CompressedStrokePoints>(std::move(strokes));
+    } catch (const std::bad_alloc&) {
+        return false;
+    }
+    return true;
+}
+
+auto EraseUndoAction::decompress() -> bool {
+    if (!this->compressed) {
+        return true;
+    }
+
+    auto compressed = std::move(this->compressed);
+    try {
+        compressed->restore();
+    } catch (const InputStreamException& e) {
+        g_warning("Could not restore the erased strokes: %s", e.what());
+        return false;
+    }
+    return true;
+}
+
+auto EraseUndoAction::isCompressed() const -> bool { return this->compressed != nullptr; }
@@ -11,14 +11,17 @@
 
 #pragma once
 
-#include <set>     // for multiset
-#include <string>  // for string
+#include <cstddef>  // for size_t
+#include <memory>   // for unique_ptr
+#include <set>      // for multiset
+#include <string>   // for string
 
 #include "model/PageRef.h"  // for PageRef
 #include "model/Stroke.h"   // for Stroke
 
-#include "PageLayerPosEntry.h"  // for PageLayerPosEntry
-#include "UndoAction.h"         // for UndoAction
+#include "CompressedStrokePoints.h"  // for CompressedStrokePoints
+#include "PageLayerPosEntry.h"       // for PageLayerPosEntry
+#include "UndoAction.h"              // for UndoAction
 
 class Control;
 class Layer;
@@ -39,7 +42,15 @@ public:
 
     std::string getText() override;
 
+    size_t getByteSize() const override;
+    bool compress() override;
+    bool decompress() override;
+    bool isCompressed() const override;
+
 private:
     std::multiset<PageLayerPosEntry<Stroke>> edited{};
     std::multiset<PageLayerPosEntry<Stroke>> original{};
+
+    /// The points of the original strokes, while the action is deep in the undo history
+    std::unique_ptr<CompressedStrokePoints> compressed;
 };
@@ -89,12 +89,12 @@ void MergeLayerDownUndoAction::triggerUIUpdate(Control* control) {
     /*
      * NOTE: (call order relevant to avoid deadlock)
      *     When this implementation is called by the `UndoRedoHandler` the
-     *     document is locked. Calling `layerChanged` adds a render job which
-     *     can only be processed when the document is unlocked again, but might
-     *     have already claimed `Scheduler::jobRunningMutex`.
-     *     `fireRebuildLayerMenu` will wait for `jobRunningMutex` to be free,
-     *     so calling `fireRebuildLayerMenu` AFTER `layerChanged` will likely
-     *     result in a DEADLOCK.
+     *     document is locked. Calling `layerChanged` adds render and preview
+     *     jobs which can only be processed when the document is unlocked
+     *     again, but might already have been started by a scheduler worker.
+     *     `fireRebuildLayerMenu` will wait for the running jobs of the removed
+     *     previews to finish, so calling `fireRebuildLayerMenu` AFTER
+     *     `layerChanged` will likely result in a DEADLOCK.
      */
 
     /*
@@ -11,3 +11,11 @@ auto UndoAction::getPages() -> std::vector<PageRef> {
 }
 
 auto UndoAction::getClassName() const -> std::string const& { return this->className; }
+
+auto UndoAction::getByteSize() const -> size_t { return sizeof(UndoAction); }
+
+auto UndoAction::compress() -> bool { return false; }
+
+auto UndoAction::decompress() -> bool { return true; }
+
+auto UndoAction::isCompressed() const -> bool { return false; }
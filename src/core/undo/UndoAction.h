@@ -11,9 +11,10 @@
 
 #pragma once
 
-#include <memory>  // for unique_ptr
-#include <string>  // for string
-#include <vector>  // for vector
+#include <cstddef>  // for size_t
+#include <memory>   // for unique_ptr
+#include <string>   // for string
+#include <vector>   // for vector
 
 #include "model/PageRef.h"  // for PageRef
 
@@ -35,6 +36,26 @@ public:
      */
     virtual std::vector<PageRef> getPages();
 
+    /**
+     * @return An estimate of the memory used by the action, in bytes
+     */
+    virtual size_t getByteSize() const;
+
+    /**
+     * Compresses what the action keeps of the document (e.g. the deleted elements), while it is deep in the undo
+     * history. Only called on actions which are done, not undone.
+     * @return If the action has been compressed
+     */
+    virtual bool compress();
+
+    /**
+     * Restores what compress() compressed, before the action is undone
+     * @return false if the compressed data could not be restored
+     */
+    virtual bool decompress();
+
+    virtual bool isCompressed() const;
+
     auto getClassName() const -> std::string const&;
 
 protected:
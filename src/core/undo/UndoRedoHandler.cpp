@@ -1,13 +1,13 @@
 #include "UndoRedoHandler.h"
 
-#include <algorithm>  // for find_if
+#include <algorithm>  // for find, find_if, min
 #include <cinttypes>  // for PRIu64
 #include <cstdint>    // for uint64_t
-#include <iterator>   // for end, begin
+#include <iterator>   // for end, begin, next
 #include <memory>     // for unique_ptr, allocator_traits<>::value_type
 #include <utility>    // for move
 
-#include <glib.h>  // for g_message
+#include <glib.h>  // for g_message, g_debug, g_format_size
 
 #include "control/Control.h"  // for Control
 #include "model/Document.h"   // for Document
@@ -64,6 +64,9 @@ void UndoRedoHandler::printContents() {
         {                                  // NOLINT
             printAction(this->savedUndo);  // NOLINT
         }                                  // NOLINT
+        auto usage = getMemoryUsage();     // NOLINT
+        g_message("memory: %zu bytes, %zu compressed bytes in %zu actions", usage.total, usage.compressed,  // NOLINT
+                  usage.compressedActions);                                                                 // NOLINT
     }
 }
 
@@ -80,9 +83,13 @@ void UndoRedoHandler::clearContents() {
 
     undoList.clear();
     clearRedo();
+    this->countedSizes.clear();
+    this->undoUsage = MemoryUsage();
+    this->compressionEnd = 0;
 
     this->savedUndo = nullptr;
     this->autosavedUndo = nullptr;
+    this->unknownChangesSinceAutosave = true;
 
     printContents();
 }
@@ -93,6 +100,10 @@ void UndoRedoHandler::clearRedo() {
         g_message("clearRedo()::Delete UndoAction: %p / %s", undoAction.get(), undoAction->getClassName().c_str());
     }
 #endif
+    for (const auto& action: this->redoList) {
+        this->countedSizes.erase(action.get());
+    }
+    this->redoUsage = MemoryUsage();
     redoList.clear();
     printContents();
 }
@@ -107,8 +118,13 @@ void UndoRedoHandler::undo() {
     auto& undoAction = *this->undoList.back();
     this->redoList.emplace_back(std::move(this->undoList.back()));
     this->undoList.pop_back();
+    if (!this->undoList.empty()) {
+        uncountAction(this->undoList.back().get(), this->undoUsage);
+    }
+    this->compressionEnd = std::min(this->compressionEnd, this->undoList.size());
 
-    bool undoResult = undoAction.undo(this->control);
+    bool undoResult = undoAction.decompress() && undoAction.undo(this->control);
+    countAction(&undoAction, this->redoUsage);
 
     if (!undoResult) {
         string msg = FS(_F("Could not undo \"{1}\"\n"
@@ -117,7 +133,9 @@ void UndoRedoHandler::undo() {
         XojMsgBox::showErrorToUser(control->getGtkWindow(), msg);
     }
 
-    fireUpdateUndoRedoButtons(undoAction.getPages());
+    auto pages = undoAction.getPages();
+    rememberChangedPages(pages);
+    fireUpdateUndoRedoButtons(pages);
 
     printContents();
 }
@@ -130,6 +148,10 @@ void UndoRedoHandler::redo() {
     xoj_assert(this->redoList.back());
 
     UndoAction& redoAction = *this->redoList.back();
+    uncountAction(&redoAction, this->redoUsage);
+    if (!this->undoList.empty()) {
+        countAction(this->undoList.back().get(), this->undoUsage);
+    }
 
     this->undoList.emplace_back(std::move(this->redoList.back()));
     this->redoList.pop_back();
@@ -143,7 +165,9 @@ void UndoRedoHandler::redo() {
         XojMsgBox::showErrorToUser(control->getGtkWindow(), msg);
     }
 
-    fireUpdateUndoRedoButtons(redoAction.getPages());
+    auto pages = redoAction.getPages();
+    rememberChangedPages(pages);
+    fireUpdateUndoRedoButtons(pages);
 
     printContents();
 }
@@ -160,13 +184,99 @@ void UndoRedoHandler::addUndoAction(UndoActionPtr action) {
         return;
     }
 
+    if (!this->undoList.empty()) {
+        countAction(this->undoList.back().get(), this->undoUsage);
+    }
     this->undoList.emplace_back(std::move(action));
     clearRedo();
-    fireUpdateUndoRedoButtons(this->undoList.back()->getPages());
+    enforceMemoryLimit();
+    auto pages = this->undoList.back()->getPages();
+    rememberChangedPages(pages);
+    fireUpdateUndoRedoButtons(pages);
 
     printContents();
 }
 
+void UndoRedoHandler::setMemoryLimit(size_t bytes) { this->memoryLimit = bytes; }
+
+void UndoRedoHandler::enforceMemoryLimit() {
+    if (this->memoryLimit == 0) {
+        return;
+    }
+
+    size_t compressedCount = 0;
+    // The last action is not counted, and never compressed
+    while (this->undoUsage.total - this->undoUsage.compressed > this->memoryLimit &&
+           this->compressionEnd + 1 < this->undoList.size()) {
+        UndoAction* action = this->undoList[this->compressionEnd++].get();
+        if (action->isCompressed()) {
+            continue;
+        }
+        uncountAction(action, this->undoUsage);
+        if (action->compress()) {
+            compressedCount++;
+        }
+        countAction(action, this->undoUsage);
+    }
+
+    if (compressedCount > 0) {
+        g_debug("%zu undo actions compressed, %s", compressedCount, getMemoryUsageDescription().c_str());
+    }
+}
+
+void UndoRedoHandler::countAction(const UndoAction* action, MemoryUsage& usage) {
+    CountedSize counted{action->getByteSize(), action->isCompressed()};
+    this->countedSizes[action] = counted;
+    usage.total += counted.size;
+    if (counted.compressed) {
+        usage.compressed += counted.size;
+        usage.compressedActions++;
+    }
+}
+
+void UndoRedoHandler::uncountAction(const UndoAction* action, MemoryUsage& usage) {
+    auto it = this->countedSizes.find(action);
+    if (it == this->countedSizes.end()) {
+        return;
+    }
+    usage.total -= it->second.size;
+    if (it->second.compressed) {
+        usage.compressed -= it->second.size;
+        usage.compressedActions--;
+    }
+    this->countedSizes.erase(it);
+}
+
+auto UndoRedoHandler::getMemoryUsage() const -> MemoryUsage {
+    MemoryUsage usage;
+    for (const MemoryUsage* counted: {&this->undoUsage, &this->redoUsage}) {
+        usage.total += counted->total;
+        usage.compressed += counted->compressed;
+        usage.compressedActions += counted->compressedActions;
+    }
+    if (!this->undoList.empty()) {
+        const UndoAction& last = *this->undoList.back();
+        size_t size = last.getByteSize();
+        usage.total += size;
+        if (last.isCompressed()) {
+            usage.compressed += size;
+            usage.compressedActions++;
+        }
+    }
+    return usage;
+}
+
+auto UndoRedoHandler::getMemoryUsageDescription() const -> string {
+    auto usage = getMemoryUsage();
+    gchar* total = g_format_size(usage.total);
+    gchar* compressed = g_format_size(usage.compressed);
+    string description = FS(_F("Undo history: {1} ({2} compressed in {3} steps)") % total % compressed %
+                            usage.compressedActions);
+    g_free(total);
+    g_free(compressed);
+    return description;
+}
+
 auto UndoRedoHandler::undoDescription() -> string {
     if (!this->undoList.empty()) {
         UndoAction& a = *this->undoList.back();
@@ -203,6 +313,20 @@ void UndoRedoHandler::fireUpdateUndoRedoButtons(const std::vector<PageRef>& page
     }
 }
 
+void UndoRedoHandler::rememberChangedPages(const std::vector<PageRef>& pages) {
+    // Actions not bound to a page change the document itself (PDF background, layer names, ...)
+    if (pages.empty() || std::find(pages.begin(), pages.end(), nullptr) != pages.end()) {
+        this->unknownChangesSinceAutosave = true;
+        return;
+    }
+    for (const PageRef& page: pages) {
+        if (std::find(this->pagesChangedSinceAutosave.begin(), this->pagesChangedSinceAutosave.end(), page) ==
+            this->pagesChangedSinceAutosave.end()) {
+            this->pagesChangedSinceAutosave.push_back(page);
+        }
+    }
+}
+
 void UndoRedoHandler::addUndoRedoListener(UndoRedoListener* listener) { this->listener.emplace_back(listener); }
 
 auto UndoRedoHandler::isChanged() -> bool {
@@ -222,6 +346,15 @@ auto UndoRedoHandler::isChangedAutosave() -> bool {
 
 void UndoRedoHandler::documentAutosaved() {
     this->autosavedUndo = this->undoList.empty() ? nullptr : this->undoList.back().get();
+    this->pagesChangedSinceAutosave.clear();
+    this->unknownChangesSinceAutosave = false;
+}
+
+auto UndoRedoHandler::getPagesChangedSinceAutosave() const -> std::optional<std::vector<PageRef>> {
+    if (this->unknownChangesSinceAutosave) {
+        return std::nullopt;
+    }
+    return this->pagesChangedSinceAutosave;
 }
 
 void UndoRedoHandler::documentSaved() {
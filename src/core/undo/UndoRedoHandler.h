@@ -11,9 +11,12 @@
 
 #pragma once
 
-#include <deque>   // for deque
-#include <string>  // for string
-#include <vector>  // for vector
+#include <cstddef>        // for size_t
+#include <deque>          // for deque
+#include <optional>       // for optional
+#include <string>         // for string
+#include <unordered_map>  // for unordered_map
+#include <vector>         // for vector
 
 #include "model/PageRef.h"  // for PageRef
 
@@ -53,11 +56,54 @@ public:
     bool isChanged();
     bool isChangedAutosave();
     void documentAutosaved();
+
+    /**
+     * @return The pages changed by the actions done, undone or redone since the last autosave, or std::nullopt if
+     * some of these actions changed more than the contents of their pages
+     */
+    std::optional<std::vector<PageRef>> getPagesChangedSinceAutosave() const;
     void documentSaved();
 
+    struct MemoryUsage {
+        /// The memory used by the actions as they are, in bytes
+        size_t total = 0;
+        /// The part of total used by the compressed actions
+        size_t compressed = 0;
+        size_t compressedActions = 0;
+    };
+
+    /**
+     * @return An estimate of the memory used by the undo and redo history. Does not walk the history.
+     */
+    MemoryUsage getMemoryUsage() const;
+
+    /**
+     * @return The memory used by the undo and redo history, as shown to the user
+     */
+    std::string getMemoryUsageDescription() const;
+
+    /**
+     * @param bytes The memory the undo history may use before its older actions are compressed, 0 for no limit
+     */
+    void setMemoryLimit(size_t bytes);
+
 private:
     void clearRedo();
     void printContents();
+    void rememberChangedPages(const std::vector<PageRef>& pages);
+
+    /**
+     * Compresses the older undo actions, oldest first, so that the uncompressed ones fit in the limit set by
+     * setMemoryLimit(). The last action is never compressed.
+     */
+    void enforceMemoryLimit();
+
+    /**
+     * Adds the size of an action to the running totals. The last undo action is not counted: it may still grow, e.g.
+     * while erasing. An action is only counted while its size does not change, so compress, undo or redo it uncounted.
+     */
+    void countAction(const UndoAction* action, MemoryUsage& usage);
+    void uncountAction(const UndoAction* action, MemoryUsage& usage);
 
 private:
     std::deque<UndoActionPtr> undoList;
@@ -66,7 +112,32 @@ private:
     UndoAction* savedUndo = nullptr;
     UndoAction* autosavedUndo = nullptr;
 
+    /**
+     * See getPagesChangedSinceAutosave()
+     */
+    std::vector<PageRef> pagesChangedSinceAutosave;
+    bool unknownChangesSinceAutosave = true;
+
     std::vector<UndoRedoListener*> listener;
 
+    struct CountedSize {
+        size_t size;
+        bool compressed;
+    };
+
+    /**
+     * The sizes of the counted actions, see countAction()
+     */
+    std::unordered_map<const UndoAction*, CountedSize> countedSizes;
+    MemoryUsage undoUsage;
+    MemoryUsage redoUsage;
+
+    /**
+     * The undo actions before this index have been compressed, or could not be
+     */
+    size_t compressionEnd = 0;
+
+    size_t memoryLimit = 0;
+
     Control* control = nullptr;
 };
@@ -19,7 +19,12 @@
  */
 void DocumentView::setMarkAudioStroke(bool markAudioStroke) { this->markAudioStroke = markAudioStroke; }
 
-void DocumentView::setPdfCache(PdfCache* cache) { pdfCache = cache; }
+void DocumentView::setCacheContours(bool cacheContours) { this->cacheContours = cacheContours; }
+
+void DocumentView::setPdfCache(PdfCache* cache, xoj::view::PdfCacheTreatment treatment) {
+    pdfCache = cache;
+    pdfCacheTreatment = treatment;
+}
 
 /**
  * Drawing first step
@@ -62,7 +67,7 @@ void DocumentView::finializeDrawing() {
  * Draw the background
  */
 void DocumentView::drawBackground(xoj::view::BackgroundFlags bgFlags) const {
-    auto bgView = xoj::view::BackgroundView::createForPage(page, bgFlags, pdfCache);
+    auto bgView = xoj::view::BackgroundView::createForPage(page, bgFlags, pdfCache, pdfCacheTreatment);
     bgView->draw(cr);
 }
 
@@ -73,7 +78,8 @@ void DocumentView::drawPage(ConstPageRef page, cairo_t* cr, bool dontRenderEditi
     drawBackground(flags);
 
     xoj::view::Context context{cr, (xoj::view::NonAudioTreatment)this->markAudioStroke,
-                               (xoj::view::EditionTreatment) !this->dontRenderEditingStroke, xoj::view::NORMAL_COLOR};
+                               (xoj::view::EditionTreatment) !this->dontRenderEditingStroke, xoj::view::NORMAL_COLOR,
+                               (xoj::view::ContourTreatment)this->cacheContours};
     for (const Layer* layer: page->getLayersView()) {
         if (layer->isVisible()) {
             xoj::view::LayerView layerView(layer);
@@ -105,7 +111,8 @@ void DocumentView::drawLayersOfPage(const LayerRangeVector& layerRange, ConstPag
     }
 
     xoj::view::Context context{cr, (xoj::view::NonAudioTreatment)this->markAudioStroke,
-                               (xoj::view::EditionTreatment) !this->dontRenderEditingStroke, xoj::view::NORMAL_COLOR};
+                               (xoj::view::EditionTreatment) !this->dontRenderEditingStroke, xoj::view::NORMAL_COLOR,
+                               (xoj::view::ContourTreatment)this->cacheContours};
     for (auto&& [_, l]: visibleLayers) {
         xoj::view::LayerView layerView(l);
         layerView.draw(context);
@@ -56,9 +56,19 @@ public:
      */
     void setMarkAudioStroke(bool markAudioStroke);
 
+    /**
+     * Keep the contours of the pressure strokes in the strokes, to draw them faster next time. Only for the views of
+     * the visible pages: the contours are dropped when their page leaves the view (see XojPageView::setIsVisible()).
+     */
+    void setCacheContours(bool cacheContours);
+
     // API for special drawing, usually you won't call this methods
 public:
-    void setPdfCache(PdfCache* cache);
+    /**
+     * @param treatment REUSE_CACHED_PDF_ONLY for the drawings which must not evict the renderings of the main view
+     * from the cache, e.g. the sidebar previews
+     */
+    void setPdfCache(PdfCache* cache, xoj::view::PdfCacheTreatment treatment = xoj::view::CACHE_PDF_RENDERING);
 
     /**
      * Drawing first step
@@ -87,7 +97,9 @@ private:
     cairo_t* cr = nullptr;
     ConstPageRef page = nullptr;
     PdfCache* pdfCache = nullptr;
+    xoj::view::PdfCacheTreatment pdfCacheTreatment = xoj::view::CACHE_PDF_RENDERING;
     bool dontRenderEditingStroke = false;
     bool markAudioStroke = false;
+    bool cacheContours = false;
 
 };
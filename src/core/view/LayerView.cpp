@@ -1,12 +1,14 @@
 #include "LayerView.h"
 
 #include <memory>  // for unique_ptr
+#include <vector>  // for vector
 
 #include <cairo.h>  // for cairo_clip_extents, cairo_rectangle
 #include <glib.h>   // for g_message
 
-#include "model/Element.h"  // for Element
-#include "model/Layer.h"    // for Layer
+#include "model/Element.h"   // for Element
+#include "model/Layer.h"     // for Layer
+#include "util/Rectangle.h"  // for Rectangle
 
 #include "DebugShowRepaintBounds.h"  // for IF_DEBUG_REPAINT
 #include "View.h"                    // for Context, ElementView
@@ -27,7 +29,8 @@ void LayerView::draw(const Context& ctx) const {
     double maxY;
     cairo_clip_extents(ctx.cr, &minX, &minY, &maxX, &maxY);
 
-    for (auto const& e: layer->getElementsView()) {
+    // Only visit the elements close to the mask, using the spatial index of the layer
+    for (auto const* e: layer->getElementsInArea(xoj::util::Rectangle<double>(minX, minY, maxX - minX, maxY - minY))) {
 
         IF_DEBUG_REPAINT({
             auto cr = ctx.cr;
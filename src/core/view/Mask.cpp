@@ -1,11 +1,13 @@
 #include "Mask.h"
 
+#include <cmath>  // for ceil
 #include <iostream>
 
 #include <cairo.h>
 
 #include "util/Assert.h"
 #include "util/Range.h"
+#include "util/Recolor.h"
 #include "util/safe_casts.h"  // for ceil_cast, floor_cast
 
 #include "config-debug.h"
@@ -75,6 +77,12 @@ void Mask::constructorImpl(DPIInfoType dpiInfo, const Range& extent, double zoom
      */
     cairo_surface_t* surf = SurfaceCreator<DPIInfoType>::create(dpiInfo, contentType, width, height);
 
+    double scaleX = 1.0;
+    double scaleY = 1.0;
+    cairo_surface_get_device_scale(surf, &scaleX, &scaleY);
+    this->byteSize = static_cast<size_t>(std::ceil(width * scaleX)) * static_cast<size_t>(std::ceil(height * scaleY)) *
+                     (contentType == CAIRO_CONTENT_ALPHA ? 1U : 4U);
+
     IF_DBG_MASKS({
         std::cout << "Creating mask of type: " << getSurfaceTypeName(surf) << std::endl;
         std::cout << "  Its size: " << width << " x " << height << " (in device space)" << std::endl;
@@ -145,7 +153,43 @@ void Mask::wipeRange(const Range& rg) {
     wipe();
 }
 
-void Mask::reset() { cr.reset(); }
+void Mask::reset() {
+    cr.reset();
+    byteSize = 0;
+}
+
+auto Mask::createRecolored(const Recolor& recolor) const -> Mask {
+    xoj_assert(isInitialized());
+    cairo_surface_t* source = cairo_get_target(const_cast<cairo_t*>(cr.get()));
+    xoj_assert(cairo_surface_get_type(source) == CAIRO_SURFACE_TYPE_IMAGE);
+
+    double scaleX = 1.0;
+    double scaleY = 1.0;
+    cairo_surface_get_device_scale(source, &scaleX, &scaleY);
+    cairo_surface_t* surf = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, cairo_image_surface_get_width(source),
+                                                       cairo_image_surface_get_height(source));
+    cairo_surface_set_device_scale(surf, scaleX, scaleY);
+
+    Mask res;
+    res.xOffset = xOffset;
+    res.yOffset = yOffset;
+    res.zoom = zoom;
+    res.byteSize = byteSize;
+    res.cr.reset(cairo_create(surf), xoj::util::adopt);
+    cairo_surface_destroy(surf);  // surf is now owned by res.cr
+
+    {
+        xoj::util::CairoSaveGuard saveGuard(res.cr.get());  // Restoring releases the source
+        cairo_set_operator(res.cr.get(), CAIRO_OPERATOR_SOURCE);
+        cairo_set_source_surface(res.cr.get(), source, 0, 0);
+        cairo_paint(res.cr.get());
+    }
+    recolor.recolorImageSurface(surf);
+
+    cairo_translate(res.cr.get(), -xOffset, -yOffset);
+    cairo_scale(res.cr.get(), zoom, zoom);
+    return res;
+}
 
 #ifdef DEBUG_MASKS
 namespace {
@@ -11,12 +11,15 @@
 
 #pragma once
 
+#include <cstddef>  // for size_t
+
 #include <cairo.h>
 #include <gdk/gdk.h>
 
 #include "util/raii/CairoWrappers.h"
 
 class Range;
+class Recolor;
 
 namespace xoj::view {
 
@@ -77,8 +80,19 @@ public:
      */
     void reset();
 
+    /**
+     * @brief Create a recolored copy of the mask, see Recolor::recolorImageSurface()
+     * Only for masks created with a DPI scaling and the CAIRO_CONTENT_COLOR_ALPHA content type.
+     */
+    Mask createRecolored(const Recolor& recolor) const;
+
     inline double getZoom() const { return zoom; }
 
+    /**
+     * @return The memory used by the pixels of the surface, in bytes
+     */
+    inline size_t getByteSize() const { return byteSize; }
+
 private:
     template <typename DPIInfoType>
     void constructorImpl(DPIInfoType dpiInfo, const Range& extent, double zoom, cairo_content_t contentType);
@@ -87,5 +101,6 @@ private:
     int xOffset = 0;
     int yOffset = 0;
     double zoom = 1.0;
+    size_t byteSize = 0;
 };
 };  // namespace xoj::view
@@ -34,7 +34,14 @@ void StrokeView::draw(const Context& ctx) const {
     const bool highlighter = s->getToolType() == StrokeTool::HIGHLIGHTER;
     const bool filledHighlighter = highlighter && s->getFill() != -1;
     const bool drawTranslucent = ctx.fadeOutNonAudio && s->getAudioFilename().empty();
-    const bool useMask = (!ctx.noColor && filledHighlighter) || drawTranslucent;
+    /**
+     * A pressure stroke without filling is drawn by filling its contour once (except on PDF surfaces, see
+     * StrokeViewHelper::drawWithPressure): no pixel is painted twice, so it can be made translucent without a mask
+     */
+    const bool singleFill = !ctx.noColor && s->hasPressure() && !highlighter && s->getFill() == -1 &&
+                            !(ctx.showCurrentEdition && s->getErasable() != nullptr) &&
+                            cairo_surface_get_type(cairo_get_target(ctx.cr)) != CAIRO_SURFACE_TYPE_PDF;
+    const bool useMask = (!ctx.noColor && filledHighlighter) || (drawTranslucent && !singleFill);
 
     if (ctx.showCurrentEdition && filledHighlighter && s->getErasable() != nullptr) {
         // Currently being erased filled highlighter strokes need a special treatment
@@ -120,6 +127,12 @@ void StrokeView::draw(const Context& ctx) const {
          */
         Util::cairo_set_source_rgbi(cr, s->getColor(), OPACITY_HIGHLIGHTER);
         cairo_set_operator(cr, CAIRO_OPERATOR_MULTIPLY);
+    } else if (drawTranslucent) {
+        /**
+         * Translucent pen, filled at once (see singleFill)
+         */
+        Util::cairo_set_source_rgbi(cr, s->getColor(), std::max(MINIMAL_ALPHA, OPACITY_NO_AUDIO));
+        cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
     } else {
         /**
          * Normal pen
@@ -133,7 +146,7 @@ void StrokeView::draw(const Context& ctx) const {
         ErasableStrokeView erasableStrokeView(*erasable);
         erasableStrokeView.draw(cr);
     } else if (s->hasPressure() && !highlighter) {
-        StrokeViewHelper::drawWithPressure(cr, s->getPointVector(), s->getLineStyle());
+        StrokeViewHelper::drawWithPressure(cr, *s, ctx.cacheContours);
     } else {
         StrokeViewHelper::drawNoPressure(cr, s->getPointVector(), s->getWidth(), s->getLineStyle());
     }
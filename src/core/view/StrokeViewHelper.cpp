@@ -2,6 +2,7 @@
 
 #include "model/LineStyle.h"
 #include "model/Point.h"
+#include "model/Stroke.h"
 #include "model/StrokeContour.h"
 #include "util/Assert.h"
 #include "util/LoopUtil.h"
@@ -68,3 +69,17 @@ double xoj::view::StrokeViewHelper::drawWithPressure(cairo_t* cr, const std::vec
     }
     return dashOffset;
 }
+
+void xoj::view::StrokeViewHelper::drawWithPressure(cairo_t* cr, const Stroke& s, bool cacheContour) {
+    if (cairo_surface_get_type(cairo_get_target(cr)) == CAIRO_SURFACE_TYPE_PDF) {
+        drawWithPressure(cr, s.getPointVector(), s.getLineStyle());
+        return;
+    }
+    auto contour = cacheContour ? s.getContour() : s.getCachedContour();
+    if (!contour) {
+        drawWithPressure(cr, s.getPointVector(), s.getLineStyle());
+        return;
+    }
+    contour->addToCairo(cr);
+    cairo_fill(cr);
+}
@@ -17,6 +17,7 @@
 
 class LineStyle;
 class Point;
+class Stroke;
 
 namespace xoj::view::StrokeViewHelper {
 
@@ -37,4 +38,11 @@ void drawNoPressure(cairo_t* cr, const std::vector<Point>& pts, const double str
  *      Effectively, the return value equals dashOffset + length of the path.
  */
 double drawWithPressure(cairo_t* cr, const std::vector<Point>& pts, const LineStyle& lineStyle, double dashOffset = 0);
+
+/**
+ * @brief Draw a whole stroke with pressure, by filling its contour cached in the stroke (see Stroke::getContour()).
+ * PDF surfaces get one line per segment instead, as in drawWithPressure() above.
+ * @param cacheContour If false, a contour which is not cached yet is computed for this call only
+ */
+void drawWithPressure(cairo_t* cr, const Stroke& s, bool cacheContour = true);
 };  // namespace xoj::view::StrokeViewHelper
@@ -1,13 +1,15 @@
 #include "TexImageView.h"
 
+#include <mutex>   // for lock_guard
 #include <string>  // for string
 
-#include <cairo.h>             // for cairo_paint_with_alpha, cairo_scale
-#include <glib.h>              // for g_warning
-#include <poppler.h>           // for PopplerPage, PopplerDocument, g_clear_...
+#include <cairo.h>    // for cairo_paint_with_alpha, cairo_scale
+#include <glib.h>     // for g_warning
+#include <poppler.h>  // for PopplerPage, PopplerDocument, g_clear_...
 
-#include "model/TexImage.h"  // for TexImage
-#include "view/View.h"       // for Context, OPACITY_NO_AUDIO, view
+#include "model/TexImage.h"                      // for TexImage
+#include "pdf/popplerapi/PopplerGlibDocument.h"  // for PopplerGlibDocument
+#include "view/View.h"                           // for Context, OPACITY_NO_AUDIO, view
 
 using namespace xoj::view;
 
@@ -24,6 +26,7 @@ void TexImageView::draw(const Context& ctx) const {
     cairo_surface_t* img = texImage->getImage();
 
     if (pdf != nullptr) {
+        std::lock_guard lock(PopplerGlibDocument::getPopplerMutex());
         if (poppler_document_get_n_pages(pdf) < 1) {
             g_warning("Got latex PDF without pages!: %s", texImage->getText().c_str());
             return;
@@ -3,11 +3,11 @@
 #include <algorithm>  // for max
 #include <cstddef>    // for size_t
 
+#include <pango/pangocairo.h>  // for pango_cairo_show_layout
+
 #include "model/Text.h"           // for Text
 #include "util/Color.h"           // for cairo_set_source_rgbi
-#include "util/StringUtils.h"     // for StringUtils
 #include "util/raii/CairoWrappers.h"
-#include "util/raii/GObjectSPtr.h"
 #include "view/View.h"            // for Context, OPACITY_NO_AUDIO, view
 
 #include "filesystem.h"  // for path
@@ -18,14 +18,6 @@ TextView::TextView(const Text* text): text(text) {}
 
 TextView::~TextView() = default;
 
-auto TextView::initPango(cairo_t* cr, const Text* t) -> xoj::util::GObjectSPtr<PangoLayout> {
-    auto layout = t->createPangoLayout();
-    pango_cairo_update_layout(cr, layout.get());
-    pango_context_set_matrix(pango_layout_get_context(layout.get()), nullptr);
-
-    return layout;
-}
-
 void TextView::draw(const Context& ctx) const {
     if (text->isInEditing()) {
         // The drawing is handled by gui/TextEditor
@@ -45,9 +37,5 @@ void TextView::draw(const Context& ctx) const {
 
     cairo_translate(ctx.cr, text->getX(), text->getY());
 
-    auto layout = initPango(ctx.cr, text);
-    const std::string& content = text->getText();
-    pango_layout_set_text(layout.get(), content.c_str(), static_cast<int>(content.length()));
-
-    pango_cairo_show_layout(ctx.cr, layout.get());
+    text->withPangoLayout(ctx.cr, [cr = ctx.cr](PangoLayout* layout) { pango_cairo_show_layout(cr, layout); });
 }
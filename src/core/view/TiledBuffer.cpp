@@ -0,0 +1,216 @@
+#include "TiledBuffer.h"
+
+#include <algorithm>  // for max, find_if, rotate, remove_if
+#include <iterator>   // for next
+
+#include "util/safe_casts.h"  // for floor_cast, ceil_cast
+
+using namespace xoj::view;
+
+static bool intersects(const Range& a, const Range& b) { return !a.intersect(b).empty(); }
+
+auto TiledBuffer::getTilesIn(const Range& rg, double zoom) -> std::vector<TileIndex> {
+    if (rg.empty() || !rg.isValid()) {
+        return {};
+    }
+    const double scale = zoom / TILE_SIZE;
+    const int x0 = std::max(0, floor_cast<int>(rg.minX * scale));
+    const int y0 = std::max(0, floor_cast<int>(rg.minY * scale));
+    const int x1 = std::max(x0, ceil_cast<int>(rg.maxX * scale) - 1);
+    const int y1 = std::max(y0, ceil_cast<int>(rg.maxY * scale) - 1);
+
+    std::vector<TileIndex> tiles;
+    tiles.reserve(static_cast<size_t>(x1 - x0 + 1) * static_cast<size_t>(y1 - y0 + 1));
+    for (int y = y0; y <= y1; y++) {
+        for (int x = x0; x <= x1; x++) {
+            tiles.push_back({x, y});
+        }
+    }
+    return tiles;
+}
+
+auto TiledBuffer::getTileExtent(TileIndex index, double zoom) -> Range {
+    const double size = TILE_SIZE / zoom;
+    return Range(index.x * size, index.y * size, (index.x + 1) * size, (index.y + 1) * size);
+}
+
+auto TiledBuffer::isInitialized() const -> bool {
+    return std::any_of(levels.begin(), levels.end(), [](const Level& l) { return !l.tiles.empty(); });
+}
+
+auto TiledBuffer::hasTilesIn(const Range& rg) const -> bool {
+    for (const Level& l: levels) {
+        for (const auto& [index, tile]: l.tiles) {
+            if (intersects(getTileExtent(index, l.zoom), rg)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+auto TiledBuffer::getMissingTiles(const Range& rg, double zoom) const -> std::vector<TileIndex> {
+    auto tiles = getTilesIn(rg, zoom);
+    if (const Level* l = findLevel(zoom)) {
+        tiles.erase(std::remove_if(tiles.begin(), tiles.end(),
+                                   [l](const TileIndex& i) { return l->tiles.count(i) != 0; }),
+                    tiles.end());
+    }
+    return tiles;
+}
+
+void TiledBuffer::addTiles(double zoom, std::vector<RenderedTile> tiles) {
+    Level& level = useLevel(zoom);
+    for (auto& [index, content]: tiles) {
+        Tile tile{std::move(content), {}};
+        recolorTile(tile);
+        level.tiles.insert_or_assign(index, std::move(tile));
+    }
+}
+
+void TiledBuffer::replaceTiles(double zoom, std::vector<RenderedTile> tiles, bool keepOtherLevels) {
+    if (!keepOtherLevels) {
+        levels.clear();
+    }
+    Level& level = useLevel(zoom);
+    level.tiles.clear();
+    for (auto& [index, content]: tiles) {
+        Tile tile{std::move(content), {}};
+        recolorTile(tile);
+        level.tiles.emplace(index, std::move(tile));
+    }
+}
+
+void TiledBuffer::update(double zoom, const Mask& content, const Range& rg) {
+    dropOtherLevels(zoom, rg);
+    auto it = std::find_if(levels.begin(), levels.end(), [zoom](const Level& l) { return l.zoom == zoom; });
+    if (it == levels.end()) {
+        return;
+    }
+    for (auto& [index, tile]: it->tiles) {
+        if (intersects(getTileExtent(index, zoom), rg)) {
+            content.paintTo(tile.content.get());
+            recolorTile(tile);
+        }
+    }
+}
+
+auto TiledBuffer::drawOnTiles(double zoom, const Range& rg, const std::function<void(cairo_t*)>& draw) -> bool {
+    dropOtherLevels(zoom, rg);
+    auto it = std::find_if(levels.begin(), levels.end(), [zoom](const Level& l) { return l.zoom == zoom; });
+    if (it == levels.end() || it->tiles.empty()) {
+        return false;
+    }
+    for (auto& [index, tile]: it->tiles) {
+        if (intersects(getTileExtent(index, zoom), rg)) {
+            {
+                xoj::util::CairoSaveGuard saveGuard(tile.content.get());
+                draw(tile.content.get());
+            }
+            recolorTile(tile);
+        }
+    }
+    return true;
+}
+
+void TiledBuffer::setRecolor(const std::optional<Recolor>& recolor) {
+    if (this->recolor == recolor) {
+        return;
+    }
+    this->recolor = recolor;
+    for (Level& l: levels) {
+        for (auto& [index, tile]: l.tiles) {
+            recolorTile(tile);
+        }
+    }
+}
+
+auto TiledBuffer::paintTo(cairo_t* cr, const Range& rg, double zoom) const -> bool {
+    auto paintLevel = [&](const Level& l) {
+        for (const auto& [index, tile]: l.tiles) {
+            if (intersects(getTileExtent(index, l.zoom), rg)) {
+                (this->recolor ? tile.recolored : tile.content).paintTo(cr);
+            }
+        }
+    };
+
+    for (const Level& l: levels) {
+        if (l.zoom != zoom) {
+            paintLevel(l);
+        }
+    }
+    const Level* current = findLevel(zoom);
+    if (!current) {
+        return false;
+    }
+    paintLevel(*current);
+    return getMissingTiles(rg, zoom).empty();
+}
+
+void TiledBuffer::evict(const Range& rg, double zoom) {
+    Range keep = rg;
+    keep.addPadding(TILE_SIZE / zoom);
+    const bool complete = findLevel(zoom) && getMissingTiles(rg, zoom).empty();
+
+    for (Level& l: levels) {
+        if (l.zoom != zoom && complete) {
+            l.tiles.clear();
+            continue;
+        }
+        const Range& kept = l.zoom == zoom ? keep : rg;
+        for (auto it = l.tiles.begin(); it != l.tiles.end();) {
+            it = intersects(getTileExtent(it->first, l.zoom), kept) ? std::next(it) : l.tiles.erase(it);
+        }
+    }
+    levels.erase(std::remove_if(levels.begin(), levels.end(), [](const Level& l) { return l.tiles.empty(); }),
+                 levels.end());
+}
+
+void TiledBuffer::reset() { levels.clear(); }
+
+auto TiledBuffer::getByteSize() const -> size_t {
+    size_t size = 0;
+    for (const Level& l: levels) {
+        for (const auto& [index, tile]: l.tiles) {
+            size += tile.content.getByteSize() + tile.recolored.getByteSize();
+        }
+    }
+    return size;
+}
+
+void TiledBuffer::recolorTile(Tile& tile) const {
+    if (this->recolor) {
+        tile.recolored = tile.content.createRecolored(*this->recolor);
+    } else {
+        tile.recolored.reset();
+    }
+}
+
+auto TiledBuffer::useLevel(double zoom) -> Level& {
+    auto it = std::find_if(levels.begin(), levels.end(), [zoom](const Level& l) { return l.zoom == zoom; });
+    if (it != levels.end()) {
+        std::rotate(it, std::next(it), levels.end());
+    } else {
+        levels.push_back({zoom, {}});
+        if (levels.size() > MAX_LEVELS) {
+            levels.erase(levels.begin());
+        }
+    }
+    return levels.back();
+}
+
+auto TiledBuffer::findLevel(double zoom) const -> const Level* {
+    auto it = std::find_if(levels.begin(), levels.end(), [zoom](const Level& l) { return l.zoom == zoom; });
+    return it == levels.end() ? nullptr : &*it;
+}
+
+void TiledBuffer::dropOtherLevels(double zoom, const Range& rg) {
+    for (Level& l: levels) {
+        if (l.zoom == zoom) {
+            continue;
+        }
+        for (auto it = l.tiles.begin(); it != l.tiles.end();) {
+            it = intersects(getTileExtent(it->first, l.zoom), rg) ? l.tiles.erase(it) : std::next(it);
+        }
+    }
+}
@@ -0,0 +1,182 @@
+/*
+ * Xournal++
+ *
+ * Buffer of a page view, split into tiles
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <compare>     // for operator<=>
+#include <cstddef>     // for size_t
+#include <functional>  // for function
+#include <map>         // for map
+#include <optional>    // for optional
+#include <utility>     // for pair
+#include <vector>      // for vector
+
+#include <cairo.h>  // for cairo_t
+
+#include "util/Range.h"    // for Range
+#include "util/Recolor.h"  // for Recolor
+
+#include "Mask.h"  // for Mask
+
+namespace xoj::view {
+
+/**
+ * @brief Rendered content of a page, split into tiles of TILE_SIZE x TILE_SIZE pixels
+ *
+ * Only the tiles of the visible part of the page are rendered, so the memory used scales with the size of the viewport
+ * instead of the size of the page at the current zoom.
+ *
+ * The tiles are grouped by zoom level. The tiles of the zoom levels rendered before are kept as scaled placeholders,
+ * shown until the tiles of the current zoom are rendered. At most MAX_LEVELS zoom levels are kept.
+ *
+ * When recoloring is enabled, a recolored copy of every tile is kept alongside it, updated whenever the tile changes.
+ * The recoloring is then done once per rendering instead of on every repaint.
+ *
+ * The buffer is not thread safe, it has to be locked by its owner.
+ */
+class TiledBuffer {
+public:
+    /// Size of a tile, in device pixels (before DPI scaling)
+    static constexpr int TILE_SIZE = 256;
+
+    /// Number of zoom levels kept
+    static constexpr size_t MAX_LEVELS = 3;
+
+    struct TileIndex {
+        int x;
+        int y;
+
+        auto operator<=>(const TileIndex&) const = default;
+    };
+
+    using RenderedTile = std::pair<TileIndex, Mask>;
+
+    TiledBuffer() = default;
+
+public:
+    /**
+     * @return The indices of the tiles covering the range (in page coordinates) at the given zoom
+     */
+    static std::vector<TileIndex> getTilesIn(const Range& rg, double zoom);
+
+    /**
+     * @return The part of the page covered by the tile, in page coordinates
+     */
+    static Range getTileExtent(TileIndex index, double zoom);
+
+    /**
+     * @return If there is any tile
+     */
+    bool isInitialized() const;
+
+    /**
+     * @return If some tile, at any zoom, intersects the range
+     */
+    bool hasTilesIn(const Range& rg) const;
+
+    /**
+     * @return The tiles covering the range at the zoom which are not rendered yet
+     */
+    std::vector<TileIndex> getMissingTiles(const Range& rg, double zoom) const;
+
+    /**
+     * @brief Add rendered tiles. The zoom level becomes the current one.
+     */
+    void addTiles(double zoom, std::vector<RenderedTile> tiles);
+
+    /**
+     * @brief Replace all the tiles of the zoom level, after the whole page has been rerendered
+     * @param keepOtherLevels If the tiles of the other zoom levels are still up to date, e.g. the page only changed
+     * size. They are dropped otherwise.
+     */
+    void replaceTiles(double zoom, std::vector<RenderedTile> tiles, bool keepOtherLevels);
+
+    /**
+     * @brief Paint a rerendered part of the page onto the tiles of the zoom level. The tiles of the other levels
+     * intersecting the range are outdated and dropped.
+     * @param rg The rerendered range, in page coordinates
+     */
+    void update(double zoom, const Mask& content, const Range& rg);
+
+    /**
+     * @brief Draw on every tile of the zoom level intersecting the range. The tiles of the other levels intersecting
+     * the range are outdated and dropped.
+     * @param draw Called with the cairo context of every tile, in page coordinates
+     * @return false if there was no tile of the zoom level to draw on
+     */
+    bool drawOnTiles(double zoom, const Range& rg, const std::function<void(cairo_t*)>& draw);
+
+    /**
+     * @brief Set the recoloring of the painted tiles, the recolored copies of the tiles are updated if it changed
+     * @param recolor std::nullopt to disable the recoloring
+     */
+    void setRecolor(const std::optional<Recolor>& recolor);
+
+    /**
+     * @brief Paint the tiles intersecting the range: the tiles of the other zoom levels first, scaled, and those of
+     * the given zoom on top of them. The recolored copies are painted if the recoloring is enabled.
+     * @param cr A cairo context in page coordinates
+     * @return true if the range was covered by tiles of the given zoom
+     */
+    bool paintTo(cairo_t* cr, const Range& rg, double zoom) const;
+
+    /**
+     * @brief Drop the tiles far from the range: the tiles of the given zoom which are not within one tile of the range,
+     * and the tiles of the other levels outside of it or hidden by the tiles of the given zoom
+     */
+    void evict(const Range& rg, double zoom);
+
+    /**
+     * @brief Delete all the tiles
+     */
+    void reset();
+
+    /**
+     * @return The memory used by the tiles, in bytes
+     */
+    size_t getByteSize() const;
+
+private:
+    struct Tile {
+        Mask content;
+        /// Only initialized when recoloring is enabled
+        Mask recolored;
+    };
+
+    struct Level {
+        double zoom;
+        std::map<TileIndex, Tile> tiles;
+    };
+
+    /**
+     * Update the recolored copy of the tile
+     */
+    void recolorTile(Tile& tile) const;
+
+    /**
+     * @return The level of the zoom, moved to the end of the levels (the most recent one), created if needed
+     */
+    Level& useLevel(double zoom);
+
+    const Level* findLevel(double zoom) const;
+
+    /**
+     * Drop the tiles of the levels other than the given zoom intersecting the range
+     */
+    void dropOtherLevels(double zoom, const Range& rg);
+
+    /// Sorted from the oldest to the most recently used
+    std::vector<Level> levels;
+
+    std::optional<Recolor> recolor;
+};
+
+};  // namespace xoj::view
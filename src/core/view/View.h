@@ -23,6 +23,8 @@ namespace view {
 enum NonAudioTreatment : bool { FADE_OUT_NON_AUDIO_ = true, NORMAL_NON_AUDIO = false };
 enum EditionTreatment : bool { SHOW_CURRENT_EDITING = true, HIDE_CURRENT_EDITING = false };
 enum ColorTreatment : bool { COLORBLIND = true, NORMAL_COLOR = false };
+/// Whether the contours of the pressure strokes are kept in the strokes (see Stroke::getContour())
+enum ContourTreatment : bool { CACHE_CONTOURS = true, COMPUTE_CONTOURS = false };
 
 class Context {
 public:
@@ -30,9 +32,14 @@ public:
     NonAudioTreatment fadeOutNonAudio;
     EditionTreatment showCurrentEdition;
     ColorTreatment noColor;
-
-    static Context createDefault(cairo_t* cr) { return {cr, NORMAL_NON_AUDIO, HIDE_CURRENT_EDITING, NORMAL_COLOR}; }
-    static Context createColorBlind(cairo_t* cr) { return {cr, NORMAL_NON_AUDIO, HIDE_CURRENT_EDITING, COLORBLIND}; }
+    ContourTreatment cacheContours;
+
+    static Context createDefault(cairo_t* cr) {
+        return {cr, NORMAL_NON_AUDIO, HIDE_CURRENT_EDITING, NORMAL_COLOR, COMPUTE_CONTOURS};
+    }
+    static Context createColorBlind(cairo_t* cr) {
+        return {cr, NORMAL_NON_AUDIO, HIDE_CURRENT_EDITING, COLORBLIND, COMPUTE_CONTOURS};
+    }
 };
 
 class ElementView {
@@ -18,6 +18,8 @@ enum ImageBackgroundTreatment : bool { SHOW_IMAGE_BACKGROUND = true, HIDE_IMAGE_
 enum RulingBackgroundTreatment : bool { SHOW_RULING_BACKGROUND = true, HIDE_RULING_BACKGROUND = false };
 enum BackgroundColorTreatment : bool { FORCE_AT_LEAST_BACKGROUND_COLOR = true, DONT_FORCE_BACKGROUND_COLOR = false };
 enum VisibilityTreatment : bool { FORCE_VISIBLE = true, USE_DOCUMENT_VISIBILITY = false };
+/// Whether the PDF rasterized for the drawing is kept in the PdfCache, or only the renderings already cached are used
+enum PdfCacheTreatment : bool { CACHE_PDF_RENDERING = true, REUSE_CACHED_PDF_ONLY = false };
 
 struct BackgroundFlags {
     PDFBackgroundTreatment showPDF;
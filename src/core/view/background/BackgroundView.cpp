@@ -56,8 +56,8 @@ auto BackgroundView::createRuled(double width, double height, Color backgroundCo
     return res;
 }
 
-auto BackgroundView::createForPage(ConstPageRef page, BackgroundFlags bgFlags, PdfCache* pdfCache)
-        -> std::unique_ptr<BackgroundView> {
+auto BackgroundView::createForPage(ConstPageRef page, BackgroundFlags bgFlags, PdfCache* pdfCache,
+                                   PdfCacheTreatment pdfCacheTreatment) -> std::unique_ptr<BackgroundView> {
     const double width = page->getWidth();
     const double height = page->getHeight();
     if (!bgFlags.forceVisible && !page->isLayerVisible(0)) {
@@ -74,7 +74,8 @@ auto BackgroundView::createForPage(ConstPageRef page, BackgroundFlags bgFlags, P
                 break;
             case PageTypeFormat::Pdf:
                 if (bgFlags.showPDF) {
-                    return std::make_unique<PdfBackgroundView>(width, height, page->getPdfPageNr(), pdfCache);
+                    return std::make_unique<PdfBackgroundView>(width, height, page->getPdfPageNr(), pdfCache,
+                                                               pdfCacheTreatment);
                 }
                 break;
             default:
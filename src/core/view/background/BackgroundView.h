@@ -42,7 +42,9 @@ public:
 
     [[nodiscard]] static std::unique_ptr<BackgroundView> createForPage(ConstPageRef page,
                                                                        xoj::view::BackgroundFlags bgFlags,
-                                                                       PdfCache* pdfCache = nullptr);
+                                                                       PdfCache* pdfCache = nullptr,
+                                                                       PdfCacheTreatment pdfCacheTreatment =
+                                                                               CACHE_PDF_RENDERING);
 
 protected:
     double pageWidth;
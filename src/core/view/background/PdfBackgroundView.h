@@ -24,7 +24,8 @@ namespace view {
 
 class PdfBackgroundView: public BackgroundView {
 public:
-    PdfBackgroundView(double pageWidth, double pageHeight, size_t pageNo, PdfCache* pdfCache = nullptr);
+    PdfBackgroundView(double pageWidth, double pageHeight, size_t pageNo, PdfCache* pdfCache = nullptr,
+                      PdfCacheTreatment pdfCacheTreatment = CACHE_PDF_RENDERING);
     virtual ~PdfBackgroundView() = default;
 
     /**
@@ -35,6 +36,7 @@ public:
 private:
     size_t pageNo;
     PdfCache* pdfCache = nullptr;
+    PdfCacheTreatment pdfCacheTreatment;
 };
 
 };  // namespace view
@@ -60,10 +60,8 @@ void TextEditionView::drawWithoutDrawingAids(cairo_t* cr) const {
     // The data is owned by textEditor
     PangoLayout* layout = this->textEditor->getUpToDateLayout();
 
-    // The cairo context might have changed. Update the pango layout
-    pango_cairo_update_layout(cr, layout);
-
-    pango_context_set_matrix(pango_layout_get_context(layout), nullptr);
+    // The cairo context might have changed. Update the pango layout, without relaying it out if nothing changed
+    Text::updatePangoFontOptions(cr, layout);
 
     pango_cairo_show_layout(cr, layout);
 }
@@ -0,0 +1,194 @@
+#include "util/NumberScanner.h"
+
+#include <algorithm>  // for copy, min
+#include <array>      // for array
+#include <cstdint>    // for uint64_t
+#include <limits>     // for numeric_limits
+#include <string>     // for string
+
+#include <glib.h>  // for g_ascii_strtod
+
+using namespace xoj::util;
+
+/// Powers of ten that are exactly representable as double
+static constexpr std::array<double, 23> EXACT_POWERS_OF_TEN = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                                               1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                                               1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+/// Integers up to this value are exactly representable as double
+static constexpr uint64_t MAX_EXACT_MANTISSA = uint64_t(1) << 53;
+
+/// More digits do not fit in the 64 bit mantissa
+static constexpr int MAX_MANTISSA_DIGITS = 19;
+
+static inline auto isDigit(char c) -> bool { return c >= '0' && c <= '9'; }
+
+// Same as g_ascii_isspace()
+static inline auto isSpace(char c) -> bool {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+NumberScanner::NumberScanner(const char* begin, const char* end): begin(begin), ptr(begin), end(end) {}
+
+NumberScanner::NumberScanner(std::string_view str): NumberScanner(str.data(), str.data() + str.size()) {}
+
+auto NumberScanner::readDouble(double& value) -> bool {
+    skipWhitespace();
+
+    const char* p = this->ptr;
+    bool negative = false;
+    if (p != this->end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        p++;
+    }
+
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool anyDigit = false;
+
+    for (; p != this->end && isDigit(*p); p++) {
+        anyDigit = true;
+        mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+        if (mantissa != 0 && ++digits > MAX_MANTISSA_DIGITS) {
+            return readDoubleSlow(value);
+        }
+    }
+    if (p != this->end && (*p == 'x' || *p == 'X') && anyDigit) {
+        // Hexadecimal number
+        return readDoubleSlow(value);
+    }
+    if (p != this->end && *p == '.') {
+        for (p++; p != this->end && isDigit(*p); p++) {
+            anyDigit = true;
+            mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+            exponent--;
+            if (mantissa != 0 && ++digits > MAX_MANTISSA_DIGITS) {
+                return readDoubleSlow(value);
+            }
+        }
+    }
+    if (!anyDigit) {
+        // "inf", "nan" or no number at all
+        return readDoubleSlow(value);
+    }
+
+    if (p != this->end && (*p == 'e' || *p == 'E')) {
+        const char* q = p + 1;
+        bool negativeExponent = false;
+        if (q != this->end && (*q == '-' || *q == '+')) {
+            negativeExponent = *q == '-';
+            q++;
+        }
+        // The exponent is only part of the number if it has digits
+        if (q != this->end && isDigit(*q)) {
+            int e = 0;
+            for (; q != this->end && isDigit(*q); q++) {
+                if (e > 100000) {
+                    return readDoubleSlow(value);
+                }
+                e = e * 10 + (*q - '0');
+            }
+            exponent += negativeExponent ? -e : e;
+            p = q;
+        }
+    }
+
+    double result = 0;
+    if (mantissa != 0) {
+        if (mantissa > MAX_EXACT_MANTISSA || exponent < -22 || exponent > 22) {
+            return readDoubleSlow(value);
+        }
+        // Both operands are exact, so the result is correctly rounded
+        result = static_cast<double>(mantissa);
+        if (exponent < 0) {
+            result /= EXACT_POWERS_OF_TEN[static_cast<size_t>(-exponent)];
+        } else {
+            result *= EXACT_POWERS_OF_TEN[static_cast<size_t>(exponent)];
+        }
+    }
+
+    value = negative ? -result : result;
+    this->ptr = p;
+    return true;
+}
+
+auto NumberScanner::readDoubleSlow(double& value) -> bool {
+    // g_ascii_strtod needs a null-terminated string
+    const char* tokenEnd = this->ptr;
+    while (tokenEnd != this->end && !isSpace(*tokenEnd)) {
+        tokenEnd++;
+    }
+    const auto length = static_cast<size_t>(tokenEnd - this->ptr);
+
+    std::array<char, 64> buffer{};
+    std::string longToken;
+    const char* str = buffer.data();
+    if (length < buffer.size()) {
+        std::copy(this->ptr, tokenEnd, buffer.begin());
+    } else {
+        longToken.assign(this->ptr, tokenEnd);
+        str = longToken.c_str();
+    }
+
+    char* endPtr = nullptr;
+    double result = g_ascii_strtod(str, &endPtr);
+    if (endPtr == str) {
+        return false;
+    }
+    value = result;
+    this->ptr += endPtr - str;
+    return true;
+}
+
+auto NumberScanner::readUnsigned(size_t& value) -> bool {
+    skipWhitespace();
+
+    const char* p = this->ptr;
+    size_t result = 0;
+    for (; p != this->end && isDigit(*p); p++) {
+        auto digit = static_cast<size_t>(*p - '0');
+        if (result > (std::numeric_limits<size_t>::max() - digit) / 10) {
+            return false;
+        }
+        result = result * 10 + digit;
+    }
+    if (p == this->ptr) {
+        return false;
+    }
+    value = result;
+    this->ptr = p;
+    return true;
+}
+
+auto NumberScanner::skip(char c) -> bool {
+    if (this->ptr != this->end && *this->ptr == c) {
+        this->ptr++;
+        return true;
+    }
+    return false;
+}
+
+void NumberScanner::skipWhitespace() {
+    while (this->ptr != this->end && isSpace(*this->ptr)) {
+        this->ptr++;
+    }
+}
+
+auto NumberScanner::atEnd() -> bool {
+    skipWhitespace();
+    return this->ptr == this->end;
+}
+
+auto NumberScanner::position() const -> size_t { return static_cast<size_t>(this->ptr - this->begin); }
+
+auto NumberScanner::countTokens() const -> size_t {
+    size_t count = 0;
+    bool inToken = false;
+    for (const char* p = this->ptr; p != this->end; p++) {
+        bool space = isSpace(*p);
+        count += !space && !inToken;
+        inToken = !space;
+    }
+    return count;
+}
@@ -0,0 +1,69 @@
+#include "util/ReadAheadStream.h"
+
+#include <algorithm>  // for max
+#include <utility>    // for move
+
+using namespace xoj::util;
+
+ReadAheadStream::ReadAheadStream(ReadFunction read, size_t chunkSize, size_t chunkCount):
+        read(std::move(read)),
+        chunkSize(std::max<size_t>(chunkSize, 1)),
+        chunks(std::max<size_t>(chunkCount, 1)),
+        chunkLengths(chunks.size(), 0) {
+    for (auto& c: this->chunks) {
+        c.resize(this->chunkSize);
+    }
+    this->thread = std::thread([this]() { run(); });
+}
+
+ReadAheadStream::~ReadAheadStream() {
+    {
+        std::lock_guard lock(this->mutex);
+        this->stopped = true;
+    }
+    this->cond.notify_all();
+    this->thread.join();
+}
+
+auto ReadAheadStream::next() -> std::string_view {
+    std::unique_lock lock(this->mutex);
+    if (this->consuming) {
+        this->consuming = false;
+        this->readIndex = (this->readIndex + 1) % this->chunks.size();
+        this->filled--;
+        this->cond.notify_all();
+    }
+
+    this->cond.wait(lock, [this]() { return this->filled > 0 || this->finished; });
+    if (this->filled == 0) {
+        return {};
+    }
+    this->consuming = true;
+    return {this->chunks[this->readIndex].data(), this->chunkLengths[this->readIndex]};
+}
+
+void ReadAheadStream::run() {
+    for (;;) {
+        {
+            std::unique_lock lock(this->mutex);
+            this->cond.wait(lock, [this]() { return this->filled < this->chunks.size() || this->stopped; });
+            if (this->stopped) {
+                return;
+            }
+        }
+
+        // The chunk at writeIndex is neither filled nor being consumed: no need to lock while reading it
+        std::ptrdiff_t len = this->read(this->chunks[this->writeIndex].data(), this->chunkSize);
+
+        std::lock_guard lock(this->mutex);
+        if (len <= 0) {
+            this->finished = true;
+            this->cond.notify_all();
+            return;
+        }
+        this->chunkLengths[this->writeIndex] = static_cast<size_t>(len);
+        this->writeIndex = (this->writeIndex + 1) % this->chunks.size();
+        this->filled++;
+        this->cond.notify_all();
+    }
+}
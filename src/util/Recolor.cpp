@@ -1,6 +1,10 @@
 #include "util/Recolor.h"
 
+#include <cstddef>  // for ptrdiff_t
+#include <cstdint>  // for uint32_t
+
 #include "util/Color.h"
+#include "util/raii/CairoWrappers.h"
 
 Recolor::Recolor(const ColorU8& light, const ColorU8& dark): dark(dark), light(light) { recalcDiffAndOff(); }
 
@@ -47,3 +51,77 @@ void Recolor::recolorCurrentCairoRegion(cairo_t* cr) const {
     Util::cairo_set_source_rgbi(cr, offset);
     cairo_paint(cr);
 }
+
+/**
+ * Recolors a premultiplied channel c of alpha a: ((a - c) * difference + offset * a) / 255
+ * For opaque pixels, this is exactly convertColor(). As difference + offset <= 255, the result never exceeds a.
+ */
+static inline auto recolorChannel(uint32_t c, uint32_t a, uint32_t difference, uint32_t offset) -> uint32_t {
+    return ((a - c) * difference + offset * a) / 255U;
+}
+
+void Recolor::recolorImageSurface(cairo_surface_t* surface) const {
+    const cairo_format_t format = cairo_image_surface_get_format(surface);
+    if (format != CAIRO_FORMAT_ARGB32 && format != CAIRO_FORMAT_RGB24) {
+        return;
+    }
+    // The alpha byte of RGB24 pixels is undefined
+    const uint32_t forcedAlpha = format == CAIRO_FORMAT_RGB24 ? 0xff000000U : 0U;
+
+    cairo_surface_flush(surface);
+    unsigned char* data = cairo_image_surface_get_data(surface);
+    const int width = cairo_image_surface_get_width(surface);
+    const int height = cairo_image_surface_get_height(surface);
+    const int stride = cairo_image_surface_get_stride(surface);
+
+    const uint32_t dr = difference.red;
+    const uint32_t dg = difference.green;
+    const uint32_t db = difference.blue;
+    const uint32_t or_ = offset.red;
+    const uint32_t og = offset.green;
+    const uint32_t ob = offset.blue;
+
+    // Native endian 0xAARRGGBB premultiplied pixels
+    auto recolorPixel = [&](uint32_t& pixel) {
+        const uint32_t p = pixel | forcedAlpha;
+        const uint32_t a = p >> 24U;
+        const uint32_t r = recolorChannel((p >> 16U) & 0xffU, a, dr, or_);
+        const uint32_t g = recolorChannel((p >> 8U) & 0xffU, a, dg, og);
+        const uint32_t b = recolorChannel(p & 0xffU, a, db, ob);
+        pixel = (a << 24U) | (r << 16U) | (g << 8U) | b;
+    };
+
+    for (int y = 0; y < height; y++) {
+        auto* row = reinterpret_cast<uint32_t*>(data + static_cast<ptrdiff_t>(y) * stride);
+        int x = 0;
+        // Blocks of a fixed size are vectorized even by the cheap cost model of -O2
+        for (; x + 8 <= width; x += 8) {
+            for (int i = 0; i < 8; i++) {
+                recolorPixel(row[x + i]);
+            }
+        }
+        for (; x < width; x++) {
+            recolorPixel(row[x]);
+        }
+    }
+    cairo_surface_mark_dirty(surface);
+}
+
+void Recolor::paintRecolored(cairo_t* cr, const std::function<void(cairo_t*)>& draw) const {
+    cairo_push_group(cr);
+    draw(cr);
+    cairo_pattern_t* group = cairo_pop_group(cr);
+
+    cairo_surface_t* groupSurface = nullptr;
+    if (cairo_pattern_get_surface(group, &groupSurface) == CAIRO_STATUS_SUCCESS) {
+        // The group is similar to the target of cr, which is not necessarily an image surface
+        cairo_surface_t* image = cairo_surface_map_to_image(groupSurface, nullptr);
+        recolorImageSurface(image);
+        cairo_surface_unmap_image(groupSurface, image);
+    }
+
+    xoj::util::CairoSaveGuard saveGuard(cr);
+    cairo_set_source(cr, group);
+    cairo_paint(cr);
+    cairo_pattern_destroy(group);
+}
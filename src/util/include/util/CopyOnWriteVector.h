@@ -0,0 +1,102 @@
+/*
+ * Xournal++
+ *
+ * A vector whose copies share their data until modified
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <atomic>   // for atomic_thread_fence
+#include <cstddef>  // for size_t
+#include <memory>   // for shared_ptr, make_shared
+#include <utility>  // for move
+#include <vector>   // for vector
+
+namespace xoj::util {
+
+/**
+ * @brief std::vector wrapper with copy-on-write semantics
+ *
+ * Copying a CopyOnWriteVector is cheap: both copies share the same buffer. The buffer is duplicated by mut() only if
+ * it is shared, so a copy can be read from another thread while the original is being modified.
+ * Only const access is provided directly: all modifications go through mut().
+ *
+ * A given CopyOnWriteVector object is not thread-safe by itself, just like std::vector.
+ */
+template <typename T>
+class CopyOnWriteVector {
+public:
+    using value_type = T;
+    using size_type = typename std::vector<T>::size_type;
+    using const_iterator = typename std::vector<T>::const_iterator;
+    using iterator = const_iterator;
+
+    CopyOnWriteVector(): buffer(std::make_shared<std::vector<T>>()) {}
+    CopyOnWriteVector(std::vector<T> v): buffer(std::make_shared<std::vector<T>>(std::move(v))) {}
+
+    CopyOnWriteVector(const CopyOnWriteVector&) = default;
+    CopyOnWriteVector& operator=(const CopyOnWriteVector&) = default;
+
+    // A moved-from vector must stay usable
+    CopyOnWriteVector(CopyOnWriteVector&& o) noexcept: buffer(std::move(o.buffer)) {
+        o.buffer = std::make_shared<std::vector<T>>();
+    }
+    CopyOnWriteVector& operator=(CopyOnWriteVector&& o) noexcept {
+        std::swap(buffer, o.buffer);
+        return *this;
+    }
+
+    CopyOnWriteVector& operator=(const std::vector<T>& v) {
+        buffer = std::make_shared<std::vector<T>>(v);
+        return *this;
+    }
+    CopyOnWriteVector& operator=(std::vector<T>&& v) {
+        buffer = std::make_shared<std::vector<T>>(std::move(v));
+        return *this;
+    }
+
+    /**
+     * @return The vector, for modification. The data is copied first if it is shared with another CopyOnWriteVector.
+     */
+    std::vector<T>& mut() {
+        if (buffer.use_count() > 1) {
+            buffer = std::make_shared<std::vector<T>>(*buffer);
+        } else {
+            // Synchronizes with the release of the buffer by another thread, whose reads must be finished
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        return *buffer;
+    }
+
+    const std::vector<T>& get() const { return *buffer; }
+    operator const std::vector<T>&() const { return *buffer; }
+
+    size_type size() const { return buffer->size(); }
+    bool empty() const { return buffer->empty(); }
+    const T* data() const { return buffer->data(); }
+
+    const T& operator[](size_t i) const { return (*buffer)[i]; }
+    const T& at(size_t i) const { return buffer->at(i); }
+    const T& front() const { return buffer->front(); }
+    const T& back() const { return buffer->back(); }
+
+    const_iterator begin() const { return buffer->cbegin(); }
+    const_iterator end() const { return buffer->cend(); }
+    const_iterator cbegin() const { return buffer->cbegin(); }
+    const_iterator cend() const { return buffer->cend(); }
+
+    /**
+     * @return whether the data is currently shared with another CopyOnWriteVector
+     */
+    bool isShared() const { return buffer.use_count() > 1; }
+
+private:
+    std::shared_ptr<std::vector<T>> buffer;
+};
+
+}  // namespace xoj::util
@@ -0,0 +1,79 @@
+/*
+ * Xournal++
+ *
+ * Fast scanner for lists of numbers
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>      // for size_t
+#include <string_view>  // for string_view
+
+namespace xoj::util {
+
+/**
+ * @brief Reads numbers from a character buffer, as found in the stroke data of .xopp files
+ *
+ * The numbers are always read in the C locale and without allocating. Decimal numbers with at most 19 significant
+ * digits and a small exponent (e.g. everything written with "%.8g") are converted exactly by a fast path, anything
+ * else (more digits, "inf", "nan", hexadecimal...) falls back to g_ascii_strtod().
+ *
+ * The buffer does not need to be null-terminated: the scanner never reads past its end.
+ */
+class NumberScanner {
+public:
+    NumberScanner(const char* begin, const char* end);
+    explicit NumberScanner(std::string_view str);
+
+public:
+    /**
+     * Skips whitespace and reads a floating point number, like g_ascii_strtod()
+     *
+     * @return false (and does not move) if there is no number at the current position
+     */
+    bool readDouble(double& value);
+
+    /**
+     * Skips whitespace and reads a decimal unsigned integer
+     *
+     * @return false (and does not move) if there is no number at the current position, or if it does not fit
+     */
+    bool readUnsigned(size_t& value);
+
+    /**
+     * Consumes the next character if it is c
+     */
+    bool skip(char c);
+
+    void skipWhitespace();
+
+    /**
+     * @return true if only whitespace is left
+     */
+    bool atEnd();
+
+    /**
+     * @return The number of characters read so far
+     */
+    size_t position() const;
+
+    /**
+     * Counts the whitespace separated tokens left in the buffer, e.g. to reserve memory before reading them
+     */
+    size_t countTokens() const;
+
+private:
+    bool readDoubleSlow(double& value);
+
+private:
+    const char* begin;
+    const char* ptr;
+    const char* end;
+};
+
+}  // namespace xoj::util
@@ -0,0 +1,95 @@
+/*
+ * Xournal++
+ *
+ * Reads a stream ahead of its consumer, on a dedicated thread
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t, ptrdiff_t
+#include <functional>          // for function
+#include <mutex>               // for mutex
+#include <string_view>         // for string_view
+#include <thread>              // for thread
+#include <vector>              // for vector
+
+namespace xoj::util {
+
+/**
+ * @brief Runs the producer of a stream (e.g. the decompression of a file) concurrently with its consumer (e.g. a
+ * parser)
+ *
+ * The read function is called repeatedly on a dedicated thread to fill a ring of fixed size chunks, until it returns
+ * 0 or less (end of the stream or error). The consumer gets the chunks in order with next(). The reading thread waits
+ * whenever all the chunks are filled, so the memory used is bounded.
+ */
+class ReadAheadStream final {
+public:
+    /**
+     * Reads at most len bytes to buffer
+     *
+     * @return The number of bytes read, 0 or less at the end of the stream
+     */
+    using ReadFunction = std::function<std::ptrdiff_t(char* buffer, size_t len)>;
+
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+    static constexpr size_t DEFAULT_CHUNK_COUNT = 4;
+
+    /**
+     * Starts reading immediately
+     */
+    explicit ReadAheadStream(ReadFunction read, size_t chunkSize = DEFAULT_CHUNK_SIZE,
+                             size_t chunkCount = DEFAULT_CHUNK_COUNT);
+    ReadAheadStream(const ReadAheadStream&) = delete;
+    ReadAheadStream& operator=(const ReadAheadStream&) = delete;
+
+    /**
+     * Stops reading (the read function is not called again after the current call) and waits for the thread
+     */
+    ~ReadAheadStream();
+
+public:
+    /**
+     * Waits for the next chunk of the stream. The previous chunk is handed back to the reading thread.
+     *
+     * @return The next chunk, valid until the next call. Empty at the end of the stream.
+     */
+    std::string_view next();
+
+private:
+    void run();
+
+private:
+    ReadFunction read;
+    const size_t chunkSize;
+
+    std::vector<std::vector<char>> chunks;
+    std::vector<size_t> chunkLengths;
+
+    /// Index of the next chunk to be returned by next(), only accessed by the consumer
+    size_t readIndex = 0;
+
+    /// If next() returned the chunk at readIndex, which is not yet handed back
+    bool consuming = false;
+
+    /// Index of the next chunk to fill, only accessed by the reading thread
+    size_t writeIndex = 0;
+
+    /// Number of chunks filled and not handed back yet, guarded by mutex
+    size_t filled = 0;
+    bool finished = false;
+    bool stopped = false;
+
+    std::mutex mutex;
+    std::condition_variable cond;
+
+    std::thread thread;
+};
+
+}  // namespace xoj::util
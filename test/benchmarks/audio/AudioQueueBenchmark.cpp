@@ -0,0 +1,75 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal Benchmarks
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <chrono>    // for steady_clock, microseconds
+#include <cstddef>   // for size_t
+#include <iostream>  // for cout
+#include <iterator>  // for back_inserter
+#include <thread>    // for thread, sleep_until
+#include <vector>    // for vector
+
+#include <gtest/gtest.h>
+
+#include "audio/AudioQueue.h"
+
+/**
+ * A producer pushing buffers at a fixed rate without ever waiting, as the PortAudio recording callback, and a consumer
+ * draining the queue as the VorbisConsumer. Reports the frames dropped because the consumer fell behind.
+ */
+TEST(AudioQueueBenchmark, droppedFrames) {
+    constexpr unsigned int channels = 2;
+    constexpr size_t framesPerBuffer = 256;
+    constexpr size_t bufferCount = 20000;
+    constexpr auto period = std::chrono::microseconds(50);
+
+    AudioQueue<float> queue;
+    queue.setAudioAttributes(44100, channels);
+
+    std::thread producer([&]() {
+        std::vector<float> buffer(framesPerBuffer * channels);
+        float next = 0;
+        auto deadline = std::chrono::steady_clock::now();
+        for (size_t n = 0; n < bufferCount; n++) {
+            for (float& s: buffer) {
+                s = next++;
+            }
+            queue.emplace(buffer.begin(), buffer.end());
+            deadline += period;
+            std::this_thread::sleep_until(deadline);
+        }
+        queue.signalEndOfStream();
+    });
+
+    size_t popped = 0;
+    bool ordered = true;
+    float last = -1;
+    std::vector<float> buffer;
+    while (!(queue.hasStreamEnded() && queue.empty())) {
+        queue.waitForProducer();
+        while (!queue.empty()) {
+            buffer.clear();
+            queue.pop(std::back_inserter(buffer), 64 * channels);
+            for (float s: buffer) {
+                ordered = ordered && s > last;
+                last = s;
+            }
+            popped += buffer.size();
+        }
+    }
+    producer.join();
+
+    size_t dropped = queue.getDroppedSamples();
+    std::cout << "AudioQueue: " << bufferCount * framesPerBuffer << " frames pushed, " << dropped / channels
+              << " frames dropped" << std::endl;
+
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(popped + dropped, bufferCount * framesPerBuffer * channels);
+}
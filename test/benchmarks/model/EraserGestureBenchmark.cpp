@@ -0,0 +1,114 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal Benchmarks
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <chrono>    // for steady_clock, duration
+#include <cmath>     // for sin
+#include <iostream>  // for cout
+#include <memory>    // for make_shared, make_unique
+#include <random>    // for mt19937, uniform_real_distribution
+#include <vector>    // for vector
+
+#include <gdk/gdk.h>
+#include <gtest/gtest.h>
+
+#include "control/ToolEnums.h"
+#include "control/ToolHandler.h"
+#include "control/settings/Settings.h"
+#include "control/tools/EraseHandler.h"
+#include "gui/LegacyRedrawable.h"
+#include "model/Document.h"
+#include "model/DocumentHandler.h"
+#include "model/EraserMotionRecording.h"
+#include "model/Layer.h"
+#include "model/Point.h"
+#include "model/Stroke.h"
+#include "model/XojPage.h"
+#include "undo/UndoRedoHandler.h"
+
+class NullRedrawable: public LegacyRedrawable {
+public:
+    void repaintArea(double, double, double, double) const override {}
+    void repaintPage() const override {}
+    void rerenderPage(bool) override {}
+    void rerenderRect(double, double, double, double) override {}
+    GdkRGBA getSelectionColor() override { return {}; }
+    void deleteViewBuffer() override {}
+    int getX() const override { return 0; }
+    int getY() const override { return 0; }
+};
+
+/**
+ * Erases with a zigzag gesture across a dense page at the end of a long document, with the motion recording enabled
+ */
+TEST(EraserGestureBenchmark, densePage) {
+    constexpr size_t pageCount = 1000;
+    constexpr size_t erasedPage = 900;
+    constexpr int strokeCount = 5000;
+    constexpr int eventCount = 5000;
+
+    Settings settings("non-existing-file-path");
+    settings.transactionStart();  // Never write the settings file
+    settings.setMotionExportEnabled(true);
+    ToolHandler tools(nullptr, nullptr, &settings);
+    tools.selectTool(TOOL_ERASER);
+    tools.setEraserType(ERASER_TYPE_DELETE_STROKE);
+    UndoRedoHandler undo(nullptr);
+    NullRedrawable view;
+
+    DocumentHandler dh;
+    Document doc(&dh);
+    for (size_t i = 0; i < pageCount; i++) {
+        doc.addPage(std::make_shared<XojPage>(595, 842));
+    }
+    PageRef page = doc.getPage(erasedPage);
+    Layer* layer = page->getSelectedLayer();
+
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<double> distX(0.0, 595.0);
+    std::uniform_real_distribution<double> distY(0.0, 842.0);
+    for (int i = 0; i < strokeCount; i++) {
+        auto s = std::make_unique<Stroke>();
+        s->setWidth(1);
+        double x = distX(gen);
+        double y = distY(gen);
+        s->addPoint(Point(x, y));
+        s->addPoint(Point(x + 15, y + 5));
+        layer->addElement(std::move(s));
+    }
+
+    using clock = std::chrono::steady_clock;
+    auto start = clock::now();
+    {
+        EraseHandler eraser(&undo, &doc, page, &tools, &view, &settings);
+        for (int i = 0; i < eventCount; i++) {
+            double t = static_cast<double>(i) / eventCount;
+            eraser.erase(595.0 * t, 421.0 + 400.0 * std::sin(t * 40.0), static_cast<size_t>(i));
+        }
+        doc.lock();
+        eraser.finalize();
+        doc.unlock();
+    }
+    auto time = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+    const EraserMotionRecording& recording = doc.getEraserMotionRecording();
+    size_t erased = strokeCount - layer->getElementsView().size();
+    std::cout << "Eraser gesture of " << eventCount << " events on page " << erasedPage << ": " << time << " ms ("
+              << erased << " strokes erased)" << std::endl;
+
+    ASSERT_EQ(recording.getMotionPointCount(), static_cast<size_t>(eventCount));
+    size_t affected = 0;
+    for (const EraserMotionPoint& p: recording.getMotionPoints()) {
+        EXPECT_EQ(p.pageIndex, erasedPage);
+        affected += p.affectedStrokeIndices.size();
+    }
+    // The strokes only close to the eraser are recorded as affected too
+    EXPECT_GE(affected, erased);
+}
@@ -0,0 +1,93 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal Benchmarks
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <chrono>    // for steady_clock, duration
+#include <cstdlib>   // for abs
+#include <iostream>  // for cout
+#include <memory>    // for unique_ptr
+#include <random>    // for mt19937, uniform_real_distribution
+#include <vector>    // for vector
+
+#include <cairo.h>
+#include <gtest/gtest.h>
+
+#include "helpers/PressureStroke.h"
+#include "model/Stroke.h"
+#include "util/raii/CairoWrappers.h"
+#include "view/StrokeViewHelper.h"
+
+using namespace xoj::view;
+
+/**
+ * Compares rendering a page of pressure strokes from their cached contours with computing the contours on every render
+ */
+TEST(StrokeContourBenchmark, pageRender) {
+    constexpr int width = 595;
+    constexpr int height = 842;
+    constexpr int strokeCount = 600;
+    constexpr size_t pointCount = 150;
+    constexpr int renderCount = 10;
+
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<double> distX(0.0, width - 80.0);
+    std::uniform_real_distribution<double> distY(10.0, height - 10.0);
+    std::vector<std::unique_ptr<Stroke>> strokes;
+    for (int i = 0; i < strokeCount; i++) {
+        strokes.push_back(makePressureStroke(distX(gen), distY(gen), pointCount));
+    }
+
+    auto render = [&](auto&& draw) {
+        xoj::util::CairoSurfaceSPtr surface(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height),
+                                            xoj::util::adopt);
+        xoj::util::CairoSPtr cr(cairo_create(surface.get()), xoj::util::adopt);
+        cairo_set_source_rgb(cr.get(), 0, 0, 0);
+        for (const auto& s: strokes) {
+            draw(cr.get(), *s);
+        }
+        cairo_surface_flush(surface.get());
+        return surface;
+    };
+
+    using clock = std::chrono::steady_clock;
+
+    // Before: the contour was computed on every render
+    auto start = clock::now();
+    xoj::util::CairoSurfaceSPtr before;
+    for (int i = 0; i < renderCount; i++) {
+        before = render([](cairo_t* cr, const Stroke& s) {
+            StrokeViewHelper::drawWithPressure(cr, s.getPointVector(), s.getLineStyle());
+        });
+    }
+    auto beforeTime = std::chrono::duration<double, std::milli>(clock::now() - start).count() / renderCount;
+
+    // Now: the contour is computed on the first render only
+    start = clock::now();
+    xoj::util::CairoSurfaceSPtr after;
+    for (int i = 0; i < renderCount; i++) {
+        after = render([](cairo_t* cr, const Stroke& s) { StrokeViewHelper::drawWithPressure(cr, s); });
+    }
+    auto afterTime = std::chrono::duration<double, std::milli>(clock::now() - start).count() / renderCount;
+
+    std::cout << "Page of " << strokeCount << " pressure strokes: " << beforeTime << " ms per render before, "
+              << afterTime << " ms now (" << beforeTime / afterTime << "x)" << std::endl;
+
+    // Only the approximation of the arcs differs
+    const int stride = cairo_image_surface_get_stride(before.get());
+    const unsigned char* dataBefore = cairo_image_surface_get_data(before.get());
+    const unsigned char* dataAfter = cairo_image_surface_get_data(after.get());
+    double difference = 0;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < 4 * width; x++) {
+            difference += std::abs(dataBefore[y * stride + x] - dataAfter[y * stride + x]);
+        }
+    }
+    EXPECT_LT(difference / (4.0 * width * height), 1.0);
+}
@@ -0,0 +1,64 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal Benchmarks
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <chrono>    // for steady_clock, duration
+#include <cstdio>    // for snprintf
+#include <iostream>  // for cout
+#include <random>    // for mt19937, uniform_real_distribution
+#include <string>    // for string
+#include <vector>    // for vector
+
+#include <glib.h>
+#include <gtest/gtest.h>
+
+#include "util/NumberScanner.h"
+
+using xoj::util::NumberScanner;
+
+/**
+ * Compares the scanner with the g_ascii_strtod loop it replaced in LoadHandler, on the coordinates of a large stroke
+ */
+TEST(NumberScannerBenchmark, strokeCoordinates) {
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<double> dist(0.0, 842.0);
+    std::string data;
+    char buffer[64];
+    for (int i = 0; i < 200000; i++) {
+        std::snprintf(buffer, sizeof(buffer), "%.8g ", dist(gen));
+        data += buffer;
+    }
+
+    using clock = std::chrono::steady_clock;
+    auto start = clock::now();
+    std::vector<double> expected;
+    for (const char* ptr = data.c_str(); *ptr != 0;) {
+        char* endPtr = nullptr;
+        double val = g_ascii_strtod(ptr, &endPtr);
+        if (endPtr == ptr) {
+            break;
+        }
+        ptr = endPtr;
+        expected.push_back(val);
+    }
+    auto strtodTime = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+    start = clock::now();
+    std::vector<double> actual;
+    NumberScanner scanner(data);
+    for (double val = 0; scanner.readDouble(val);) {
+        actual.push_back(val);
+    }
+    auto scannerTime = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+    std::cout << "g_ascii_strtod: " << strtodTime << " ms, NumberScanner: " << scannerTime << " ms ("
+              << strtodTime / scannerTime << "x)" << std::endl;
+    EXPECT_EQ(expected, actual);
+}
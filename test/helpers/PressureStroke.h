@@ -0,0 +1,32 @@
+/*
+ * Xournal++
+ *
+ * Pressure strokes shared by the tests and the benchmarks
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cmath>    // for sin, cos
+#include <cstddef>  // for size_t
+#include <memory>   // for make_unique, unique_ptr
+
+#include "model/Point.h"   // for Point
+#include "model/Stroke.h"  // for Stroke
+
+/**
+ * @return A looping stroke starting around (x, y) and heading right, whose pressure varies along the way
+ */
+inline auto makePressureStroke(double x, double y, size_t pointCount) -> std::unique_ptr<Stroke> {
+    auto s = std::make_unique<Stroke>();
+    s->setWidth(1.5);
+    for (size_t i = 0; i < pointCount; i++) {
+        double t = static_cast<double>(i) * 0.2;
+        s->addPoint(Point(x + 2.0 * t + 3.0 * std::cos(t), y + 6.0 * std::sin(t), 1.0 + 0.8 * std::sin(0.3 * t)));
+    }
+    return s;
+}
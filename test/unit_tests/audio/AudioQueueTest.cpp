@@ -0,0 +1,72 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cstddef>   // for size_t
+#include <iterator>  // for back_inserter
+#include <vector>    // for vector
+
+#include <gtest/gtest.h>
+
+#include "audio/AudioQueue.h"
+
+TEST(AudioQueue, testWrapAround) {
+    AudioQueue<float> queue(8);
+    queue.setAudioAttributes(44100, 2);
+    ASSERT_EQ(queue.capacity(), 8U);
+
+    std::vector<float> out;
+    float next = 0;
+    for (int round = 0; round < 10; round++) {
+        std::vector<float> in = {next, next + 1, next + 2, next + 3, next + 4, next + 5};
+        next += 6;
+        queue.emplace(in.begin(), in.end());
+        queue.pop(std::back_inserter(out), 6);
+    }
+
+    ASSERT_EQ(out.size(), 60U);
+    for (size_t i = 0; i < out.size(); i++) {
+        EXPECT_EQ(out[i], static_cast<float>(i));
+    }
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.getDroppedSamples(), 0U);
+}
+
+TEST(AudioQueue, testWholeFramesAndOverflow) {
+    AudioQueue<float> queue(8);
+    queue.setAudioAttributes(44100, 2);
+
+    std::vector<float> in = {0, 1, 2, 3, 4};
+    queue.emplace(in.begin(), in.end());
+
+    // Only the complete frames are popped
+    std::vector<float> out;
+    queue.pop(std::back_inserter(out), 10);
+    EXPECT_EQ(out, (std::vector<float>{0, 1, 2, 3}));
+    EXPECT_EQ(queue.size(), 1U);
+
+    // The samples which do not fit are dropped
+    std::vector<float> more(10, 5);
+    queue.emplace(more.begin(), more.end());
+    EXPECT_EQ(queue.size(), 8U);
+    EXPECT_EQ(queue.getDroppedSamples(), 3U);
+
+    queue.signalEndOfStream();
+    EXPECT_TRUE(queue.hasStreamEnded());
+    // Does not block once the stream has ended
+    queue.waitForProducer();
+    queue.waitForConsumer();
+
+    queue.reset();
+    EXPECT_TRUE(queue.empty());
+    EXPECT_FALSE(queue.hasStreamEnded());
+    EXPECT_EQ(queue.getDroppedSamples(), 0U);
+    EXPECT_EQ(queue.getAudioAttributes().second, 0);
+}
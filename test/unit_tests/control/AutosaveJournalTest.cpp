@@ -0,0 +1,86 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <fstream>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "control/xojfile/AutosaveJournal.h"
+#include "control/xojfile/LoadHandler.h"
+#include "control/xojfile/SaveHandler.h"
+#include "model/Document.h"
+#include "model/DocumentHandler.h"
+#include "model/Layer.h"
+#include "model/Stroke.h"
+#include "model/XojPage.h"
+
+#include "filesystem.h"
+
+static void addStroke(const PageRef& page, double x) {
+    auto s = std::make_unique<Stroke>();
+    s->setWidth(1);
+    s->addPoint(Point(x, 10));
+    s->addPoint(Point(x + 10, 20));
+    page->getSelectedLayer()->addElement(std::move(s));
+}
+
+static auto strokeCount(const ConstPageRef& page) -> size_t {
+    return page->getLayersView()[0]->getElementsView().size();
+}
+
+TEST(ControlAutosaveJournal, testReplay) {
+    const fs::path autosave = fs::temp_directory_path() / "xournalpp-test-units_AutosaveJournal.autosave.xopp";
+    const fs::path journal = AutosaveJournal::getPath(autosave);
+    fs::remove(journal);
+
+    DocumentHandler handler;
+    Document doc(&handler);
+    doc.addPage(std::make_shared<XojPage>(200, 200));
+    doc.addPage(std::make_shared<XojPage>(200, 200));
+    addStroke(doc.getPage(0), 0);
+    addStroke(doc.getPage(1), 0);
+
+    {
+        SaveHandler saver;
+        saver.prepareSave(&doc, autosave);
+        saver.saveTo(autosave);
+        ASSERT_TRUE(saver.getErrorMessage().empty());
+    }
+
+    // Change the second page, and insert a new page at the beginning
+    addStroke(doc.getPage(1), 50);
+    doc.insertPage(std::make_shared<XojPage>(300, 300), 0);
+    addStroke(doc.getPage(0), 0);
+    addStroke(doc.getPage(0), 50);
+    addStroke(doc.getPage(0), 100);
+
+    AutosaveJournal::Record record{{2, 0, 1}, {2, 1}};
+    auto changed = doc.createSnapshot({0, 2});
+    ASSERT_TRUE(AutosaveJournal::append(journal, record, changed.get()).empty());
+
+    // An incomplete record, as left by a crash while writing, is ignored
+    {
+        std::ofstream out(journal, std::ios::out | std::ios::binary | std::ios::app);
+        out << "xopp-journal 1000 1 0 0\nabc";
+    }
+
+    auto loaded = LoadHandler().loadDocument(autosave);
+    ASSERT_TRUE(loaded);
+    ASSERT_EQ(3U, loaded->getPageCount());
+    EXPECT_EQ(300.0, loaded->getPage(0)->getWidth());
+    EXPECT_EQ(3U, strokeCount(loaded->getPage(0)));
+    EXPECT_EQ(1U, strokeCount(loaded->getPage(1)));
+    EXPECT_EQ(2U, strokeCount(loaded->getPage(2)));
+
+    fs::remove(journal);
+    fs::remove(autosave);
+}
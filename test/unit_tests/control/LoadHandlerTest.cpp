@@ -612,3 +612,61 @@ TEST(ControlLoadHandler, testRelativePath) {
     saveReloadTest(fs::temp_directory_path());
     saveReloadTest(fs::current_path());
 }
+
+TEST(ControlLoadHandler, testLoadPagesLazily) {
+    LoadHandler handler;
+    handler.setLoadPagesLazily(true);
+    auto doc = handler.loadDocument(GET_TESTFILE(u8"packaged_xopp/pages.xopp"));
+    ASSERT_TRUE(doc);
+
+    ASSERT_EQ((size_t)6, doc->getPageCount());
+    for (size_t i = 0; i < doc->getPageCount(); i++) {
+        EXPECT_FALSE(doc->getPage(i)->isContentLoaded());
+    }
+
+    checkPageType(doc.get(), 0, "p1", PageType(PageTypeFormat::Plain));
+    checkPageType(doc.get(), 1, "p2", PageType(PageTypeFormat::Ruled));
+    checkPageType(doc.get(), 2, "p3", PageType(PageTypeFormat::Lined));
+    checkPageType(doc.get(), 3, "p4", PageType(PageTypeFormat::Staves));
+    checkPageType(doc.get(), 4, "p5", PageType(PageTypeFormat::Graph));
+    checkPageType(doc.get(), 5, "p6", PageType(PageTypeFormat::Image));
+    for (size_t i = 0; i < doc->getPageCount(); i++) {
+        EXPECT_TRUE(doc->getPage(i)->isContentLoaded());
+    }
+
+    // Nothing was modified: all the pages but the kept one can be unloaded
+    EXPECT_EQ((size_t)5, doc->unloadLazyPages(0, 2));
+    EXPECT_FALSE(doc->getPage(0)->isContentLoaded());
+    EXPECT_TRUE(doc->getPage(2)->isContentLoaded());
+
+    // Loaded again when accessed
+    checkPageType(doc.get(), 0, "p1", PageType(PageTypeFormat::Plain));
+
+    // The layers may be modified once accessed through a non-const method: they must stay loaded
+    doc->getPage(0)->getSelectedLayer();
+    EXPECT_EQ((size_t)0, doc->unloadLazyPages(0, 2));
+    EXPECT_TRUE(doc->getPage(0)->isContentLoaded());
+}
+
+TEST(ControlLoadHandler, testLoadLayersLazily) {
+    LoadHandler handler;
+    handler.setLoadPagesLazily(true);
+    auto doc = handler.loadDocument(GET_TESTFILE(u8"load/layer.xoj"));
+    ASSERT_TRUE(doc);
+
+    ASSERT_EQ((size_t)1, doc->getPageCount());
+    ConstPageRef page = doc->getPage(0);
+    EXPECT_FALSE(page->isContentLoaded());
+
+    // A copy of a page not loaded yet shares its lazy content
+    auto snapshot = doc->createSnapshot();
+    ConstPageRef copy = snapshot->getPage(0);
+    EXPECT_FALSE(copy->isContentLoaded());
+
+    for (const ConstPageRef& p: {page, copy}) {
+        EXPECT_EQ((size_t)3, p->getLayerCount());
+        checkLayer(p, 0, "l1");
+        checkLayer(p, 1, "l2");
+        checkLayer(p, 2, "l3");
+    }
+}
@@ -0,0 +1,86 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cstddef>  // for size_t
+
+#include <cairo-pdf.h>    // for cairo_pdf_surface_create
+#include <cairo.h>
+#include <glib.h>         // for GError
+#include <gtest/gtest.h>
+
+#include "control/PdfCache.h"
+#include "pdf/base/XojPdfDocument.h"
+#include "util/raii/CairoWrappers.h"
+
+#include "filesystem.h"
+
+constexpr double PAGE_WIDTH = 200;
+constexpr double PAGE_HEIGHT = 300;
+constexpr size_t PAGE_COUNT = 4;
+
+static auto createPdf() -> fs::path {
+    const fs::path path = fs::temp_directory_path() / "xournalpp-test-units_PdfCache.pdf";
+    xoj::util::CairoSurfaceSPtr surface(cairo_pdf_surface_create(path.u8string().c_str(), PAGE_WIDTH, PAGE_HEIGHT),
+                                        xoj::util::adopt);
+    xoj::util::CairoSPtr cr(cairo_create(surface.get()), xoj::util::adopt);
+    for (size_t i = 0; i < PAGE_COUNT; i++) {
+        cairo_rectangle(cr.get(), 10.0 * static_cast<double>(i), 10, 50, 50);
+        cairo_fill(cr.get());
+        cairo_show_page(cr.get());
+    }
+    cr.reset();
+    surface.reset();
+    return path;
+}
+
+static void render(PdfCache& cache, size_t pdfPageNo, double zoom, xoj::view::PdfCacheTreatment treatment) {
+    xoj::util::CairoSurfaceSPtr surface(
+            cairo_image_surface_create(CAIRO_FORMAT_ARGB32, static_cast<int>(PAGE_WIDTH * zoom) + 1,
+                                       static_cast<int>(PAGE_HEIGHT * zoom) + 1),
+            xoj::util::adopt);
+    xoj::util::CairoSPtr cr(cairo_create(surface.get()), xoj::util::adopt);
+    cairo_scale(cr.get(), zoom, zoom);
+    cache.render(cr.get(), pdfPageNo, zoom, PAGE_WIDTH, PAGE_HEIGHT, treatment);
+}
+
+TEST(PdfCache, testPreviewsKeepTheMainViewPages) {
+    const fs::path path = createPdf();
+    XojPdfDocument doc;
+    GError* error = nullptr;
+    ASSERT_TRUE(doc.load(path, "", &error));
+    ASSERT_EQ(doc.getPageCount(), PAGE_COUNT);
+
+    PdfCache cache(doc, nullptr, nullptr);
+    cache.setMaxSize(2);
+
+    // The main view shows the pages 0 and 1, the latter being the most recently used
+    render(cache, 0, 2.0, xoj::view::CACHE_PDF_RENDERING);
+    render(cache, 1, 2.0, xoj::view::CACHE_PDF_RENDERING);
+    EXPECT_TRUE(cache.contains(0));
+    EXPECT_TRUE(cache.contains(1));
+
+    // The sidebar draws the thumbnails of all the pages: nothing is evicted nor added
+    for (size_t i = 0; i < PAGE_COUNT; i++) {
+        render(cache, i, 0.2, xoj::view::REUSE_CACHED_PDF_ONLY);
+    }
+    EXPECT_TRUE(cache.contains(0));
+    EXPECT_TRUE(cache.contains(1));
+    EXPECT_FALSE(cache.contains(2));
+    EXPECT_FALSE(cache.contains(3));
+
+    // Reusing the page 0 did not make it the most recently used one
+    render(cache, 2, 2.0, xoj::view::CACHE_PDF_RENDERING);
+    EXPECT_FALSE(cache.contains(0));
+    EXPECT_TRUE(cache.contains(1));
+    EXPECT_TRUE(cache.contains(2));
+
+    fs::remove(path);
+}
@@ -0,0 +1,78 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <set>  // for set
+
+#include <gtest/gtest.h>
+
+#include "control/RenderCache.h"
+
+namespace {
+class TestClient: public RenderCache::Client {
+public:
+    bool evictRenderCache(size_t id) override {
+        if (pinned.count(id)) {
+            return false;
+        }
+        evicted.insert(id);
+        return true;
+    }
+
+    std::set<size_t> pinned;
+    std::set<size_t> evicted;
+};
+}  // namespace
+
+TEST(RenderCache, testLeastRecentlyUsedEvicted) {
+    RenderCache cache(300);
+    TestClient a;
+    TestClient b;
+
+    cache.update(&a, 1, RenderCache::PAGE_BUFFER, 100);
+    cache.update(&a, 2, RenderCache::PAGE_BUFFER, 100);
+    cache.update(&a, 3, RenderCache::PDF_PAGE, 100);
+    cache.touch(&a, 1);
+
+    // The updating client is never called back: it may hold its own lock
+    cache.update(&b, 1, RenderCache::PREVIEW, 100);
+    EXPECT_EQ(a.evicted, std::set<size_t>({2}));
+    EXPECT_TRUE(b.evicted.empty());
+
+    auto stats = cache.getStats();
+    EXPECT_EQ(stats.used, 300U);
+    EXPECT_EQ(stats.images, 3U);
+    EXPECT_EQ(stats.evictions, 1U);
+    EXPECT_EQ(stats.usedByKind[RenderCache::PAGE_BUFFER], 100U);
+    EXPECT_EQ(stats.usedByKind[RenderCache::PDF_PAGE], 100U);
+    EXPECT_EQ(stats.usedByKind[RenderCache::PREVIEW], 100U);
+}
+
+TEST(RenderCache, testRefusedEviction) {
+    RenderCache cache(250);
+    TestClient a;
+    TestClient b;
+    a.pinned = {1};
+
+    cache.update(&a, 1, RenderCache::PAGE_BUFFER, 100);
+    cache.update(&a, 2, RenderCache::PAGE_BUFFER, 100);
+    cache.update(&b, 1, RenderCache::PAGE_BUFFER, 100);
+    EXPECT_EQ(a.evicted, std::set<size_t>({2}));
+    EXPECT_EQ(cache.getStats().used, 200U);
+
+    // Shrinking the budget evicts everything which can be evicted
+    cache.setBudget(0);
+    EXPECT_EQ(b.evicted, std::set<size_t>({1}));
+    EXPECT_EQ(cache.getStats().used, 100U);
+
+    cache.remove(&a);
+    EXPECT_EQ(cache.getStats().used, 0U);
+    EXPECT_EQ(cache.getStats().images, 0U);
+}
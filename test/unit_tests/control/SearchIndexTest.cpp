@@ -0,0 +1,80 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cstddef>  // for size_t
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include <gtest/gtest.h>
+
+#include "control/SearchIndex.h"
+
+static void addPdfPage(SearchIndexData& data, size_t pdfPageNo, const std::string& text) {
+    data.addPdfPage(pdfPageNo, text, SearchIndexData::getTrigrams(text));
+}
+
+TEST(SearchIndex, testFindPdfCandidates) {
+    SearchIndexData data;
+    addPdfPage(data, 0, "the quick brown fox");
+    addPdfPage(data, 1, "jumps over the lazy dog");
+    addPdfPage(data, 2, "");
+    addPdfPage(data, 3, "a brown dog");
+    addPdfPage(data, 4, "abcd bcde");
+
+    EXPECT_EQ(data.findPdfCandidates("brown"), (std::vector<bool>{true, false, false, true, false}));
+    EXPECT_EQ(data.findPdfCandidates("the"), (std::vector<bool>{true, true, false, false, false}));
+    EXPECT_EQ(data.findPdfCandidates("cat"), (std::vector<bool>{false, false, false, false, false}));
+    EXPECT_EQ(data.findPdfCandidates("lazy fox"), (std::vector<bool>{false, false, false, false, false}));
+
+    // All the trigrams of the pattern are on the page, but not the pattern: the occurrences are counted afterwards
+    EXPECT_EQ(data.findPdfCandidates("abcde"), (std::vector<bool>{false, false, false, false, true}));
+    EXPECT_EQ(SearchIndex::countOccurrences(data.pdfText[4], "abcde"), 0U);
+
+    // Patterns too short to have a trigram may be on any page
+    EXPECT_EQ(data.findPdfCandidates("zz"), (std::vector<bool>{true, true, true, true, true}));
+}
+
+TEST(SearchIndex, testCountOccurrences) {
+    EXPECT_EQ(SearchIndex::countOccurrences("the quick brown fox", "o"), 2U);
+    EXPECT_EQ(SearchIndex::countOccurrences("aaaa", "aa"), 3U);
+    EXPECT_EQ(SearchIndex::countOccurrences("abc", "abcd"), 0U);
+    EXPECT_EQ(SearchIndex::countOccurrences("", "a"), 0U);
+}
+
+TEST(SearchIndex, testRank) {
+    std::vector<SearchIndex::PageHit> hits = {{0, 1}, {2, 5}, {4, 1}, {7, 5}, {9, 3}};
+    SearchIndex::rank(hits);
+    std::vector<size_t> pages;
+    for (const auto& hit: hits) {
+        pages.push_back(hit.page);
+    }
+    EXPECT_EQ(pages, (std::vector<size_t>{2, 7, 9, 0, 4}));
+}
+
+TEST(SearchIndex, testNextAndPreviousPage) {
+    const std::vector<size_t> pages = {2, 5, 9};
+
+    EXPECT_EQ(SearchIndex::nextPage(pages, 0), 2U);
+    EXPECT_EQ(SearchIndex::nextPage(pages, 2), 5U);
+    EXPECT_EQ(SearchIndex::nextPage(pages, 6), 9U);
+    EXPECT_EQ(SearchIndex::nextPage(pages, 9), 2U);
+    EXPECT_EQ(SearchIndex::nextPage(pages, 12), 2U);
+
+    EXPECT_EQ(SearchIndex::previousPage(pages, 12), 9U);
+    EXPECT_EQ(SearchIndex::previousPage(pages, 9), 5U);
+    EXPECT_EQ(SearchIndex::previousPage(pages, 3), 2U);
+    EXPECT_EQ(SearchIndex::previousPage(pages, 2), 9U);
+    EXPECT_EQ(SearchIndex::previousPage(pages, 0), 9U);
+
+    // A single page is always the next and the previous one
+    EXPECT_EQ(SearchIndex::nextPage({4}, 4), 4U);
+    EXPECT_EQ(SearchIndex::previousPage({4}, 4), 4U);
+}
@@ -0,0 +1,157 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <memory>  // for make_shared, make_unique
+#include <vector>  // for vector
+
+#include <gdk/gdk.h>
+#include <gtest/gtest.h>
+
+#include "control/ToolEnums.h"
+#include "control/ToolHandler.h"
+#include "control/settings/Settings.h"
+#include "control/tools/EraseHandler.h"
+#include "gui/LegacyRedrawable.h"
+#include "model/Document.h"
+#include "model/DocumentHandler.h"
+#include "model/EraserMotionRecording.h"
+#include "model/Layer.h"
+#include "model/Point.h"
+#include "model/Stroke.h"
+#include "model/XojPage.h"
+#include "undo/UndoRedoHandler.h"
+#include "util/Util.h"
+
+static auto makePage() -> PageRef { return std::make_shared<XojPage>(595, 842); }
+
+TEST(EraserGesture, testPageIndex) {
+    DocumentHandler dh;
+    Document doc(&dh);
+    std::vector<PageRef> pages;
+    for (int i = 0; i < 5; i++) {
+        pages.push_back(makePage());
+        doc.addPage(pages.back());
+    }
+    for (size_t i = 0; i < pages.size(); i++) {
+        EXPECT_EQ(doc.indexOf(pages[i]), i);
+    }
+
+    PageRef inserted = makePage();
+    doc.insertPage(inserted, 1);
+    EXPECT_EQ(doc.indexOf(inserted), 1U);
+    EXPECT_EQ(doc.indexOf(pages[1]), 2U);
+    EXPECT_EQ(doc.indexOf(pages[4]), 5U);
+
+    doc.deletePage(0);
+    EXPECT_EQ(doc.indexOf(pages[0]), npos);
+    EXPECT_EQ(doc.indexOf(inserted), 0U);
+    EXPECT_EQ(doc.indexOf(pages[4]), 4U);
+
+    doc.clearDocument();
+    EXPECT_EQ(doc.indexOf(inserted), npos);
+}
+
+TEST(EraserGesture, testAddMotionPoints) {
+    EraserMotionRecording recording;
+    recording.addMotionPoint(Point(0, 0), 10, 5.0, 2);
+
+    std::vector<EraserMotionPoint> gesture;
+    gesture.emplace_back(Point(1, 1), 20, 5.0, 3);
+    gesture.back().addAffectedStroke(7);
+    gesture.emplace_back(Point(2, 2), 30, 5.0, 3);
+    recording.addMotionPoints(std::move(gesture));
+
+    ASSERT_EQ(recording.getMotionPointCount(), 3U);
+    EXPECT_EQ(recording.getStartTimestamp(), 10U);
+    EXPECT_EQ(recording.getEndTimestamp(), 30U);
+    EXPECT_EQ(recording.getMotionPoints()[1].pageIndex, 3U);
+    EXPECT_EQ(recording.getMotionPoints()[1].affectedStrokeIndices, std::vector<size_t>{7});
+}
+
+/**
+ * Draws nothing, the test only checks the document
+ */
+class NullRedrawable: public LegacyRedrawable {
+public:
+    void repaintArea(double, double, double, double) const override {}
+    void repaintPage() const override {}
+    void rerenderPage(bool) override {}
+    void rerenderRect(double, double, double, double) override {}
+    GdkRGBA getSelectionColor() override { return {}; }
+    void deleteViewBuffer() override {}
+    int getX() const override { return 0; }
+    int getY() const override { return 0; }
+};
+
+static auto makeLine(double y) -> std::unique_ptr<Stroke> {
+    auto s = std::make_unique<Stroke>();
+    s->setWidth(1);
+    for (int x = 0; x <= 200; x += 10) {
+        s->addPoint(Point(x, y));
+    }
+    return s;
+}
+
+TEST(EraserGesture, testEraseHandlerRecording) {
+    Settings settings("non-existing-file-path");
+    settings.transactionStart();  // Never write the settings file
+    settings.setMotionExportEnabled(true);
+    ToolHandler tools(nullptr, nullptr, &settings);
+    tools.selectTool(TOOL_ERASER);
+    UndoRedoHandler undo(nullptr);
+    NullRedrawable view;
+
+    DocumentHandler dh;
+    Document doc(&dh);
+    for (int i = 0; i < 5; i++) {
+        doc.addPage(makePage());
+    }
+    PageRef page = doc.getPage(3);
+    Layer* layer = page->getSelectedLayer();
+    layer->addElement(makeLine(50));
+    layer->addElement(makeLine(100));
+
+    {
+        EraseHandler eraser(&undo, &doc, page, &tools, &view, &settings);
+        eraser.erase(100, 100, 10);
+        eraser.erase(110, 100, 20);
+        eraser.erase(100, 300, 30);
+        // Nothing is recorded before the end of the gesture
+        EXPECT_EQ(doc.getEraserMotionRecording().getMotionPointCount(), 0U);
+
+        doc.lock();
+        eraser.finalize();
+        doc.unlock();
+    }
+
+    const EraserMotionRecording& recording = doc.getEraserMotionRecording();
+    ASSERT_EQ(recording.getMotionPointCount(), 3U);
+    for (const EraserMotionPoint& p: recording.getMotionPoints()) {
+        EXPECT_EQ(p.pageIndex, 3U);
+    }
+    EXPECT_EQ(recording.getMotionPoints()[0].affectedStrokeIndices, std::vector<size_t>{1});
+    EXPECT_EQ(recording.getMotionPoints()[1].affectedStrokeIndices, std::vector<size_t>{1});
+    EXPECT_TRUE(recording.getMotionPoints()[2].affectedStrokeIndices.empty());
+
+    // The erased line was split in two
+    EXPECT_EQ(layer->getElementsView().size(), 3U);
+    EXPECT_TRUE(undo.canUndo());
+
+    // A page inserted before moves the page index, a gesture which is not finalized is flushed by the destructor
+    doc.insertPage(makePage(), 0);
+    {
+        EraseHandler eraser(&undo, &doc, page, &tools, &view, &settings);
+        eraser.erase(150, 50, 40);
+    }
+    ASSERT_EQ(recording.getMotionPointCount(), 4U);
+    EXPECT_EQ(recording.getMotionPoints()[3].pageIndex, 4U);
+    EXPECT_EQ(recording.getMotionPoints()[3].affectedStrokeIndices, std::vector<size_t>{0});
+}
@@ -0,0 +1,63 @@
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "model/Layer.h"
+#include "model/Stroke.h"
+#include "util/Rectangle.h"
+
+using xoj::util::Rectangle;
+
+static auto makeStroke(double x, double y) -> std::unique_ptr<Stroke> {
+    auto s = std::make_unique<Stroke>();
+    s->setWidth(1);
+    s->addPoint(Point(x, y));
+    s->addPoint(Point(x + 10, y + 10));
+    return s;
+}
+
+TEST(LayerSpatialIndex, testQuery) {
+    Layer layer;
+    auto* a = makeStroke(0, 0).release();
+    auto* b = makeStroke(500, 500).release();
+    auto* c = makeStroke(5, 5).release();
+    layer.addElement(ElementPtr(a));
+    layer.addElement(ElementPtr(b));
+    layer.addElement(ElementPtr(c));
+
+    EXPECT_EQ(layer.getElementsInArea(Rectangle<double>(0, 0, 20, 20)), (std::vector<Element*>{a, c}));
+    EXPECT_EQ(layer.getElementsInArea(Rectangle<double>(490, 490, 5, 5)), (std::vector<Element*>{}));
+    EXPECT_EQ(layer.getElementsInArea(Rectangle<double>(-1000, -1000, 3000, 3000)), (std::vector<Element*>{a, b, c}));
+
+    // Moving an element updates the index
+    b->move(-500, -500);
+    EXPECT_EQ(layer.getElementsInArea(Rectangle<double>(0, 0, 20, 20)), (std::vector<Element*>{a, b, c}));
+    EXPECT_EQ(layer.getElementsInArea(Rectangle<double>(490, 490, 30, 30)), (std::vector<Element*>{}));
+
+    // Removed elements are not returned anymore
+    auto removed = layer.removeElement(a);
+    EXPECT_EQ(layer.getElementsInArea(Rectangle<double>(0, 0, 20, 20)), (std::vector<Element*>{b, c}));
+}
+
+TEST(LayerSpatialIndex, testOrderAfterInsertion) {
+    Layer layer;
+    std::vector<Element*> expected;
+    for (int i = 0; i < 4; i++) {
+        auto s = makeStroke(i, i);
+        expected.push_back(s.get());
+        layer.addElement(std::move(s));
+    }
+
+    // Insert many elements at the same position, to exhaust the gaps between the order keys
+    for (int i = 0; i < 30; i++) {
+        auto s = makeStroke(i, i);
+        expected.insert(expected.begin() + 2, s.get());
+        layer.insertElement(std::move(s), 2);
+    }
+
+    for (size_t i = 0; i < expected.size(); i++) {
+        EXPECT_EQ(layer.indexOf(expected[i]), static_cast<Element::Index>(i));
+    }
+    EXPECT_EQ(layer.getElementsInArea(Rectangle<double>(-100, -100, 200, 200)), expected);
+}
@@ -12,9 +12,14 @@
 #include <config-test.h>
 #include <gtest/gtest.h>
 
+#include "model/Document.h"
+#include "model/EraserMotionRecording.h"
+#include "model/Layer.h"
 #include "model/MotionRecording.h"
 #include "model/Point.h"
 #include "model/Stroke.h"
+#include "model/XojPage.h"
+#include "motion/MotionTimeline.h"
 
 TEST(MotionRecording, testBasicOperations) {
     MotionRecording motion;
@@ -192,3 +197,56 @@ TEST(MotionRecording, testSerialization) {
     // which are tested in the util/ObjectIOStreamTest.cpp file.
     // This test primarily verifies the API usage compiles correctly.
 }
+
+static auto makeRecordedStroke(size_t pointCount, const std::vector<size_t>& timestamps) -> std::unique_ptr<Stroke> {
+    auto stroke = std::make_unique<Stroke>();
+    for (size_t i = 0; i < pointCount; i++) {
+        stroke->addPoint(Point(10.0 * static_cast<double>(i), 10.0));
+    }
+    auto motion = std::make_unique<MotionRecording>();
+    for (size_t ts: timestamps) {
+        motion->addMotionPoint(Point(0.0, 0.0, 0.5), ts, false);
+    }
+    stroke->setMotionRecording(std::move(motion));
+    return stroke;
+}
+
+TEST(MotionRecording, testTimeline) {
+    Document doc(nullptr);
+    auto page = std::make_shared<XojPage>(200.0, 100.0);
+    auto first = makeRecordedStroke(4, {1000, 1050, 1100});
+    const Stroke* firstStroke = first.get();
+    page->getSelectedLayer()->addElement(std::move(first));
+    page->getSelectedLayer()->addElement(makeRecordedStroke(3, {5000, 5200}));
+    // Not replayed
+    page->getSelectedLayer()->addElement(std::make_unique<Stroke>());
+    doc.addPage(page);
+
+    EraserMotionRecording eraser;
+    eraser.addMotionPoint(Point(20.0, 20.0, -1.0), 6000, 8.0, 0);
+    eraser.addMotionPoint(Point(25.0, 20.0, -1.0), 6100, 8.0, 0);
+
+    MotionTimeline timeline(doc, eraser);
+
+    // The idle time between the strokes and the eraser moves is skipped
+    EXPECT_EQ(timeline.getDuration(), 400);
+    EXPECT_EQ(timeline.getFrameCount(10), 5);
+    EXPECT_EQ(timeline.getFrameTimestamp(0, 10), 1000);
+    EXPECT_EQ(timeline.getFrameTimestamp(1, 10), 5000);
+    EXPECT_EQ(timeline.getFrameTimestamp(2, 10), 5100);
+    EXPECT_EQ(timeline.getFrameTimestamp(3, 10), 6000);
+    EXPECT_EQ(timeline.getFrameTimestamp(4, 10), 6100);
+    EXPECT_EQ(timeline.getPageAt(5100), 0);
+
+    const auto& strokes = timeline.getStrokes(0);
+    ASSERT_EQ(strokes.size(), 2);
+    EXPECT_EQ(strokes[0].stroke, firstStroke);
+    EXPECT_EQ(MotionTimeline::getDrawnPointCount(strokes[0], 999), 0);
+    EXPECT_EQ(MotionTimeline::getDrawnPointCount(strokes[0], 1050), 3);
+    EXPECT_EQ(MotionTimeline::getDrawnPointCount(strokes[0], 1100), 4);
+
+    EXPECT_EQ(timeline.getEraserAt(0, 5100), nullptr);
+    const EraserMotionPoint* point = timeline.getEraserAt(0, 6050);
+    ASSERT_NE(point, nullptr);
+    EXPECT_EQ(point->timestamp, 6000);
+}
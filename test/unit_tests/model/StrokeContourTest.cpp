@@ -0,0 +1,69 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <array>  // for array
+
+#include <cairo.h>
+#include <gtest/gtest.h>
+
+#include "helpers/PressureStroke.h"
+#include "model/LineStyle.h"
+#include "model/Stroke.h"
+#include "util/raii/CairoWrappers.h"
+
+using namespace xoj::view;
+
+/// The extents of the filled contour, as {x1, y1, x2, y2}
+static auto fillExtents(const PrecomputedStrokeContour& contour) -> std::array<double, 4> {
+    xoj::util::CairoSurfaceSPtr surface(cairo_recording_surface_create(CAIRO_CONTENT_ALPHA, nullptr),
+                                        xoj::util::adopt);
+    xoj::util::CairoSPtr cr(cairo_create(surface.get()), xoj::util::adopt);
+    contour.addToCairo(cr.get());
+    std::array<double, 4> e{};
+    cairo_fill_extents(cr.get(), &e[0], &e[1], &e[2], &e[3]);
+    return e;
+}
+
+TEST(StrokeContour, testContourCache) {
+    auto s = makePressureStroke(10, 10, 50);
+    auto contour = s->getContour();
+    EXPECT_EQ(s->getContour(), contour);
+
+    // Clones share the points, and thus the contour
+    auto clone = s->cloneStroke();
+    EXPECT_EQ(clone->getContour(), contour);
+
+    // Moving translates the contour instead of computing it again
+    s->move(5, 5);
+    auto moved = s->getCachedContour();
+    ASSERT_NE(moved, nullptr);
+    EXPECT_NE(moved, contour);
+    EXPECT_EQ(clone->getContour(), contour);
+    auto before = fillExtents(*contour);
+    auto after = fillExtents(*moved);
+    for (size_t i = 0; i < before.size(); i++) {
+        EXPECT_NEAR(after[i], before[i] + 5.0, 1e-6);
+    }
+
+    // Dropping the contour frees it until the next use
+    s->dropContour();
+    EXPECT_EQ(s->getCachedContour(), nullptr);
+    EXPECT_NE(s->getContour(), nullptr);
+    EXPECT_EQ(clone->getCachedContour(), contour);
+
+    contour = clone->getContour();
+    clone->scalePressure(2.0);
+    EXPECT_NE(clone->getContour(), contour);
+
+    contour = clone->getContour();
+    clone->setLineStyle(LineStyle());
+    EXPECT_NE(clone->getContour(), contour);
+}
@@ -0,0 +1,51 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <barrier>  // for barrier
+#include <cstddef>  // for size_t, ptrdiff_t
+#include <thread>   // for thread
+#include <vector>   // for vector
+
+#include <gtest/gtest.h>
+#include <pango/pango.h>
+
+#include "model/Text.h"
+
+TEST(TextLayout, testLayoutReusedByManyThreads) {
+    // More threads than the 4 layouts cached before the cache followed the number of render threads
+    constexpr size_t threadCount = 8;
+    Text::setRenderThreadCount(threadCount);
+
+    Text text;
+    text.setText("The quick brown fox");
+
+    // Each thread has its own pango font map, and thus its own layout
+    std::vector<PangoLayout*> first(threadCount);
+    std::vector<PangoLayout*> second(threadCount);
+    std::barrier sync(static_cast<std::ptrdiff_t>(threadCount));
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < threadCount; i++) {
+        threads.emplace_back([&, i]() {
+            first[i] = text.withPangoLayout(nullptr, [](PangoLayout* layout) { return layout; });
+            // All the threads have a layout before any draws again
+            sync.arrive_and_wait();
+            second[i] = text.withPangoLayout(nullptr, [](PangoLayout* layout) { return layout; });
+        });
+    }
+    for (auto& t: threads) {
+        t.join();
+    }
+
+    for (size_t i = 0; i < threadCount; i++) {
+        EXPECT_NE(first[i], nullptr);
+        EXPECT_EQ(first[i], second[i]);
+    }
+}
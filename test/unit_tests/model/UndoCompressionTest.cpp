@@ -0,0 +1,150 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cmath>   // for sin
+#include <memory>  // for make_shared, make_unique
+#include <vector>  // for vector
+
+#include <gtest/gtest.h>
+
+#include "model/Layer.h"
+#include "model/Point.h"
+#include "model/Stroke.h"
+#include "model/XojPage.h"
+#include "model/eraser/ErasableStroke.h"
+#include "model/eraser/PaddedBox.h"
+#include "undo/DeleteUndoAction.h"
+#include "undo/EraseUndoAction.h"
+#include "undo/UndoRedoHandler.h"
+#include "util/Range.h"
+#include "util/SmallVector.h"
+
+TEST(UndoCompression, testDeleteUndoActionRoundTrip) {
+    auto page = std::make_shared<XojPage>(595, 842);
+    Layer* layer = page->getSelectedLayer();
+
+    DeleteUndoAction action(page, false);
+    std::vector<std::vector<Point>> points;
+    std::vector<Stroke*> strokes;
+    for (int i = 0; i < 10; i++) {
+        auto s = std::make_unique<Stroke>();
+        s->setWidth(1);
+        for (int j = 0; j < 1000; j++) {
+            s->addPoint(Point(j * 0.5, 400 + 100 * std::sin(i + j * 0.01), 0.5));
+        }
+        points.push_back(s->getPointVector());
+        strokes.push_back(s.get());
+        action.addElement(layer, std::move(s), i);
+    }
+
+    size_t hotSize = action.getByteSize();
+    ASSERT_TRUE(action.compress());
+    EXPECT_TRUE(action.isCompressed());
+    EXPECT_FALSE(action.compress());
+    EXPECT_LT(action.getByteSize(), hotSize);
+    for (Stroke* s: strokes) {
+        EXPECT_EQ(s->getPointCount(), 0U);
+    }
+
+    // The strokes are restored in place: the pointers held by other undo actions stay valid
+    ASSERT_TRUE(action.decompress());
+    EXPECT_FALSE(action.isCompressed());
+    for (size_t i = 0; i < strokes.size(); i++) {
+        ASSERT_EQ(strokes[i]->getPointCount(), points[i].size());
+        for (size_t j = 0; j < points[i].size(); j++) {
+            EXPECT_TRUE(strokes[i]->getPoint(j).equalsPos(points[i][j]));
+            EXPECT_EQ(strokes[i]->getPoint(j).z, points[i][j].z);
+        }
+    }
+    EXPECT_EQ(action.getByteSize(), hotSize);
+}
+
+/**
+ * Erases the middle of a new stroke as EraseHandler does
+ *
+ * @param original Set to the erased stroke, which is owned by the action
+ */
+static auto eraseNewStroke(const PageRef& page, Layer* layer, int seed, Stroke*& original)
+        -> std::unique_ptr<EraseUndoAction> {
+    auto s = std::make_unique<Stroke>();
+    s->setWidth(1);
+    for (int j = 0; j < 2000; j++) {
+        s->addPoint(Point(j * 0.25, 400 + 100 * std::sin(seed + j * 0.01), 0.5));
+    }
+    original = s.get();
+    layer->addElement(std::move(s));
+    Element::Index pos = layer->indexOf(original);
+
+    auto action = std::make_unique<EraseUndoAction>(page);
+    const PaddedBox box{original->getPoint(1000), 2, 2.5};
+    auto* erasable = new ErasableStroke(*original);
+    original->setErasable(erasable);
+    action->addOriginal(layer, original, pos);
+    Range range;
+    erasable->beginErasure(original->intersectWithPaddedBox(box), range);
+    action->finalize();
+    return action;
+}
+
+TEST(UndoCompression, testHandlerMemoryLimit) {
+    auto page = std::make_shared<XojPage>(595, 842);
+    Layer* layer = page->getSelectedLayer();
+
+    UndoRedoHandler handler(nullptr);
+    handler.setMemoryLimit(100 * 1024);
+
+    std::vector<EraseUndoAction*> actions;
+    std::vector<Stroke*> originals;
+    std::vector<std::vector<Point>> points;
+    for (int i = 0; i < 6; i++) {
+        Stroke* original = nullptr;
+        auto action = eraseNewStroke(page, layer, i, original);
+        actions.push_back(action.get());
+        originals.push_back(original);
+        points.push_back(original->getPointVector());
+        handler.addUndoAction(std::move(action));
+    }
+
+    // The oldest actions are compressed first, the last one never
+    ASSERT_TRUE(actions.front()->isCompressed());
+    EXPECT_EQ(originals.front()->getPointCount(), 0U);
+    EXPECT_FALSE(actions.back()->isCompressed());
+    EXPECT_EQ(originals.back()->getPointCount(), points.back().size());
+
+    // The running totals match the sizes of the actions
+    auto usage = handler.getMemoryUsage();
+    size_t total = 0;
+    size_t compressed = 0;
+    size_t compressedActions = 0;
+    for (const EraseUndoAction* action: actions) {
+        total += action->getByteSize();
+        if (action->isCompressed()) {
+            compressed += action->getByteSize();
+            compressedActions++;
+        }
+    }
+    EXPECT_EQ(usage.total, total);
+    EXPECT_EQ(usage.compressed, compressed);
+    EXPECT_EQ(usage.compressedActions, compressedActions);
+    EXPECT_LE(usage.total - usage.compressed - actions.back()->getByteSize(), 100U * 1024U);
+
+    // Undoing that far first restores the points of the erased stroke (see UndoRedoHandler::undo())
+    ASSERT_TRUE(actions.front()->decompress());
+    EXPECT_FALSE(actions.front()->isCompressed());
+    ASSERT_EQ(originals.front()->getPointCount(), points.front().size());
+    for (size_t j = 0; j < points.front().size(); j++) {
+        EXPECT_TRUE(originals.front()->getPoint(j).equalsPos(points.front()[j]));
+        EXPECT_EQ(originals.front()->getPoint(j).z, points.front()[j].z);
+    }
+
+    handler.clearContents();
+    EXPECT_EQ(handler.getMemoryUsage().total, 0U);
+}
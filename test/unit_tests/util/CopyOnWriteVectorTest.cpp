@@ -0,0 +1,82 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "util/CopyOnWriteVector.h"
+
+using xoj::util::CopyOnWriteVector;
+
+TEST(UtilCopyOnWriteVector, testCopySharesData) {
+    CopyOnWriteVector<int> a(std::vector<int>{1, 2, 3});
+    CopyOnWriteVector<int> b = a;
+
+    EXPECT_TRUE(a.isShared());
+    EXPECT_EQ(a.data(), b.data());
+    EXPECT_EQ(b.get(), (std::vector<int>{1, 2, 3}));
+}
+
+TEST(UtilCopyOnWriteVector, testModificationDetachesCopy) {
+    CopyOnWriteVector<int> a(std::vector<int>{1, 2, 3});
+    CopyOnWriteVector<int> b = a;
+
+    a.mut().push_back(4);
+    a.mut()[0] = 0;
+
+    EXPECT_FALSE(a.isShared());
+    EXPECT_FALSE(b.isShared());
+    EXPECT_EQ(a.get(), (std::vector<int>{0, 2, 3, 4}));
+    EXPECT_EQ(b.get(), (std::vector<int>{1, 2, 3}));
+}
+
+TEST(UtilCopyOnWriteVector, testUnsharedModificationDoesNotCopy) {
+    CopyOnWriteVector<int> a(std::vector<int>{1, 2, 3});
+    const int* data = a.data();
+    a.mut()[1] = 5;
+    EXPECT_EQ(a.data(), data);
+    EXPECT_EQ(a[1], 5);
+}
+
+TEST(UtilCopyOnWriteVector, testMovedFromIsEmpty) {
+    CopyOnWriteVector<int> a(std::vector<int>{1, 2, 3});
+    CopyOnWriteVector<int> b = std::move(a);
+    EXPECT_TRUE(a.empty());  // NOLINT(bugprone-use-after-move)
+    EXPECT_EQ(b.size(), 3U);
+    a.mut().push_back(1);
+    EXPECT_EQ(a.size(), 1U);
+}
+
+TEST(UtilCopyOnWriteVector, testReadCopyInOtherThread) {
+    std::vector<int> init(100000);
+    for (size_t i = 0; i < init.size(); i++) {
+        init[i] = static_cast<int>(i);
+    }
+    CopyOnWriteVector<int> a(init);
+
+    for (int round = 0; round < 10; round++) {
+        CopyOnWriteVector<int> snapshot = a;
+        long long sum = 0;
+        std::thread reader([snapshot = std::move(snapshot), &sum]() {
+            for (int v: snapshot) {
+                sum += v;
+            }
+        });
+        for (auto& v: a.mut()) {
+            v++;
+        }
+        reader.join();
+        const long long n = static_cast<long long>(init.size());
+        EXPECT_EQ(sum, n * (n - 1) / 2 + round * n);
+    }
+}
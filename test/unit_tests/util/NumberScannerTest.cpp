@@ -0,0 +1,140 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cmath>    // for isnan
+#include <cstdio>   // for snprintf
+#include <cstring>  // for memcmp
+#include <random>   // for mt19937, uniform_real_distribution
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include <glib.h>
+#include <gtest/gtest.h>
+
+#include "util/NumberScanner.h"
+
+using xoj::util::NumberScanner;
+
+/// Reads all the numbers of str with g_ascii_strtod, like LoadHandler used to
+static auto readWithStrtod(const std::string& str) -> std::vector<double> {
+    std::vector<double> result;
+    const char* ptr = str.c_str();
+    while (*ptr != 0) {
+        char* endPtr = nullptr;
+        double val = g_ascii_strtod(ptr, &endPtr);
+        if (endPtr == ptr) {
+            break;
+        }
+        ptr = endPtr;
+        result.push_back(val);
+    }
+    return result;
+}
+
+static auto readWithScanner(const std::string& str) -> std::vector<double> {
+    std::vector<double> result;
+    NumberScanner scanner(str);
+    for (double val = 0; scanner.readDouble(val);) {
+        result.push_back(val);
+    }
+    return result;
+}
+
+static void expectSameAsStrtod(const std::string& str) {
+    auto expected = readWithStrtod(str);
+    auto actual = readWithScanner(str);
+    ASSERT_EQ(expected.size(), actual.size()) << str;
+    for (size_t i = 0; i < expected.size(); i++) {
+        if (std::isnan(expected[i])) {
+            EXPECT_TRUE(std::isnan(actual[i])) << str;
+        } else {
+            // Bitwise equality, including the sign of zero
+            EXPECT_EQ(0, std::memcmp(&expected[i], &actual[i], sizeof(double))) << str << " #" << i;
+        }
+    }
+}
+
+TEST(UtilNumberScanner, testDoubles) {
+    expectSameAsStrtod("0 1 -1 +1 12.5 -0 -0.0 .5 5. 0.1 0.3 123.456 1e5 1E-5 -2.5e+3 007 0.000123");
+    expectSameAsStrtod("  \t\n 17.4 \r\n 18.25\t19  ");
+    expectSameAsStrtod("595.27559 841.88976 1.2345678e-05 9.8765432e+20 1e22 1e23 1e-22 1e-23");
+    expectSameAsStrtod("12345678901234567890 0.12345678901234567890123 9007199254740993");
+    expectSameAsStrtod("nan inf -inf infinity 0x1p3 1e400 1e-400");
+    expectSameAsStrtod("1e 2e+ 3E- 4");
+    expectSameAsStrtod("1.5abc");
+    expectSameAsStrtod("- 1");
+    expectSameAsStrtod("");
+}
+
+TEST(UtilNumberScanner, testRandomDoubles) {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(-5000.0, 5000.0);
+    std::string eight;
+    std::string seventeen;
+    char buffer[64];
+    for (int i = 0; i < 10000; i++) {
+        double val = dist(gen);
+        std::snprintf(buffer, sizeof(buffer), "%.8g ", val);
+        eight += buffer;
+        std::snprintf(buffer, sizeof(buffer), "%.17g ", val);
+        seventeen += buffer;
+    }
+    expectSameAsStrtod(eight);
+    expectSameAsStrtod(seventeen);
+}
+
+TEST(UtilNumberScanner, testNotNullTerminated) {
+    const std::string str = "1.25 2.5 37";
+    NumberScanner scanner(str.data(), str.data() + 9);
+    double val = 0;
+    EXPECT_EQ(2U, scanner.countTokens());
+    EXPECT_TRUE(scanner.readDouble(val));
+    EXPECT_EQ(1.25, val);
+    EXPECT_TRUE(scanner.readDouble(val));
+    EXPECT_EQ(2.5, val);
+    EXPECT_EQ(8U, scanner.position());
+    EXPECT_FALSE(scanner.readDouble(val));
+    EXPECT_TRUE(scanner.atEnd());
+}
+
+TEST(UtilNumberScanner, testMotionTuples) {
+    NumberScanner scanner("1000,1.5,2.5,0.5,0 1010,-3,4e1,1,1 1020,x");
+    size_t timestamp = 0;
+    size_t flag = 0;
+    double x = 0;
+    double y = 0;
+    double z = 0;
+
+    ASSERT_TRUE(scanner.readUnsigned(timestamp) && scanner.skip(',') && scanner.readDouble(x) && scanner.skip(',') &&
+                scanner.readDouble(y) && scanner.skip(',') && scanner.readDouble(z) && scanner.skip(',') &&
+                scanner.readUnsigned(flag));
+    EXPECT_EQ(1000U, timestamp);
+    EXPECT_EQ(1.5, x);
+    EXPECT_EQ(2.5, y);
+    EXPECT_EQ(0.5, z);
+    EXPECT_EQ(0U, flag);
+
+    ASSERT_TRUE(scanner.readUnsigned(timestamp) && scanner.skip(',') && scanner.readDouble(x) && scanner.skip(',') &&
+                scanner.readDouble(y) && scanner.skip(',') && scanner.readDouble(z) && scanner.skip(',') &&
+                scanner.readUnsigned(flag));
+    EXPECT_EQ(1010U, timestamp);
+    EXPECT_EQ(-3.0, x);
+    EXPECT_EQ(40.0, y);
+    EXPECT_EQ(1U, flag);
+
+    EXPECT_TRUE(scanner.readUnsigned(timestamp) && scanner.skip(','));
+    EXPECT_FALSE(scanner.readDouble(x));
+    EXPECT_EQ(40U, scanner.position());
+    EXPECT_FALSE(scanner.atEnd());
+
+    NumberScanner overflow("99999999999999999999999");
+    EXPECT_FALSE(overflow.readUnsigned(timestamp));
+}
@@ -0,0 +1,69 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <algorithm>  // for min
+#include <atomic>     // for atomic
+#include <cstring>    // for memcpy
+#include <string>     // for string
+
+#include <gtest/gtest.h>
+
+#include "util/ReadAheadStream.h"
+
+using xoj::util::ReadAheadStream;
+
+TEST(UtilReadAheadStream, testReadsWholeStream) {
+    std::string source;
+    for (int i = 0; i < 100000; i++) {
+        source += std::to_string(i);
+        source += ' ';
+    }
+
+    size_t pos = 0;
+    // Odd sizes, so that the reads do not match the chunks
+    ReadAheadStream stream(
+            [&](char* buffer, size_t len) -> std::ptrdiff_t {
+                size_t n = std::min({len, source.size() - pos, size_t(777)});
+                std::memcpy(buffer, source.data() + pos, n);
+                pos += n;
+                return static_cast<std::ptrdiff_t>(n);
+            },
+            1000, 3);
+
+    std::string result;
+    for (auto chunk = stream.next(); !chunk.empty(); chunk = stream.next()) {
+        result += chunk;
+    }
+    EXPECT_EQ(source, result);
+    EXPECT_TRUE(stream.next().empty());
+}
+
+TEST(UtilReadAheadStream, testStopsEarly) {
+    std::atomic<size_t> calls{0};
+    {
+        ReadAheadStream stream(
+                [&](char* buffer, size_t len) -> std::ptrdiff_t {
+                    calls++;
+                    buffer[0] = 'x';
+                    return 1;
+                },
+                16, 2);
+        EXPECT_EQ("x", stream.next());
+        // The stream is infinite: the destructor must stop the reading thread
+    }
+    // The reading thread only fills the two chunks of the ring, and then waits
+    EXPECT_LE(calls.load(), 2U);
+}
+
+TEST(UtilReadAheadStream, testError) {
+    ReadAheadStream stream([](char*, size_t) -> std::ptrdiff_t { return -1; });
+    EXPECT_TRUE(stream.next().empty());
+}
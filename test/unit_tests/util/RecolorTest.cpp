@@ -0,0 +1,68 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cstdint>
+
+#include <cairo.h>
+#include <gtest/gtest.h>
+
+#include "util/Recolor.h"
+#include "util/raii/CairoWrappers.h"
+
+namespace {
+auto getPixel(cairo_surface_t* surface, int x) -> uint32_t {
+    cairo_surface_flush(surface);
+    return reinterpret_cast<uint32_t*>(cairo_image_surface_get_data(surface))[x];
+}
+
+void setPixel(cairo_surface_t* surface, int x, uint32_t pixel) {
+    cairo_surface_flush(surface);
+    reinterpret_cast<uint32_t*>(cairo_image_surface_get_data(surface))[x] = pixel;
+    cairo_surface_mark_dirty(surface);
+}
+}  // namespace
+
+TEST(UtilRecolor, testImageSurfaceMatchesConvertColor) {
+    Recolor recolor(ColorU8(0xf0, 0xe0, 0xd0), ColorU8(0x10, 0x20, 0x30));
+    // More than a block of 8 pixels, to cover the remainder loop
+    constexpr int width = 19;
+    xoj::util::CairoSurfaceSPtr surface(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, 1), xoj::util::adopt);
+
+    for (int x = 0; x < width; x++) {
+        auto c = static_cast<uint8_t>(x * 13);
+        setPixel(surface.get(), x, 0xff000000U | (uint32_t(c) << 16U) | (uint32_t(255 - c) << 8U) | (c / 2U));
+    }
+    recolor.recolorImageSurface(surface.get());
+
+    for (int x = 0; x < width; x++) {
+        auto c = static_cast<uint8_t>(x * 13);
+        ColorU8 expected = recolor.convertColor(ColorU8(c, static_cast<uint8_t>(255 - c), static_cast<uint8_t>(c / 2)));
+        uint32_t p = getPixel(surface.get(), x);
+        EXPECT_EQ(p >> 24U, 0xffU);
+        EXPECT_EQ((p >> 16U) & 0xffU, expected.red);
+        EXPECT_EQ((p >> 8U) & 0xffU, expected.green);
+        EXPECT_EQ(p & 0xffU, expected.blue);
+    }
+}
+
+TEST(UtilRecolor, testImageSurfaceKeepsTransparency) {
+    Recolor recolor(ColorU8(0xff, 0xff, 0xff), ColorU8(0, 0, 0));
+    xoj::util::CairoSurfaceSPtr surface(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 2, 1), xoj::util::adopt);
+
+    setPixel(surface.get(), 0, 0x00000000U);
+    // Half transparent black, premultiplied
+    setPixel(surface.get(), 1, 0x80000000U);
+    recolor.recolorImageSurface(surface.get());
+
+    EXPECT_EQ(getPixel(surface.get(), 0), 0x00000000U);
+    // Half transparent white, premultiplied
+    EXPECT_EQ(getPixel(surface.get(), 1), 0x80808080U);
+}